@@ -24,16 +24,22 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <map>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <iterator>
+
+#include <boost/optional.hpp>
 #include <boost/utility/in_place_factory.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
-#include <opencv2/highgui/highgui.hpp>
-
 #include "utility/buildsys.hpp"
 #include "utility/gccversion.hpp"
 #include "utility/limits.hpp"
 #include "utility/path.hpp"
-#include "utility/openmp.hpp"
 
 #include "service/cmdline.hpp"
 
@@ -50,7 +56,6 @@
 #include "vts-libs/vts/meshopinput.hpp"
 #include "vts-libs/vts/meshop.hpp"
 #include "vts-libs/vts/math.hpp"
-#include "vts-libs/vts/opencv/atlas.hpp"
 #include "vts-libs/vts/ntgenerator.hpp"
 #include "vts-libs/tools-support/progress.hpp"
 
@@ -64,6 +69,15 @@
 #include "3dtiles/b3dm.hpp"
 #include "3dtiles/io.hpp"
 
+#include "cutengine.hpp"
+#include "shard.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "threadpool.hpp"
+#include "gltfdecoder.hpp"
+#include "tdttree.hpp"
+#include "meshcache.hpp"
+
 namespace po = boost::program_options;
 namespace bio = boost::iostreams;
 namespace fs = boost::filesystem;
@@ -78,26 +92,29 @@ namespace tdt = threedtiles;
 
 namespace {
 
-struct Config : tools::TmpTsEncoder::Config {
+struct Config : tools::TmpTsEncoder::Config, vtstools::CutConfig {
     geo::SrsDefinition inputSrs;
 
     std::string tilesetId;
     std::string referenceFrame;
     math::Size2 optimalTextureSize;
     double ntLodPixelSize;
+    bool fastAnalysis;
+    std::size_t analysisSample;
+    fs::path meshCache;
+
+    /** Input archive, locates tile content files for mesh cache keys.
+     */
+    fs::path input;
 
-    boost::optional<vts::LodTileRange> tileExtents;
-    double clipMargin;
-    double borderClipMargin;
-    double zShift;
+    vtstools::ShardConfig sharding;
 
     Config()
         : inputSrs(4328)
         , optimalTextureSize(256, 256)
         , ntLodPixelSize(1.0)
-        , clipMargin(1.0 / 128.)
-        , borderClipMargin(clipMargin)
-        , zShift(0.0)
+        , fastAnalysis(false)
+        , analysisSample(8)
     {}
 
     void configuration(po::options_description &config) {
@@ -146,7 +163,33 @@ struct Config : tools::TmpTsEncoder::Config {
              ->default_value(zShift)->required()
              , "Manual height adjustment (value is "
              "added to z component of all vertices).")
+
+            ("fastAnalysis", po::value(&fastAnalysis)
+             ->default_value(fastAnalysis)->implicit_value(true)
+             , "Analyze input from tile headers (glTF accessor bounds and "
+             "image headers) instead of fully decoded tiles. Faster on "
+             "large inputs but the LOD is only an estimate.")
+
+            ("fastAnalysis.sample", po::value(&analysisSample)
+             ->default_value(analysisSample)
+             , "Number of tiles fully decoded in each reference frame "
+             "subtree during fast analysis to verify the estimate. LOD is "
+             "taken from this sample when estimate is ambiguous.")
+
+            ("meshCache", po::value(&meshCache)
+             , "Directory of persistent cache of decoded and optimized input "
+             "meshes. Repeated conversions of the same input (e.g. with "
+             "different tileExtents or into another reference frame) load "
+             "meshes from the cache instead of decoding them (or reading "
+             "them at all). Entries are matched by path, size and "
+             "modification time of the content file. Disabled when not "
+             "set.")
             ;
+
+        sharding.configuration(config);
+        vtstools::metricsConfiguration(config);
+        vtstools::traceConfiguration(config);
+        vtstools::threadPoolConfiguration(config);
     }
 
     void configure(const po::variables_map &vars) {
@@ -155,6 +198,12 @@ struct Config : tools::TmpTsEncoder::Config {
         if (vars.count("tileExtents")) {
             tileExtents = vars["tileExtents"].as<vts::LodTileRange>();
         }
+
+        sharding.configure(vars);
+        shard = sharding.shard(tileExtents);
+        vtstools::configureMetrics(vars);
+        vtstools::configureTrace(vars);
+        vtstools::configureThreadPool(vars);
     }
 };
 
@@ -216,11 +265,18 @@ void Tdt2Vts::configuration(po::options_description &cmdline
 void Tdt2Vts::configure(const po::variables_map &vars)
 {
     config_.configure(vars);
+    config_.input = input_;
 
     createMode_ = (vars.count("overwrite")
                    ? vts::CreateMode::overwrite
                    : vts::CreateMode::failIfExists);
 
+    if (config_.sharding.worker) {
+        // worker cuts into its own tileset
+        output_ = vtstools::shardOutput(output_, *config_.sharding.worker);
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     epConfig_ = vt::configureProgress(vars);
 }
 
@@ -293,16 +349,105 @@ void addImage(SizeOnlyAtlas &atlas, const gltf::DataView &data
     atlas.add(imgproc::imageSize(data.first, gltf::size(data), filename));
 }
 
-void addImage(vts::opencv::Atlas &atlas, const gltf::DataView &data
+/** Encoded images handed over to the cutting engine which decodes them
+ *  only when needed.
+ */
+struct LazyAtlas {
+    vtstools::LazyTexture::list textures;
+
+    std::size_t size() const { return textures.size(); }
+};
+
+/** Tells whether atlas keeps encoded images. Such atlas gets views into
+ *  tile content instead of copies of images decoded by the gltf library.
+ */
+template <typename Atlas>
+bool keepsImages(const Atlas&) { return false; }
+
+bool keepsImages(const LazyAtlas&) { return true; }
+
+void addImage(LazyAtlas &atlas, const gltf::DataView &data
+              , const std::string &filename)
+{
+    // data are owned by the gltf library, keep a copy
+    auto copy(std::make_shared<std::vector<char>>(data.first, data.second));
+    atlas.textures.emplace_back(copy, copy->data(), copy->size(), filename);
+}
+
+gltf::DataView dataView(const vtstools::GltfImage &image)
+{
+    typedef decltype(gltf::DataView().first) Pointer;
+    return gltf::DataView(reinterpret_cast<Pointer>(image.data)
+                          , reinterpret_cast<Pointer>(image.data
+                                                      + image.size));
+}
+
+/** Adds image decoded natively; holder owns image data.
+ */
+template <typename Atlas>
+void addImage(Atlas &atlas, const vtstools::GltfImage &image
+              , const std::shared_ptr<const void>&
+              , const std::string &filename)
+{
+    addImage(atlas, dataView(image), filename);
+}
+
+void addImage(LazyAtlas &atlas, const vtstools::GltfImage &image
+              , const std::shared_ptr<const void> &holder
               , const std::string &filename)
 {
-    std::vector<std::uint8_t> d(data.first, data.second);
-    auto image(cv::imdecode(d, cv::IMREAD_COLOR));
-    if (!image.data) {
-        LOGTHROW(err2, vs::FormatError)
-            << "Cannot decode texture image from <" << filename << ">.";
+    // zero copy
+    atlas.textures.emplace_back(holder, image.data, image.size, filename);
+}
+
+/** Leading part of image read to get its size during estimate.
+ */
+const std::size_t ImageHeaderSize(1 << 16);
+
+/** Tile content as read from the archive.
+ */
+typedef decltype(std::declval<const tdt::Archive&>()
+                 .istream(std::string())->read()) Content;
+
+/** Reads content header (up to glTF JSON, see vtstools::gltfHeaderSize)
+ *  from the start of the stream.
+ */
+void readHeader(std::istream &s, Content &header, const std::string &filename)
+{
+    header.clear();
+    for (;;) {
+        const auto size(vtstools::gltfHeaderSize(header.data()
+                                                 , header.size()));
+        if (size <= header.size()) { break; }
+
+        const auto have(header.size());
+        header.resize(size);
+        if (!s.read(header.data() + have, size - have)) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Truncated header of <" << filename << ">.";
+        }
+    }
+}
+
+/** Reads the rest of content after its header.
+ */
+template <typename Stream>
+void readContent(Stream &is, Content &data, const std::string &filename)
+{
+    auto &s(is.get());
+    const auto have(data.size());
+    if (const auto size = is.size()) {
+        if (*size > have) {
+            data.resize(*size);
+            if (!s.read(data.data() + have, *size - have)) {
+                LOGTHROW(err2, std::runtime_error)
+                    << "Unable to read <" << filename << ">.";
+            }
+        }
+    } else {
+        data.insert(data.end(), std::istreambuf_iterator<char>(s)
+                    , std::istreambuf_iterator<char>());
     }
-    atlas.add(image);
 }
 
 template <typename Atlas>
@@ -317,6 +462,24 @@ public:
 
     void optimize() { tools::optimize(mesh_); }
 
+    /** Loads tile content. Content the gltf library cannot decode (Draco
+     *  or meshopt compressed, quantized) is decoded natively.
+     *
+     *  Content is read whole when decoded natively or when the atlas keeps
+     *  images: images are then views into content (no copy) even when the
+     *  gltf library decodes the rest. Otherwise only the header is read to
+     *  tell, the rest is read by the gltf library.
+     */
+    void load(const tdt::Archive &archive, const std::string &uri
+              , const gltf::MeshLoader::DecodeOptions &options);
+
+    /** Loads proxy of tile content built from glTF JSON and image headers
+     *  only (see vtstools::estimateGltf). Geometry and image data are never
+     *  read; fails if content stream is not seekable.
+     */
+    void estimate(const tdt::Archive &archive, const std::string &uri
+                  , const gltf::MeshLoader::DecodeOptions &options);
+
     std::pair<vts::Mesh&, Atlas&> get() {
         if (mesh_.submeshes.size() != atlas_.size()) {
             LOGTHROW(err2, std::runtime_error)
@@ -347,41 +510,149 @@ protected:
     }
 
     virtual void image(const gltf::DataView &imageData) {
+        if (const auto *image = locate(imageData)) {
+            addImage(atlas_, *image, content_, filename_);
+            return;
+        }
         addImage(atlas_, imageData, filename_);
     }
 
+    /** Finds image handed out by the gltf library (from its own buffer) in
+     *  content read by load. Returns nullptr when not found.
+     */
+    const vtstools::GltfImage* locate(const gltf::DataView &data) const {
+        const auto size(gltf::size(data));
+        const auto *bytes(reinterpret_cast<const char*>(data.first));
+        for (const auto &image : images_) {
+            if ((image.size == size)
+                && !std::memcmp(image.data, bytes, size))
+            {
+                return &image;
+            }
+        }
+        return nullptr;
+    }
+
     std::string filename_;
 
+    /** Whole tile content and images located in it, valid during load.
+     */
+    std::shared_ptr<const Content> content_;
+    std::vector<vtstools::GltfImage> images_;
+
     vts::Mesh mesh_;
     Atlas atlas_;
     vts::SubMesh *sm_;
 };
 
-// ------------------------------------------------------------------------
+template <typename Atlas>
+void VtsMeshLoader<Atlas>::load(const tdt::Archive &archive
+                                , const std::string &uri
+                                , const gltf::MeshLoader::DecodeOptions
+                                &options)
+{
+    auto is(archive.istream(uri));
+    auto data(std::make_shared<Content>());
+    readHeader(is->get(), *data, filename_);
+
+    // content using extensions the gltf library does not know (compressed
+    // or quantized geometry) must not reach it: it could misinterpret it
+    if (!vtstools::gltfNeedsNativeDecoder(data->data(), data->size())) {
+        if (keepsImages(atlas_)) {
+            readContent(*is, *data, filename_);
+            images_ = vtstools::gltfImages(data->data(), data->size());
+            content_ = std::move(data);
+        }
+        is.reset();
 
-struct TileInfo {
-    const tdt::Tile *tile;
-    const tdt::TilePath path;
+        archive.loadMesh(*this, uri, options);
+        images_.clear();
+        content_.reset();
+        return;
+    }
 
-    TileInfo(const tdt::Tile *tile, const tdt::TilePath &path)
-        : tile(tile), path(path)
-    {}
+    LOG(info1) << "Decoding <" << filename_ << "> natively.";
+    readContent(*is, *data, filename_);
 
-    std::string makePath() const;
+    vtstools::GltfContent content;
+    vtstools::decodeGltf(data->data(), data->size(), options.trafo
+                         , options.flipTc, content);
 
-    using list = std::vector<TileInfo>;
-};
+    mesh_ = std::move(content.mesh);
+    std::shared_ptr<const Content> holder(std::move(data));
+    for (const auto &image : content.images) {
+        addImage(atlas_, image, holder, filename_);
+    }
+}
+
+template <typename Atlas>
+void VtsMeshLoader<Atlas>::estimate(const tdt::Archive &archive
+                                    , const std::string &uri
+                                    , const gltf::MeshLoader::DecodeOptions
+                                    &options)
+{
+    auto is(archive.istream(uri));
+    auto &s(is->get());
+
+    // read tile header (up to glTF JSON) only
+    Content header;
+    readHeader(s, header, filename_);
+
+    vtstools::GltfContent content;
+    vtstools::estimateGltf(header.data(), header.size(), options.trafo
+                           , options.flipTc, content);
+
+    mesh_ = std::move(content.mesh);
+    atlas_ = Atlas();
+    sm_ = nullptr;
+
+    // read only leading part of each image holding its size
+    std::vector<char> buffer;
+    for (const auto &image : content.images) {
+        buffer.resize(std::min(image.size, ImageHeaderSize));
+        s.clear();
+        if (!s.seekg(image.offset) || !s.read(buffer.data(), buffer.size()))
+        {
+            LOGTHROW(err2, std::runtime_error)
+                << "Unable to read image header from <" << filename_
+                << ">.";
+        }
+        addImage(atlas_, dataView(vtstools::GltfImage
+                                  (buffer.data(), buffer.size()))
+                 , filename_);
+    }
+}
+
+// ------------------------------------------------------------------------
+
+typedef vtstools::TdtTile TileInfo;
+
+std::string makePath(const TileInfo &ti)
+{
+    return ti.uri + '[' + ti.path + ']';
+}
+
+/** Processing cost of tiles: size of tile content in bytes. Content of
+ *  unknown size costs 1.
+ */
+std::vector<double> tileCosts(const tdt::Archive &archive
+                              , const TileInfo::list &tiles)
+{
+    vtstools::TraceSpan span("tileCosts");
+    std::vector<double> costs(tiles.size(), 1.0);
+    vtstools::parallelFor(tiles.size(), [&](std::size_t i)
+    {
+        if (const auto size = archive.istream(tiles[i].uri)->size()) {
+            costs[i] = std::max<double>(1.0, *size);
+        }
+    });
+    return costs;
+}
 
 /** Tile Cutter.
  *
- *  Code in this class depends on the fact that loaded 3D Tiles tileset has
- *  these properties:
- *
- *    * all referenced tilesets are included in one tile tree
- *    * tile.refine is set for every tile (inherited from parent)
- *    * tile.transform is set and reflects root transformation
- *
- *  These properties are guaranteed by tdt::Archive::tileset() function.
+ *  Works on content tiles collected by vtstools::collectTiles (with
+ *  external tilesets loaded on the way).
  *
  *  Preconditions:
  *    * The tiles at the bottom of the tree must have the same level of detail.
@@ -392,158 +663,275 @@ public:
            , tools::TmpTileset &tmpset, vts::NtGenerator &ntg
            , const tdt::Archive &archive)
         : config_(config), rf_(rf), tmpset_(tmpset), ntg_(ntg)
-        , archive_(archive), tileset_(archive.tileset())
-        , nodes_(vts::NodeInfo::leaves(rf_))
+        , archive_(archive), nodes_(vts::NodeInfo::leaves(rf_))
     {}
 
     void run(vt::ExternalProgress &progress);
 
 private:
-    void cut3DTile(const TileInfo &ti, const tools::LodInfo &lodInfo);
-
-    void splitToTiles(const std::string &tilePath
-                      , const vts::NodeInfo &root
-                      , vts::Lod lod, const vts::TileRange &tr
-                      , const vts::Mesh &mesh
-                      , const vts::opencv::Atlas &atlas
-                      , vts::TileIndex::Flag::value_type tileFlags);
-
-    void cutTile(const std::string &tilePath, const vts::NodeInfo &node
-                 , const vts::Mesh &mesh
-                 , const vts::opencv::Atlas &atlas
-                 , vts::TileIndex::Flag::value_type tileFlags);
-
     const Config &config_;
     const vr::ReferenceFrame &rf_;
     tools::TmpTileset &tmpset_;
     vts::NtGenerator &ntg_;
     const tdt::Archive &archive_;
-    const tdt::Tileset &tileset_;
 
     const vts::NodeInfo::list nodes_;
 };
 
-std::string TileInfo::makePath() const
-{
-    std::ostringstream os;
-    os << tile->content->uri << '[' << path << ']';
-    return os.str();
-}
+/** Provides 3D Tiles to the cutting engine.
+ */
+class TileReader : public vtstools::SourceReader {
+public:
+    TileReader(const tdt::Archive &archive, const TileInfo::list &tiles
+               , const std::vector<double> &costs
+               , const tools::LodInfo &lodInfo, const Config &config
+               , const vtstools::MeshCache &cache)
+        : archive_(archive), tiles_(tiles), costs_(costs)
+        , lodInfo_(lodInfo), config_(config), cache_(cache)
+    {}
 
-tools::LodInfo analyze(vt::ExternalProgress &progress
-                       , const Config &config
-                       , const vts::NodeInfo::list &nodes
-                       , const tdt::Archive &archive)
-{
-    LOG(info3) << "Analyzing input dataset (" << archive.treeSize()
-               << " 3D Tiles).";
+    virtual std::size_t size() const { return tiles_.size(); }
 
-    const auto &root(*archive.tileset().root);
+    virtual std::string name(std::size_t index) const {
+        return "3D Tile <" + makePath(tiles_[index]) + ">";
+    }
 
-    auto lodInfo(tools::LodInfo::invalid());
+    virtual const char* traceName() const { return "cut3DTile"; }
 
-    traverse(root, [&](const tdt::Tile &tile, const tdt::TilePath &path)
-             -> void
-    {
-        LOG(info2) << "Analyzing tile <" << path << ">";
+    virtual const geo::SrsDefinition& srs(std::size_t) const {
+        return config_.inputSrs;
+    }
 
-        if (*tile.refine != tdt::Refinement::replace) {
-            LOGTHROW(err2, std::runtime_error)
-                << "Only <" << tdt::Refinement::replace
-                << "> refinement is supported.";
+    virtual vtstools::CutTarget::list targets(std::size_t index) const {
+        return vtstools::lodInfoTargets(lodInfo_, tiles_[index].depth);
+    }
+
+    virtual double cost(std::size_t index) const { return costs_[index]; }
+
+    virtual void load(std::size_t index, vtstools::SourceMesh &source) const;
+
+private:
+    const tdt::Archive &archive_;
+    const TileInfo::list &tiles_;
+    const std::vector<double> &costs_;
+    const tools::LodInfo &lodInfo_;
+    const Config &config_;
+    const vtstools::MeshCache &cache_;
+};
+
+/** Mesh measurement in individual RF nodes.
+ */
+typedef std::vector<std::pair<const vts::NodeInfo*, tools::MeshInfo>>
+    Measurement;
+
+Measurement measure(const Config &config, const vts::NodeInfo::list &nodes
+                    , VtsMeshLoader<SizeOnlyAtlas> &loader)
+{
+    auto m(loader.get());
+    const auto &mesh(m.first);
+    const auto &atlas(m.second);
+
+    // compute mesh area in each RF node
+    Measurement measurement;
+    for (const auto &rfNode : nodes) {
+        const vts::CsConvertor conv(config.inputSrs, rfNode.srs());
+        if (const auto mi = tools::measureMesh
+            (rfNode, conv, mesh, atlas.get()))
+        {
+            measurement.emplace_back(&rfNode, mi);
         }
+    }
+    return measurement;
+}
+
+void add(tools::MeshInfo::map &mim, const Measurement &measurement)
+{
+    for (const auto &item : measurement) { mim[item.first] += item.second; }
+}
+
+vtstools::TreeAnalysis
+analyze(vt::ExternalProgress &progress
+        , const Config &config
+        , const vts::NodeInfo::list &nodes
+        , const tdt::Archive &archive
+        , const TileInfo::list &allTiles
+        , const std::vector<double> &allCosts)
+{
+    LOG(info3) << "Analyzing input dataset (" << allTiles.size()
+               << " 3D Tiles).";
+
+    vtstools::TreeAnalysis analysis;
 
-        if (!tile.content) { return; }
+    for (const auto &ti : allTiles) {
+        LOG(info2) << "Analyzing tile <" << ti.path << ">";
 
-        if (!ba::iends_with(tile.content->uri, ".b3dm")) {
+        if (!ba::iends_with(ti.uri, ".b3dm")
+            && !ba::iends_with(ti.uri, ".glb"))
+        {
             LOGTHROW(err2, std::runtime_error)
                 << "Unsupported file content type: <"
-                << tile.content->uri << "> in tile <" << path << ">.";
+                << ti.uri << "> in tile <" << ti.path << ">.";
         }
 
-        const auto depth(path.depth());
+        const auto depth(ti.depth);
 
-        if (tile.children.empty()) {
+        if (ti.leaf) {
             // leaf
-            lodInfo.commonBottom
-                = std::min(lodInfo.commonBottom, depth);
-            lodInfo.bottomDepth
-                = std::max(lodInfo.bottomDepth, depth);
+            analysis.commonBottom
+                = std::min(analysis.commonBottom, depth);
+            analysis.bottomDepth
+                = std::max(analysis.bottomDepth, depth);
         }
 
         // update top
-        lodInfo.topDepth = std::min(lodInfo.topDepth, depth);
-    });
+        analysis.topDepth = std::min(analysis.topDepth, depth);
+    }
 
     LOG(info2) << "Found top/common-bottom/bottom: "
-               << lodInfo.topDepth << "/" << lodInfo.commonBottom
-               << "/" << lodInfo.bottomDepth << ".";
+               << analysis.topDepth << "/" << analysis.commonBottom
+               << "/" << analysis.bottomDepth << ".";
 
-    // collect info for OpenMP
+    // collect tiles at common bottom depth
     TileInfo::list tiles;
-    traverse(root, [&](const tdt::Tile &tile, const tdt::TilePath &path)
-             -> void
-    {
-        if ((path.depth() == lodInfo.commonBottom) && tile.content) {
-            tiles.emplace_back(&tile, path);
+    std::vector<double> costs;
+    for (std::size_t i(0), e(allTiles.size()); i != e; ++i) {
+        const auto &ti(allTiles[i]);
+        if (ti.depth == analysis.commonBottom) {
+            tiles.push_back(ti);
+            costs.push_back(allCosts[i]);
         }
-    });
+    }
     progress.expect(tiles.size());
+    const auto order(vtstools::costOrder(costs));
 
     tools::MeshInfo::map mim;
 
-    UTILITY_OMP(parallel for shared(tiles, mim) schedule(dynamic))
-    for (std::size_t i = 0; i < tiles.size(); ++i) {
+    // fully decoded sample verifying fast estimate, taken per RF subtree
+    tools::MeshInfo::map sampleEstimate;
+    tools::MeshInfo::map sampleFull;
+    std::map<const vts::NodeInfo*, std::size_t> sampleCount;
+
+    std::atomic<std::size_t> estimated(0);
+    std::mutex mimMutex;
+
+    vtstools::parallelFor(order.size(), [&](std::size_t o)
+    {
+        const auto i(order[o]);
         const auto &ti(tiles[i]);
-        const auto &tile(*ti.tile);
-        const auto path(ti.makePath());
+        const auto path(makePath(ti));
+        vtstools::ScopedPhase phase(vtstools::Phase::analyze);
 
-        VtsMeshLoader<SizeOnlyAtlas> loader(path);
         gltf::MeshLoader::DecodeOptions options;
         options.flipTc = true;
-        options.trafo = *tile.transform;
-        archive.loadMesh(loader, tile.content->uri, options);
-
-        auto m(loader.get());
-        const auto &mesh(m.first);
-        const auto &atlas(m.second);
-
-        // compute mesh area in each RF node
-        for (const auto &rfNode : nodes) {
-            const vts::CsConvertor conv(config.inputSrs, rfNode.srs());
-            if (const auto mi = tools::measureMesh
-                (rfNode, conv, mesh, atlas.get()))
-            {
-                UTILITY_OMP(critical(slpk2vts_meshInfo_1))
-                    mim[&rfNode] += mi;
+        options.trafo = ti.transform;
+
+        boost::optional<Measurement> estimate;
+        if (config.fastAnalysis) {
+            try {
+                VtsMeshLoader<SizeOnlyAtlas> loader(path);
+                loader.estimate(archive, ti.uri, options);
+                estimate = measure(config, nodes, loader);
+                ++estimated;
+            } catch (const std::exception &e) {
+                LOG(info2) << "Cannot estimate tile <" << path << "> ("
+                           << e.what() << "); decoding.";
+            }
+        }
+
+        // decode estimated tile as well if any of its subtrees still lacks
+        // its sample
+        bool sampled(false);
+        if (estimate && config.analysisSample) {
+            std::lock_guard<std::mutex> lock(mimMutex);
+            for (const auto &item : *estimate) {
+                if (sampleCount[item.first] < config.analysisSample) {
+                    sampled = true;
+                }
             }
+            if (sampled) {
+                for (const auto &item : *estimate) {
+                    ++sampleCount[item.first];
+                }
+            }
+        }
+
+        boost::optional<Measurement> full;
+        if (!estimate || sampled) {
+            VtsMeshLoader<SizeOnlyAtlas> loader(path);
+            loader.load(archive, ti.uri, options);
+            full = measure(config, nodes, loader);
         }
+
+        std::lock_guard<std::mutex> lock(mimMutex);
+        add(mim, estimate ? *estimate : *full);
+        if (sampled) {
+            add(sampleEstimate, *estimate);
+            add(sampleFull, *full);
+        }
+    });
+
+    if (config.fastAnalysis) {
+        LOG(info3) << "Estimated " << estimated << " of " << tiles.size()
+                   << " tiles from headers.";
     }
 
     // shift between common depth and bottom depth
-    const auto lodShift(lodInfo.bottomDepth - lodInfo.commonBottom);
+    const auto lodShift(analysis.bottomDepth - analysis.commonBottom);
+
+    const auto bestLod([&](const tools::MeshInfo::map &map
+                           , const vts::NodeInfo *node)
+                       -> boost::optional<double>
+    {
+        const auto fmap(map.find(node));
+        if (fmap == map.end()) { return boost::none; }
+        return tools::bestLod(*node, fmap->second.area
+                              , config.optimalTextureSize);
+    });
 
     for (const auto &item : mim) {
-        const auto bl
-            (lodShift + tools::bestLod(*item.first, item.second.area
-                                       , config.optimalTextureSize));
-        const auto &lod(lodInfo.localLods[item.first]
-                        = tools::LodParams(item.second.extents
-                                           , std::round(bl)));
+        auto bl(*bestLod(mim, item.first));
+
+        // estimate is ambiguous if it rounds to a different LOD than fully
+        // decoded sample does (or misses the subtree altogether)
+        if (const auto full = bestLod(sampleFull, item.first)) {
+            const auto estimate(bestLod(sampleEstimate, item.first));
+            if (!estimate || (std::round(*full) != std::round(*estimate))) {
+                LOG(info3)
+                    << "Estimated LOD (" << estimate.value_or(bl)
+                    << ") differs from "
+                    "sampled LOD (" << *full << ") in subtree "
+                    << item.first->srs() << "; using sampled LOD.";
+                bl = *full;
+            }
+        }
+
+        const vts::Lod lod(std::round(lodShift + bl));
+        analysis.assign(*item.first, item.second.extents, lod);
         LOG(info3)
             << "Assigned LOD " << (item.first->nodeId().lod + lod)
             << " (local LOD " << lod
-            << ") for bottom depth (" << lodInfo.bottomDepth
+            << ") for bottom depth (" << analysis.bottomDepth
             << ") in subtree " << item.first->srs() << ".";
     }
 
-    return lodInfo;
+    return analysis;
 }
 
 void Cutter::run(vt::ExternalProgress &progress)
 {
-    // analyze first
-    const auto lodInfo(analyze(progress, config_, nodes_, archive_));
+    // flatten tileset tree, loading external tilesets on the way
+    const auto tiles(vtstools::collectTiles(archive_));
+    const auto costs(tileCosts(archive_, tiles));
+
+    // analyze first; sharded conversion analyzes only in the coordinator
+    const auto analysis(vtstools::shardedAnalysis
+                        (config_.sharding, nodes_, [&]()
+                         {
+                             return analyze(progress, config_, nodes_
+                                            , archive_, tiles, costs);
+                         }));
+    if (!analysis) { return; }
+    const auto lodInfo(analysis->lodInfo());
 
     // compute navtile information (adds accumulators)
     for (const auto &item : lodInfo.localLods) {
@@ -552,234 +940,55 @@ void Cutter::run(vt::ExternalProgress &progress)
                                   , config_.ntLodPixelSize);
     }
 
-    const auto &root(*archive_.tileset().root);
-
-    // collect info for OpenMP (again, now all with beef)
-    TileInfo::list tiles;
-    traverse(root, [&](const tdt::Tile &tile, const tdt::TilePath &path)
-             -> void
-    {
-        if (tile.content) {
-            tiles.emplace_back(&tile, path);
-        }
-    });
-    progress.expect(tiles.size());
-
-    UTILITY_OMP(parallel for shared(tiles) schedule(dynamic))
-    for (std::size_t i = 0; i < tiles.size(); ++i) {
-        // TODO: add progress to log lines
-        cut3DTile(tiles[i], lodInfo);
-        ++progress;
-    }
-}
-
-
-void Cutter::cut3DTile(const TileInfo &ti, const tools::LodInfo &lodInfo)
-{
-    const auto &tile(*ti.tile);
-    const auto tilePath(ti.makePath());
-    const auto depth(ti.path.depth());
-
-    // load mesh and all textures
-    VtsMeshLoader<vts::opencv::Atlas> loader(tilePath);
-    gltf::MeshLoader::DecodeOptions options;
-    options.flipTc = true;
-    options.trafo = *tile.transform;
-    archive_.loadMesh(loader, tile.content->uri, options);
-    loader.optimize();
-
-    auto m(loader.get());
-    const auto &inMesh(m.first);
-    const auto &inAtlas(m.second);
-
-    // for each valid rfnode
-    for (const auto &item : lodInfo.localLods) {
-        const auto rfNode(*item.first);
-        const auto bottomLod(item.second);
-        const vts::CsConvertor conv(config_.inputSrs, rfNode.srs());
-
-        // compute local lod + sanity check
-        const auto fromBottom(lodInfo.bottomDepth - depth);
-        if (fromBottom > bottomLod) {
-            // out of reference frame -> skip
-            continue;
-        }
-
-        const vts::Lod localLod(bottomLod - fromBottom);
-        const auto lod(localLod + rfNode.nodeId().lod);
-
-        /** (extra) Tile flags to be stored along generate tiles from this 3D
-         *  Tile
-         */
-        vts::TileIndex::Flag::value_type tileFlags(0);
-        if (depth <= lodInfo.commonBottom) {
-            // mark all tiles not below common bottom level as watertight
-            tileFlags |= vts::TileIndex::Flag::watertight;
-
-            if (depth == lodInfo.commonBottom) {
-                // mark all tiles at commom bottom level as alien
-                tileFlags |= vts::TileIndex::Flag::alien;
-            }
-        }
-
-        // projected mesh/atlas
-        vts::Mesh mesh;
-        vts::opencv::Atlas atlas;
-
-        // and for each submesh
-        std::size_t meshIndex(0);
-        for (auto &sm : inMesh) {
-            const auto &texture(inAtlas.get(meshIndex++));
-
-            // make all faces valid by default
-            vts::VertexMask valid(sm.vertices.size(), true);
-            math::Points3 projected;
-            projected.reserve(sm.vertices.size());
-
-            auto ivalid(valid.begin());
-            for (const auto &v : sm.vertices) {
-                try {
-                    projected.push_back(conv(v));
-                    // apply zShift
-                    if (config_.zShift) {
-                        projected.back()(2) += config_.zShift;
-                    }
-                    ++ivalid;
-                } catch (const std::exception&) {
-                    // failed to convert vertex, mask it and skip
-                    projected.emplace_back();
-                    *ivalid++ = false;
-                }
-            }
-
-            // clip mesh to node's extents
-            // FIXME: implement actual mask application in clipping!
-            vts::FaceOriginList faceOrigin;
-            auto osm(vts::clip(sm, projected, rfNode.extents(), valid
-                               , &faceOrigin));
-            if (osm.faces.empty()) { continue; }
+    // optimized meshes from previous runs
+    const vtstools::MeshCache cache(config_.meshCache);
 
-            // at least one face survived, remember
-
-            mesh.submeshes.push_back(std::move(osm));
-            atlas.add(texture);
-        }
-
-        // anything there?
-        if (mesh.empty()) { continue; }
-
-        // compute local tile range
-        auto tr(tools::computeTileRange(rfNode.extents(), localLod
-                                        , tools::computeExtents(mesh)));
-
-        // convert local tilerange to global tilerange
-        {
-            const auto origin
-                (vts::lowestChild(vts::point(rfNode.nodeId()), localLod));
-            tr.ll += origin;
-            tr.ur += origin;
-        }
-
-        // split to tiles
-        LOG(info3) << "Splitting 3D Tile <" << tilePath
-                   << "> to tiles in " << lod << "/" << tr << ".";
-        splitToTiles(tilePath, rfNode, lod, tr, mesh, atlas, tileFlags);
-    }
+    vtstools::CutEngine(config_, tmpset_)
+        .run(TileReader(archive_, tiles, costs, lodInfo, config_, cache)
+             , progress);
 }
 
-void Cutter::splitToTiles(const std::string &tilePath
-                          , const vts::NodeInfo &root
-                          , vts::Lod lod, const vts::TileRange &tr
-                          , const vts::Mesh &mesh
-                          , const vts::opencv::Atlas &atlas
-                          , vts::TileIndex::Flag::value_type tileFlags)
+/** Mesh cache key of tile: its content file (stat only) and
+ *  transformation.
+ */
+std::string cacheKey(const fs::path &input, const TileInfo &ti)
 {
-    if (config_.tileExtents) {
-        // check for range validity
-        const auto &rootId(root.nodeId());
-        if (lod < config_.tileExtents->lod) {
-            LOG(info2)
-                << "Nothing to cut from 3D Tile <" << tilePath << ">.";
-        }
-
-        const auto gtr(vts::global(rootId, lod, tr));
-        const auto extents(vts::shiftRange(*config_.tileExtents, lod));
-
-        if (!vts::tileRangesOverlap(gtr, extents)) {
-            LOG(info2)
-                << "Nothing to cut from 3D Tile <" << tilePath << ">"
-                << ", gtr: " << gtr << ", extents: " << extents << ".";
-            return;
-        }
-    }
-
-    typedef vts::TileRange::value_type Index;
-    Index je(tr.ur(1));
-    Index ie(tr.ur(0));
-
-    for (Index j = tr.ll(1); j <= je; ++j) {
-        for (Index i = tr.ll(0); i <= ie; ++i) {
-            vts::TileId tileId(lod, i, j);
-            const auto node(root.child(tileId));
-            cutTile(tilePath, node, mesh, atlas, tileFlags);
-        }
+    std::ostringstream os;
+    os.precision(17);
+    for (int i(0); i < 4; ++i) {
+        for (int j(0); j < 4; ++j) { os << ti.transform(i, j) << ' '; }
     }
+    return vtstools::MeshCache::fileKey
+        (vtstools::MeshCache::contentFile(input, ti.uri), ti.uri, os.str());
 }
 
-void Cutter::cutTile(const std::string &tilePath, const vts::NodeInfo &node
-                     , const vts::Mesh &mesh
-                     , const vts::opencv::Atlas &atlas
-                     , vts::TileIndex::Flag::value_type tileFlags)
+void TileReader::load(std::size_t index, vtstools::SourceMesh &source) const
 {
-    // compute border condition (defaults to all available)
-    vts::BorderCondition borderCondition;
-    if (config_.tileExtents) {
-        borderCondition = vts::inside(*config_.tileExtents, node.nodeId());
-        if (!borderCondition) {
-            LOG(info1)
-                << node.nodeId() << ": Nothing to cut from 3D Tile <"
-                << tilePath << ">.";
-            return;
-        }
-    }
-
-    // compute clip extents
-    const auto extents(vts::inflateTileExtents
-                       (node.extents(), config_.clipMargin
-                        , borderCondition, config_.borderClipMargin));
-
-    vts::Mesh clipped;
-    vts::opencv::Atlas clippedAtlas(0); // PNG!
-
-    std::size_t smIndex(0);
-    std::size_t faces(0);
-    for (const auto &sm : mesh) {
-        const auto &texture(atlas.get(smIndex++));
+    const auto &ti(tiles_[index]);
 
-        auto m(vts::clip(sm, extents));
-        if (m.empty()) { continue; }
-
-        clipped.submeshes.push_back(std::move(m));
-        clippedAtlas.add(texture);
-        faces += clipped.submeshes.back().faces.size();
+    // try optimized mesh from previous runs first
+    std::string key;
+    if (cache_.enabled()) {
+        key = cacheKey(config_.input, ti);
+        if (!key.empty() && cache_.load(key, source)) { return; }
     }
 
-    if (clipped.empty()) {
-        LOG(info1)
-            << node.nodeId() << ": Nothing cut from 3D Tile <"
-            << tilePath << ">.";
-        return;
+    // load mesh, textures are decoded by the engine when needed
+    VtsMeshLoader<LazyAtlas> loader(makePath(ti));
+    gltf::MeshLoader::DecodeOptions options;
+    options.flipTc = true;
+    options.trafo = ti.transform;
+    {
+        vtstools::TraceSpan span("loadMesh", ti.uri);
+        loader.load(archive_, ti.uri, options);
     }
+    loader.optimize();
 
-    LOG(info2)
-        << node.nodeId() << ": Cut " << faces
-        << " faces from 3D Tile <" << tilePath << ">.";
-
-    // store in temporary storage
-    const auto tileId(node.nodeId());
+    auto m(loader.get());
+    source.mesh = std::move(m.first);
+    source.textures = std::move(m.second.textures);
 
-    tools::repack(tileId, clipped, clippedAtlas);
-    tmpset_.store(tileId, clipped, clippedAtlas, tileFlags);
+    if (!key.empty()) { cache_.store(key, source); }
 }
 
 // ------------------------------------------------------------------------
@@ -810,6 +1019,12 @@ public:
             .run(progress());
     }
 
+    /** Keeps cut tiles for the shard coordinator.
+     */
+    void finishShard(const boost::filesystem::path &path) {
+        vtstools::finishShard(path, tmpset(), ntg());
+    }
+
 private:
     const ::Config config_;
 };
@@ -820,15 +1035,42 @@ int Tdt2Vts::run()
     properties.referenceFrame = config_.referenceFrame;
     properties.id = config_.tilesetId;
 
-    // open 3D Tiles archive, let it recusively load tileset
+    // open 3D Tiles archive; external tilesets are loaded lazily by the
+    // cutter
     boost::optional<tdt::Archive> input;
     if (!config_.resume) {
-        input = boost::in_place(input_, "", true);
+        input = boost::in_place(input_, "", false);
+    }
+
+    if (config_.sharding.coordinator() && !config_.resume) {
+        // analyze input once (creates output), cut in worker processes, then
+        // generate from merged tiles
+        config_.sharding.analysis = vtstools::shardAnalysis(output_);
+        {
+            Encoder analyzer(output_, properties, createMode_, config_
+                             , vt::ExternalProgress::Config(epConfig_)
+                             , input);
+        }
+        vtstools::ShardCoordinator(output_, config_.tileExtents
+                                   , config_.sharding, config_.keepTmpset)
+            .run();
+        config_.resume = true;
+        createMode_ = vts::CreateMode::overwrite;
     }
 
     // run the encoder
-    Encoder(output_, properties, createMode_, config_
-            , std::move(epConfig_), input).run();
+    Encoder encoder(output_, properties, createMode_, config_
+                    , std::move(epConfig_), input);
+
+    if (config_.sharding.worker) {
+        encoder.finishShard(output_);
+    } else {
+        vtstools::ScopedPhase phase(vtstools::Phase::generate);
+        encoder.run();
+    }
+
+    vtstools::writeMetrics(config_.sharding.worker);
+    vtstools::writeTrace(config_.sharding.worker);
 
     // all done
     LOG(info4) << "All done.";
@@ -840,5 +1082,6 @@ int Tdt2Vts::run()
 int main(int argc, char *argv[])
 {
     utility::unlimitedCoredump();
+    vtstools::saveCommandLine(argc, argv);
     return Tdt2Vts()(argc, argv);
 }
@@ -0,0 +1,1064 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** Phase-level benchmark of the *2vts converters.
+ *
+ *  Generates synthetic dataset (quadtree of textured terrain meshes) in the
+ *  real input format of selected converter (VEF, SLPK, 3D Tiles or LODTree
+ *  archive), runs the converter binary on it and reports time spent in each
+ *  phase (as collected by the converter's --metrics) as JSON.
+ */
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <system_error>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "utility/buildsys.hpp"
+#include "utility/gccversion.hpp"
+#include "utility/limits.hpp"
+
+#include "service/cmdline.hpp"
+
+#include "geo/csconvertor.hpp"
+
+#include "jsoncpp/json.hpp"
+
+#include "vts-libs/registry/po.hpp"
+#include "vts-libs/vts.hpp"
+#include "vts-libs/vts/mesh.hpp"
+#include "vts-libs/vts/nodeinfo.hpp"
+
+#include "threadpool.hpp"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+namespace vr = vtslibs::registry;
+namespace vts = vtslibs::vts;
+namespace ublas = boost::numeric::ublas;
+
+namespace {
+
+/** Synthetic dataset shape.
+ */
+struct DatasetConfig {
+    /** Input format: vef, slpk, 3dtiles or lodtree.
+     */
+    std::string profile;
+
+    /** Quadtree depth; depth 0 is a single unit. VEF (and SLPK generated
+     *  from VEF) has 4^depth windows with depth + 1 LODs each.
+     */
+    int depth;
+
+    /** Number of vertices along unit side.
+     */
+    int grid;
+
+    /** Number of submeshes (textures) per unit.
+     */
+    int submeshes;
+
+    /** Texture size (pixels along side).
+     */
+    int textureSize;
+
+    /** Dataset size (in SRS units along side).
+     */
+    double size;
+
+    DatasetConfig()
+        : depth(-1), grid(-1), submeshes(-1), textureSize(-1), size(2000.0)
+    {}
+
+    /** Fills unset values from profile preset.
+     */
+    void applyProfile();
+};
+
+void DatasetConfig::applyProfile()
+{
+    struct Preset { const char *name; int depth, grid, submeshes, texture; };
+
+    // VEF: few big windows with big textures; SLPK: deep tree of small
+    // multi-texture nodes; 3D Tiles and LODTree: medium tiles
+    static const Preset presets[] = {
+        { "vef", 2, 256, 1, 2048 }
+        , { "slpk", 4, 32, 2, 512 }
+        , { "3dtiles", 3, 64, 1, 1024 }
+        , { "lodtree", 3, 64, 1, 1024 }
+    };
+
+    for (const auto &preset : presets) {
+        if (profile != preset.name) { continue; }
+        if (depth < 0) { depth = preset.depth; }
+        if (grid < 0) { grid = preset.grid; }
+        if (submeshes < 0) { submeshes = preset.submeshes; }
+        if (textureSize < 0) { textureSize = preset.texture; }
+        return;
+    }
+
+    LOGTHROW(err2, std::runtime_error)
+        << "Unknown dataset profile <" << profile << ">.";
+}
+
+/** Dataset placement: SRS of the first reference frame subtree and its
+ *  center.
+ */
+struct Placement {
+    geo::SrsDefinition srs;
+    geo::SrsDefinition physicalSrs;
+    math::Point2 center;
+};
+
+Placement placement(const std::string &referenceFrame)
+{
+    const auto &rf(vr::system.referenceFrames(referenceFrame));
+    const auto nodes(vts::NodeInfo::leaves(rf));
+    if (nodes.empty()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "No subtree in reference frame <" << referenceFrame << ">.";
+    }
+
+    const auto &node(nodes.front());
+    const auto &ne(node.extents());
+
+    Placement p;
+    p.srs = vr::system.srs(node.srs()).srsDef;
+    p.physicalSrs = vr::system.srs(rf.model.physicalSrs).srsDef;
+    p.center = math::Point2((ne.ll(0) + ne.ur(0)) / 2.0
+                            , (ne.ll(1) + ne.ur(1)) / 2.0);
+    return p;
+}
+
+/** One synthetic input unit (quadtree node).
+ */
+struct Unit {
+    int depth;
+    int x;
+    int y;
+    math::Extents2 extents;
+    std::string name;
+
+    typedef std::vector<Unit> list;
+};
+
+/** Units ordered by depth, row-major inside one depth.
+ */
+Unit::list makeUnits(const DatasetConfig &dc, const math::Point2 &center)
+{
+    Unit::list units;
+    const math::Point2 origin(center(0) - dc.size / 2.0
+                              , center(1) - dc.size / 2.0);
+
+    for (int depth(0); depth <= dc.depth; ++depth) {
+        const int count(1 << depth);
+        const double step(dc.size / count);
+        for (int y(0); y < count; ++y) {
+            for (int x(0); x < count; ++x) {
+                Unit unit;
+                unit.depth = depth;
+                unit.x = x;
+                unit.y = y;
+                unit.extents = math::Extents2
+                    (origin(0) + x * step, origin(1) + y * step
+                     , origin(0) + (x + 1) * step
+                     , origin(1) + (y + 1) * step);
+                unit.name = (boost::lexical_cast<std::string>(depth)
+                             + "-" + boost::lexical_cast<std::string>(x)
+                             + "-" + boost::lexical_cast<std::string>(y));
+                units.push_back(unit);
+            }
+        }
+    }
+
+    return units;
+}
+
+/** Index of unit in list produced by makeUnits.
+ */
+std::size_t unitIndex(int depth, int x, int y)
+{
+    return (((std::size_t(1) << (2 * depth)) - 1) / 3
+            + (std::size_t(y) << depth) + x);
+}
+
+/** Terrain mesh covering given extents, grid x grid vertices. Columns are
+ *  split into strips, one submesh (with its own texture) per strip. Terrain
+ *  is continuous across units and depths.
+ */
+vts::Mesh makeMesh(const math::Extents2 &e, int grid, int submeshes)
+{
+    grid = std::max(2, grid);
+    const int cells(grid - 1);
+    submeshes = std::max(1, std::min(submeshes, cells));
+
+    const double dx((e.ur(0) - e.ll(0)) / cells);
+    const double dy((e.ur(1) - e.ll(1)) / cells);
+
+    vts::Mesh mesh;
+    for (int s(0); s < submeshes; ++s) {
+        const int c0((s * cells) / submeshes);
+        const int c1(((s + 1) * cells) / submeshes);
+        const int width(c1 - c0 + 1);
+
+        mesh.submeshes.emplace_back();
+        auto &sm(mesh.submeshes.back());
+
+        for (int j(0); j < grid; ++j) {
+            for (int i(c0); i <= c1; ++i) {
+                const double x(e.ll(0) + i * dx);
+                const double y(e.ll(1) + j * dy);
+                sm.vertices.emplace_back
+                    (x, y, 20.0 * std::sin(x / 150.0) * std::cos(y / 110.0));
+                sm.tc.emplace_back(double(i - c0) / (c1 - c0)
+                                   , double(j) / cells);
+            }
+        }
+
+        const auto v([&](int i, int j) { return j * width + (i - c0); });
+        for (int j(0); j < cells; ++j) {
+            for (int i(c0); i < c1; ++i) {
+                sm.faces.emplace_back(v(i, j), v(i + 1, j), v(i + 1, j + 1));
+                sm.faces.emplace_back(v(i, j), v(i + 1, j + 1), v(i, j + 1));
+            }
+        }
+        sm.facesTc = sm.faces;
+    }
+
+    return mesh;
+}
+
+/** Texture: gradient with noise to keep image codecs busy.
+ */
+cv::Mat makeTexture(int size, const Unit &unit, int submesh)
+{
+    cv::Mat tex(size, size, CV_8UC3);
+    cv::randu(tex, cv::Scalar(0, 0, 0), cv::Scalar(64, 64, 64));
+    tex += cv::Scalar(64 + 32 * (unit.depth % 4), 96 + 16 * submesh
+                      , 128 + (unit.x + unit.y) % 64);
+    return tex;
+}
+
+std::string textureName(std::size_t index)
+{
+    return boost::lexical_cast<std::string>(index) + ".jpg";
+}
+
+void writeTexture(const fs::path &path, const cv::Mat &tex)
+{
+    if (!cv::imwrite(path.string(), tex)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to write " << path << ".";
+    }
+}
+
+/** Writes mesh as OBJ; material of each submesh is its index.
+ */
+void writeObj(const fs::path &path, const vts::Mesh &mesh
+              , const std::string &mtllib = std::string())
+{
+    std::ofstream f(path.string());
+    f.precision(15);
+
+    if (!mtllib.empty()) { f << "mtllib " << mtllib << '\n'; }
+
+    for (const auto &sm : mesh) {
+        for (const auto &v : sm.vertices) {
+            f << "v " << v(0) << ' ' << v(1) << ' ' << v(2) << '\n';
+        }
+    }
+    for (const auto &sm : mesh) {
+        for (const auto &t : sm.tc) {
+            f << "vt " << t(0) << ' ' << t(1) << '\n';
+        }
+    }
+
+    // vertices and texture coordinates are paired in generated meshes
+    std::size_t base(1);
+    for (std::size_t s(0), e(mesh.submeshes.size()); s != e; ++s) {
+        const auto &sm(mesh.submeshes[s]);
+        f << "usemtl " << s << '\n';
+        for (const auto &face : sm.faces) {
+            f << "f";
+            for (int i(0); i < 3; ++i) {
+                f << ' ' << (base + face(i)) << '/' << (base + face(i));
+            }
+            f << '\n';
+        }
+        base += sm.vertices.size();
+    }
+
+    f.close();
+    if (!f) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to write " << path << ".";
+    }
+}
+
+void writeMtl(const fs::path &path, std::size_t count)
+{
+    std::ofstream f(path.string());
+    for (std::size_t s(0); s < count; ++s) {
+        f << "newmtl " << s << "\nmap_Kd " << textureName(s) << "\n\n";
+    }
+
+    f.close();
+    if (!f) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to write " << path << ".";
+    }
+}
+
+void writeJson(const fs::path &path, const Json::Value &value)
+{
+    std::ofstream f(path.string());
+    Json::StyledStreamWriter().write(f, value);
+
+    f.close();
+    if (!f) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to write " << path << ".";
+    }
+}
+
+// ------------------------------------------------------------------------
+// VEF (and SLPK generated from VEF by vef2slpk)
+
+/** Generated window: finest LOD is the unit itself, coarser LODs have
+ *  halved grid and texture size.
+ */
+Json::Value generateWindow(const DatasetConfig &dc, const Unit &unit
+                           , const fs::path &root)
+{
+    Json::Value window(Json::objectValue);
+    window["path"] = unit.name;
+    auto &lods(window["lods"] = Json::Value(Json::arrayValue));
+
+    for (int lod(0); lod <= dc.depth; ++lod) {
+        const auto lodName(boost::lexical_cast<std::string>(lod));
+        const auto dir(root / unit.name / lodName);
+        fs::create_directories(dir);
+
+        const auto mesh(makeMesh(unit.extents
+                                 , std::max(2, ((dc.grid - 1) >> lod) + 1)
+                                 , dc.submeshes));
+        writeObj(dir / "mesh.obj", mesh);
+
+        auto &l(lods.append(Json::Value(Json::objectValue)));
+        l["path"] = lodName;
+        l["mesh"]["path"] = "mesh.obj";
+        l["mesh"]["format"] = "obj";
+
+        const int ts(std::max(16, dc.textureSize >> lod));
+        auto &atlas(l["atlas"] = Json::Value(Json::arrayValue));
+        for (std::size_t s(0), e(mesh.submeshes.size()); s != e; ++s) {
+            writeTexture(dir / textureName(s), makeTexture(ts, unit, s));
+
+            auto &texture(atlas.append(Json::Value(Json::objectValue)));
+            texture["path"] = textureName(s);
+            texture["format"] = "jpg";
+            auto &size(texture["size"] = Json::Value(Json::arrayValue));
+            size.append(ts);
+            size.append(ts);
+        }
+    }
+
+    return window;
+}
+
+/** Writes VEF archive (directory with manifest.json): one window per unit
+ *  at the bottom of the quadtree.
+ */
+void generateVef(const DatasetConfig &dc, const Placement &placement
+                 , const Unit::list &units, const fs::path &root)
+{
+    std::vector<const Unit*> bottom;
+    for (const auto &unit : units) {
+        if (unit.depth == dc.depth) { bottom.push_back(&unit); }
+    }
+
+    std::vector<Json::Value> windows(bottom.size());
+    vtstools::parallelFor(bottom.size(), [&](std::size_t i)
+    {
+        windows[i] = generateWindow(dc, *bottom[i], root);
+    });
+
+    Json::Value manifest(Json::objectValue);
+    manifest["version"] = 1;
+    manifest["srs"] = boost::lexical_cast<std::string>(placement.srs);
+    auto &w(manifest["windows"] = Json::Value(Json::arrayValue));
+    for (auto &window : windows) { w.append(window); }
+
+    writeJson(root / "manifest.json", manifest);
+}
+
+// ------------------------------------------------------------------------
+// 3D Tiles
+
+void putU32(std::string &out, std::uint32_t value)
+{
+    for (int i(0); i < 4; ++i) { out.push_back(char(value >> (8 * i))); }
+}
+
+/** Writes binary glTF with embedded JPEG textures. Mesh is in tile's local
+ *  Z-up space, glTF is Y-up.
+ */
+void writeGlb(const fs::path &path, const vts::Mesh &mesh
+              , const std::vector<std::vector<unsigned char>> &images)
+{
+    Json::Value gltf(Json::objectValue);
+    gltf["asset"]["version"] = "2.0";
+    gltf["scene"] = 0;
+
+    Json::Value scene(Json::objectValue);
+    scene["nodes"].append(0);
+    gltf["scenes"].append(scene);
+
+    Json::Value node(Json::objectValue);
+    node["mesh"] = 0;
+    gltf["nodes"].append(node);
+
+    auto &views(gltf["bufferViews"] = Json::Value(Json::arrayValue));
+    auto &accessors(gltf["accessors"] = Json::Value(Json::arrayValue));
+    std::string bin;
+
+    const auto addView([&](const void *data, std::size_t size) -> Json::UInt
+    {
+        while (bin.size() % 4) { bin.push_back('\0'); }
+        auto &view(views.append(Json::Value(Json::objectValue)));
+        view["buffer"] = 0;
+        view["byteOffset"] = Json::UInt64(bin.size());
+        view["byteLength"] = Json::UInt64(size);
+        bin.append(static_cast<const char*>(data), size);
+        return views.size() - 1;
+    });
+
+    const auto addAccessor([&](const void *data, std::size_t size
+                               , int componentType, std::size_t count
+                               , const char *type) -> Json::Value&
+    {
+        auto &accessor(accessors.append(Json::Value(Json::objectValue)));
+        accessor["bufferView"] = addView(data, size);
+        accessor["componentType"] = componentType;
+        accessor["count"] = Json::UInt64(count);
+        accessor["type"] = type;
+        return accessor;
+    });
+
+    const int Float(5126), UnsignedInt(5125);
+
+    auto &primitives(gltf["meshes"].append(Json::Value(Json::objectValue))
+                     ["primitives"]);
+    for (std::size_t s(0), e(mesh.submeshes.size()); s != e; ++s) {
+        const auto &sm(mesh.submeshes[s]);
+
+        std::vector<float> position;
+        math::Extents3 extents(math::InvalidExtents{});
+        for (const auto &v : sm.vertices) {
+            const math::Point3 p(v(0), v(2), -v(1));
+            math::update(extents, p);
+            position.insert(position.end(), { float(p(0)), float(p(1))
+                                              , float(p(2)) });
+        }
+
+        // glTF texture origin is top-left
+        std::vector<float> uv;
+        for (const auto &t : sm.tc) {
+            uv.insert(uv.end(), { float(t(0)), float(1.0 - t(1)) });
+        }
+
+        std::vector<std::uint32_t> indices;
+        for (const auto &face : sm.faces) {
+            indices.insert(indices.end(), { face(0), face(1), face(2) });
+        }
+
+        auto &primitive(primitives.append(Json::Value(Json::objectValue)));
+        primitive["material"] = Json::UInt(s);
+
+        auto &pa(addAccessor(position.data()
+                             , position.size() * sizeof(float)
+                             , Float, sm.vertices.size(), "VEC3"));
+        for (int i(0); i < 3; ++i) {
+            pa["min"].append(extents.ll(i));
+            pa["max"].append(extents.ur(i));
+        }
+        primitive["attributes"]["POSITION"] = accessors.size() - 1;
+
+        addAccessor(uv.data(), uv.size() * sizeof(float)
+                    , Float, sm.tc.size(), "VEC2");
+        primitive["attributes"]["TEXCOORD_0"] = accessors.size() - 1;
+
+        addAccessor(indices.data(), indices.size() * sizeof(std::uint32_t)
+                    , UnsignedInt, indices.size(), "SCALAR");
+        primitive["indices"] = accessors.size() - 1;
+
+        auto &material(gltf["materials"].append
+                       (Json::Value(Json::objectValue)));
+        material["pbrMetallicRoughness"]["baseColorTexture"]["index"]
+            = Json::UInt(s);
+        gltf["textures"].append(Json::Value(Json::objectValue))["source"]
+            = Json::UInt(s);
+
+        auto &image(gltf["images"].append(Json::Value(Json::objectValue)));
+        image["bufferView"] = addView(images[s].data(), images[s].size());
+        image["mimeType"] = "image/jpeg";
+    }
+
+    while (bin.size() % 4) { bin.push_back('\0'); }
+    Json::Value buffer(Json::objectValue);
+    buffer["byteLength"] = Json::UInt64(bin.size());
+    gltf["buffers"].append(buffer);
+
+    auto json(Json::FastWriter().write(gltf));
+    while (json.size() % 4) { json.push_back(' '); }
+
+    std::string glb("glTF");
+    putU32(glb, 2);
+    putU32(glb, 12 + 8 + json.size() + 8 + bin.size());
+    putU32(glb, json.size());
+    putU32(glb, 0x4e4f534a); // JSON
+    glb.append(json);
+    putU32(glb, bin.size());
+    putU32(glb, 0x004e4942); // BIN
+    glb.append(bin);
+
+    std::ofstream f(path.string(), std::ios::binary);
+    f.write(glb.data(), glb.size());
+
+    f.close();
+    if (!f) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to write " << path << ".";
+    }
+}
+
+/** Generates unit's GLB (in physical SRS relative to unit center) and
+ *  returns its tile (without children).
+ */
+Json::Value generateTile(const DatasetConfig &dc, const Placement &placement
+                         , const Unit &unit, const fs::path &root)
+{
+    const geo::CsConvertor conv(placement.srs, placement.physicalSrs);
+
+    auto mesh(makeMesh(unit.extents, dc.grid, dc.submeshes));
+
+    const auto &e(unit.extents);
+    const auto origin(conv(math::Point3((e.ll(0) + e.ur(0)) / 2.0
+                                        , (e.ll(1) + e.ur(1)) / 2.0, 0.0)));
+    double radius(0.0);
+    for (auto &sm : mesh) {
+        for (auto &v : sm.vertices) {
+            v = conv(v) - origin;
+            radius = std::max(radius, ublas::norm_2(v));
+        }
+    }
+
+    std::vector<std::vector<unsigned char>> images;
+    for (std::size_t s(0), se(mesh.submeshes.size()); s != se; ++s) {
+        images.emplace_back();
+        cv::imencode(".jpg", makeTexture(dc.textureSize, unit, s)
+                     , images.back());
+    }
+
+    writeGlb(root / (unit.name + ".glb"), mesh, images);
+
+    Json::Value tile(Json::objectValue);
+    for (int i(0); i < 16; ++i) {
+        tile["transform"].append(((i % 5) == 0) ? 1.0 : 0.0);
+    }
+    for (int i(0); i < 3; ++i) { tile["transform"][12 + i] = origin(i); }
+    for (int i(0); i < 3; ++i) {
+        tile["boundingVolume"]["sphere"].append(0.0);
+    }
+    tile["boundingVolume"]["sphere"].append(radius);
+    tile["geometricError"]
+        = (e.ur(0) - e.ll(0)) / std::max(1, dc.grid - 1);
+    tile["content"]["uri"] = unit.name + ".glb";
+    return tile;
+}
+
+/** Writes 3D Tiles tileset: one tile per unit, children replace parents.
+ *  Transforms of child tiles are made relative to their parents.
+ */
+void generateTileset(const DatasetConfig &dc, const Placement &placement
+                     , const Unit::list &units, const fs::path &root)
+{
+    std::vector<Json::Value> tiles(units.size());
+    vtstools::parallelFor(units.size(), [&](std::size_t i)
+    {
+        tiles[i] = generateTile(dc, placement, units[i], root);
+    });
+
+    const std::function<Json::Value(std::size_t, const math::Point3&)>
+        build([&](std::size_t index, const math::Point3 &parent)
+              -> Json::Value
+    {
+        const auto &unit(units[index]);
+        auto tile(tiles[index]);
+
+        math::Point3 origin;
+        for (int i(0); i < 3; ++i) {
+            origin(i) = tile["transform"][12 + i].asDouble();
+            tile["transform"][12 + i] = origin(i) - parent(i);
+        }
+
+        if (unit.depth < dc.depth) {
+            tile["refine"] = "REPLACE";
+            auto &children(tile["children"] = Json::Value(Json::arrayValue));
+            for (int j(0); j < 4; ++j) {
+                children.append(build(unitIndex(unit.depth + 1
+                                                , 2 * unit.x + (j & 1)
+                                                , 2 * unit.y + (j >> 1))
+                                      , origin));
+            }
+        }
+        return tile;
+    });
+
+    Json::Value tileset(Json::objectValue);
+    tileset["asset"]["version"] = "1.0";
+    tileset["root"] = build(0, math::Point3(0.0, 0.0, 0.0));
+    tileset["geometricError"]
+        = 2.0 * tileset["root"]["geometricError"].asDouble();
+
+    writeJson(root / "tileset.json", tileset);
+}
+
+// ------------------------------------------------------------------------
+// LODTree
+
+/** Generates unit's OBJ model with MTL and textures.
+ */
+void generateModel(const DatasetConfig &dc, const Unit &unit
+                   , const fs::path &root)
+{
+    const auto dir(root / "Data" / unit.name);
+    fs::create_directories(dir);
+
+    const auto mesh(makeMesh(unit.extents, dc.grid, dc.submeshes));
+    writeObj(dir / "model.obj", mesh, "model.mtl");
+    writeMtl(dir / "model.mtl", mesh.submeshes.size());
+    for (std::size_t s(0), e(mesh.submeshes.size()); s != e; ++s) {
+        writeTexture(dir / textureName(s)
+                     , makeTexture(dc.textureSize, unit, s));
+    }
+}
+
+void writeNode(std::ostream &os, const DatasetConfig &dc
+               , const Unit::list &units, std::size_t index
+               , const std::string &indent)
+{
+    const auto &unit(units[index]);
+    const auto &e(unit.extents);
+    const double size(e.ur(0) - e.ll(0));
+
+    os << indent << "<Node>\n"
+       << indent << "\t<Center>" << (e.ll(0) + e.ur(0)) / 2.0 << ' '
+       << (e.ll(1) + e.ur(1)) / 2.0 << " 0</Center>\n"
+       << indent << "\t<Radius>" << size / std::sqrt(2.0) << "</Radius>\n"
+       << indent << "\t<MinRange>0</MinRange>\n"
+       << indent << "\t<MaxRange>" << size * 4.0 << "</MaxRange>\n"
+       << indent << "\t<ModelFile>" << unit.name << "/model.obj"
+       << "</ModelFile>\n";
+
+    if (unit.depth < dc.depth) {
+        for (int j(0); j < 4; ++j) {
+            writeNode(os, dc, units
+                      , unitIndex(unit.depth + 1, 2 * unit.x + (j & 1)
+                                  , 2 * unit.y + (j >> 1))
+                      , indent + "\t");
+        }
+    }
+
+    os << indent << "</Node>\n";
+}
+
+/** Writes LODTree export: metadata, root XML and one block holding the
+ *  whole quadtree.
+ */
+void generateLodTree(const DatasetConfig &dc, const Placement &placement
+                     , const Unit::list &units, const fs::path &root)
+{
+    vtstools::parallelFor(units.size(), [&](std::size_t i)
+    {
+        generateModel(dc, units[i], root);
+    });
+
+    const auto write([&](const fs::path &path
+                         , const std::function<void(std::ostream&)> &fn)
+    {
+        std::ofstream f(path.string());
+        f.precision(15);
+        f << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+        fn(f);
+        f.close();
+        if (!f) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Unable to write " << path << ".";
+        }
+    });
+
+    write(root / "metadata.xml", [&](std::ostream &os)
+    {
+        os << "<ModelMetadata version=\"1\">\n"
+           << "\t<SRS>" << placement.srs << "</SRS>\n"
+           << "\t<SRSOrigin>0,0,0</SRSOrigin>\n"
+           << "</ModelMetadata>\n";
+    });
+
+    write(root / "LODTreeExport.xml", [&](std::ostream &os)
+    {
+        os << "<LODTreeExport version=\"1.1\">\n"
+           << "\t<Tile>Data/Tile.xml</Tile>\n"
+           << "</LODTreeExport>\n";
+    });
+
+    write(root / "Data" / "Tile.xml", [&](std::ostream &os)
+    {
+        os << "<Tile version=\"1.0\">\n";
+        writeNode(os, dc, units, 0, "\t");
+        os << "</Tile>\n";
+    });
+}
+
+// ------------------------------------------------------------------------
+
+/** Null-terminated array of C strings for exec.
+ */
+class CStrings {
+public:
+    CStrings(const std::vector<std::string> &strings)
+        : strings_(strings)
+    {
+        for (auto &s : strings_) { ptrs_.push_back(&s[0]); }
+        ptrs_.push_back(nullptr);
+    }
+
+    char* const* get() const { return ptrs_.data(); }
+
+private:
+    std::vector<std::string> strings_;
+    std::vector<char*> ptrs_;
+};
+
+/** Runs tool and waits for it to finish. Throws when it fails.
+ */
+void runTool(const fs::path &tool, const std::vector<std::string> &args)
+{
+    std::vector<std::string> argv{ tool.string() };
+    argv.insert(argv.end(), args.begin(), args.end());
+    const CStrings cargv(argv);
+
+    LOG(info3) << "Running " << tool << ".";
+
+    const auto pid(::fork());
+    if (pid < 0) {
+        std::system_error e(errno, std::system_category());
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to run " << tool << ": <"
+            << e.code() << ", " << e.what() << ">.";
+    }
+
+    if (!pid) {
+        ::execv(argv.front().c_str(), cargv.get());
+        ::_exit(127);
+    }
+
+    int status(0);
+    while (::waitpid(pid, &status, 0) < 0) {
+        if (errno == EINTR) { continue; }
+        std::system_error e(errno, std::system_category());
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to wait for " << tool << ": <"
+            << e.code() << ", " << e.what() << ">.";
+    }
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+        LOGTHROW(err2, std::runtime_error)
+            << tool << " failed (wait status " << status << ").";
+    }
+}
+
+typedef std::chrono::steady_clock Clock;
+
+double since(const Clock::time_point &start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+class Benchmark : public service::Cmdline
+{
+public:
+    Benchmark()
+        : service::Cmdline("vts-tools-benchmark", BUILD_TARGET_VERSION)
+        , keep_(false), referenceFrame_("melown2015")
+    {}
+
+private:
+    virtual void configuration(po::options_description &cmdline
+                               , po::options_description &config
+                               , po::positional_options_description &pd)
+        UTILITY_OVERRIDE;
+
+    virtual void configure(const po::variables_map &vars)
+        UTILITY_OVERRIDE;
+
+    virtual bool help(std::ostream &out, const std::string &what) const
+        UTILITY_OVERRIDE;
+
+    virtual int run() UTILITY_OVERRIDE;
+
+    /** Generates input archive, returns converter name and its input.
+     */
+    std::pair<std::string, fs::path> generate(Json::Value &report) const;
+
+    fs::path workdir_;
+    fs::path output_;
+    fs::path tools_;
+    bool keep_;
+    std::string referenceFrame_;
+
+    DatasetConfig dataset_;
+};
+
+void Benchmark::configuration(po::options_description &cmdline
+                              , po::options_description &config
+                              , po::positional_options_description &pd)
+{
+    vr::registryConfiguration(cmdline, vr::defaultPath());
+
+    cmdline.add_options()
+        ("workdir", po::value(&workdir_)->required()
+         , "Working directory; synthetic dataset and output tileset are "
+         "created there.")
+        ("output", po::value(&output_)
+         , "Path to JSON report. Written to stdout if not set.")
+        ("keep", po::value(&keep_)->default_value(false)
+         ->implicit_value(true)
+         , "Keep working directory content.")
+        ("tools", po::value(&tools_)
+         , "Directory with converter binaries. Defaults to directory of "
+         "this binary.")
+
+        ("profile", po::value(&dataset_.profile)->default_value("slpk")
+         , "Input format: vef, slpk, 3dtiles or lodtree.")
+        ("depth", po::value(&dataset_.depth)
+         , "Dataset quadtree depth (overrides profile).")
+        ("grid", po::value(&dataset_.grid)
+         , "Number of vertices along each unit's side (overrides profile).")
+        ("submeshes", po::value(&dataset_.submeshes)
+         , "Number of submeshes per unit (overrides profile).")
+        ("textureSize", po::value(&dataset_.textureSize)
+         , "Texture size in pixels (overrides profile).")
+        ("size", po::value(&dataset_.size)
+         ->default_value(dataset_.size)
+         , "Dataset extent (in subtree SRS units).")
+
+        ("referenceFrame", po::value(&referenceFrame_)
+         ->default_value(referenceFrame_)
+         , "Destination reference frame.")
+        ;
+
+    vtstools::threadPoolConfiguration(cmdline);
+
+    pd.add("workdir", 1);
+
+    (void) config;
+}
+
+void Benchmark::configure(const po::variables_map &vars)
+{
+    dataset_.applyProfile();
+    vtstools::configureThreadPool(vars);
+
+    if (tools_.empty()) {
+        tools_ = fs::read_symlink("/proc/self/exe").parent_path();
+    }
+}
+
+bool Benchmark::help(std::ostream &out, const std::string &what) const
+{
+    if (what.empty()) {
+        out << R"RAW(vts-tools-benchmark
+usage
+    vts-tools-benchmark WORKDIR [OPTIONS]
+
+Generates synthetic dataset in given input format (VEF directory, SLPK
+produced by vef2slpk, 3D Tiles with GLB content or LODTree export with OBJ
+models), converts it to VTS by the corresponding converter and reports
+time spent in individual phases (parse, analyze, project, clip, split,
+store, generate) as collected by the converter's --metrics option. Phase
+wall and CPU times are summed over all threads, "elapsed" is real time
+between phase's first start and last end.
+
+)RAW";
+    }
+    return false;
+}
+
+std::pair<std::string, fs::path>
+Benchmark::generate(Json::Value &report) const
+{
+    const auto data(workdir_ / "data");
+    fs::create_directories(data);
+
+    const auto p(placement(referenceFrame_));
+    const auto units(makeUnits(dataset_, p.center));
+    report["dataset"]["units"] = Json::UInt64(units.size());
+
+    const auto &profile(dataset_.profile);
+    if (profile == "vef") {
+        generateVef(dataset_, p, units, data / "vef");
+        return { "vef2vts", data / "vef" };
+    }
+
+    if (profile == "slpk") {
+        generateVef(dataset_, p, units, data / "vef");
+        runTool(tools_ / "vef2slpk"
+                , { (data / "vef").string(), (data / "input.slpk").string()
+                    , "--overwrite" });
+        return { "slpk2vts", data / "input.slpk" };
+    }
+
+    if (profile == "3dtiles") {
+        fs::create_directories(data / "3dtiles");
+        generateTileset(dataset_, p, units, data / "3dtiles");
+        return { "3dtiles2vts", data / "3dtiles" / "tileset.json" };
+    }
+
+    generateLodTree(dataset_, p, units, data / "lodtree");
+    return { "lodtree2vts", data / "lodtree" };
+}
+
+int Benchmark::run()
+{
+    const auto output(workdir_ / "tileset");
+    const auto metricsPath(workdir_ / "metrics.json");
+    fs::remove_all(workdir_ / "data");
+
+    Json::Value report(Json::objectValue);
+    report["benchmark"] = "vts-tools-benchmark";
+    report["version"] = BUILD_TARGET_VERSION;
+    report["threads"] = vtstools::threadCount();
+
+    auto &dataset(report["dataset"]);
+    dataset["profile"] = dataset_.profile;
+    dataset["depth"] = dataset_.depth;
+    dataset["grid"] = dataset_.grid;
+    dataset["submeshes"] = dataset_.submeshes;
+    dataset["textureSize"] = dataset_.textureSize;
+    dataset["size"] = dataset_.size;
+
+    // generate input (not measured)
+    const auto input([&]()
+    {
+        const auto start(Clock::now());
+        const auto input(generate(report));
+        dataset["generateTime"] = since(start);
+        return input;
+    }());
+    report["tool"] = input.first;
+
+    // convert; vef2vts takes output first
+    std::vector<std::string> args;
+    if (input.first == "vef2vts") {
+        args = { output.string(), input.second.string() };
+    } else {
+        args = { input.second.string(), output.string() };
+    }
+    args.insert(args.end(), {
+            "--overwrite", "--tilesetId", "benchmark"
+            , "--referenceFrame", referenceFrame_
+            , "--threads"
+            , boost::lexical_cast<std::string>(vtstools::threadCount())
+            , "--metrics", metricsPath.string() });
+
+    {
+        const auto start(Clock::now());
+        runTool(tools_ / input.first, args);
+        report["wallTime"] = since(start);
+    }
+
+    Json::Value metrics;
+    {
+        std::ifstream f(metricsPath.string());
+        if (!f || !Json::Reader().parse(f, metrics)) {
+            LOG(fatal) << "Unable to read metrics from " << metricsPath
+                       << ".";
+            return EXIT_FAILURE;
+        }
+    }
+    report["peakRss"] = metrics["peakRss"];
+    report["phases"] = metrics["phases"];
+
+    if (output_.empty()) {
+        Json::StyledStreamWriter().write(std::cout, report);
+    } else {
+        std::ofstream f(output_.string());
+        Json::StyledStreamWriter().write(f, report);
+        f.close();
+        if (!f) {
+            LOG(fatal) << "Unable to write report to " << output_ << ".";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!keep_) {
+        fs::remove_all(workdir_ / "data");
+        fs::remove_all(output);
+        fs::remove(metricsPath);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    utility::unlimitedCoredump();
+    return Benchmark()(argc, argv);
+}
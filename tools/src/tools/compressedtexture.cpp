@@ -0,0 +1,531 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "compressedtexture.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace vtstools {
+
+namespace {
+
+/** Block payload formats.
+ */
+enum class Format {
+    unsupported
+    , bc1, bc2, bc3
+    , etc1, etc2, etc2Eac
+};
+
+/** Compressed payload of first mip level.
+ */
+struct Payload {
+    Format format;
+    int width;
+    int height;
+    const std::uint8_t *data;
+    std::size_t size;
+
+    Payload() : format(Format::unsupported), width(), height(), data(), size()
+    {}
+
+    int blocksX() const { return (width + 3) / 4; }
+    int blocksY() const { return (height + 3) / 4; }
+};
+
+/** Block size in bytes.
+ */
+std::size_t blockSize(Format format)
+{
+    switch (format) {
+    case Format::bc1: case Format::etc1: case Format::etc2: return 8;
+    case Format::bc2: case Format::bc3: case Format::etc2Eac: return 16;
+    default: return 0;
+    }
+}
+
+std::uint32_t le32(const char *p)
+{
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+std::uint64_t le64(const char *p)
+{
+    std::uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+Format dxgiFormat(std::uint32_t format)
+{
+    switch (format) {
+    case 70: case 71: case 72: return Format::bc1;
+    case 73: case 74: case 75: return Format::bc2;
+    case 76: case 77: case 78: return Format::bc3;
+    }
+    return Format::unsupported;
+}
+
+Format glFormat(std::uint32_t format)
+{
+    switch (format) {
+    case 0x83f0: case 0x83f1: return Format::bc1;
+    case 0x83f2: return Format::bc2;
+    case 0x83f3: return Format::bc3;
+    case 0x8d64: return Format::etc1;
+    case 0x9274: case 0x9275: return Format::etc2;
+    case 0x9278: case 0x9279: return Format::etc2Eac;
+    }
+    return Format::unsupported;
+}
+
+Format vkFormat(std::uint32_t format)
+{
+    switch (format) {
+    case 131: case 132: case 133: case 134: return Format::bc1;
+    case 135: case 136: return Format::bc2;
+    case 137: case 138: return Format::bc3;
+    case 147: case 148: return Format::etc2;
+    case 151: case 152: return Format::etc2Eac;
+    }
+    return Format::unsupported;
+}
+
+const char KtxIdentifier[12] = {
+    '\xab', 'K', 'T', 'X', ' ', '1', '1', '\xbb', '\r', '\n', '\x1a', '\n'
+};
+
+const char Ktx2Identifier[12] = {
+    '\xab', 'K', 'T', 'X', ' ', '2', '0', '\xbb', '\r', '\n', '\x1a', '\n'
+};
+
+/** Parses container header. Returns payload with unsupported format on any
+ *  unknown container or payload. Only first size bytes of fullSize long
+ *  data are available when sniffing; payload pointer is then meaningless.
+ */
+Payload parse(const char *data, std::size_t size, std::size_t fullSize)
+{
+    Payload p;
+    std::size_t offset(0);
+
+    if ((size >= 128) && !std::memcmp(data, "DDS ", 4)) {
+        p.height = le32(data + 12);
+        p.width = le32(data + 16);
+        const auto fourCC(data + 84);
+        offset = 128;
+        if (!std::memcmp(fourCC, "DXT1", 4)) {
+            p.format = Format::bc1;
+        } else if (!std::memcmp(fourCC, "DXT3", 4)) {
+            p.format = Format::bc2;
+        } else if (!std::memcmp(fourCC, "DXT5", 4)) {
+            p.format = Format::bc3;
+        } else if (!std::memcmp(fourCC, "DX10", 4) && (size >= 148)) {
+            p.format = dxgiFormat(le32(data + 128));
+            offset = 148;
+        }
+    } else if ((size >= 68) && !std::memcmp(data, KtxIdentifier, 12)) {
+        if (le32(data + 12) != 0x04030201) {
+            // big-endian file
+            return p;
+        }
+        p.format = glFormat(le32(data + 28));
+        p.width = le32(data + 36);
+        p.height = le32(data + 40);
+        // header, key/value data and imageSize of first level
+        offset = 64 + std::size_t(le32(data + 60)) + 4;
+    } else if ((size >= 104) && !std::memcmp(data, Ktx2Identifier, 12)) {
+        if (le32(data + 44)) {
+            // supercompressed (BasisLZ, zstd, ...)
+            return p;
+        }
+        p.format = vkFormat(le32(data + 12));
+        p.width = le32(data + 20);
+        p.height = le32(data + 24);
+        offset = le64(data + 80);
+    } else {
+        return p;
+    }
+
+    const std::size_t needed(std::size_t(p.blocksX()) * p.blocksY()
+                             * blockSize(p.format));
+    if ((p.format == Format::unsupported) || (p.width <= 0)
+        || (p.height <= 0) || (offset > fullSize)
+        || (fullSize - offset < needed))
+    {
+        p.format = Format::unsupported;
+        return p;
+    }
+
+    p.data = reinterpret_cast<const std::uint8_t*>(data) + offset;
+    p.size = needed;
+    return p;
+}
+
+Payload parse(const char *data, std::size_t size)
+{
+    return parse(data, size, size);
+}
+
+/** Decoded 4x4 block, BGR.
+ */
+typedef std::array<std::array<std::uint8_t, 3>, 16> Block;
+
+typedef std::array<int, 3> Rgb;
+
+inline std::uint8_t clamp(int value)
+{
+    return std::uint8_t(std::min(255, std::max(0, value)));
+}
+
+inline void set(Block &block, int x, int y, const Rgb &c)
+{
+    auto &out(block[y * 4 + x]);
+    out[0] = clamp(c[2]);
+    out[1] = clamp(c[1]);
+    out[2] = clamp(c[0]);
+}
+
+Rgb rgb565(std::uint16_t c)
+{
+    const int r((c >> 11) & 0x1f), g((c >> 5) & 0x3f), b(c & 0x1f);
+    return {{ (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) }};
+}
+
+/** BC1 color block; BC2/3 color blocks always use 4-color mode.
+ */
+void decodeBc1(const std::uint8_t *src, Block &block, bool bc1)
+{
+    const std::uint16_t c0(src[0] | (src[1] << 8));
+    const std::uint16_t c1(src[2] | (src[3] << 8));
+
+    std::array<Rgb, 4> palette;
+    palette[0] = rgb565(c0);
+    palette[1] = rgb565(c1);
+    if ((c0 > c1) || !bc1) {
+        for (int i(0); i < 3; ++i) {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+    } else {
+        for (int i(0); i < 3; ++i) {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0;
+        }
+    }
+
+    const std::uint32_t indices(src[4] | (src[5] << 8) | (src[6] << 16)
+                                | (std::uint32_t(src[7]) << 24));
+    for (int i(0); i < 16; ++i) {
+        set(block, i & 3, i >> 2, palette[(indices >> (2 * i)) & 3]);
+    }
+}
+
+const int etcModifiers[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }
+    , { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+const int etcDistances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+inline int extend4(int v) { return (v << 4) | v; }
+inline int extend5(int v) { return (v << 3) | (v >> 2); }
+inline int extend6(int v) { return (v << 2) | (v >> 4); }
+inline int extend7(int v) { return (v << 1) | (v >> 6); }
+
+/** Signed 3-bit delta.
+ */
+inline int delta3(int v) { return (v & 4) ? (v - 8) : v; }
+
+/** Pixel index (0-3) of ETC pixel; pixels are stored column by column.
+ */
+inline int etcIndex(std::uint32_t bits, int x, int y)
+{
+    const int i(x * 4 + y);
+    return (((bits >> (16 + i)) & 1) << 1) | ((bits >> i) & 1);
+}
+
+void decodeEtcPaint(std::uint32_t bits, const std::array<Rgb, 4> &paint
+                    , Block &block)
+{
+    for (int y(0); y < 4; ++y) {
+        for (int x(0); x < 4; ++x) {
+            set(block, x, y, paint[etcIndex(bits, x, y)]);
+        }
+    }
+}
+
+/** ETC1 block or ETC2 RGB block (etc2 enables T, H and planar modes).
+ */
+void decodeEtc(const std::uint8_t *src, Block &block, bool etc2)
+{
+    const std::uint32_t bits((std::uint32_t(src[4]) << 24) | (src[5] << 16)
+                             | (src[6] << 8) | src[7]);
+    const bool diff(src[3] & 2);
+    const bool flip(src[3] & 1);
+
+    Rgb base[2];
+    if (diff) {
+        const int r(src[0] >> 3), g(src[1] >> 3), b(src[2] >> 3);
+        const int r2(r + delta3(src[0] & 7));
+        const int g2(g + delta3(src[1] & 7));
+        const int b2(b + delta3(src[2] & 7));
+
+        if (etc2 && ((r2 < 0) || (r2 > 31))) {
+            // T mode
+            const Rgb c1{{ extend4(((src[0] >> 1) & 0xc) | (src[0] & 3))
+                           , extend4(src[1] >> 4), extend4(src[1] & 0xf) }};
+            const Rgb c2{{ extend4(src[2] >> 4), extend4(src[2] & 0xf)
+                           , extend4(src[3] >> 4) }};
+            const int d(etcDistances[(((src[3] >> 2) & 3) << 1)
+                                     | (src[3] & 1)]);
+            std::array<Rgb, 4> paint;
+            paint[0] = c1;
+            paint[2] = c2;
+            for (int i(0); i < 3; ++i) {
+                paint[1][i] = c2[i] + d;
+                paint[3][i] = c2[i] - d;
+            }
+            decodeEtcPaint(bits, paint, block);
+            return;
+        }
+
+        if (etc2 && ((g2 < 0) || (g2 > 31))) {
+            // H mode
+            const int r1((src[0] >> 3) & 0xf);
+            const int g1(((src[0] & 7) << 1) | ((src[1] >> 4) & 1));
+            const int b1((src[1] & 8) | ((src[1] & 3) << 1)
+                         | ((src[2] >> 7) & 1));
+            const int rr2((src[2] >> 3) & 0xf);
+            const int gg2(((src[2] & 7) << 1) | ((src[3] >> 7) & 1));
+            const int bb2((src[3] >> 3) & 0xf);
+
+            const Rgb c1{{ extend4(r1), extend4(g1), extend4(b1) }};
+            const Rgb c2{{ extend4(rr2), extend4(gg2), extend4(bb2) }};
+            const bool order(((r1 << 8) | (g1 << 4) | b1)
+                             >= ((rr2 << 8) | (gg2 << 4) | bb2));
+            const int d(etcDistances[(src[3] & 4) | ((src[3] & 1) << 1)
+                                     | (order ? 1 : 0)]);
+            std::array<Rgb, 4> paint;
+            for (int i(0); i < 3; ++i) {
+                paint[0][i] = c1[i] + d;
+                paint[1][i] = c1[i] - d;
+                paint[2][i] = c2[i] + d;
+                paint[3][i] = c2[i] - d;
+            }
+            decodeEtcPaint(bits, paint, block);
+            return;
+        }
+
+        if (etc2 && ((b2 < 0) || (b2 > 31))) {
+            // planar mode
+            const Rgb o{{
+                extend6((src[0] >> 1) & 0x3f)
+                , extend7(((src[0] & 1) << 6) | ((src[1] >> 1) & 0x3f))
+                , extend6(((src[1] & 1) << 5) | (src[2] & 0x18)
+                          | ((src[2] & 3) << 1) | ((src[3] >> 7) & 1))
+            }};
+            const Rgb h{{
+                extend6(((src[3] >> 1) & 0x3e) | (src[3] & 1))
+                , extend7(src[4] >> 1)
+                , extend6(((src[4] & 1) << 5) | (src[5] >> 3))
+            }};
+            const Rgb v{{
+                extend6(((src[5] & 7) << 3) | (src[6] >> 5))
+                , extend7(((src[6] & 0x1f) << 2) | (src[7] >> 6))
+                , extend6(src[7] & 0x3f)
+            }};
+            for (int y(0); y < 4; ++y) {
+                for (int x(0); x < 4; ++x) {
+                    Rgb c;
+                    for (int i(0); i < 3; ++i) {
+                        c[i] = (x * (h[i] - o[i]) + y * (v[i] - o[i])
+                                + 4 * o[i] + 2) >> 2;
+                    }
+                    set(block, x, y, c);
+                }
+            }
+            return;
+        }
+
+        base[0] = {{ extend5(r), extend5(g), extend5(b) }};
+        base[1] = {{ extend5(r2), extend5(g2), extend5(b2) }};
+    } else {
+        base[0] = {{ extend4(src[0] >> 4), extend4(src[1] >> 4)
+                     , extend4(src[2] >> 4) }};
+        base[1] = {{ extend4(src[0] & 0xf), extend4(src[1] & 0xf)
+                     , extend4(src[2] & 0xf) }};
+    }
+
+    const int table[2] = { (src[3] >> 5) & 7, (src[3] >> 2) & 7 };
+    for (int y(0); y < 4; ++y) {
+        for (int x(0); x < 4; ++x) {
+            const int sub(flip ? (y >> 1) : (x >> 1));
+            const auto *m(etcModifiers[table[sub]]);
+            const int index(etcIndex(bits, x, y));
+            const int modifier((index & 1) ? m[1] : m[0]);
+            const int value((index & 2) ? -modifier : modifier);
+            const auto &c(base[sub]);
+            set(block, x, y, {{ c[0] + value, c[1] + value, c[2] + value }});
+        }
+    }
+}
+
+void decodeBlock(Format format, const std::uint8_t *src, Block &block)
+{
+    switch (format) {
+    case Format::bc1: decodeBc1(src, block, true); break;
+    case Format::bc2: case Format::bc3: decodeBc1(src + 8, block, false); break;
+    case Format::etc1: decodeEtc(src, block, false); break;
+    case Format::etc2: decodeEtc(src, block, true); break;
+    case Format::etc2Eac: decodeEtc(src + 8, block, true); break;
+    default: break;
+    }
+}
+
+/** Marks blocks covered by footprint's textured faces. Returns empty mask
+ *  when all blocks are needed.
+ */
+std::vector<char> blockMask(const Payload &p, const vts::SubMesh &sm)
+{
+    const int bx(p.blocksX()), by(p.blocksY());
+
+    for (const auto &t : sm.tc) {
+        if ((t(0) < 0.0) || (t(0) > 1.0) || (t(1) < 0.0) || (t(1) > 1.0)) {
+            // wrapped texture coordinates
+            return {};
+        }
+    }
+
+    std::vector<char> mask(std::size_t(bx) * by, 0);
+    for (const auto &face : sm.facesTc) {
+        double xmin(p.width), xmax(0.0), ymin(p.height), ymax(0.0);
+        for (int i(0); i < 3; ++i) {
+            const auto &t(sm.tc[face(i)]);
+            const double x(t(0) * p.width), y((1.0 - t(1)) * p.height);
+            xmin = std::min(xmin, x); xmax = std::max(xmax, x);
+            ymin = std::min(ymin, y); ymax = std::max(ymax, y);
+        }
+
+        // one texel margin for filtering
+        const int x0(std::max(0, int(xmin - 1.0) / 4));
+        const int x1(std::min(bx - 1, int(xmax + 1.0) / 4));
+        const int y0(std::max(0, int(ymin - 1.0) / 4));
+        const int y1(std::min(by - 1, int(ymax + 1.0) / 4));
+        for (int y(y0); y <= y1; ++y) {
+            std::fill(mask.begin() + y * bx + x0
+                      , mask.begin() + y * bx + x1 + 1, 1);
+        }
+    }
+
+    return mask;
+}
+
+} // namespace
+
+TextureEncoding textureEncoding(const std::string &name)
+{
+    if (ba::iends_with(name, ".dds")) { return TextureEncoding::dds; }
+    if (ba::iends_with(name, ".ktx2")) { return TextureEncoding::ktx2; }
+    if (ba::iends_with(name, ".ktx")) { return TextureEncoding::ktx; }
+    return TextureEncoding::image;
+}
+
+bool compressedTextureSupported(const char *data, std::size_t size)
+{
+    return parse(data, size).format != Format::unsupported;
+}
+
+bool compressedTextureSupported(const char *header, std::size_t headerSize
+                                , std::size_t size)
+{
+    return (parse(header, std::min(headerSize, size), size).format
+            != Format::unsupported);
+}
+
+math::Size2 compressedTextureSize(const char *data, std::size_t size)
+{
+    const auto p(parse(data, size));
+    if (p.format == Format::unsupported) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported compressed texture.";
+    }
+    return math::Size2(p.width, p.height);
+}
+
+cv::Mat decodeCompressedTexture(const char *data, std::size_t size
+                                , const vts::SubMesh *footprint)
+{
+    const auto p(parse(data, size));
+    if (p.format == Format::unsupported) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported compressed texture.";
+    }
+
+    const int bx(p.blocksX()), by(p.blocksY());
+    const auto bsize(blockSize(p.format));
+    const auto mask(footprint ? blockMask(p, *footprint)
+                    : std::vector<char>());
+
+    cv::Mat image(p.height, p.width, CV_8UC3, cv::Scalar(0, 0, 0));
+    Block block;
+    for (int y(0); y < by; ++y) {
+        for (int x(0); x < bx; ++x) {
+            if (!mask.empty() && !mask[y * bx + x]) { continue; }
+
+            decodeBlock(p.format, p.data + (std::size_t(y) * bx + x) * bsize
+                        , block);
+
+            // copy block, clipped at image edges
+            const int w(std::min(4, p.width - x * 4));
+            const int h(std::min(4, p.height - y * 4));
+            for (int j(0); j < h; ++j) {
+                auto *row(image.ptr<std::uint8_t>(y * 4 + j) + x * 4 * 3);
+                for (int i(0); i < w; ++i) {
+                    std::copy(block[j * 4 + i].begin()
+                              , block[j * 4 + i].end(), row + i * 3);
+                }
+            }
+        }
+    }
+
+    return image;
+}
+
+} // namespace vtstools
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_compressedtexture_hpp_included_
+#define vts_tools_compressedtexture_hpp_included_
+
+#include <string>
+#include <cstddef>
+
+#include <opencv2/core/core.hpp>
+
+#include "math/geometry_core.hpp"
+
+#include "vts-libs/vts/mesh.hpp"
+
+/** GPU compressed texture decoding (DDS, KTX, KTX2 containers with BC1-3 or
+ *  ETC1/ETC2 payload).
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+
+/** Texture file encoding, ordered from cheapest to most expensive to decode.
+ */
+enum class TextureEncoding { dds, ktx, ktx2, image };
+
+/** Encoding by file name (extension), image for anything unknown.
+ */
+TextureEncoding textureEncoding(const std::string &name);
+
+/** Returns true if compressed texture payload is supported (checks container
+ *  header only).
+ */
+bool compressedTextureSupported(const char *data, std::size_t size);
+
+/** Number of leading bytes enough to check compressed texture support.
+ */
+constexpr std::size_t CompressedTextureHeaderSize(148);
+
+/** Same as above with only header (first headerSize bytes, see
+ *  CompressedTextureHeaderSize) of size bytes long payload available.
+ */
+bool compressedTextureSupported(const char *header, std::size_t headerSize
+                                , std::size_t size);
+
+/** Size of compressed texture (first mip level).
+ */
+math::Size2 compressedTextureSize(const char *data, std::size_t size);
+
+/** Decodes first mip level of compressed texture into 8-bit BGR image.
+ *
+ *  If footprint is given only 4x4 blocks covered by its textured faces (with
+ *  one texel margin) are decoded, the rest of the image is left black.
+ *  Footprint's texture coordinates have origin at the bottom-left corner.
+ */
+cv::Mat decodeCompressedTexture(const char *data, std::size_t size
+                                , const vts::SubMesh *footprint = nullptr);
+
+} // namespace vtstools
+
+#endif // vts_tools_compressedtexture_hpp_included_
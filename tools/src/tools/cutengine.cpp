@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+
+#include "vts-libs/vts/csconvertor.hpp"
+#include "vts-libs/vts/meshop.hpp"
+#include "vts-libs/vts/math.hpp"
+
+#include "cutengine.hpp"
+#include "threadpool.hpp"
+
+namespace vtstools {
+
+LazyTexture::LazyTexture(const std::shared_ptr<const void> &holder
+                         , const char *data, std::size_t size
+                         , const std::string &name)
+    : state_(std::make_shared<State>())
+{
+    state_->holder = holder;
+    state_->data = data;
+    state_->size = size;
+    state_->name = name;
+}
+
+const cv::Mat& LazyTexture::get() const
+{
+    auto &state(*state_);
+    std::call_once(state.once, [&]()
+    {
+        TraceSpan span("decodeTexture", state.name);
+        state.image = cv::imdecode(cv::Mat(1, state.size, CV_8U
+                                           , const_cast<char*>(state.data))
+                                   , cv::IMREAD_COLOR);
+        if (!state.image.data) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Cannot decode texture image from <" << state.name
+                << ">.";
+        }
+        count(Counter::texturesDecoded);
+    });
+    return state.image;
+}
+
+CutTarget::list lodInfoTargets(const tools::LodInfo &lodInfo, int depth)
+{
+    CutTarget::list targets;
+
+    // for each valid rfnode
+    for (const auto &item : lodInfo.localLods) {
+        const auto &rfNode(*item.first);
+        const auto bottomLod(item.second);
+
+        // compute local lod + sanity check
+        const auto fromBottom(lodInfo.bottomDepth - depth);
+        if (fromBottom > bottomLod) {
+            // out of reference frame -> skip
+            continue;
+        }
+
+        const vts::Lod localLod(bottomLod - fromBottom);
+
+        /** (extra) Tile flags to be stored along generate tiles from this
+         *  data
+         */
+        vts::TileIndex::Flag::value_type tileFlags(0);
+        if (depth <= lodInfo.commonBottom) {
+            // mark all tiles not below common bottom level as watertight
+            tileFlags |= vts::TileIndex::Flag::watertight;
+
+            if (depth == lodInfo.commonBottom) {
+                // mark all tiles at commom bottom level as alien
+                tileFlags |= vts::TileIndex::Flag::alien;
+            }
+        }
+
+        targets.emplace_back(rfNode, localLod + rfNode.nodeId().lod
+                             , tileFlags);
+    }
+
+    return targets;
+}
+
+namespace {
+
+struct Unit {
+    std::size_t index;
+    CutTarget::list targets;
+    double cost;
+
+    Unit(std::size_t index, CutTarget::list &&targets, double cost)
+        : index(index), targets(std::move(targets)), cost(cost)
+    {}
+
+    typedef std::vector<Unit> list;
+};
+
+} // namespace
+
+void CutEngine::run(const SourceReader &reader
+                    , vt::ExternalProgress &progress) const
+{
+    const auto size(reader.size());
+    progress.expect(size);
+
+    // compute targets for all units, cull units without any target
+    Unit::list units;
+    std::size_t culled(0);
+    for (std::size_t i(0); i < size; ++i) {
+        auto targets(reader.targets(i));
+        if (targets.empty()) {
+            ++culled;
+            ++progress;
+            continue;
+        }
+
+        const double cost(reader.cost(i) * targets.size());
+        units.emplace_back(i, std::move(targets), cost);
+    }
+
+    // most expensive first, similar units in reader's (spatial) order
+    {
+        std::vector<double> costs;
+        costs.reserve(units.size());
+        for (const auto &unit : units) { costs.push_back(unit.cost); }
+
+        Unit::list ordered;
+        ordered.reserve(units.size());
+        for (auto i : costOrder(costs)) {
+            ordered.push_back(std::move(units[i]));
+        }
+        units.swap(ordered);
+    }
+
+    LOG(info3) << "Cutting " << units.size() << " work units ("
+               << culled << " culled).";
+
+    typedef std::chrono::steady_clock Clock;
+    const auto start(Clock::now());
+
+    // per-thread time of the last finished unit, used to measure idle time
+    std::map<std::thread::id, Clock::time_point> finished;
+    std::mutex finishedMutex;
+
+    const std::size_t unitsSize(units.size());
+    parallelFor(unitsSize, [&](std::size_t i)
+    {
+        const auto &unit(units[i]);
+        const auto name(reader.name(unit.index));
+        TraceSpan span(reader.traceName(), name);
+
+        SourceMesh source;
+        {
+            ScopedPhase phase(Phase::parse);
+            reader.load(unit.index, source);
+            count(Counter::meshesDecoded, source.mesh.submeshes.size());
+            count(Counter::texturesDecoded, source.atlas.size());
+        }
+
+        const auto &srs(reader.srs(unit.index));
+        for (const auto &target : unit.targets) {
+            cut(name, srs, source, target);
+        }
+
+        ++progress;
+
+        const auto now(Clock::now());
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        finished[std::this_thread::get_id()] = now;
+    });
+
+    // report time threads spent waiting for the last unit; pool threads that
+    // got no unit at all were idle for the whole run
+    const auto end(Clock::now());
+    const double wall(std::chrono::duration<double>(end - start).count());
+    const std::size_t threads(std::max<std::size_t>(threadCount()
+                                                    , finished.size()));
+    double idle(wall * (threads - finished.size()));
+    for (const auto &item : finished) {
+        idle += std::chrono::duration<double>(end - item.second).count();
+    }
+
+    LOG(info3) << "Cut " << unitsSize << " work units in " << wall
+               << " s using " << finished.size() << " of " << threads
+               << " thread(s); tail idle time: " << idle
+               << " thread-seconds ("
+               << (wall > 0.0 ? (100.0 * idle) / (wall * threads) : 0.0)
+               << " % of capacity).";
+}
+
+void CutEngine::cut(const std::string &name, const geo::SrsDefinition &srs
+                    , const SourceMesh &source, const CutTarget &target)
+    const
+{
+    const auto &rfNode(*target.node);
+    const auto &nodeId(rfNode.nodeId());
+    const auto lod(target.lod);
+
+    // out of this node, abandon
+    if (lod < nodeId.lod) { return; }
+
+    const vts::CsConvertor conv(srs, rfNode.srs());
+    const bool hasRegions(!source.regions.empty());
+
+    // projected mesh/atlas
+    SourceMesh projected;
+
+    // and for each submesh
+    std::size_t smIndex(0);
+    for (const auto &sm : source.mesh) {
+        const auto index(smIndex++);
+
+        // make all faces valid by default
+        vts::VertexMask valid(sm.vertices.size(), true);
+        math::Points3 pv;
+        pv.reserve(sm.vertices.size());
+
+        ScopedPhase projectPhase(Phase::project);
+        auto ivalid(valid.begin());
+        for (const auto &v : sm.vertices) {
+            try {
+                pv.push_back(conv(v));
+                // apply zShift
+                if (config_.zShift) {
+                    pv.back()(2) += config_.zShift;
+                }
+                ++ivalid;
+            } catch (const std::exception&) {
+                // failed to convert vertex, mask it and skip
+                pv.emplace_back();
+                *ivalid++ = false;
+            }
+        }
+
+        count(Counter::facesProjected, sm.faces.size());
+        projectPhase.stop();
+
+        // clip mesh to node's extents
+        // FIXME: implement actual mask application in clipping!
+        ScopedPhase clipPhase(Phase::clip);
+        vts::FaceOriginList faceOrigin;
+        auto osm(vts::clip(sm, pv, rfNode.extents(), valid, &faceOrigin));
+        clipPhase.stop();
+        if (osm.faces.empty()) { continue; }
+
+        // at least one face survived, remember
+        osm.jsonStr = sm.jsonStr;
+
+        if (hasRegions) {
+            // get texturing info
+            const auto &srcRi(source.regions[index]);
+            projected.regions.emplace_back(srcRi.regions);
+            auto &tr(projected.regions.back());
+            // remap face regions (if any)
+            if (!srcRi.regions.empty()) {
+                for (const auto fo : faceOrigin) {
+                    tr.faces.push_back(srcRi.faces[fo]);
+                }
+            }
+        }
+
+        projected.mesh.submeshes.push_back(std::move(osm));
+        projected.addTexture(source, index);
+    }
+
+    // anything there?
+    if (projected.mesh.empty()) { return; }
+
+    const vts::Lod localLod(lod - nodeId.lod);
+
+    // compute local tile range
+    auto tr(tools::computeTileRange(rfNode.extents(), localLod
+                                    , tools::computeExtents(projected.mesh)));
+
+    // convert local tilerange to global tilerange
+    {
+        const auto origin(vts::lowestChild(vts::point(nodeId), localLod));
+        tr.ll += origin;
+        tr.ur += origin;
+    }
+
+    // split to tiles
+    LOG(info3) << "Splitting " << name << " to tiles in "
+               << lod << "/" << tr << ".";
+    splitToTiles(name, rfNode, lod, tr, projected, target.flags);
+}
+
+void CutEngine::splitToTiles(const std::string &name
+                             , const vts::NodeInfo &root
+                             , vts::Lod lod, const vts::TileRange &tr
+                             , const SourceMesh &source
+                             , vts::TileIndex::Flag::value_type tileFlags)
+    const
+{
+    TraceSpan span("splitToTiles", name);
+
+    if (config_.tileExtents) {
+        // check for range validity
+        if (lod < config_.tileExtents->lod) {
+            LOG(info2) << "Nothing to cut from " << name << ".";
+            return;
+        }
+
+        const auto gtr(vts::global(root.nodeId(), lod, tr));
+        const auto extents(vts::shiftRange(*config_.tileExtents, lod));
+
+        if (!vts::tileRangesOverlap(gtr, extents)) {
+            LOG(info2)
+                << "Nothing to cut from " << name
+                << ", gtr: " << gtr << ", extents: " << extents << ".";
+            return;
+        }
+    }
+
+    // tile range is global here
+    if (config_.shard && !config_.shard->overlaps(lod, tr)) {
+        LOG(info2) << "Nothing to cut from " << name << " in this shard.";
+        return;
+    }
+
+    typedef vts::TileRange::value_type Index;
+    Index je(tr.ur(1));
+    Index ie(tr.ur(0));
+
+    for (Index j = tr.ll(1); j <= je; ++j) {
+        for (Index i = tr.ll(0); i <= ie; ++i) {
+            vts::TileId tileId(lod, i, j);
+            const auto node(root.child(tileId));
+            cutTile(name, node, source, tileFlags);
+        }
+    }
+}
+
+void CutEngine::cutTile(const std::string &name, const vts::NodeInfo &node
+                        , const SourceMesh &source
+                        , vts::TileIndex::Flag::value_type tileFlags) const
+{
+    TraceSpan span("cutTile", name);
+
+    // compute border condition (defaults to all available)
+    vts::BorderCondition borderCondition;
+    if (config_.tileExtents) {
+        borderCondition = vts::inside(*config_.tileExtents, node.nodeId());
+        if (!borderCondition) {
+            LOG(info1)
+                << node.nodeId() << ": Nothing to cut from " << name << ".";
+            return;
+        }
+    }
+
+    // tile generated by another shard
+    if (config_.shard && !config_.shard->owns(node.nodeId())) { return; }
+
+    // compute clip extents
+    const auto extents(vts::inflateTileExtents
+                       (node.extents(), config_.clipMargin
+                        , borderCondition, config_.borderClipMargin));
+
+    const bool hasRegions(!source.regions.empty());
+
+    vts::Mesh clipped;
+    vts::opencv::Atlas clippedAtlas(0); // PNG!
+    tools::TextureRegionInfo::list clippedRegions;
+
+    ScopedPhase splitPhase(Phase::split);
+
+    std::size_t smIndex(0);
+    std::size_t faces(0);
+    for (const auto &sm : source.mesh) {
+        const auto index(smIndex++);
+
+        vts::FaceOriginList faceOrigin;
+        auto m(vts::clip(sm, extents, vts::VertexMask(), &faceOrigin));
+        if (m.empty()) { continue; }
+        m.jsonStr = sm.jsonStr;
+
+        clipped.submeshes.push_back(std::move(m));
+        clippedAtlas.add(source.texture(index));
+        faces += clipped.submeshes.back().faces.size();
+
+        if (hasRegions) {
+            // get texturing info
+            const auto &ri(source.regions[index]);
+            clippedRegions.emplace_back(ri.regions);
+            auto &tr(clippedRegions.back());
+            // remap face regions (if any)
+            if (!ri.regions.empty()) {
+                for (const auto fo : faceOrigin) {
+                    tr.faces.push_back(ri.faces[fo]);
+                }
+            }
+        }
+    }
+
+    if (clipped.empty()) {
+        LOG(info1) << node.nodeId() << ": Nothing cut from " << name << ".";
+        return;
+    }
+
+    LOG(info2)
+        << node.nodeId() << ": Cut " << faces << " faces from " << name
+        << ".";
+
+    // store in temporary storage
+    const auto tileId(node.nodeId());
+
+    if (config_.repack) {
+        if (hasRegions) {
+            tools::repack(tileId, clipped, clippedAtlas, clippedRegions);
+        } else {
+            tools::repack(tileId, clipped, clippedAtlas);
+        }
+    }
+    count(Counter::facesSplit, faces);
+    splitPhase.stop();
+
+    ScopedPhase storePhase(Phase::store);
+    TraceSpan storeSpan("TmpTileset::store", name);
+    tmpset_.store(tileId, clipped, clippedAtlas, tileFlags);
+    count(Counter::tilesWritten);
+}
+
+} // namespace vtstools
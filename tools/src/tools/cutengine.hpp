@@ -0,0 +1,251 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_cutengine_hpp_included_
+#define vts_tools_cutengine_hpp_included_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include <boost/optional.hpp>
+
+#include "geo/srsdef.hpp"
+
+#include "vts-libs/vts.hpp"
+#include "vts-libs/vts/opencv/atlas.hpp"
+#include "vts-libs/tools-support/progress.hpp"
+#include "vts-libs/tools-support/tmptileset.hpp"
+#include "vts-libs/tools-support/repackatlas.hpp"
+#include "vts-libs/tools-support/analyze.hpp"
+
+#include "shard.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+
+/** Cutting engine shared by all *2vts converters.
+ *
+ *  Converter provides its input via SourceReader interface; the engine takes
+ *  care of scheduling, projection, clipping to RF nodes, splitting to tiles,
+ *  atlas repacking and storing into the temporary tileset.
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+namespace vt = vtslibs::tools;
+namespace tools = vtslibs::vts::tools;
+
+/** Cutting configuration common to all converters.
+ */
+struct CutConfig {
+    boost::optional<vts::LodTileRange> tileExtents;
+    double clipMargin;
+    double borderClipMargin;
+    double zShift;
+
+    /** Repack atlas of every generated tile.
+     */
+    bool repack;
+
+    /** Only tiles owned by this shard are generated (sharded run). Border
+     *  conditions are still derived from tileExtents.
+     */
+    boost::optional<Shard> shard;
+
+    CutConfig()
+        : clipMargin(1.0 / 128.)
+        , borderClipMargin(clipMargin)
+        , zShift(0.0)
+        , repack(true)
+    {}
+};
+
+/** Encoded texture decoded on first use. Copies share the decoded image.
+ *
+ *  Encoded data are not copied; holder keeps them alive.
+ */
+class LazyTexture {
+public:
+    LazyTexture(const std::shared_ptr<const void> &holder, const char *data
+                , std::size_t size, const std::string &name);
+
+    /** Decodes texture (once). Throws when data cannot be decoded.
+     */
+    const cv::Mat& get() const;
+
+    /** Encoded data.
+     */
+    const char* data() const { return state_->data; }
+    std::size_t size() const { return state_->size; }
+    const std::string& name() const { return state_->name; }
+
+    typedef std::vector<LazyTexture> list;
+
+private:
+    struct State {
+        std::shared_ptr<const void> holder;
+        const char *data;
+        std::size_t size;
+        std::string name;
+
+        std::once_flag once;
+        cv::Mat image;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+/** Loaded input data: mesh, its atlas and optional per-submesh texture
+ *  region information (SLPK).
+ */
+struct SourceMesh {
+    vts::Mesh mesh;
+    vts::opencv::Atlas atlas;
+
+    /** Alternative to atlas: per-submesh textures decoded only when some of
+     *  submesh's faces end up in a tile.
+     */
+    LazyTexture::list textures;
+
+    tools::TextureRegionInfo::list regions;
+
+    /** Texture of given submesh.
+     */
+    cv::Mat texture(std::size_t index) const {
+        return textures.empty() ? atlas.get(index) : textures[index].get();
+    }
+
+    /** Adds texture of given submesh of other source.
+     */
+    void addTexture(const SourceMesh &other, std::size_t index) {
+        if (other.textures.empty()) {
+            atlas.add(other.atlas.get(index));
+        } else {
+            textures.push_back(other.textures[index]);
+        }
+    }
+};
+
+/** Destination of input data: RF node (subtree root), LOD in which the data
+ *  are cut into tiles and extra flags stored with every generated tile.
+ */
+struct CutTarget {
+    const vts::NodeInfo *node;
+    vts::Lod lod;
+    vts::TileIndex::Flag::value_type flags;
+
+    CutTarget(const vts::NodeInfo &node, vts::Lod lod
+              , vts::TileIndex::Flag::value_type flags = 0)
+        : node(&node), lod(lod), flags(flags)
+    {}
+
+    typedef std::vector<CutTarget> list;
+};
+
+/** Computes targets of data found at given depth of tree-like input (SLPK, 3D
+ *  Tiles, LODTree) from analysis result.
+ */
+CutTarget::list lodInfoTargets(const tools::LodInfo &lodInfo, int depth);
+
+/** Input data interface. Every converter wraps its input format (VEF windows,
+ *  I3S nodes, 3D Tiles, LODTree nodes) by this interface.
+ *
+ *  All functions are called from multiple threads at once.
+ */
+class SourceReader {
+public:
+    virtual ~SourceReader() {}
+
+    /** Number of work units.
+     */
+    virtual std::size_t size() const = 0;
+
+    /** Unit description used in log messages, e.g. "SLPK node <1-2>".
+     */
+    virtual std::string name(std::size_t index) const = 0;
+
+    /** SRS of unit's data.
+     */
+    virtual const geo::SrsDefinition& srs(std::size_t index) const = 0;
+
+    /** Destinations of unit's data. Must not perform any I/O. Units without
+     *  any target are not loaded at all.
+     */
+    virtual CutTarget::list targets(std::size_t index) const = 0;
+
+    /** Loads unit's data.
+     */
+    virtual void load(std::size_t index, SourceMesh &source) const = 0;
+
+    /** Estimated cost of unit's data processing in one target (e.g. size of
+     *  unit's data in bytes). Units are processed starting with the most
+     *  expensive ones, units of similar cost in index order (see
+     *  vtstools::costOrder). Must not perform any I/O.
+     */
+    virtual double cost(std::size_t index) const { (void) index; return 1.0; }
+
+    /** Name of unit processing span in trace.
+     */
+    virtual const char* traceName() const { return "cutUnit"; }
+};
+
+class CutEngine {
+public:
+    CutEngine(const CutConfig &config, tools::TmpTileset &tmpset)
+        : config_(config), tmpset_(tmpset)
+    {}
+
+    /** Cuts all units provided by reader. Sets progress expectation to the
+     *  number of units.
+     */
+    void run(const SourceReader &reader, vt::ExternalProgress &progress)
+        const;
+
+    /** Projects source data into target's SRS, clips them to target's RF
+     *  node and splits them into tiles.
+     */
+    void cut(const std::string &name, const geo::SrsDefinition &srs
+             , const SourceMesh &source, const CutTarget &target) const;
+
+private:
+    void splitToTiles(const std::string &name, const vts::NodeInfo &root
+                      , vts::Lod lod, const vts::TileRange &tr
+                      , const SourceMesh &source
+                      , vts::TileIndex::Flag::value_type tileFlags) const;
+
+    void cutTile(const std::string &name, const vts::NodeInfo &node
+                 , const SourceMesh &source
+                 , vts::TileIndex::Flag::value_type tileFlags) const;
+
+    const CutConfig &config_;
+    tools::TmpTileset &tmpset_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_cutengine_hpp_included_
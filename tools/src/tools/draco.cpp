@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+#ifdef VTS_TOOLS_HAS_DRACO
+#  include <draco/compression/decode.h>
+#endif
+
+#include "dbglog/dbglog.hpp"
+
+#include "draco.hpp"
+
+namespace vtstools {
+
+#ifdef VTS_TOOLS_HAS_DRACO
+
+bool dracoSupported() { return true; }
+
+void decodeDraco(const char *data, std::size_t size, vts::SubMesh &sm
+                 , const DracoAttributes &attributes
+                 , std::vector<DracoUvRegion> *uvRegions)
+{
+    // decoder keeps only options; one per thread avoids any sharing
+    thread_local draco::Decoder decoder;
+
+    draco::DecoderBuffer buffer;
+    buffer.Init(data, size);
+    auto decoded(decoder.DecodeMeshFromBuffer(&buffer));
+    if (!decoded.ok()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to decode Draco mesh: "
+            << decoded.status().error_msg_string() << ".";
+    }
+    const std::unique_ptr<draco::Mesh> mesh(std::move(decoded).value());
+
+    const auto attribute([&](int uniqueId
+                             , draco::GeometryAttribute::Type type)
+                         -> const draco::PointAttribute*
+    {
+        if (uniqueId >= 0) { return mesh->GetAttributeByUniqueId(uniqueId); }
+        return mesh->GetNamedAttribute(type);
+    });
+
+    const auto *position(attribute(attributes.position
+                                   , draco::GeometryAttribute::POSITION));
+    if (!position) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Draco mesh has no position attribute.";
+    }
+
+    const auto *texcoord(attribute(attributes.texcoord
+                                   , draco::GeometryAttribute::TEX_COORD));
+
+    const std::uint32_t points(mesh->num_points());
+
+    sm.vertices.resize(points);
+    {
+        float v[3];
+        for (draco::PointIndex i(0); i < points; ++i) {
+            position->ConvertValue(position->mapped_index(i), 3, v);
+            sm.vertices[i.value()] = math::Point3d(v[0], v[1], v[2]);
+        }
+    }
+
+    if (texcoord) {
+        sm.tc.resize(points);
+        float t[2];
+        for (draco::PointIndex i(0); i < points; ++i) {
+            texcoord->ConvertValue(texcoord->mapped_index(i), 2, t);
+            sm.tc[i.value()] = math::Point2d(t[0], t[1]);
+        }
+    }
+
+    sm.faces.clear();
+    sm.faces.reserve(mesh->num_faces());
+    for (draco::FaceIndex f(0); f < mesh->num_faces(); ++f) {
+        const auto &face(mesh->face(f));
+        sm.faces.emplace_back(face[0].value(), face[1].value()
+                              , face[2].value());
+    }
+
+    if (texcoord) {
+        sm.facesTc = sm.faces;
+    } else {
+        sm.facesTc.clear();
+    }
+
+    if (!uvRegions) { return; }
+    uvRegions->clear();
+
+    for (int a(0), e(mesh->num_attributes()); a != e; ++a) {
+        const auto *metadata(mesh->GetAttributeMetadataByAttributeId(a));
+        std::string type;
+        if (!metadata
+            || !metadata->GetEntryString("i3s-attribute-type", &type)
+            || (type != "uv-region"))
+        {
+            continue;
+        }
+
+        const auto *regions(mesh->attribute(a));
+        uvRegions->resize(points);
+        for (draco::PointIndex i(0); i < points; ++i) {
+            regions->ConvertValue(regions->mapped_index(i), 4
+                                  , (*uvRegions)[i.value()].data());
+        }
+        break;
+    }
+}
+
+#else // VTS_TOOLS_HAS_DRACO
+
+bool dracoSupported() { return false; }
+
+void decodeDraco(const char*, std::size_t, vts::SubMesh&
+                 , const DracoAttributes&, std::vector<DracoUvRegion>*)
+{
+    LOGTHROW(err2, std::runtime_error)
+        << "Draco compressed mesh cannot be decoded: "
+        "built without Draco support.";
+}
+
+#endif // VTS_TOOLS_HAS_DRACO
+
+} // namespace vtstools
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_draco_hpp_included_
+#define vts_tools_draco_hpp_included_
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "vts-libs/vts/mesh.hpp"
+
+/** Draco mesh decompression (optional, see VTS_TOOLS_HAS_DRACO).
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+
+/** True if built with Draco support.
+ */
+bool dracoSupported();
+
+/** Selection of decoded attributes. Attributes are selected by Draco unique
+ *  ID (e.g. from glTF KHR_draco_mesh_compression extension) or, when ID is
+ *  negative, by attribute type.
+ */
+struct DracoAttributes {
+    int position;
+    int texcoord;
+
+    DracoAttributes() : position(-1), texcoord(-1) {}
+};
+
+/** Per-vertex I3S texture region (i3s-attribute-type "uv-region"): u/v
+ *  minimum and maximum normalized to 16 bits.
+ */
+typedef std::array<std::uint16_t, 4> DracoUvRegion;
+
+/** Decodes Draco compressed mesh into submesh vertices, texture coordinates
+ *  (if present) and faces (texture faces share vertex indices).
+ *
+ *  Per-vertex I3S uv-regions are stored into uvRegions if provided and
+ *  present in the mesh (left empty otherwise).
+ *
+ *  Uses one decoder per thread; safe to call from multiple threads. Throws
+ *  when built without Draco support.
+ */
+void decodeDraco(const char *data, std::size_t size, vts::SubMesh &sm
+                 , const DracoAttributes &attributes = DracoAttributes()
+                 , std::vector<DracoUvRegion> *uvRegions = nullptr);
+
+} // namespace vtstools
+
+#endif // vts_tools_draco_hpp_included_
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <system_error>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "geometrycache.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace vtstools {
+
+GeometryCache::GeometryCache(const Config &config)
+    : config_(config), size_(), spillFd_(-1), spillFailed_(false)
+{}
+
+GeometryCache::~GeometryCache()
+{
+    if (spillFd_ >= 0) { ::close(spillFd_); }
+
+    if (!config_.memory) { return; }
+
+    LOG(info2)
+        << "Geometry cache: " << stats_.stored << " stored, "
+        << stats_.hits << " hits (" << stats_.spillHits
+        << " from spill file), " << stats_.misses << " misses, "
+        << stats_.spilled << " spilled, " << stats_.evicted << " evicted, "
+        << stats_.dropped << " dropped; peak size " << stats_.peakSize
+        << " B (limit " << config_.memory << " B), spill file size "
+        << stats_.spillSize << " B (limit " << config_.spill << " B).";
+}
+
+void GeometryCache::put(const std::string &key, std::string &&blob)
+{
+    if (!config_.memory) { return; }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto fentries(entries_.find(key));
+    if (fentries != entries_.end()) { erase(fentries); }
+
+    auto &entry(entries_[key]);
+    entry.size = blob.size();
+    entry.blob = std::move(blob);
+    entry.lru = lru_.insert(lru_.end(), key);
+    size_ += entry.size;
+    ++stats_.stored;
+
+    shrink();
+    stats_.peakSize = std::max(stats_.peakSize, size_);
+}
+
+bool GeometryCache::take(const std::string &key, std::string &blob)
+{
+    if (!config_.memory) { return false; }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto fentries(entries_.find(key));
+    if (fentries == entries_.end()) {
+        ++stats_.misses;
+        return false;
+    }
+    ++stats_.hits;
+
+    auto &entry(fentries->second);
+    if (!entry.spilled) {
+        blob = std::move(entry.blob);
+        erase(fentries);
+        return true;
+    }
+
+    // spilled data are never overwritten, read them without lock
+    const auto offset(entry.offset);
+    const auto size(entry.size);
+    erase(fentries);
+    ++stats_.spillHits;
+    lock.unlock();
+
+    blob.resize(size);
+    for (std::size_t done(0); done < size; ) {
+        const auto r(::pread(spillFd_, &blob[done], size - done
+                             , offset + done));
+        if (r <= 0) {
+            if ((r < 0) && (errno == EINTR)) { continue; }
+            std::system_error e(errno, std::system_category());
+            LOG(warn2) << "Unable to read from geometry cache spill file: <"
+                       << e.code() << ", " << e.what() << ">.";
+            blob.clear();
+            return false;
+        }
+        done += r;
+    }
+    return true;
+}
+
+void GeometryCache::drop(const std::string &key)
+{
+    if (!config_.memory) { return; }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto fentries(entries_.find(key));
+    if (fentries == entries_.end()) { return; }
+    erase(fentries);
+    ++stats_.dropped;
+}
+
+GeometryCache::Stats GeometryCache::stats() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void GeometryCache::erase(Entries::iterator ientries)
+{
+    auto &entry(ientries->second);
+    if (!entry.spilled) {
+        size_ -= entry.size;
+        lru_.erase(entry.lru);
+    }
+    entries_.erase(ientries);
+}
+
+void GeometryCache::shrink()
+{
+    while ((size_ > config_.memory) && !lru_.empty()) {
+        const auto fentries(entries_.find(lru_.front()));
+        auto &entry(fentries->second);
+
+        if (!spill(entry)) {
+            erase(fentries);
+            ++stats_.evicted;
+            continue;
+        }
+
+        size_ -= entry.size;
+        lru_.pop_front();
+        std::string().swap(entry.blob);
+        entry.spilled = true;
+        ++stats_.spilled;
+    }
+}
+
+bool GeometryCache::spill(Entry &entry)
+{
+    if (!config_.spill || spillFailed_
+        || (stats_.spillSize + entry.size > config_.spill))
+    {
+        return false;
+    }
+
+    if (spillFd_ < 0) {
+        const auto dir(config_.spillDir.empty()
+                       ? fs::temp_directory_path() : config_.spillDir);
+        const auto path(dir / fs::unique_path
+                        ("geometrycache-%%%%-%%%%-%%%%-%%%%.spill"));
+        spillFd_ = ::open(path.c_str()
+                          , O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (spillFd_ < 0) {
+            std::system_error e(errno, std::system_category());
+            LOG(warn2) << "Unable to create geometry cache spill file "
+                       << path << ": <" << e.code() << ", " << e.what()
+                       << ">; not spilling.";
+            spillFailed_ = true;
+            return false;
+        }
+
+        // file lives only as long as the descriptor
+        ::unlink(path.c_str());
+        LOG(info2) << "Spilling geometry cache to " << dir << ".";
+    }
+
+    const auto offset(stats_.spillSize);
+    for (std::size_t done(0); done < entry.size; ) {
+        const auto w(::pwrite(spillFd_, entry.blob.data() + done
+                              , entry.size - done, offset + done));
+        if (w <= 0) {
+            if ((w < 0) && (errno == EINTR)) { continue; }
+            std::system_error e(errno, std::system_category());
+            LOG(warn2) << "Unable to write to geometry cache spill file: <"
+                       << e.code() << ", " << e.what()
+                       << ">; not spilling anymore.";
+            spillFailed_ = true;
+            return false;
+        }
+        done += w;
+    }
+
+    entry.offset = offset;
+    stats_.spillSize += entry.size;
+    return true;
+}
+
+} // namespace vtstools
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_geometrycache_hpp_included_
+#define vts_tools_geometrycache_hpp_included_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include <boost/filesystem/path.hpp>
+
+/** Cache of decoded geometry handed over from analysis to cutting.
+ *
+ *  Entries are opaque blobs (compact binary form of decoded data) keyed by
+ *  source node ID. Every node is cut exactly once, therefore take() removes
+ *  the entry and frees its memory (or spill space) right away.
+ *
+ *  Memory held by blobs is capped. When full, the least recently stored
+ *  blobs are spilled to an (unlinked) file in the spill directory, up to the
+ *  spill limit; beyond that least recently stored blobs are dropped. Dropped
+ *  nodes are decoded again by the consumer. Entries known not to be needed
+ *  (e.g. nodes without any cut target) should be dropped as soon as that is
+ *  known.
+ *
+ *  All functions are thread safe.
+ */
+namespace vtstools {
+
+class GeometryCache {
+public:
+    struct Config {
+        /** Memory limit in bytes. Zero disables the cache.
+         */
+        std::size_t memory;
+
+        /** Spill file size limit in bytes. Zero disables spilling.
+         */
+        std::size_t spill;
+
+        /** Directory of spill file; system temporary directory if empty.
+         */
+        boost::filesystem::path spillDir;
+
+        Config(std::size_t memory = 0, std::size_t spill = 0)
+            : memory(memory), spill(spill)
+        {}
+    };
+
+    GeometryCache(const Config &config);
+
+    ~GeometryCache();
+
+    bool enabled() const { return config_.memory; }
+
+    /** Stores blob under given key, possibly spilling or dropping older
+     *  blobs.
+     */
+    void put(const std::string &key, std::string &&blob);
+
+    /** Removes blob stored under given key and returns it in blob. Returns
+     *  false on cache miss.
+     */
+    bool take(const std::string &key, std::string &blob);
+
+    /** Drops blob stored under given key, if any.
+     */
+    void drop(const std::string &key);
+
+    /** Cache statistics.
+     */
+    struct Stats {
+        std::size_t stored;
+        std::size_t hits;
+        std::size_t misses;
+
+        /** Blobs written to spill file and hits served from it.
+         */
+        std::size_t spilled;
+        std::size_t spillHits;
+
+        /** Blobs evicted for lack of space and blobs dropped by drop().
+         */
+        std::size_t evicted;
+        std::size_t dropped;
+
+        /** Peak size of all blobs held in memory.
+         */
+        std::size_t peakSize;
+
+        /** Size of spill file.
+         */
+        std::size_t spillSize;
+
+        Stats()
+            : stored(), hits(), misses(), spilled(), spillHits(), evicted()
+            , dropped(), peakSize(), spillSize()
+        {}
+    };
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        /** Blob in memory; empty when spilled.
+         */
+        std::string blob;
+
+        /** Position in recency list while in memory.
+         */
+        std::list<std::string>::iterator lru;
+
+        bool spilled;
+        std::size_t offset;
+        std::size_t size;
+
+        Entry() : spilled(false), offset(), size() {}
+    };
+
+    typedef std::unordered_map<std::string, Entry> Entries;
+
+    /** Frees memory until it fits the limit. Called under lock.
+     */
+    void shrink();
+
+    /** Writes blob to spill file; returns false if it does not fit or
+     *  spilling fails. Called under lock.
+     */
+    bool spill(Entry &entry);
+
+    void erase(Entries::iterator ientries);
+
+    const Config config_;
+    mutable std::mutex mutex_;
+    Entries entries_;
+
+    /** Keys of blobs in memory, least recently stored first.
+     */
+    std::list<std::string> lru_;
+
+    std::size_t size_;
+
+    /** Spill file descriptor, opened on first spill, -1 if none or failed.
+     */
+    int spillFd_;
+    bool spillFailed_;
+
+    Stats stats_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_geometrycache_hpp_included_
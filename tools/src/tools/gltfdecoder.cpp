@@ -0,0 +1,960 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <map>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "dbglog/dbglog.hpp"
+
+#include "jsoncpp/json.hpp"
+
+#include "gltfdecoder.hpp"
+#include "draco.hpp"
+#include "meshopt.hpp"
+
+namespace vtstools {
+
+namespace {
+
+const std::uint32_t GlbMagic(0x46546c67);
+const std::uint32_t GlbChunkJson(0x4e4f534a);
+const std::uint32_t GlbChunkBin(0x004e4942);
+const std::size_t GlbHeaderSize(12);
+const std::size_t B3dmHeaderSize(28);
+
+const char *DracoExtension("KHR_draco_mesh_compression");
+const char *MeshoptExtension("EXT_meshopt_compression");
+const char *KhrMeshoptExtension("KHR_meshopt_compression");
+const char *QuantizationExtension("KHR_mesh_quantization");
+const char *TextureTransformExtension("KHR_texture_transform");
+
+/** Extensions handled only by this decoder.
+ */
+const std::vector<std::string> nativeExtensions{
+    DracoExtension, MeshoptExtension, KhrMeshoptExtension
+    , QuantizationExtension, TextureTransformExtension
+};
+
+/** Little-endian field reader.
+ */
+template <typename T>
+T get(const char *p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+/** Column-major 4x4 matrix (glTF layout).
+ */
+typedef std::array<double, 16> Matrix;
+
+Matrix identity()
+{
+    Matrix m{};
+    m[0] = m[5] = m[10] = m[15] = 1.0;
+    return m;
+}
+
+Matrix operator*(const Matrix &a, const Matrix &b)
+{
+    Matrix m{};
+    for (int c(0); c < 4; ++c) {
+        for (int r(0); r < 4; ++r) {
+            double sum(0.0);
+            for (int k(0); k < 4; ++k) { sum += a[k * 4 + r] * b[c * 4 + k]; }
+            m[c * 4 + r] = sum;
+        }
+    }
+    return m;
+}
+
+math::Point3d transform(const Matrix &m, const math::Point3d &p)
+{
+    return math::Point3d
+        (m[0] * p(0) + m[4] * p(1) + m[8] * p(2) + m[12]
+         , m[1] * p(0) + m[5] * p(1) + m[9] * p(2) + m[13]
+         , m[2] * p(0) + m[6] * p(1) + m[10] * p(2) + m[14]);
+}
+
+Matrix translation(double x, double y, double z)
+{
+    auto m(identity());
+    m[12] = x; m[13] = y; m[14] = z;
+    return m;
+}
+
+/** Converts glTF Y-up to Z-up.
+ */
+Matrix yUpToZUp()
+{
+    Matrix m{};
+    m[0] = 1.0;
+    m[6] = 1.0;
+    m[9] = -1.0;
+    m[15] = 1.0;
+    return m;
+}
+
+Matrix fromMatrix4(const math::Matrix4 &trafo)
+{
+    Matrix m;
+    for (int c(0); c < 4; ++c) {
+        for (int r(0); r < 4; ++r) { m[c * 4 + r] = trafo(r, c); }
+    }
+    return m;
+}
+
+/** Node's local transformation (matrix or TRS).
+ */
+Matrix localMatrix(const Json::Value &node)
+{
+    const auto &matrix(node["matrix"]);
+    if (matrix.isArray() && (matrix.size() == 16)) {
+        Matrix m;
+        for (int i(0); i < 16; ++i) { m[i] = matrix[i].asDouble(); }
+        return m;
+    }
+
+    auto m(identity());
+
+    const auto &t(node["translation"]);
+    if (t.isArray() && (t.size() == 3)) {
+        m = m * translation(t[0].asDouble(), t[1].asDouble()
+                            , t[2].asDouble());
+    }
+
+    const auto &r(node["rotation"]);
+    if (r.isArray() && (r.size() == 4)) {
+        const double x(r[0].asDouble()), y(r[1].asDouble())
+            , z(r[2].asDouble()), w(r[3].asDouble());
+        Matrix rm(identity());
+        rm[0] = 1 - 2 * (y * y + z * z);
+        rm[1] = 2 * (x * y + z * w);
+        rm[2] = 2 * (x * z - y * w);
+        rm[4] = 2 * (x * y - z * w);
+        rm[5] = 1 - 2 * (x * x + z * z);
+        rm[6] = 2 * (y * z + x * w);
+        rm[8] = 2 * (x * z + y * w);
+        rm[9] = 2 * (y * z - x * w);
+        rm[10] = 1 - 2 * (x * x + y * y);
+        m = m * rm;
+    }
+
+    const auto &s(node["scale"]);
+    if (s.isArray() && (s.size() == 3)) {
+        Matrix sm(identity());
+        sm[0] = s[0].asDouble();
+        sm[5] = s[1].asDouble();
+        sm[10] = s[2].asDouble();
+        m = m * sm;
+    }
+
+    return m;
+}
+
+/** Parsed GLB container.
+ */
+struct Glb {
+    Json::Value json;
+    const char *bin;
+    std::size_t binSize;
+    math::Point3d rtc;
+
+    /** Offset of binary chunk data in content. Only the offset is known
+     *  (bin is null) when parsed from header.
+     */
+    std::size_t binOffset;
+
+    /** Decompressed (meshopt) buffer views.
+     */
+    mutable std::map<int, std::shared_ptr<std::vector<char>>> decoded;
+
+    Glb() : bin(), binSize(), rtc(0, 0, 0), binOffset() {}
+};
+
+Json::Value parseJson(const char *data, std::size_t size, const char *what)
+{
+    Json::Value value;
+    Json::Reader reader;
+    if (!reader.parse(data, data + size, value)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to parse " << what << ": "
+            << reader.getFormattedErrorMessages() << ".";
+    }
+    return value;
+}
+
+/** Parses b3dm or GLB content. With headerOnly set data end after binary
+ *  chunk header (see gltfHeaderSize).
+ */
+Glb parseGlb(const char *data, std::size_t size, bool headerOnly = false)
+{
+    Glb glb;
+
+    if ((size >= B3dmHeaderSize) && !std::memcmp(data, "b3dm", 4)) {
+        const auto ftJson(get<std::uint32_t>(data + 12));
+        const auto ftBin(get<std::uint32_t>(data + 16));
+        const auto btJson(get<std::uint32_t>(data + 20));
+        const auto btBin(get<std::uint32_t>(data + 24));
+        const std::size_t offset
+            (B3dmHeaderSize + std::size_t(ftJson) + ftBin + btJson + btBin);
+        if (offset > size) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Truncated b3dm header.";
+        }
+
+        if (ftJson) {
+            const auto ft(parseJson(data + B3dmHeaderSize, ftJson
+                                    , "b3dm feature table"));
+            const auto &rtc(ft["RTC_CENTER"]);
+            if (rtc.isArray() && (rtc.size() == 3)) {
+                glb.rtc = math::Point3d(rtc[0].asDouble(), rtc[1].asDouble()
+                                        , rtc[2].asDouble());
+            }
+        }
+
+        const auto rtc(glb.rtc);
+        glb = parseGlb(data + offset, size - offset, headerOnly);
+        glb.rtc = rtc;
+        glb.binOffset += offset;
+        return glb;
+    }
+
+    if ((size < GlbHeaderSize + 8) || (get<std::uint32_t>(data) != GlbMagic))
+    {
+        throw GltfUnsupported("Content is neither b3dm nor binary glTF.");
+    }
+
+    if (get<std::uint32_t>(data + 4) != 2) {
+        throw GltfUnsupported("Only glTF 2.0 is supported.");
+    }
+
+    const auto length(std::min<std::size_t>
+                      (get<std::uint32_t>(data + 8), size));
+    std::size_t offset(GlbHeaderSize);
+    bool json(false);
+    while (offset + 8 <= length) {
+        const std::size_t chunkSize(get<std::uint32_t>(data + offset));
+        const auto chunkType(get<std::uint32_t>(data + offset + 4));
+        const auto *chunk(data + offset + 8);
+        if (headerOnly && (chunkType == GlbChunkBin)) {
+            // binary chunk not available, remember where it is
+            glb.binOffset = offset + 8;
+            glb.binSize = chunkSize;
+            break;
+        }
+
+        if (offset + 8 + chunkSize > length) {
+            LOGTHROW(err2, std::runtime_error) << "Truncated GLB chunk.";
+        }
+
+        if (chunkType == GlbChunkJson) {
+            glb.json = parseJson(chunk, chunkSize, "glTF JSON");
+            json = true;
+        } else if ((chunkType == GlbChunkBin) && !glb.bin) {
+            glb.bin = chunk;
+            glb.binSize = chunkSize;
+            glb.binOffset = offset + 8;
+        }
+
+        offset += 8 + chunkSize;
+    }
+
+    if (!json) {
+        LOGTHROW(err2, std::runtime_error) << "GLB without JSON chunk.";
+    }
+
+    return glb;
+}
+
+/** Buffer view data.
+ */
+struct View {
+    const char *data;
+    std::size_t size;
+    std::size_t stride;
+};
+
+/** Offset of embedded data range in binary chunk.
+ */
+std::size_t rangeOffset(const Glb &glb, const Json::Value &range, int index)
+{
+    const auto buffer(range.get("buffer", 0).asInt());
+    if (buffer || glb.json["buffers"][0].isMember("uri")) {
+        throw GltfUnsupported("External glTF buffers are not supported.");
+    }
+
+    const std::size_t offset(range.get("byteOffset", 0).asUInt64());
+    const std::size_t length(range["byteLength"].asUInt64());
+    if ((offset > glb.binSize) || (length > glb.binSize - offset)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "glTF buffer view " << index << " out of buffer bounds.";
+    }
+
+    return offset;
+}
+
+/** Embedded data range.
+ */
+const char* binaryRange(const Glb &glb, const Json::Value &range, int index)
+{
+    const auto offset(rangeOffset(glb, range, index));
+    if (!glb.bin) {
+        LOGTHROW(err2, std::runtime_error)
+            << "glTF binary chunk not available.";
+    }
+    return glb.bin + offset;
+}
+
+View bufferView(const Glb &glb, int index)
+{
+    const auto &view(glb.json["bufferViews"][index]);
+    if (!view.isObject()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid glTF buffer view " << index << ".";
+    }
+
+    const auto *meshopt(&view["extensions"][MeshoptExtension]);
+    if (!meshopt->isObject()) {
+        meshopt = &view["extensions"][KhrMeshoptExtension];
+    }
+
+    if (meshopt->isObject()) {
+        // compressed data, decode once
+        const std::size_t stride((*meshopt)["byteStride"].asUInt64());
+        auto &decoded(glb.decoded[index]);
+        if (!decoded) {
+            const auto *data(binaryRange(glb, *meshopt, index));
+            decoded = std::make_shared<std::vector<char>>
+                (decodeMeshopt(data, (*meshopt)["byteLength"].asUInt64()
+                               , (*meshopt)["count"].asUInt64(), stride
+                               , meshoptMode((*meshopt)["mode"].asString())
+                               , meshoptFilter((*meshopt)
+                                               .get("filter", "NONE")
+                                               .asString())));
+        }
+        return { decoded->data(), decoded->size()
+                 , view.get("byteStride", Json::UInt64(stride)).asUInt() };
+    }
+
+    return { binaryRange(glb, view, index)
+             , view["byteLength"].asUInt64()
+             , view.get("byteStride", 0).asUInt() };
+}
+
+/** Typed accessor data.
+ */
+struct Accessor {
+    const char *data;
+    std::size_t count;
+    std::size_t stride;
+    int componentType;
+    int components;
+    bool normalized;
+
+    double get(std::size_t index, int component) const;
+};
+
+int componentSize(int componentType)
+{
+    switch (componentType) {
+    case 5120: case 5121: return 1;
+    case 5122: case 5123: return 2;
+    case 5125: case 5126: return 4;
+    }
+    LOGTHROW(err2, std::runtime_error)
+        << "Invalid glTF component type " << componentType << ".";
+    return 0;
+}
+
+int typeComponents(const std::string &type)
+{
+    if (type == "SCALAR") { return 1; }
+    if (type == "VEC2") { return 2; }
+    if (type == "VEC3") { return 3; }
+    if (type == "VEC4") { return 4; }
+    throw GltfUnsupported("Unsupported glTF accessor type " + type + ".");
+}
+
+double Accessor::get(std::size_t index, int component) const
+{
+    const auto *p(data + index * stride
+                  + component * componentSize(componentType));
+    switch (componentType) {
+    case 5120: {
+        const double v(vtstools::get<std::int8_t>(p));
+        return normalized ? std::max(v / 127.0, -1.0) : v;
+    }
+    case 5121: {
+        const double v(vtstools::get<std::uint8_t>(p));
+        return normalized ? v / 255.0 : v;
+    }
+    case 5122: {
+        const double v(vtstools::get<std::int16_t>(p));
+        return normalized ? std::max(v / 32767.0, -1.0) : v;
+    }
+    case 5123: {
+        const double v(vtstools::get<std::uint16_t>(p));
+        return normalized ? v / 65535.0 : v;
+    }
+    case 5125: return vtstools::get<std::uint32_t>(p);
+    case 5126: return vtstools::get<float>(p);
+    }
+    return 0.0;
+}
+
+Accessor accessor(const Glb &glb, int index)
+{
+    const auto &a(glb.json["accessors"][index]);
+    if (!a.isObject()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid glTF accessor " << index << ".";
+    }
+    if (a.isMember("sparse")) {
+        throw GltfUnsupported("Sparse glTF accessors are not supported.");
+    }
+    if (!a.isMember("bufferView")) {
+        throw GltfUnsupported("glTF accessors without buffer view are not "
+                              "supported.");
+    }
+
+    Accessor accessor;
+    accessor.componentType = a["componentType"].asInt();
+    accessor.components = typeComponents(a["type"].asString());
+    accessor.normalized = a.get("normalized", false).asBool();
+    accessor.count = a["count"].asUInt64();
+
+    const auto view(bufferView(glb, a["bufferView"].asInt()));
+    const std::size_t offset(a.get("byteOffset", 0).asUInt64());
+    const std::size_t element(componentSize(accessor.componentType)
+                              * accessor.components);
+    accessor.stride = view.stride ? view.stride : element;
+    accessor.data = view.data + offset;
+
+    if (accessor.count
+        && (offset + (accessor.count - 1) * accessor.stride + element
+            > view.size))
+    {
+        LOGTHROW(err2, std::runtime_error)
+            << "glTF accessor " << index << " out of buffer view bounds.";
+    }
+
+    return accessor;
+}
+
+/** Accessor bound value (min/max are stored in component type units).
+ */
+double boundValue(const Json::Value &accessor, const Json::Value &value)
+{
+    const auto v(value.asDouble());
+    if (!accessor.get("normalized", false).asBool()) { return v; }
+
+    switch (accessor["componentType"].asInt()) {
+    case 5120: return std::max(v / 127.0, -1.0);
+    case 5121: return v / 255.0;
+    case 5122: return std::max(v / 32767.0, -1.0);
+    case 5123: return v / 65535.0;
+    }
+    return v;
+}
+
+/** Reads accessor bounds, returns false if not available.
+ */
+template <typename Point>
+bool accessorBounds(const Json::Value &accessor, Point &lo, Point &hi)
+{
+    const int dim(lo.size());
+    const auto &min(accessor["min"]);
+    const auto &max(accessor["max"]);
+    if (!min.isArray() || !max.isArray() || (int(min.size()) < dim)
+        || (int(max.size()) < dim))
+    {
+        return false;
+    }
+
+    for (int i(0); i < dim; ++i) {
+        lo(i) = boundValue(accessor, min[i]);
+        hi(i) = boundValue(accessor, max[i]);
+    }
+    return true;
+}
+
+/** Checks that all faces reference existing vertices and texture
+ *  coordinates.
+ */
+void checkIndices(const vts::SubMesh &sm)
+{
+    for (const auto &face : sm.faces) {
+        for (const auto index : face) {
+            if (index >= sm.vertices.size()) {
+                LOGTHROW(err2, std::runtime_error)
+                    << "glTF vertex index " << index << " out of bounds ("
+                    << sm.vertices.size() << " vertices).";
+            }
+        }
+    }
+
+    for (const auto &face : sm.facesTc) {
+        for (const auto index : face) {
+            if (index >= sm.tc.size()) {
+                LOGTHROW(err2, std::runtime_error)
+                    << "glTF texture coordinate index " << index
+                    << " out of bounds (" << sm.tc.size()
+                    << " texture coordinates).";
+            }
+        }
+    }
+}
+
+/** Appends geometry of src to dst.
+ */
+void append(vts::SubMesh &dst, const vts::SubMesh &src)
+{
+    const auto vOffset(dst.vertices.size());
+    const auto tOffset(dst.tc.size());
+    dst.vertices.insert(dst.vertices.end(), src.vertices.begin()
+                        , src.vertices.end());
+    dst.tc.insert(dst.tc.end(), src.tc.begin(), src.tc.end());
+
+    for (const auto &face : src.faces) {
+        dst.faces.emplace_back(face(0) + vOffset, face(1) + vOffset
+                               , face(2) + vOffset);
+    }
+    for (const auto &face : src.facesTc) {
+        dst.facesTc.emplace_back(face(0) + tOffset, face(1) + tOffset
+                                 , face(2) + tOffset);
+    }
+}
+
+class Decoder {
+public:
+    Decoder(const Glb &glb, const Matrix &trafo, bool flipTc
+            , GltfContent &content, bool proxy = false)
+        : glb_(glb), trafo_(trafo), flipTc_(flipTc), content_(content)
+        , proxy_(proxy)
+    {}
+
+    void decode();
+
+private:
+    void node(int index, const Matrix &parent, int depth);
+    void mesh(int index, const Matrix &matrix);
+    void primitive(const Json::Value &primitive, const Matrix &matrix);
+    void proxy(const Json::Value &primitive, vts::SubMesh &sm);
+    const Json::Value& baseColorTexture(const Json::Value &primitive) const;
+    int textureIndex(const Json::Value &primitive) const;
+    void textureTransform(const Json::Value &primitive, vts::SubMesh &sm);
+    void add(int texture, vts::SubMesh &&sm);
+    void image(int texture);
+
+    const Glb &glb_;
+    const Matrix trafo_;
+    const bool flipTc_;
+    GltfContent &content_;
+    const bool proxy_;
+
+    /** Texture index -> submesh textured by it.
+     */
+    std::map<int, std::size_t> textured_;
+};
+
+void Decoder::decode()
+{
+    const auto &json(glb_.json);
+
+    // vertices: node -> Z-up -> RTC -> tile transformation
+    const auto base(trafo_ * translation(glb_.rtc(0), glb_.rtc(1)
+                                         , glb_.rtc(2))
+                    * yUpToZUp());
+
+    const auto &scenes(json["scenes"]);
+    if (!scenes.isArray() || !scenes.size()) {
+        // no scene: every mesh as is
+        for (int m(0), e(json["meshes"].size()); m < e; ++m) {
+            mesh(m, base);
+        }
+        return;
+    }
+
+    const auto &scene(scenes[json.get("scene", 0).asInt()]);
+    for (const auto &n : scene["nodes"]) { node(n.asInt(), base, 0); }
+}
+
+void Decoder::node(int index, const Matrix &parent, int depth)
+{
+    if (depth > 64) {
+        LOGTHROW(err2, std::runtime_error)
+            << "glTF node hierarchy too deep (cycle?).";
+    }
+
+    const auto &n(glb_.json["nodes"][index]);
+    const auto matrix(parent * localMatrix(n));
+
+    if (n.isMember("mesh")) { mesh(n["mesh"].asInt(), matrix); }
+
+    for (const auto &child : n["children"]) {
+        node(child.asInt(), matrix, depth + 1);
+    }
+}
+
+void Decoder::mesh(int index, const Matrix &matrix)
+{
+    for (const auto &p : glb_.json["meshes"][index]["primitives"]) {
+        primitive(p, matrix);
+    }
+}
+
+void Decoder::primitive(const Json::Value &primitive, const Matrix &matrix)
+{
+    if (primitive.get("mode", 4).asInt() != 4) {
+        // only triangles carry surface
+        return;
+    }
+
+    vts::SubMesh sm;
+
+    const auto &attributes(primitive["attributes"]);
+    const auto &draco(primitive["extensions"][DracoExtension]);
+
+    if (proxy_) {
+        proxy(primitive, sm);
+    } else if (draco.isObject()) {
+        const auto view(bufferView(glb_, draco["bufferView"].asInt()));
+        DracoAttributes da;
+        da.position = draco["attributes"].get("POSITION", -1).asInt();
+        da.texcoord = draco["attributes"].get("TEXCOORD_0", -1).asInt();
+        decodeDraco(view.data, view.size, sm, da);
+    } else {
+        if (!attributes.isMember("POSITION")) {
+            LOGTHROW(err2, std::runtime_error)
+                << "glTF primitive without positions.";
+        }
+
+        const auto position(accessor(glb_, attributes["POSITION"].asInt()));
+        sm.vertices.resize(position.count);
+        for (std::size_t i(0); i < position.count; ++i) {
+            sm.vertices[i] = math::Point3d(position.get(i, 0)
+                                           , position.get(i, 1)
+                                           , position.get(i, 2));
+        }
+
+        if (attributes.isMember("TEXCOORD_0")) {
+            const auto tc(accessor(glb_, attributes["TEXCOORD_0"].asInt()));
+            sm.tc.resize(tc.count);
+            for (std::size_t i(0); i < tc.count; ++i) {
+                sm.tc[i] = math::Point2d(tc.get(i, 0), tc.get(i, 1));
+            }
+        }
+
+        if (primitive.isMember("indices")) {
+            const auto indices(accessor(glb_, primitive["indices"].asInt()));
+            sm.faces.reserve(indices.count / 3);
+            const auto index([&](std::size_t i) -> unsigned int {
+                return indices.get(i, 0);
+            });
+            for (std::size_t i(0); i + 2 < indices.count; i += 3) {
+                sm.faces.emplace_back(index(i), index(i + 1), index(i + 2));
+            }
+        } else {
+            sm.faces.reserve(position.count / 3);
+            for (std::size_t i(0); i + 2 < position.count; i += 3) {
+                sm.faces.emplace_back(i, i + 1, i + 2);
+            }
+        }
+
+        // use the same indices for both 3D and 2D faces
+        if (!sm.tc.empty()) { sm.facesTc = sm.faces; }
+    }
+
+    checkIndices(sm);
+
+    for (auto &v : sm.vertices) { v = transform(matrix, v); }
+    textureTransform(primitive, sm);
+    if (flipTc_) {
+        for (auto &t : sm.tc) { t(1) = 1.0 - t(1); }
+    }
+
+    add(textureIndex(primitive), std::move(sm));
+}
+
+void Decoder::add(int texture, vts::SubMesh &&sm)
+{
+    if (texture >= 0) {
+        auto ftextured(textured_.find(texture));
+        if (ftextured != textured_.end()) {
+            auto &target(content_.mesh.submeshes[ftextured->second]);
+            if (target.tc.empty() == sm.tc.empty()) {
+                // same image: merge into submesh already textured by it
+                append(target, sm);
+                return;
+            }
+        } else {
+            textured_[texture] = content_.mesh.submeshes.size();
+        }
+    }
+
+    content_.mesh.submeshes.push_back(std::move(sm));
+    if (texture >= 0) { image(texture); }
+}
+
+void Decoder::proxy(const Json::Value &primitive, vts::SubMesh &sm)
+{
+    const auto &json(glb_.json);
+    const auto &attributes(primitive["attributes"]);
+    if (!attributes.isMember("POSITION")) {
+        LOGTHROW(err2, std::runtime_error)
+            << "glTF primitive without positions.";
+    }
+
+    const auto &position
+        (json["accessors"][attributes["POSITION"].asInt()]);
+    if (position["count"].asUInt64() < 3) { return; }
+
+    math::Point3d lo, hi;
+    if (!accessorBounds(position, lo, hi)) {
+        throw GltfUnsupported("glTF POSITION accessor without bounds.");
+    }
+
+    // quad perpendicular to the smallest extent
+    int n(0);
+    for (int i(1); i < 3; ++i) {
+        if ((hi(i) - lo(i)) < (hi(n) - lo(n))) { n = i; }
+    }
+    const int a((n + 1) % 3), b((n + 2) % 3);
+    for (int corner(0); corner < 4; ++corner) {
+        math::Point3d p;
+        p(n) = (lo(n) + hi(n)) / 2.0;
+        p(a) = (corner & 1) ? hi(a) : lo(a);
+        p(b) = (corner & 2) ? hi(b) : lo(b);
+        sm.vertices.push_back(p);
+    }
+    sm.faces.emplace_back(0, 1, 3);
+    sm.faces.emplace_back(0, 3, 2);
+
+    if (!attributes.isMember("TEXCOORD_0")) { return; }
+
+    math::Point2d tlo(0.0, 0.0), thi(1.0, 1.0);
+    accessorBounds(json["accessors"][attributes["TEXCOORD_0"].asInt()]
+                   , tlo, thi);
+    for (int corner(0); corner < 4; ++corner) {
+        sm.tc.emplace_back((corner & 1) ? thi(0) : tlo(0)
+                           , (corner & 2) ? thi(1) : tlo(1));
+    }
+    sm.facesTc = sm.faces;
+}
+
+const Json::Value& Decoder::baseColorTexture(const Json::Value &primitive)
+    const
+{
+    const auto &json(glb_.json);
+    const auto &material(json["materials"][primitive["material"].asInt()]);
+    return material["pbrMetallicRoughness"]["baseColorTexture"];
+}
+
+int Decoder::textureIndex(const Json::Value &primitive) const
+{
+    if (!primitive.isMember("material")) { return -1; }
+    const auto &bct(baseColorTexture(primitive));
+    if (!bct.isObject()) { return -1; }
+    return bct.get("index", -1).asInt();
+}
+
+void Decoder::textureTransform(const Json::Value &primitive
+                               , vts::SubMesh &sm)
+{
+    if (sm.tc.empty() || !primitive.isMember("material")) { return; }
+
+    const auto &tt(baseColorTexture(primitive)
+                   ["extensions"][TextureTransformExtension]);
+    if (!tt.isObject()) { return; }
+
+    const auto &offset(tt["offset"]);
+    const auto &scale(tt["scale"]);
+    const double ox(offset.isArray() ? offset[0u].asDouble() : 0.0);
+    const double oy(offset.isArray() ? offset[1u].asDouble() : 0.0);
+    const double sx(scale.isArray() ? scale[0u].asDouble() : 1.0);
+    const double sy(scale.isArray() ? scale[1u].asDouble() : 1.0);
+    const double r(tt.get("rotation", 0.0).asDouble());
+    const double c(std::cos(r)), sn(std::sin(r));
+
+    // translation * rotation * scale
+    for (auto &t : sm.tc) {
+        const double u(t(0) * sx), v(t(1) * sy);
+        t = math::Point2d(c * u + sn * v + ox, -sn * u + c * v + oy);
+    }
+}
+
+void Decoder::image(int index)
+{
+    const auto &json(glb_.json);
+    const auto &texture(json["textures"][index]);
+    if (!texture.isMember("source")) {
+        throw GltfUnsupported("glTF texture without source image.");
+    }
+
+    const auto &image(json["images"][texture["source"].asInt()]);
+    if (!image.isMember("bufferView")) {
+        throw GltfUnsupported("External glTF images are not supported.");
+    }
+
+    const auto viewIndex(image["bufferView"].asInt());
+    if (!glb_.bin) {
+        // header only: locate image in content, it is not read here
+        const auto &view(json["bufferViews"][viewIndex]);
+        if (!view.isObject() || view["extensions"].isObject()) {
+            throw GltfUnsupported("Cannot locate glTF image.");
+        }
+        content_.images.emplace_back
+            (nullptr, view["byteLength"].asUInt64()
+             , glb_.binOffset + rangeOffset(glb_, view, viewIndex));
+        return;
+    }
+
+    const auto view(bufferView(glb_, viewIndex));
+    content_.images.emplace_back(view.data, view.size);
+}
+
+bool uses(const Json::Value &list, const std::string &extension)
+{
+    for (const auto &item : list) {
+        if (item.asString() == extension) { return true; }
+    }
+    return false;
+}
+
+} // namespace
+
+bool gltfNeedsNativeDecoder(const char *data, std::size_t size)
+{
+    Glb glb;
+    try {
+        glb = parseGlb(data, size, true);
+    } catch (const GltfUnsupported&) {
+        return false;
+    }
+
+    for (const auto &extension : nativeExtensions) {
+        if (uses(glb.json["extensionsUsed"], extension)
+            || uses(glb.json["extensionsRequired"], extension))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void decodeGltf(const char *data, std::size_t size
+                , const math::Matrix4 &trafo, bool flipTc
+                , GltfContent &content)
+{
+    const auto glb(parseGlb(data, size));
+
+    for (const auto &extension : glb.json["extensionsRequired"]) {
+        const auto name(extension.asString());
+        if (std::find(nativeExtensions.begin(), nativeExtensions.end(), name)
+            == nativeExtensions.end())
+        {
+            throw GltfUnsupported("Unsupported required glTF extension <"
+                                  + name + ">.");
+        }
+    }
+
+    Decoder(glb, fromMatrix4(trafo), flipTc, content).decode();
+}
+
+std::size_t gltfHeaderSize(const char *data, std::size_t size)
+{
+    if (size < B3dmHeaderSize) { return B3dmHeaderSize; }
+
+    std::size_t offset(0);
+    if (!std::memcmp(data, "b3dm", 4)) {
+        offset = (B3dmHeaderSize
+                  + std::size_t(get<std::uint32_t>(data + 12))
+                  + get<std::uint32_t>(data + 16)
+                  + get<std::uint32_t>(data + 20)
+                  + get<std::uint32_t>(data + 24));
+    }
+
+    // GLB header, JSON chunk (always first) and binary chunk header
+    if (size < offset + GlbHeaderSize + 8) {
+        return offset + GlbHeaderSize + 8;
+    }
+    return (offset + GlbHeaderSize + 8
+            + get<std::uint32_t>(data + offset + GlbHeaderSize) + 8);
+}
+
+void estimateGltf(const char *data, std::size_t size
+                  , const math::Matrix4 &trafo, bool flipTc
+                  , GltfContent &content)
+{
+    const auto glb(parseGlb(data, size, true));
+    Decoder(glb, fromMatrix4(trafo), flipTc, content, true).decode();
+}
+
+std::vector<GltfImage> gltfImages(const char *data, std::size_t size)
+{
+    std::vector<GltfImage> images;
+
+    Glb glb;
+    try {
+        glb = parseGlb(data, size);
+    } catch (const std::exception&) {
+        return images;
+    }
+    if (!glb.bin) { return images; }
+
+    const auto &json(glb.json);
+    if (json["buffers"][0].isMember("uri")) { return images; }
+
+    for (const auto &image : json["images"]) {
+        if (!image.isMember("bufferView")) { continue; }
+        const auto &view(json["bufferViews"][image["bufferView"].asInt()]);
+        if (!view.isObject() || view["extensions"].isObject()
+            || view.get("buffer", 0).asInt())
+        {
+            continue;
+        }
+
+        const std::size_t offset(view.get("byteOffset", 0).asUInt64());
+        const std::size_t length(view["byteLength"].asUInt64());
+        if ((offset > glb.binSize) || (length > glb.binSize - offset)) {
+            continue;
+        }
+        images.emplace_back(glb.bin + offset, length
+                            , glb.binOffset + offset);
+    }
+
+    return images;
+}
+
+} // namespace vtstools
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_gltfdecoder_hpp_included_
+#define vts_tools_gltfdecoder_hpp_included_
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "math/geometry_core.hpp"
+
+#include "vts-libs/vts/mesh.hpp"
+
+/** Native glTF 2.0 (GLB, b3dm) mesh decoder.
+ *
+ *  Decodes meshes the gltf library cannot (Draco compressed primitives,
+ *  meshopt compressed buffer views, quantized attributes with texture
+ *  transform) straight into vts::Mesh. Quantized attributes are dequantized
+ *  directly into vertex and texture coordinates. Only embedded (GLB binary
+ *  chunk) buffers and images are supported.
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+
+/** Thrown on valid glTF content this decoder does not support.
+ */
+struct GltfUnsupported : std::runtime_error {
+    GltfUnsupported(const std::string &msg) : std::runtime_error(msg) {}
+};
+
+/** Encoded image, points into decoded data. Images of estimate are not
+ *  available: data is null and offset is image's position in content.
+ */
+struct GltfImage {
+    const char *data;
+    std::size_t size;
+    std::size_t offset;
+
+    GltfImage(const char *data, std::size_t size, std::size_t offset = 0)
+        : data(data), size(size), offset(offset)
+    {}
+};
+
+/** Decoded content: one submesh per primitive, primitives sharing base color
+ *  texture are merged into one submesh. Textured submeshes add their image.
+ */
+struct GltfContent {
+    vts::Mesh mesh;
+    std::vector<GltfImage> images;
+};
+
+/** Returns true if content (b3dm or GLB) uses any extension that needs this
+ *  decoder (KHR_draco_mesh_compression, EXT_meshopt_compression,
+ *  KHR_mesh_quantization, KHR_texture_transform). Only content header is
+ *  needed (see gltfHeaderSize).
+ */
+bool gltfNeedsNativeDecoder(const char *data, std::size_t size);
+
+/** Decodes b3dm or GLB content.
+ *
+ *  Vertices are converted from glTF's Y-up to Z-up, shifted by b3dm
+ *  RTC_CENTER and transformed by trafo. Texture coordinates are flipped
+ *  vertically when flipTc is set.
+ */
+void decodeGltf(const char *data, std::size_t size
+                , const math::Matrix4 &trafo, bool flipTc
+                , GltfContent &content);
+
+/** Number of leading bytes of b3dm or GLB content estimateGltf needs. Call
+ *  repeatedly with more data until the returned size is available.
+ */
+std::size_t gltfHeaderSize(const char *data, std::size_t size);
+
+/** Builds cheap proxy of b3dm or GLB content from its header (see
+ *  gltfHeaderSize), i.e. from glTF JSON only.
+ *
+ *  Every triangle primitive becomes a quad spanning the two largest extents
+ *  of its POSITION accessor bounds, textured by its TEXCOORD_0 accessor
+ *  bounds. Images are only located (GltfImage::offset) for the caller to
+ *  read their headers. Geometry is transformed the same way as in
+ *  decodeGltf.
+ *
+ *  Throws GltfUnsupported when accessor bounds are missing.
+ */
+void estimateGltf(const char *data, std::size_t size
+                  , const math::Matrix4 &trafo, bool flipTc
+                  , GltfContent &content);
+
+/** Locates images embedded in b3dm or GLB content, in glTF images order.
+ *  Images stored other than in a plain buffer view of the binary chunk are
+ *  skipped; content this decoder cannot parse has no images.
+ */
+std::vector<GltfImage> gltfImages(const char *data, std::size_t size);
+
+} // namespace vtstools
+
+#endif // vts_tools_gltfdecoder_hpp_included_
@@ -26,6 +26,8 @@
 
 #include <cstdlib>
 #include <string>
+#include <sstream>
+#include <mutex>
 
 #include <tinyxml2.h>
 
@@ -40,7 +42,6 @@
 
 #include "utility/buildsys.hpp"
 #include "utility/gccversion.hpp"
-#include "utility/openmp.hpp"
 #include "utility/progress.hpp"
 #include "utility/limits.hpp"
 
@@ -67,6 +68,14 @@
 #include "vts-libs/tools-support/repackatlas.hpp"
 #include "vts-libs/tools-support/analyze.hpp"
 
+#include "cutengine.hpp"
+#include "shard.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "threadpool.hpp"
+#include "modelloader.hpp"
+#include "meshcache.hpp"
+
 namespace vs = vtslibs::storage;
 namespace vr = vtslibs::registry;
 namespace vts = vtslibs::vts;
@@ -80,25 +89,28 @@ typedef vts::opencv::HybridAtlas HybridAtlas;
 
 namespace {
 
-struct Config : tools::TmpTsEncoder::Config {
+struct Config : tools::TmpTsEncoder::Config, vtstools::CutConfig {
     std::string tilesetId;
     std::string referenceFrame;
     math::Size2 optimalTextureSize;
     double ntLodPixelSize;
 
-    boost::optional<vts::LodTileRange> tileExtents;
-    double clipMargin;
-    double borderClipMargin;
     double offsetX, offsetY, offsetZ;
-    double zShift;
+    bool nativeLoaders;
+    fs::path analysisCache;
+
+    /** Input archive, locates model and texture files for analysis cache
+     *  keys.
+     */
+    fs::path input;
+
+    vtstools::ShardConfig sharding;
 
     Config()
         : optimalTextureSize(256, 256)
         , ntLodPixelSize(1.0)
-        , clipMargin(1.0 / 128.)
-        , borderClipMargin(clipMargin)
         , offsetX(), offsetY(), offsetZ()
-        , zShift()
+        , nativeLoaders(true)
     {}
 
     void configuration(po::options_description &config) {
@@ -155,7 +167,26 @@ struct Config : tools::TmpTsEncoder::Config {
              ->default_value(zShift)->required()
              , "Manual height adjustment (value is "
              "added to z component of all vertices).")
+
+            ("nativeLoaders", po::value(&nativeLoaders)
+             ->default_value(nativeLoaders)->implicit_value(true)
+             , "Load textured OBJ and PLY models natively. Other formats "
+             "and models the native loaders cannot handle are loaded "
+             "through Assimp.")
+
+            ("analysisCache", po::value(&analysisCache)
+             , "Directory of persistent cache of analysis inputs (model "
+             "geometry and texture sizes). Repeated conversions of the same "
+             "input (e.g. into another reference frame) analyze it without "
+             "loading any model or texture. Entries are keyed on model and "
+             "texture file size and modification time, loader choice and "
+             "model placement. Disabled when not set.")
             ;
+
+        sharding.configuration(config);
+        vtstools::metricsConfiguration(config);
+        vtstools::traceConfiguration(config);
+        vtstools::threadPoolConfiguration(config);
     }
 
     void configure(const po::variables_map &vars) {
@@ -164,6 +195,12 @@ struct Config : tools::TmpTsEncoder::Config {
         if (vars.count("tileExtents")) {
             tileExtents = vars["tileExtents"].as<vts::LodTileRange>();
         }
+
+        sharding.configure(vars);
+        shard = sharding.shard(tileExtents);
+        vtstools::configureMetrics(vars);
+        vtstools::configureTrace(vars);
+        vtstools::configureThreadPool(vars);
     }
 };
 
@@ -230,6 +267,14 @@ void LodTree2Vts::configure(const po::variables_map &vars)
                    ? vts::CreateMode::overwrite
                    : vts::CreateMode::failIfExists);
 
+    config_.input = input_;
+
+    if (config_.sharding.worker) {
+        // worker cuts into its own tileset
+        output_ = vtstools::shardOutput(output_, *config_.sharding.worker);
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     epConfig_ = vt::configureProgress(vars);
 }
 
@@ -247,11 +292,85 @@ usage
 
 // ------------------------------------------------------------------------
 
-tools::LodInfo analyze(vt::ExternalProgress &progress
-                       , const Config &config
-                       , const vts::NodeInfo::list &nodes
-                       , const lodtree::Node::list &ltNodes
-                       , const lodtree::LodTreeExport &archive)
+typedef std::pair<vts::Mesh, vtstools::TextureStreams> Model;
+
+/** Loads node's model, natively if possible, through Assimp otherwise.
+ */
+Model loadModel(const Config &config, const lodtree::LodTreeExport &archive
+                , const lodtree::Node &node)
+{
+    if (config.nativeLoaders && vtstools::nativeModelFormat(node.modelPath))
+    {
+        vtstools::TraceSpan span("loadNativeModel");
+        try {
+            auto model(vtstools::loadNativeModel
+                       (archive.archive(), node.modelPath, node.origin));
+            return Model(std::move(model.mesh), std::move(model.textures));
+        } catch (const vtstools::ModelUnsupported &e) {
+            LOG(info1) << "Model " << node.modelPath << " not supported by "
+                       << "native loader (" << e.what() << ").";
+        } catch (const std::exception &e) {
+            LOG(warn2) << "Native loader failed to load model "
+                       << node.modelPath << " (" << e.what() << ").";
+        }
+    }
+
+    vtstools::TraceSpan span("loadAssimpScene");
+    Assimp::Importer imp;
+    imp.SetPropertyBool(AI_CONFIG_IMPORT_NO_SKELETON_MESHES, true);
+
+    Model model;
+    tools::TextureStreams ts;
+    std::tie(model.first, ts) = tools::loadAssimpScene
+        (imp, archive.archive(), node.modelPath, node.origin);
+    model.second.assign(ts.begin(), ts.end());
+    return model;
+}
+
+/** Analysis cache key of node: model file (stat only), loader and
+ *  placement. Returns empty key if model file cannot be stat'ed.
+ */
+std::string infoKey(const Config &config, const lodtree::Node &node)
+{
+    const auto native(config.nativeLoaders
+                      && vtstools::nativeModelFormat(node.modelPath));
+
+    std::ostringstream os;
+    os.precision(17);
+    os << (native ? "native" : "assimp") << ' ' << node.origin(0) << ' '
+       << node.origin(1) << ' ' << node.origin(2);
+
+    const auto uri(node.modelPath.string());
+    return vtstools::ModelInfoCache::fileKey
+        (vtstools::ModelInfoCache::contentFile(config.input, uri), uri
+         , os.str());
+}
+
+/** Processing cost of nodes: size of node's model file in bytes. Model of
+ *  unknown size costs 1.
+ */
+std::vector<double> nodeCosts(const lodtree::LodTreeExport &archive
+                              , const std::vector<const lodtree::Node*> &nodes)
+{
+    vtstools::TraceSpan span("nodeCosts");
+    std::vector<double> costs(nodes.size(), 1.0);
+    vtstools::parallelFor(nodes.size(), [&](std::size_t i)
+    {
+        const auto is(archive.archive().istream(nodes[i]->modelPath));
+        if (const auto size = is->size()) {
+            costs[i] = std::max<double>(1.0, *size);
+        }
+    });
+    return costs;
+}
+
+vtstools::TreeAnalysis
+analyze(vt::ExternalProgress &progress
+        , const Config &config
+        , const vts::NodeInfo::list &nodes
+        , const std::vector<const lodtree::Node*> &ltNodes
+        , const std::vector<double> &allCosts
+        , const lodtree::LodTreeExport &archive)
 {
     LOG(info3) << "Analyzing input dataset (" << ltNodes.size()
                << " LODTree nodes).";
@@ -260,100 +379,170 @@ tools::LodInfo analyze(vt::ExternalProgress &progress
     const geo::SrsDefinition inputSrs(archive.srs);
 
     // find limits for data nodes: top/bottom and bottom common to all subtrees
-    tools::LodInfo lodInfo;
-    lodInfo.topDepth = std::numeric_limits<int>::max();
-    lodInfo.commonBottom = std::numeric_limits<int>::max();
-    lodInfo.bottomDepth = -1;
+    vtstools::TreeAnalysis analysis;
 
     {
-        for (const auto &node : ltNodes) {
+        for (const auto *pnode : ltNodes) {
+            const auto &node(*pnode);
             if (node.children.empty()) {
                 // leaf
-                lodInfo.commonBottom
-                    = std::min(lodInfo.commonBottom, node.level);
-                lodInfo.bottomDepth
-                    = std::max(lodInfo.bottomDepth, node.level);
+                analysis.commonBottom
+                    = std::min(analysis.commonBottom, node.level);
+                analysis.bottomDepth
+                    = std::max(analysis.bottomDepth, node.level);
             }
 
             // update top
-            lodInfo.topDepth = std::min(lodInfo.topDepth, node.level);
+            analysis.topDepth = std::min(analysis.topDepth, node.level);
         }
 
         LOG(info2) << "Found top/common-bottom/bottom: "
-                   << lodInfo.topDepth << "/" << lodInfo.commonBottom
-                   << "/" << lodInfo.bottomDepth << ".";
+                   << analysis.topDepth << "/" << analysis.commonBottom
+                   << "/" << analysis.bottomDepth << ".";
     }
 
     tools::MeshInfo::map mim;
 
     // accumulate mesh area (both 3D and 2D) in all nodes at common bottom depth
 
-    // collect nodes for OpenMP
+    // collect nodes at common bottom depth
     std::vector<const lodtree::Node*> treeNodes;
-    for (const auto &node : ltNodes) {
-        if (node.level == lodInfo.commonBottom) {
-            treeNodes.push_back(&node);
+    std::vector<double> costs;
+    for (std::size_t i(0), e(ltNodes.size()); i != e; ++i) {
+        if (ltNodes[i]->level == analysis.commonBottom) {
+            treeNodes.push_back(ltNodes[i]);
+            costs.push_back(allCosts[i]);
         }
     }
 
-    auto *pmim(&mim);
-    const auto *pnodes(&treeNodes);
-
-    UTILITY_OMP(parallel for shared(pmim) schedule(dynamic))
-    for (std::size_t i = 0; i < pnodes->size(); ++i) {
-        const auto &node(*(*pnodes)[i]);
+    // most expensive nodes first
+    const auto order(vtstools::costOrder(costs));
 
-        Assimp::Importer imp;
-        imp.SetPropertyBool(AI_CONFIG_IMPORT_NO_SKELETON_MESHES, true);
+    // analysis inputs from previous runs
+    const vtstools::ModelInfoCache cache(config.analysisCache);
 
-        // load geometry
-        vts::Mesh mesh;
-        std::vector<math::Size2> sizes;
+    std::mutex mimMutex;
 
-        {
-            tools::TextureStreams ts;
-            std::tie(mesh, ts) = tools::loadAssimpScene
-                (imp, archive.archive(), node.modelPath, node.origin);
+    vtstools::parallelFor(order.size(), [&](std::size_t i)
+    {
+        const auto index(order[i]);
+        const auto &node(*treeNodes[index]);
+        vtstools::ScopedPhase phase(vtstools::Phase::analyze);
+
+        // load geometry and measure textures unless cached
+        vtstools::ModelInfoCache::Info info;
+        const auto key(cache.enabled() ? infoKey(config, node)
+                       : std::string());
+        if (key.empty() || !cache.load(key, info)) {
+            vtstools::TextureStreams ts;
+            std::tie(info.mesh, ts) = loadModel(config, archive, node);
 
-            // measure textures
             for (const auto &is : ts) {
-                sizes.push_back(imgproc::imageSize(*is, is->path()));
+                info.textureSizes.push_back
+                    (imgproc::imageSize(*is, is->path()));
+                info.files.push_back
+                    (vtstools::ModelInfoCache::contentFile
+                     (config.input, is->path().string()));
             }
+
+            if (!key.empty()) { cache.store(key, info); }
         }
 
+        const auto &mesh(info.mesh);
+        const auto &sizes(info.textureSizes);
+
         // compute mesh are in each RF node
         for (const auto &rfNode : nodes) {
             const vts::CsConvertor conv(inputSrs, rfNode.srs());
             const auto mi(tools::measureMesh(rfNode, conv, mesh, sizes));
             if (mi) {
-                UTILITY_OMP(critical(lodtree2vts_meshInfo_1))
-                    (*pmim)[&rfNode] += mi;
+                std::lock_guard<std::mutex> lock(mimMutex);
+                mim[&rfNode] += mi;
             }
         }
-    }
+    });
 
     // shift between common depth and bottom depth
-    const auto lodShift(lodInfo.bottomDepth - lodInfo.commonBottom);
+    const auto lodShift(analysis.bottomDepth - analysis.commonBottom);
 
     for (const auto &item : mim) {
         const auto bl
             (lodShift + tools::bestLod(*item.first, item.second.area
                                        , config.optimalTextureSize));
-        const auto &lod(lodInfo.localLods[item.first]
-                        = tools::LodParams(item.second.extents
-                                           , std::round(bl)));
+        const vts::Lod lod(std::round(bl));
+        analysis.assign(*item.first, item.second.extents, lod);
         LOG(info3)
             << "Assigned LOD " << (item.first->nodeId().lod + lod)
             << " (local LOD " << lod
-            << ") for bottom depth (" << lodInfo.bottomDepth
+            << ") for bottom depth (" << analysis.bottomDepth
             << ") in subtree " << item.first->srs() << ".";
     }
 
-    return lodInfo;
+    return analysis;
 }
 
 // ------------------------------------------------------------------------
 
+/** Provides LODTree nodes to the cutting engine.
+ */
+class NodeReader : public vtstools::SourceReader {
+public:
+    NodeReader(const lodtree::LodTreeExport &archive
+               , const std::vector<const lodtree::Node*> &nodes
+               , const std::vector<double> &costs
+               , const tools::LodInfo &lodInfo, const Config &config)
+        : archive_(archive), nodes_(nodes), costs_(costs), lodInfo_(lodInfo)
+        , config_(config), inputSrs_(archive_.srs)
+    {}
+
+    virtual std::size_t size() const { return nodes_.size(); }
+
+    virtual std::string name(std::size_t index) const {
+        std::ostringstream os;
+        os << "LODTree node " << nodes_[index]->modelPath;
+        return os.str();
+    }
+
+    virtual const char* traceName() const { return "cutNode"; }
+
+    virtual const geo::SrsDefinition& srs(std::size_t) const {
+        return inputSrs_;
+    }
+
+    virtual vtstools::CutTarget::list targets(std::size_t index) const {
+        return vtstools::lodInfoTargets(lodInfo_, nodes_[index]->level);
+    }
+
+    virtual double cost(std::size_t index) const { return costs_[index]; }
+
+    virtual void load(std::size_t index, vtstools::SourceMesh &source) const;
+
+private:
+    const lodtree::LodTreeExport &archive_;
+    const std::vector<const lodtree::Node*> &nodes_;
+    const std::vector<double> &costs_;
+    const tools::LodInfo &lodInfo_;
+    const Config &config_;
+    const geo::SrsDefinition inputSrs_;
+};
+
+void NodeReader::load(std::size_t index, vtstools::SourceMesh &source) const
+{
+    const auto &node(*nodes_[index]);
+
+    // load geometry
+    vtstools::TextureStreams ts;
+    std::tie(source.mesh, ts) = loadModel(config_, archive_, node);
+
+    // load textures
+    for (const auto &is : ts) {
+        vtstools::TraceSpan span("loadTexture", is->path().string());
+        LOG(info1) << "Loading texture from " << is->path() << ".";
+        auto tex(cv::imdecode(is->read(), cv::IMREAD_COLOR));
+        source.atlas.add(tex);
+    }
+}
+
 class Cutter {
 public:
     Cutter(const Config &config, const vr::ReferenceFrame &rf
@@ -361,27 +550,11 @@ public:
            , const lodtree::LodTreeExport &archive)
         : config_(config), rf_(rf), tmpset_(tmpset), ntg_(ntg)
         , archive_(archive), nodes_(vts::NodeInfo::leaves(rf_))
-        , inputSrs_(archive_.srs)
     {}
 
     void run(vt::ExternalProgress &progress);
 
 private:
-    void cutNode(const lodtree::LodTreeNode &node
-                 , const tools::LodInfo &lodInfo);
-
-    void splitToTiles(const lodtree::Node &ltNode
-                      , const vts::NodeInfo &root
-                      , vts::Lod lod, const vts::TileRange &tr
-                      , const vts::Mesh &mesh
-                      , const vts::opencv::Atlas &atlas
-                      , vts::TileIndex::Flag::value_type tileFlags);
-
-    void cutTile(const lodtree::Node &ltNode, const vts::NodeInfo &node
-                 , const vts::Mesh &mesh
-                 , const vts::opencv::Atlas &atlas
-                 , vts::TileIndex::Flag::value_type tileFlags);
-
     const Config &config_;
     const vr::ReferenceFrame &rf_;
     tools::TmpTileset &tmpset_;
@@ -389,29 +562,18 @@ private:
     const lodtree::LodTreeExport &archive_;
 
     const vts::NodeInfo::list nodes_;
-    const geo::SrsDefinition inputSrs_;
 };
 
 void Cutter::run(vt::ExternalProgress &progress)
 {
     // load all available nodes
-    const auto ltNodes(archive_.nodes());
-
-    // analyze first
-    const auto lodInfo(analyze(progress, config_, nodes_, ltNodes, archive_));
-
-    // compute navtile information (adds accumulators)
-    for (const auto &item : lodInfo.localLods) {
-        tools::computeNavtileInfo(*item.first, item.second, lodInfo, ntg_
-                                  , config_.tileExtents
-                                  , config_.ntLodPixelSize);
-    }
-
-    // update progress
-    progress.expect(ltNodes.size());
+    const auto ltNodes([&]()
+    {
+        vtstools::TraceSpan span("lodTreeNodes");
+        return archive_.nodes();
+    }());
 
-    // convert node map to node (pointer) list (needed by OpenMP to iterate over
-    // nodes)
+    // convert node map to node (pointer) list (needed to iterate over nodes)
     auto nl([&]() -> std::vector<const lodtree::Node*>
     {
         std::vector<const lodtree::Node*> nl;
@@ -422,231 +584,28 @@ void Cutter::run(vt::ExternalProgress &progress)
         return nl;
     }());
 
-    const std::size_t nlSize(nl.size());
-    UTILITY_OMP(parallel for schedule(dynamic))
-    for (std::size_t i = 0; i < nlSize; ++i) {
-        const auto &node(*nl[i]);
-        cutNode(node, lodInfo);
-        ++progress;
-    }
-}
-
-void Cutter::cutNode(const lodtree::Node &node, const tools::LodInfo &lodInfo)
-{
-    const auto &roArchive(archive_.archive());
+    const auto costs(nodeCosts(archive_, nl));
 
-    Assimp::Importer imp;
-    imp.SetPropertyBool(AI_CONFIG_IMPORT_NO_SKELETON_MESHES, true);
+    // analyze first; sharded conversion analyzes only in the coordinator
+    const auto analysis(vtstools::shardedAnalysis
+                        (config_.sharding, nodes_, [&]()
+                         {
+                             return analyze(progress, config_, nodes_, nl
+                                            , costs, archive_);
+                         }));
+    if (!analysis) { return; }
+    const auto lodInfo(analysis->lodInfo());
 
-    // load geometry
-    vts::Mesh inMesh;
-    vts::opencv::Atlas inAtlas;
-
-    {
-        tools::TextureStreams ts;
-        std::tie(inMesh, ts) = tools::loadAssimpScene
-            (imp, roArchive, node.modelPath, node.origin);
-
-        // load textures
-        for (const auto &is : ts) {
-            LOG(info1) << "Loading texture from " << is->path() << ".";
-            auto tex(cv::imdecode(is->read(), cv::IMREAD_COLOR));
-            inAtlas.add(tex);
-        }
-    }
-
-    // for each valid rfnode
+    // compute navtile information (adds accumulators)
     for (const auto &item : lodInfo.localLods) {
-        const auto rfNode(*item.first);
-        const auto bottomLod(item.second);
-        const vts::CsConvertor conv(inputSrs_, rfNode.srs());
-
-        // compute local lod + sanity check
-        const auto fromBottom(lodInfo.bottomDepth - node.level);
-        if (fromBottom > bottomLod) {
-            // out of reference frame -> skip
-            continue;
-        }
-
-        const vts::Lod localLod(bottomLod - fromBottom);
-        const auto lod(localLod + rfNode.nodeId().lod);
-
-        /** (extra) Tile flags to be stored along generate tiles from this node
-         */
-        vts::TileIndex::Flag::value_type tileFlags(0);
-        if (node.level <= lodInfo.commonBottom) {
-            // mark all tiles not below common bottom level as watertight
-            tileFlags |= vts::TileIndex::Flag::watertight;
-
-            if (node.level == lodInfo.commonBottom) {
-                // mark all tiles at commom bottom level as alien
-                tileFlags |= vts::TileIndex::Flag::alien;
-            }
-        }
-
-        // projested mesh/atlas
-        vts::Mesh mesh;
-        vts::opencv::Atlas atlas;
-
-        // and for each submesh
-        std::size_t meshIndex(0);
-        for (auto &sm : inMesh) {
-            const auto &texture(inAtlas.get(meshIndex++));
-
-            // make all faces valid by default
-            vts::VertexMask valid(sm.vertices.size(), true);
-            math::Points3 projected;
-            projected.reserve(sm.vertices.size());
-
-            auto ivalid(valid.begin());
-            for (const auto &v : sm.vertices) {
-                try {
-                    projected.push_back(conv(v));
-                    // apply zShift
-                    if (config_.zShift) {
-                        projected.back()(2) += config_.zShift;
-                    }
-                    ++ivalid;
-                } catch (const std::exception&) {
-                    // failed to convert vertex, mask it and skip
-                    projected.emplace_back();
-                    *ivalid++ = false;
-                }
-            }
-
-            // clip mesh to node's extents
-            // FIXME: implement actual mask application in clipping!
-            vts::FaceOriginList faceOrigin;
-            auto osm(vts::clip(sm, projected, rfNode.extents(), valid
-                               , &faceOrigin));
-            if (osm.faces.empty()) { continue; }
-
-            // at least one face survived, remember
-
-            mesh.submeshes.push_back(std::move(osm));
-            atlas.add(texture);
-        }
-
-        // anything there?
-        if (mesh.empty()) {
-            continue;
-        }
-
-        // compute local tile range
-        auto tr(tools::computeTileRange(rfNode.extents(), localLod
-                                        , tools::computeExtents(mesh)));
-
-        // convert local tilerange to global tilerange
-        {
-            const auto origin
-                (vts::lowestChild(vts::point(rfNode.nodeId()), localLod));
-            tr.ll += origin;
-            tr.ur += origin;
-        }
-
-        // split to tiles
-        LOG(info3) << "Splitting LODTree node " << node.modelPath
-                   << " to tiles in "
-                   << lod << "/" << tr << ".";
-        splitToTiles(node, rfNode, lod, tr, mesh, atlas, tileFlags);
-    }
-}
-
-void Cutter::splitToTiles(const lodtree::Node &ltNode
-                          , const vts::NodeInfo &root
-                          , vts::Lod lod, const vts::TileRange &tr
-                          , const vts::Mesh &mesh
-                          , const vts::opencv::Atlas &atlas
-                          , vts::TileIndex::Flag::value_type tileFlags)
-{
-    if (config_.tileExtents) {
-        // check for range validity
-        const auto &rootId(root.nodeId());
-        if (lod < config_.tileExtents->lod) {
-            LOG(info2)
-                << "Nothing to cut from LODTree node "
-                << ltNode.modelPath << ".";
-        }
-
-        const auto gtr(vts::global(rootId, lod, tr));
-        const auto extents(vts::shiftRange(*config_.tileExtents, lod));
-
-        if (!vts::tileRangesOverlap(gtr, extents)) {
-            LOG(info2)
-                << "Nothing to cut from LODTree node " << ltNode.modelPath
-                << ", gtr: " << gtr << ", extents: " << extents << ".";
-            return;
-        }
-    }
-
-    typedef vts::TileRange::value_type Index;
-    Index je(tr.ur(1));
-    Index ie(tr.ur(0));
-
-    for (Index j = tr.ll(1); j <= je; ++j) {
-        for (Index i = tr.ll(0); i <= ie; ++i) {
-            vts::TileId tileId(lod, i, j);
-            const auto node(root.child(tileId));
-            cutTile(ltNode, node, mesh, atlas, tileFlags);
-        }
-    }
-}
-
-void Cutter::cutTile(const lodtree::Node &ltNode, const vts::NodeInfo &node
-                     , const vts::Mesh &mesh
-                     , const vts::opencv::Atlas &atlas
-                     , vts::TileIndex::Flag::value_type tileFlags)
-{
-
-    // compute border condition (defaults to all available)
-    vts::BorderCondition borderCondition;
-    if (config_.tileExtents) {
-        borderCondition = vts::inside(*config_.tileExtents, node.nodeId());
-        if (!borderCondition) {
-            LOG(info1)
-                << node.nodeId() << ": Nothing to cut from LODTree node "
-                << ltNode.modelPath << ".";
-            return;
-        }
-    }
-
-    // compute clip extents
-    const auto extents(vts::inflateTileExtents
-                       (node.extents(), config_.clipMargin
-                        , borderCondition, config_.borderClipMargin));
-
-    vts::Mesh clipped;
-    vts::opencv::Atlas clippedAtlas(0); // PNG!
-
-    std::size_t smIndex(0);
-    std::size_t faces(0);
-    for (const auto &sm : mesh) {
-        const auto &texture(atlas.get(smIndex++));
-
-        auto m(vts::clip(sm, extents));
-        if (m.empty()) { continue; }
-
-        clipped.submeshes.push_back(std::move(m));
-        clippedAtlas.add(texture);
-        faces += clipped.submeshes.back().faces.size();
-    }
-
-    if (clipped.empty()) {
-        LOG(info1)
-            << node.nodeId() << ": Nothing cut from LODTree node "
-            << ltNode.modelPath << ".";
-        return;
+        tools::computeNavtileInfo(*item.first, item.second, lodInfo, ntg_
+                                  , config_.tileExtents
+                                  , config_.ntLodPixelSize);
     }
 
-    LOG(info2)
-        << node.nodeId() << ": Cut " << faces
-        << " faces from LODTree node " << ltNode.modelPath << ".";
-
-    // store in temporary storage
-    const auto tileId(node.nodeId());
-
-    tools::repack(tileId, clipped, clippedAtlas);
-    tmpset_.store(tileId, clipped, clippedAtlas, tileFlags);
+    vtstools::CutEngine(config_, tmpset_)
+        .run(NodeReader(archive_, nl, costs, lodInfo, config_)
+             , progress);
 }
 
 // ------------------------------------------------------------------------
@@ -677,6 +636,12 @@ public:
             .run(progress());
     }
 
+    /** Keeps cut tiles for the shard coordinator.
+     */
+    void finishShard(const boost::filesystem::path &path) {
+        vtstools::finishShard(path, tmpset(), ntg());
+    }
+
 private:
     const ::Config config_;
 };
@@ -696,14 +661,48 @@ int LodTree2Vts::run()
         }
 
         // parse the XMLs
-        input = boost::in_place(input_, offset);
+        //
+        // NB: liblodtree parses the whole export (all per-block XMLs) here,
+        // in one thread; there is no block-level API to parse blocks in
+        // parallel or to hand them out as they come. Analysis could not
+        // start early anyway: it needs common bottom depth of all nodes.
+        {
+            vtstools::TraceSpan span("parseLodTree", input_.string());
+            input = boost::in_place(input_, offset);
+        }
 
         // TODO: sanity check
     }
 
+    if (config_.sharding.coordinator() && !config_.resume) {
+        // analyze input once (creates output), cut in worker processes, then
+        // generate from merged tiles
+        config_.sharding.analysis = vtstools::shardAnalysis(output_);
+        {
+            Encoder analyzer(output_, properties, createMode_, config_
+                             , vt::ExternalProgress::Config(epConfig_)
+                             , input);
+        }
+        vtstools::ShardCoordinator(output_, config_.tileExtents
+                                   , config_.sharding, config_.keepTmpset)
+            .run();
+        config_.resume = true;
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     // run the encoder
-    Encoder(output_, properties, createMode_, config_
-            , std::move(epConfig_), input).run();
+    Encoder encoder(output_, properties, createMode_, config_
+                    , std::move(epConfig_), input);
+
+    if (config_.sharding.worker) {
+        encoder.finishShard(output_);
+    } else {
+        vtstools::ScopedPhase phase(vtstools::Phase::generate);
+        encoder.run();
+    }
+
+    vtstools::writeMetrics(config_.sharding.worker);
+    vtstools::writeTrace(config_.sharding.worker);
 
     // all done
     LOG(info4) << "All done.";
@@ -715,6 +714,7 @@ int LodTree2Vts::run()
 int main(int argc, char *argv[])
 {
     utility::unlimitedCoredump();
+    vtstools::saveCommandLine(argc, argv);
     return LodTree2Vts()(argc, argv);
 }
 
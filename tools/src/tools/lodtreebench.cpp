@@ -0,0 +1,397 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** Benchmark of LODTree model loading.
+ *
+ *  Loads models of LODTree export nodes through Assimp (the generic loader
+ *  lodtree2vts used to use exclusively) and through native loaders, single
+ *  threaded, and reports per-node load time statistics of both as JSON.
+ *  Textures are opened but not read.
+ *
+ *  An untimed warm-up round gives both loaders the same (warm) file cache
+ *  and determines nodes both loaders can load; only these are timed, in
+ *  several rounds with alternating loader order. Loaded meshes are compared
+ *  by face count, surface area and texture coordinate area.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+#include <boost/filesystem.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "utility/buildsys.hpp"
+#include "utility/gccversion.hpp"
+#include "utility/limits.hpp"
+
+#include "service/cmdline.hpp"
+
+#include "jsoncpp/json.hpp"
+
+#include "lodtree/lodtreefile.hpp"
+
+#include "vts-libs/tools-support/assimp.hpp"
+
+#include "modelloader.hpp"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+namespace vts = vtslibs::vts;
+namespace tools = vtslibs::vts::tools;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/** Loads one node's model.
+ */
+typedef std::function<vts::Mesh(const lodtree::Node&)> Loader;
+
+/** Mesh summary independent of vertex order and submesh split; compares
+ *  meshes produced by different loaders.
+ */
+struct Summary {
+    std::size_t faces;
+    double area;
+    double tcArea;
+
+    Summary() : faces(), area(), tcArea() {}
+};
+
+template <typename Point>
+double triangleArea(const Point &a, const Point &b, const Point &c)
+{
+    const double ux(b(0) - a(0)), uy(b(1) - a(1)), uz(b(2) - a(2));
+    const double vx(c(0) - a(0)), vy(c(1) - a(1)), vz(c(2) - a(2));
+    const double x(uy * vz - uz * vy), y(uz * vx - ux * vz)
+        , z(ux * vy - uy * vx);
+    return std::sqrt(x * x + y * y + z * z) / 2.0;
+}
+
+Summary summarize(const vts::Mesh &mesh)
+{
+    Summary summary;
+    for (const auto &sm : mesh.submeshes) {
+        summary.faces += sm.faces.size();
+        for (const auto &face : sm.faces) {
+            summary.area += triangleArea(sm.vertices[face(0)]
+                                         , sm.vertices[face(1)]
+                                         , sm.vertices[face(2)]);
+        }
+        for (const auto &face : sm.facesTc) {
+            const auto &a(sm.tc[face(0)]);
+            const auto &b(sm.tc[face(1)]);
+            const auto &c(sm.tc[face(2)]);
+            summary.tcArea += std::abs((b(0) - a(0)) * (c(1) - a(1))
+                                       - (c(0) - a(0)) * (b(1) - a(1)))
+                / 2.0;
+        }
+    }
+    return summary;
+}
+
+/** Relative difference of two non-negative values.
+ */
+double difference(double a, double b)
+{
+    const auto scale(std::max(std::abs(a), std::abs(b)));
+    return scale ? (std::abs(a - b) / scale) : 0.0;
+}
+
+struct Statistics {
+    double total;
+    double mean;
+    double median;
+    double p95;
+    double max;
+};
+
+Statistics statistics(std::vector<double> times)
+{
+    std::sort(times.begin(), times.end());
+    const auto percentile([&](double p) -> double
+    {
+        if (times.empty()) { return 0.0; }
+        return times[std::size_t(p * (times.size() - 1))];
+    });
+
+    Statistics s;
+    s.total = 0.0;
+    for (auto time : times) { s.total += time; }
+    s.mean = times.empty() ? 0.0 : (s.total / times.size());
+    s.median = percentile(0.5);
+    s.p95 = percentile(0.95);
+    s.max = percentile(1.0);
+    return s;
+}
+
+class LodTreeBench : public service::Cmdline
+{
+public:
+    LodTreeBench()
+        : service::Cmdline("vts-tools-lodtreebench", BUILD_TARGET_VERSION)
+        , limit_(), rounds_(3), tolerance_(1e-6)
+    {}
+
+private:
+    virtual void configuration(po::options_description &cmdline
+                               , po::options_description &config
+                               , po::positional_options_description &pd)
+        UTILITY_OVERRIDE;
+
+    virtual void configure(const po::variables_map &vars)
+        UTILITY_OVERRIDE;
+
+    virtual bool help(std::ostream &out, const std::string &what) const
+        UTILITY_OVERRIDE;
+
+    virtual int run() UTILITY_OVERRIDE;
+
+    fs::path input_;
+    fs::path output_;
+    std::size_t limit_;
+    std::size_t rounds_;
+    double tolerance_;
+};
+
+void LodTreeBench::configuration(po::options_description &cmdline
+                                 , po::options_description &config
+                                 , po::positional_options_description &pd)
+{
+    cmdline.add_options()
+        ("input", po::value(&input_)->required()
+         , "Path to input LODTree export.")
+        ("output", po::value(&output_)
+         , "Path to JSON report. Written to stdout if not set.")
+        ("limit", po::value(&limit_)->default_value(limit_)
+         , "Load at most this number of nodes (evenly sampled). "
+         "0 means all nodes.")
+        ("rounds", po::value(&rounds_)->default_value(rounds_)
+         , "Number of timed rounds; per-node median time is reported.")
+        ("tolerance", po::value(&tolerance_)->default_value(tolerance_)
+         , "Relative tolerance of mesh comparison (surface and texture "
+         "coordinate area).")
+        ;
+
+    pd.add("input", 1);
+
+    (void) config;
+}
+
+void LodTreeBench::configure(const po::variables_map &vars)
+{
+    (void) vars;
+
+    // at least one timed round
+    rounds_ = std::max<std::size_t>(rounds_, 1);
+}
+
+bool LodTreeBench::help(std::ostream &out, const std::string &what) const
+{
+    if (what.empty()) {
+        out << R"RAW(vts-tools-lodtreebench
+usage
+    vts-tools-lodtreebench INPUT [OPTIONS]
+
+Loads models of all (or --limit evenly sampled) nodes of LODTree export
+through Assimp ("assimp") and through native loaders ("native") and reports
+per-node load time statistics of both.
+
+An untimed warm-up round loads every node with both loaders; nodes either
+loader fails on are counted as failed and excluded. Remaining nodes are
+loaded in --rounds timed rounds, loader order alternating between nodes and
+rounds, and both loaders' meshes are compared.
+
+)RAW";
+    }
+    return false;
+}
+
+int LodTreeBench::run()
+{
+    const lodtree::LodTreeExport archive(input_, math::Point3(0, 0, 0));
+
+    const auto all(archive.nodes());
+    std::vector<const lodtree::Node*> nodes;
+    {
+        const std::size_t step((limit_ && (all.size() > limit_))
+                               ? (all.size() / limit_) : 1);
+        std::size_t i(0);
+        for (const auto &node : all) {
+            if (!(i++ % step)) { nodes.push_back(&node); }
+        }
+    }
+
+    LOG(info3) << "Loading " << nodes.size() << " models from "
+               << input_ << ".";
+
+    const Loader assimpLoader([&](const lodtree::Node &node) -> vts::Mesh
+    {
+        Assimp::Importer imp;
+        imp.SetPropertyBool(AI_CONFIG_IMPORT_NO_SKELETON_MESHES, true);
+        return std::get<0>(tools::loadAssimpScene
+                           (imp, archive.archive(), node.modelPath
+                            , node.origin));
+    });
+
+    const Loader nativeLoader([&](const lodtree::Node &node) -> vts::Mesh
+    {
+        return vtstools::loadNativeModel
+            (archive.archive(), node.modelPath, node.origin).mesh;
+    });
+
+    const std::pair<const char*, Loader> loaders[2] = {
+        { "assimp", assimpLoader }, { "native", nativeLoader }
+    };
+
+    // warm-up: equal file cache state for both loaders, common node subset
+    // and mesh comparison
+    std::size_t failed[2] = { 0, 0 };
+    std::vector<const lodtree::Node*> common;
+    std::size_t mismatched(0);
+    double maxAreaDiff(0.0), maxTcAreaDiff(0.0);
+    for (const auto *node : nodes) {
+        Summary summaries[2];
+        bool ok(true);
+        for (int l(0); l < 2; ++l) {
+            try {
+                summaries[l] = summarize(loaders[l].second(*node));
+            } catch (const std::exception &e) {
+                LOG(info2) << loaders[l].first << ": cannot load "
+                           << node->modelPath << " (" << e.what() << ").";
+                ++failed[l];
+                ok = false;
+            }
+        }
+        if (!ok) { continue; }
+        common.push_back(node);
+
+        const auto areaDiff(difference(summaries[0].area
+                                       , summaries[1].area));
+        const auto tcAreaDiff(difference(summaries[0].tcArea
+                                         , summaries[1].tcArea));
+        maxAreaDiff = std::max(maxAreaDiff, areaDiff);
+        maxTcAreaDiff = std::max(maxTcAreaDiff, tcAreaDiff);
+        if ((summaries[0].faces != summaries[1].faces)
+            || (areaDiff > tolerance_) || (tcAreaDiff > tolerance_))
+        {
+            LOG(warn2) << "Loaders differ on " << node->modelPath
+                       << ": faces " << summaries[0].faces << "/"
+                       << summaries[1].faces << ", area difference "
+                       << areaDiff << ", tc area difference "
+                       << tcAreaDiff << ".";
+            ++mismatched;
+        }
+    }
+
+    LOG(info3) << "Timing " << common.size() << " models loaded by both "
+               << "loaders in " << rounds_ << " rounds.";
+
+    // timed rounds, per node times
+    std::vector<std::vector<double>> times[2];
+    times[0].resize(common.size());
+    times[1].resize(common.size());
+    for (std::size_t round(0); round < rounds_; ++round) {
+        for (std::size_t n(0), e(common.size()); n != e; ++n) {
+            for (int o(0); o < 2; ++o) {
+                const int l((o + n + round) % 2);
+                const auto start(Clock::now());
+                loaders[l].second(*common[n]);
+                times[l][n].push_back(std::chrono::duration<double>
+                                      (Clock::now() - start).count());
+            }
+        }
+    }
+
+    Json::Value report(Json::objectValue);
+    report["benchmark"] = "vts-tools-lodtreebench";
+    report["version"] = BUILD_TARGET_VERSION;
+    report["input"] = input_.string();
+    report["nodes"] = Json::UInt64(nodes.size());
+    report["common"] = Json::UInt64(common.size());
+    report["rounds"] = Json::UInt64(rounds_);
+    auto &runs(report["runs"] = Json::arrayValue);
+
+    for (int l(0); l < 2; ++l) {
+        // per-node median over rounds
+        std::vector<double> medians;
+        for (auto &nodeTimes : times[l]) {
+            std::sort(nodeTimes.begin(), nodeTimes.end());
+            medians.push_back(nodeTimes[nodeTimes.size() / 2]);
+        }
+        const auto stats(statistics(medians));
+
+        auto &run(runs.append(Json::objectValue));
+        run["loader"] = loaders[l].first;
+        run["failed"] = Json::UInt64(failed[l]);
+        run["total"] = stats.total;
+        run["mean"] = stats.mean;
+        run["median"] = stats.median;
+        run["p95"] = stats.p95;
+        run["max"] = stats.max;
+
+        LOG(info3) << loaders[l].first << ": " << medians.size()
+                   << " models in " << stats.total << " s, median "
+                   << stats.median << " s per model.";
+    }
+
+    auto &comparison(report["comparison"] = Json::objectValue);
+    comparison["compared"] = Json::UInt64(common.size());
+    comparison["mismatched"] = Json::UInt64(mismatched);
+    comparison["maxAreaDifference"] = maxAreaDiff;
+    comparison["maxTcAreaDifference"] = maxTcAreaDiff;
+
+    if (output_.empty()) {
+        Json::StyledStreamWriter().write(std::cout, report);
+    } else {
+        std::ofstream f(output_.string());
+        Json::StyledStreamWriter().write(f, report);
+        f.close();
+        if (!f) {
+            LOG(fatal) << "Unable to write report to " << output_ << ".";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    utility::unlimitedCoredump();
+    return LodTreeBench()(argc, argv);
+}
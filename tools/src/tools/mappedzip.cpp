@@ -0,0 +1,361 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cstring>
+#include <algorithm>
+#include <system_error>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "mappedzip.hpp"
+
+namespace bio = boost::iostreams;
+
+namespace vtstools {
+
+namespace {
+
+const std::uint32_t LocalHeaderSignature(0x04034b50);
+const std::uint32_t CentralHeaderSignature(0x02014b50);
+const std::uint32_t EndSignature(0x06054b50);
+const std::uint32_t Zip64EndSignature(0x06064b50);
+const std::uint32_t Zip64LocatorSignature(0x07064b50);
+
+const std::size_t LocalHeaderSize(30);
+const std::size_t CentralHeaderSize(46);
+const std::size_t EndSize(22);
+const std::size_t Zip64EndSize(56);
+const std::size_t Zip64LocatorSize(20);
+
+const std::uint16_t MethodStored(0);
+const std::uint16_t MethodDeflated(8);
+
+/** Little-endian field reader.
+ */
+template <typename T>
+T get(const char *p)
+{
+    T value(0);
+    for (std::size_t i(sizeof(T)); i; --i) {
+        value = T((value << 8) | std::uint8_t(p[i - 1]));
+    }
+    return value;
+}
+
+} // namespace
+
+MappedZip::MappedZip(const boost::filesystem::path &path)
+    : path_(path), mapping_(), size_()
+{
+    const auto fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        std::system_error e(errno, std::system_category());
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to open " << path << ": <" << e.code()
+            << ", " << e.what() << ">.";
+    }
+
+    struct ::stat st;
+    if (::fstat(fd, &st) < 0) {
+        std::system_error e(errno, std::system_category());
+        ::close(fd);
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to stat " << path << ": <" << e.code()
+            << ", " << e.what() << ">.";
+    }
+    size_ = st.st_size;
+
+    if (size_) {
+        auto *m(::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0));
+        if (m == MAP_FAILED) {
+            std::system_error e(errno, std::system_category());
+            ::close(fd);
+            LOGTHROW(err2, std::runtime_error)
+                << "Unable to map " << path << ": <" << e.code()
+                << ", " << e.what() << ">.";
+        }
+        mapping_ = static_cast<const char*>(m);
+    }
+    ::close(fd);
+
+    try {
+        index();
+    } catch (...) {
+        if (mapping_) {
+            ::munmap(const_cast<char*>(mapping_), size_);
+        }
+        throw;
+    }
+
+    LOG(info2) << "Indexed " << entries_.size() << " entries in ZIP archive "
+               << path << ".";
+}
+
+MappedZip::~MappedZip()
+{
+    if (mapping_) {
+        ::munmap(const_cast<char*>(mapping_), size_);
+    }
+}
+
+void MappedZip::index()
+{
+    // find end of central directory record (followed by up to 64k comment)
+    if (size_ < EndSize) {
+        LOGTHROW(err2, std::runtime_error)
+            << "File " << path_ << " is not a ZIP archive.";
+    }
+
+    const char *end(nullptr);
+    {
+        const std::size_t limit(std::min<std::size_t>(size_, EndSize + 65535));
+        for (std::size_t back(EndSize); back <= limit; ++back) {
+            const auto *p(mapping_ + size_ - back);
+            if (get<std::uint32_t>(p) == EndSignature) {
+                end = p;
+                break;
+            }
+        }
+    }
+
+    if (!end) {
+        LOGTHROW(err2, std::runtime_error)
+            << "No end of central directory found in " << path_ << ".";
+    }
+
+    std::uint64_t count(get<std::uint16_t>(end + 10));
+    std::uint64_t cdSize(get<std::uint32_t>(end + 12));
+    std::uint64_t cdOffset(get<std::uint32_t>(end + 16));
+
+    // ZIP64 end of central directory locator precedes the end record
+    if ((std::size_t(end - mapping_) >= Zip64LocatorSize)
+        && (get<std::uint32_t>(end - Zip64LocatorSize)
+            == Zip64LocatorSignature))
+    {
+        const auto offset(get<std::uint64_t>(end - Zip64LocatorSize + 8));
+        if ((offset + Zip64EndSize > size_)
+            || (get<std::uint32_t>(mapping_ + offset) != Zip64EndSignature))
+        {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid ZIP64 end of central directory in "
+                << path_ << ".";
+        }
+        const auto *end64(mapping_ + offset);
+        count = get<std::uint64_t>(end64 + 32);
+        cdSize = get<std::uint64_t>(end64 + 40);
+        cdOffset = get<std::uint64_t>(end64 + 48);
+    }
+
+    if (cdOffset + cdSize > size_) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Central directory out of file bounds in " << path_ << ".";
+    }
+
+    entries_.reserve(count);
+    const auto *p(mapping_ + cdOffset);
+    const auto *cdEnd(p + cdSize);
+    for (std::uint64_t i(0); i != count; ++i) {
+        if ((p + CentralHeaderSize > cdEnd)
+            || (get<std::uint32_t>(p) != CentralHeaderSignature))
+        {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid central directory entry #" << i << " in "
+                << path_ << ".";
+        }
+
+        const auto nameSize(get<std::uint16_t>(p + 28));
+        const auto extraSize(get<std::uint16_t>(p + 30));
+        const auto commentSize(get<std::uint16_t>(p + 32));
+        const auto *next(p + CentralHeaderSize + nameSize + extraSize
+                         + commentSize);
+        if (next > cdEnd) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid central directory entry #" << i << " in "
+                << path_ << ".";
+        }
+
+        Entry entry;
+        entry.name.assign(p + CentralHeaderSize, nameSize);
+        entry.method = get<std::uint16_t>(p + 10);
+        entry.compressedSize = get<std::uint32_t>(p + 20);
+        entry.size = get<std::uint32_t>(p + 24);
+        entry.headerOffset = get<std::uint32_t>(p + 42);
+
+        // ZIP64 extended information: only saturated fields are present
+        const auto *extra(p + CentralHeaderSize + nameSize);
+        const auto *extraEnd(extra + extraSize);
+        while (extra + 4 <= extraEnd) {
+            const auto id(get<std::uint16_t>(extra));
+            const auto size(get<std::uint16_t>(extra + 2));
+            const auto *field(extra + 4);
+            extra = field + size;
+            if ((id != 0x0001) || (extra > extraEnd)) { continue; }
+
+            const auto wide([&](std::uint64_t &value) {
+                if ((value != 0xffffffff) || (field + 8 > extra)) { return; }
+                value = get<std::uint64_t>(field);
+                field += 8;
+            });
+            wide(entry.size);
+            wide(entry.compressedSize);
+            wide(entry.headerOffset);
+        }
+
+        // skip directories
+        if (!entry.name.empty() && (entry.name.back() != '/')) {
+            entries_.push_back(std::move(entry));
+        }
+        p = next;
+    }
+
+    std::sort(entries_.begin(), entries_.end()
+              , [](const Entry &l, const Entry &r) { return l.name < r.name; });
+}
+
+const MappedZip::Entry* MappedZip::find(const std::string &name) const
+{
+    auto ientries(std::lower_bound
+                  (entries_.begin(), entries_.end(), name
+                   , [](const Entry &e, const std::string &name) {
+                       return e.name < name;
+                   }));
+    if ((ientries == entries_.end()) || (ientries->name != name)) {
+        return nullptr;
+    }
+    return &*ientries;
+}
+
+std::vector<const MappedZip::Entry*>
+MappedZip::list(const std::string &prefix) const
+{
+    std::vector<const Entry*> out;
+    auto ientries(std::lower_bound
+                  (entries_.begin(), entries_.end(), prefix
+                   , [](const Entry &e, const std::string &prefix) {
+                       return e.name < prefix;
+                   }));
+    for (; ientries != entries_.end(); ++ientries) {
+        if (ientries->name.compare(0, prefix.size(), prefix)) { break; }
+        out.push_back(&*ientries);
+    }
+    return out;
+}
+
+const char* MappedZip::raw(const Entry &entry) const
+{
+    // local header's extra field may differ from the central one
+    const auto offset(entry.headerOffset);
+    if ((offset + LocalHeaderSize > size_)
+        || (get<std::uint32_t>(mapping_ + offset) != LocalHeaderSignature))
+    {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid local header of entry <" << entry.name << "> in "
+            << path_ << ".";
+    }
+
+    const auto dataOffset
+        (offset + LocalHeaderSize
+         + get<std::uint16_t>(mapping_ + offset + 26)
+         + get<std::uint16_t>(mapping_ + offset + 28));
+    if ((dataOffset > size_) || (entry.compressedSize > size_ - dataOffset))
+    {
+        LOGTHROW(err2, std::runtime_error)
+            << "Data of entry <" << entry.name << "> out of bounds of "
+            << path_ << ".";
+    }
+
+    switch (entry.method) {
+    case MethodStored:
+        if (entry.size != entry.compressedSize) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Stored entry <" << entry.name << "> in " << path_
+                << " has different size (" << entry.size
+                << ") and compressed size (" << entry.compressedSize
+                << ").";
+        }
+        break;
+
+    case MethodDeflated:
+        break;
+
+    default:
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported compression method " << entry.method
+            << " of entry <" << entry.name << "> in " << path_ << ".";
+    }
+
+    return mapping_ + dataOffset;
+}
+
+MappedZip::Data MappedZip::data(const Entry &entry) const
+{
+    return head(entry, entry.size);
+}
+
+MappedZip::Data MappedZip::head(const Entry &entry, std::size_t size) const
+{
+    const auto *raw(this->raw(entry));
+    size = std::min<std::uint64_t>(size, entry.size);
+
+    Data data;
+    if (entry.method == MethodStored) {
+        data.data = raw;
+        data.size = size;
+        return data;
+    }
+
+    // raw deflate stream, inflated in this thread up to requested size
+    data.buffer = std::make_shared<std::vector<char>>(size);
+    {
+        bio::zlib_params params;
+        params.noheader = true;
+        bio::filtering_istream is;
+        is.push(bio::zlib_decompressor(params));
+        is.push(bio::array_source(raw, entry.compressedSize));
+        is.read(data.buffer->data(), size);
+        if (std::size_t(is.gcount()) != size) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Unable to inflate entry <" << entry.name << "> in "
+                << path_ << ".";
+        }
+    }
+
+    data.data = data.buffer->data();
+    data.size = data.buffer->size();
+    return data;
+}
+
+} // namespace vtstools
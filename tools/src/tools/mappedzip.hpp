@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_mappedzip_hpp_included_
+#define vts_tools_mappedzip_hpp_included_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <boost/filesystem/path.hpp>
+
+/** Read-only memory mapped ZIP archive (e.g. SLPK package).
+ *
+ *  Central directory is indexed once on open (ZIP64 included). Entry data
+ *  are accessed without any locking: stored entries are served directly from
+ *  the mapping (zero-copy), deflated entries are inflated in the calling
+ *  thread.
+ */
+namespace vtstools {
+
+class MappedZip {
+public:
+    MappedZip(const boost::filesystem::path &path);
+    ~MappedZip();
+
+    MappedZip(const MappedZip&) = delete;
+    MappedZip& operator=(const MappedZip&) = delete;
+
+    struct Entry {
+        std::string name;
+        std::uint16_t method;
+        std::uint64_t headerOffset;
+        std::uint64_t compressedSize;
+        std::uint64_t size;
+
+        typedef std::vector<Entry> list;
+    };
+
+    /** Entry data. Points either into the mapping or into owned buffer.
+     */
+    struct Data {
+        const char *data;
+        std::size_t size;
+
+        /** Set for inflated entries.
+         */
+        std::shared_ptr<std::vector<char>> buffer;
+
+        Data() : data(), size() {}
+    };
+
+    /** Finds entry by its full name. Returns nullptr if not found.
+     */
+    const Entry* find(const std::string &name) const;
+
+    /** All entries whose name starts with given prefix, ordered by name.
+     */
+    std::vector<const Entry*> list(const std::string &prefix) const;
+
+    /** Returns entry's (uncompressed) data.
+     */
+    Data data(const Entry &entry) const;
+
+    /** Returns first (up to) size bytes of entry's uncompressed data;
+     *  deflated entry is inflated only that far.
+     */
+    Data head(const Entry &entry, std::size_t size) const;
+
+    const boost::filesystem::path& path() const { return path_; }
+
+    const Entry::list& entries() const { return entries_; }
+
+private:
+    void index();
+
+    /** Validates entry's local header and bounds, returns pointer to its
+     *  (compressed) data.
+     */
+    const char* raw(const Entry &entry) const;
+
+    boost::filesystem::path path_;
+    const char *mapping_;
+    std::size_t size_;
+
+    /** Sorted by name.
+     */
+    Entry::list entries_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_mappedzip_hpp_included_
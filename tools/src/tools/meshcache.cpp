@@ -0,0 +1,448 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "meshcache.hpp"
+#include "trace.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace vtstools {
+
+namespace {
+
+/** Entry file signatures and format version. Bump version whenever mesh
+ *  decoding, optimization or entry layout changes.
+ */
+const char MeshMagic[4] = { 'V', 'T', 'M', 'C' };
+const char InfoMagic[4] = { 'V', 'T', 'M', 'I' };
+const std::uint32_t Version(2);
+
+typedef decltype(vts::SubMesh::faces) Faces;
+
+std::uint64_t fnv1a(const char *data, std::size_t size
+                    , std::uint64_t hash = 0xcbf29ce484222325ull)
+{
+    for (const char *end(data + size); data != end; ++data) {
+        hash ^= std::uint8_t(*data);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+class Writer {
+public:
+    Writer(std::ostream &os) : os_(os) {}
+
+    template <typename T> void value(const T &value) {
+        os_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void size(std::size_t value) { this->value(std::uint32_t(value)); }
+
+    void bytes(const char *data, std::size_t size) {
+        value(std::uint64_t(size));
+        os_.write(data, size);
+    }
+
+    void header(const char (&magic)[4]) {
+        os_.write(magic, sizeof(magic));
+        value(Version);
+    }
+
+    void mesh(const vts::Mesh &mesh) {
+        size(mesh.submeshes.size());
+        for (const auto &sm : mesh.submeshes) {
+            size(sm.vertices.size());
+            for (const auto &v : sm.vertices) {
+                value(v(0)); value(v(1)); value(v(2));
+            }
+
+            size(sm.tc.size());
+            for (const auto &t : sm.tc) { value(t(0)); value(t(1)); }
+
+            faces(sm.faces);
+            faces(sm.facesTc);
+        }
+    }
+
+private:
+    void faces(const Faces &faces) {
+        size(faces.size());
+        for (const auto &face : faces) {
+            for (int j : { 0, 1, 2 }) { value(std::uint32_t(face(j))); }
+        }
+    }
+
+    std::ostream &os_;
+};
+
+/** Reads from memory, throws on reading past the end.
+ */
+class Reader {
+public:
+    Reader(const std::vector<char> &data)
+        : p_(data.data()), end_(data.data() + data.size())
+    {}
+
+    template <typename T> void value(T &value) {
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+    }
+
+    std::size_t size() {
+        std::uint32_t value;
+        this->value(value);
+        return value;
+    }
+
+    const char* bytes(std::size_t &size) {
+        std::uint64_t value;
+        this->value(value);
+        size = value;
+        return take(size);
+    }
+
+    void header(const char (&magic)[4]) {
+        std::uint32_t version;
+        const auto *m(take(sizeof(magic)));
+        value(version);
+        if (std::memcmp(m, magic, sizeof(magic)) || (version != Version)) {
+            throw std::runtime_error("unknown format");
+        }
+    }
+
+    void mesh(vts::Mesh &mesh) {
+        for (auto count(size()); count; --count) {
+            mesh.submeshes.emplace_back();
+            auto &sm(mesh.submeshes.back());
+
+            sm.vertices.resize(size());
+            for (auto &v : sm.vertices) {
+                value(v(0)); value(v(1)); value(v(2));
+            }
+
+            sm.tc.resize(size());
+            for (auto &t : sm.tc) { value(t(0)); value(t(1)); }
+
+            faces(sm.faces);
+            faces(sm.facesTc);
+        }
+    }
+
+    void end() const {
+        if (p_ != end_) { throw std::runtime_error("trailing data"); }
+    }
+
+private:
+    void faces(Faces &faces) {
+        faces.resize(size());
+        for (auto &face : faces) {
+            for (int j : { 0, 1, 2 }) {
+                std::uint32_t index;
+                value(index);
+                face(j) = index;
+            }
+        }
+    }
+
+    const char* take(std::size_t size) {
+        if (size > std::size_t(end_ - p_)) {
+            throw std::runtime_error("truncated entry");
+        }
+        const auto p(p_);
+        p_ += size;
+        return p;
+    }
+
+    const char *p_;
+    const char *end_;
+};
+
+} // namespace
+
+DiskCache::DiskCache(const fs::path &root, const std::string &name
+                     , const std::string &extension)
+    : root_(root), name_(name), extension_(extension)
+    , hits_(0), misses_(0), stored_(0)
+{}
+
+DiskCache::~DiskCache()
+{
+    if (!enabled()) { return; }
+
+    LOG(info2)
+        << name_ << " " << root_ << ": " << hits_ << " hits, "
+        << misses_ << " misses, " << stored_ << " stored.";
+}
+
+std::string DiskCache::key(const std::string &uri
+                           , const char *data, std::size_t size
+                           , const std::string &options)
+{
+    std::ostringstream os;
+    os << std::hex << std::setfill('0')
+       << std::setw(16) << fnv1a(uri.data(), uri.size()
+                                 , fnv1a(options.data(), options.size()))
+       << '-' << std::setw(16) << fnv1a(data, size);
+    return os.str();
+}
+
+std::string DiskCache::fileIdentity(const fs::path &file)
+{
+    struct ::stat st;
+    if (::stat(file.c_str(), &st) == -1) {
+        std::system_error e(errno, std::system_category());
+        LOG(warn2) << "Unable to stat " << file << " for cache key: <"
+                   << e.code() << ", " << e.what() << ">.";
+        return {};
+    }
+
+    // path, size and modification time (ns)
+    std::ostringstream os;
+    os << fs::absolute(file).string() << '\0' << st.st_size << '\0'
+       << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec;
+    return os.str();
+}
+
+std::string DiskCache::fileKey(const fs::path &file, const std::string &uri
+                               , const std::string &options)
+{
+    const auto identity(fileIdentity(file));
+    if (identity.empty()) { return {}; }
+    return key(uri, identity.data(), identity.size(), options);
+}
+
+fs::path DiskCache::contentFile(const fs::path &input, const std::string &uri)
+{
+    const fs::path path(uri);
+    if (path.is_absolute()) {
+        return fs::is_regular_file(path) ? path : input;
+    }
+
+    const auto file((fs::is_directory(input) ? input : input.parent_path())
+                    / path);
+    return fs::is_regular_file(file) ? file : input;
+}
+
+fs::path DiskCache::path(const std::string &key) const
+{
+    // spread entries over subdirectories
+    return root_ / key.substr(0, 2) / (key + extension_);
+}
+
+bool DiskCache::read(const std::string &key
+                     , const std::function<void(const Data&)> &parse) const
+{
+    if (!enabled()) { return false; }
+
+    const auto file(path(key));
+    std::ifstream f(file.string(), std::ios::binary | std::ios::ate);
+    if (!f) {
+        ++misses_;
+        return false;
+    }
+
+    TraceSpan span("readCacheEntry", key);
+    try {
+        auto data(std::make_shared<std::vector<char>>(f.tellg()));
+        f.seekg(0);
+        f.exceptions(std::ios::badbit | std::ios::failbit);
+        f.read(data->data(), data->size());
+        parse(data);
+    } catch (const std::exception &e) {
+        LOG(warn2) << "Ignoring broken " << name_ << " entry " << file
+                   << ": " << e.what() << ".";
+        ++misses_;
+        return false;
+    }
+
+    ++hits_;
+    return true;
+}
+
+void DiskCache::write(const std::string &key
+                      , const std::function<void(std::ostream&)> &serialize)
+    const
+{
+    if (!enabled()) { return; }
+
+    TraceSpan span("writeCacheEntry", key);
+    const auto file(path(key));
+    const auto tmp(fs::unique_path(file.string() + ".%%%%-%%%%"));
+    try {
+        fs::create_directories(file.parent_path());
+
+        // write to temporary file and move it in place
+        {
+            std::ofstream f;
+            f.exceptions(std::ios::badbit | std::ios::failbit);
+            f.open(tmp.string(), std::ios::binary | std::ios::trunc);
+            serialize(f);
+            f.close();
+        }
+        fs::rename(tmp, file);
+    } catch (const std::exception &e) {
+        LOG(warn2) << "Unable to store " << name_ << " entry " << file
+                   << ": " << e.what() << ".";
+        boost::system::error_code ec;
+        fs::remove(tmp, ec);
+        return;
+    }
+
+    ++stored_;
+}
+
+bool MeshCache::load(const std::string &key, SourceMesh &source) const
+{
+    return read(key, [&](const Data &data)
+    {
+        Reader r(*data);
+        r.header(MeshMagic);
+
+        SourceMesh out;
+        r.mesh(out.mesh);
+
+        // textures point into entry data
+        for (auto count(r.size()); count; --count) {
+            std::size_t nameSize, size;
+            const auto *name(r.bytes(nameSize));
+            const auto *texture(r.bytes(size));
+            out.textures.emplace_back(data, texture, size
+                                      , std::string(name, nameSize));
+        }
+        r.end();
+
+        source.mesh = std::move(out.mesh);
+        source.textures = std::move(out.textures);
+    });
+}
+
+void MeshCache::store(const std::string &key, const SourceMesh &source) const
+{
+    if (!enabled()) { return; }
+
+    if (source.textures.size() != source.mesh.submeshes.size()) {
+        LOG(warn2) << "Cannot cache mesh <" << key
+                   << ">: textures are not encoded.";
+        return;
+    }
+
+    write(key, [&](std::ostream &os)
+    {
+        Writer w(os);
+        w.header(MeshMagic);
+        w.mesh(source.mesh);
+
+        w.size(source.textures.size());
+        for (const auto &texture : source.textures) {
+            w.bytes(texture.name().data(), texture.name().size());
+            w.bytes(texture.data(), texture.size());
+        }
+    });
+}
+
+bool ModelInfoCache::load(const std::string &key, Info &info) const
+{
+    return read(key, [&](const Data &data)
+    {
+        Reader r(*data);
+        r.header(InfoMagic);
+
+        Info out;
+        r.mesh(out.mesh);
+
+        out.textureSizes.resize(r.size());
+        for (auto &size : out.textureSizes) {
+            std::uint32_t width, height;
+            r.value(width);
+            r.value(height);
+            size.width = width;
+            size.height = height;
+        }
+
+        // stale once any source file changes
+        for (auto count(r.size()); count; --count) {
+            std::size_t pathSize, identitySize;
+            const auto *path(r.bytes(pathSize));
+            const auto *identity(r.bytes(identitySize));
+            out.files.emplace_back(std::string(path, pathSize));
+            if (fileIdentity(out.files.back())
+                != std::string(identity, identitySize))
+            {
+                throw std::runtime_error
+                    ("source file " + out.files.back().string()
+                     + " has changed");
+            }
+        }
+        r.end();
+
+        info = std::move(out);
+    });
+}
+
+void ModelInfoCache::store(const std::string &key, const Info &info) const
+{
+    write(key, [&](std::ostream &os)
+    {
+        Writer w(os);
+        w.header(InfoMagic);
+        w.mesh(info.mesh);
+
+        w.size(info.textureSizes.size());
+        for (const auto &size : info.textureSizes) {
+            w.value(std::uint32_t(size.width));
+            w.value(std::uint32_t(size.height));
+        }
+
+        w.size(info.files.size());
+        for (const auto &file : info.files) {
+            const auto path(file.string());
+            const auto identity(fileIdentity(file));
+            if (identity.empty()) {
+                throw std::runtime_error("cannot stat " + path);
+            }
+            w.bytes(path.data(), path.size());
+            w.bytes(identity.data(), identity.size());
+        }
+    });
+}
+
+} // namespace vtstools
@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_meshcache_hpp_included_
+#define vts_tools_meshcache_hpp_included_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+#include <functional>
+
+#include <boost/filesystem/path.hpp>
+
+#include "math/geometry_core.hpp"
+
+#include "cutengine.hpp"
+
+/** Persistent caches of decoded input data.
+ *
+ *  Converting the same input repeatedly (e.g. with different tile extents or
+ *  into different reference frames) decodes every input mesh again. These
+ *  caches keep decoded data in compact binary form, one file per input, so
+ *  repeated conversions load them instead.
+ *
+ *  Entries are keyed by content URI and hash of content data (or any other
+ *  data identifying the content) or by path, size and modification time of
+ *  the file holding the content. Entries are written atomically (temporary
+ *  file renamed into place), therefore one cache directory can be shared by
+ *  concurrent runs. Broken entries are treated as cache misses.
+ *
+ *  All functions are thread safe.
+ */
+namespace vtstools {
+
+/** Directory of cache entries, base of the caches below.
+ */
+class DiskCache {
+public:
+    /** Creates cache in given directory (created on first store). Empty path
+     *  disables the cache. Name is used in log messages, entry files get
+     *  given extension.
+     */
+    DiskCache(const boost::filesystem::path &root, const std::string &name
+              , const std::string &extension);
+
+    ~DiskCache();
+
+    bool enabled() const { return !root_.empty(); }
+
+    /** Cache key of content of given URI. Options are any additional data
+     *  affecting decoded content (e.g. applied transformation).
+     */
+    static std::string key(const std::string &uri
+                           , const char *data, std::size_t size
+                           , const std::string &options = std::string());
+
+    /** Cache key of content of given URI stored in given file (the content
+     *  file itself or an archive holding it). File is only stat'ed, its
+     *  size and modification time stand for its content. Returns empty
+     *  key if file cannot be stat'ed.
+     */
+    static std::string fileKey(const boost::filesystem::path &file
+                               , const std::string &uri
+                               , const std::string &options
+                               = std::string());
+
+    /** Identity of given file: its absolute path, size and modification
+     *  time. Returns empty string if file cannot be stat'ed.
+     */
+    static std::string fileIdentity(const boost::filesystem::path &file);
+
+    /** File holding content of given URI in given input (directory, file in
+     *  directory or archive): the content file itself if it exists,
+     *  otherwise the input as a whole.
+     */
+    static boost::filesystem::path
+    contentFile(const boost::filesystem::path &input, const std::string &uri);
+
+protected:
+    typedef std::shared_ptr<const std::vector<char>> Data;
+
+    /** Reads entry and parses it. Returns false on cache miss.
+     */
+    bool read(const std::string &key
+              , const std::function<void(const Data&)> &parse) const;
+
+    /** Writes entry.
+     */
+    void write(const std::string &key
+               , const std::function<void(std::ostream&)> &serialize) const;
+
+private:
+    boost::filesystem::path path(const std::string &key) const;
+
+    const boost::filesystem::path root_;
+    const std::string name_;
+    const std::string extension_;
+
+    mutable std::atomic<std::size_t> hits_;
+    mutable std::atomic<std::size_t> misses_;
+    mutable std::atomic<std::size_t> stored_;
+};
+
+/** Cache of optimized input meshes together with their (still encoded)
+ *  textures.
+ */
+class MeshCache : public DiskCache {
+public:
+    MeshCache(const boost::filesystem::path &root)
+        : DiskCache(root, "Mesh cache", ".mesh")
+    {}
+
+    /** Loads mesh and lazily decoded textures stored under given key into
+     *  source. Returns false on cache miss.
+     */
+    bool load(const std::string &key, SourceMesh &source) const;
+
+    /** Stores source's mesh and textures under given key. Only sources
+     *  with lazily decoded textures (i.e. still encoded) can be stored.
+     */
+    void store(const std::string &key, const SourceMesh &source) const;
+};
+
+/** Cache of model analysis inputs: mesh and texture sizes. Measurement in
+ *  reference frame nodes is computed from them, therefore analysis of
+ *  repeated conversions (into any reference frame) needs no model or
+ *  texture I/O.
+ */
+class ModelInfoCache : public DiskCache {
+public:
+    ModelInfoCache(const boost::filesystem::path &root)
+        : DiskCache(root, "Model info cache", ".info")
+    {}
+
+    struct Info {
+        vts::Mesh mesh;
+        std::vector<math::Size2> textureSizes;
+
+        /** Files (textures) the info was measured from besides the model
+         *  itself. Their identity is stored with the entry; entry whose any
+         *  file has changed since is a cache miss.
+         */
+        std::vector<boost::filesystem::path> files;
+    };
+
+    /** Loads info stored under given key. Returns false on cache miss.
+     */
+    bool load(const std::string &key, Info &info) const;
+
+    /** Stores info under given key.
+     */
+    void store(const std::string &key, const Info &info) const;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_meshcache_hpp_included_
@@ -0,0 +1,481 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "dbglog/dbglog.hpp"
+
+#include "meshopt.hpp"
+
+namespace vtstools {
+
+namespace {
+
+const std::uint8_t VertexHeader(0xa0);
+const std::uint8_t IndexHeader(0xe0);
+const std::uint8_t SequenceHeader(0xd0);
+
+const std::size_t ByteGroupSize(16);
+const std::size_t VertexBlockSizeBytes(8192);
+const std::size_t VertexBlockMaxSize(256);
+const std::size_t TailMaxSize(32);
+
+typedef const std::uint8_t* Data;
+
+void truncated()
+{
+    LOGTHROW(err2, std::runtime_error) << "Truncated meshopt buffer.";
+}
+
+// ------------------------------------------------------------------------
+// vertex codec
+
+/** Decodes group of 16 bytes encoded with 0, 2, 4 or 8 bits per byte; all
+ *  ones in 2/4-bit mode escape to explicit byte.
+ */
+Data decodeBytesGroup(Data data, Data end, std::uint8_t *out, int mode)
+{
+    switch (mode) {
+    case 0:
+        std::memset(out, 0, ByteGroupSize);
+        return data;
+
+    case 1: case 2: {
+        const int bits(mode * 2);
+        const std::uint8_t escape((1 << bits) - 1);
+        auto var(data + bits * 2);
+        if (var > end) { truncated(); }
+        for (std::size_t i(0); i < ByteGroupSize; ++i) {
+            const int shift(8 - bits - (i * bits) % 8);
+            const std::uint8_t value((data[(i * bits) / 8] >> shift)
+                                     & escape);
+            if (value == escape) {
+                if (var >= end) { truncated(); }
+                out[i] = *var++;
+            } else {
+                out[i] = value;
+            }
+        }
+        return var;
+    }
+
+    default:
+        if (data + ByteGroupSize > end) { truncated(); }
+        std::memcpy(out, data, ByteGroupSize);
+        return data + ByteGroupSize;
+    }
+}
+
+/** Decodes size bytes (multiple of group size) with per-group 2-bit
+ *  headers.
+ */
+Data decodeBytes(Data data, Data end, std::uint8_t *out, std::size_t size)
+{
+    const auto header(data);
+    const auto groups(size / ByteGroupSize);
+    data += (groups + 3) / 4;
+    if (data > end) { truncated(); }
+
+    for (std::size_t g(0); g < groups; ++g) {
+        const int mode((header[g / 4] >> ((g % 4) * 2)) & 3);
+        data = decodeBytesGroup(data, end, out + g * ByteGroupSize, mode);
+    }
+    return data;
+}
+
+inline std::uint8_t unzigzag8(std::uint8_t v)
+{
+    return std::uint8_t((0 - (v & 1)) ^ (v >> 1));
+}
+
+Data decodeVertexBlock(Data data, Data end, char *vertices
+                       , std::size_t count, std::size_t stride
+                       , std::uint8_t *last)
+{
+    std::uint8_t buffer[VertexBlockMaxSize];
+    const auto aligned((count + ByteGroupSize - 1) & ~(ByteGroupSize - 1));
+
+    for (std::size_t k(0); k < stride; ++k) {
+        data = decodeBytes(data, end, buffer, aligned);
+
+        // byte deltas against previous vertex
+        std::uint8_t p(last[k]);
+        for (std::size_t i(0); i < count; ++i) {
+            p = std::uint8_t(unzigzag8(buffer[i]) + p);
+            vertices[i * stride + k] = char(p);
+        }
+        last[k] = p;
+    }
+    return data;
+}
+
+void decodeVertices(Data data, Data end, char *out, std::size_t count
+                    , std::size_t stride)
+{
+    if ((stride == 0) || (stride > 256) || (stride % 4)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid meshopt vertex stride " << stride << ".";
+    }
+    if (std::size_t(end - data) < 1 + stride) { truncated(); }
+
+    const auto header(*data++);
+    if ((header & 0xf0) != VertexHeader) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid meshopt vertex buffer header.";
+    }
+    if (header & 0x0f) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported meshopt vertex codec version "
+            << (header & 0x0f) << ".";
+    }
+
+    // first vertex baseline is stored at the end of the tail
+    std::uint8_t last[256];
+    std::memcpy(last, end - stride, stride);
+
+    const auto blockSize(std::min(VertexBlockMaxSize
+                                  , (VertexBlockSizeBytes / stride)
+                                  & ~(ByteGroupSize - 1)));
+
+    for (std::size_t offset(0); offset < count; offset += blockSize) {
+        const auto size(std::min(blockSize, count - offset));
+        data = decodeVertexBlock(data, end, out + offset * stride, size
+                                 , stride, last);
+    }
+
+    if (std::size_t(end - data) != std::max(stride, TailMaxSize)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Malformed meshopt vertex buffer tail.";
+    }
+}
+
+// ------------------------------------------------------------------------
+// index codecs
+
+std::uint32_t decodeVByte(Data &data, Data end)
+{
+    if (data >= end) { truncated(); }
+    const auto lead(*data++);
+    if (lead < 128) { return lead; }
+
+    std::uint32_t result(lead & 127);
+    int shift(7);
+    for (int i(0); i < 4; ++i) {
+        if (data >= end) { truncated(); }
+        const auto group(*data++);
+        result |= std::uint32_t(group & 127) << shift;
+        shift += 7;
+        if (group < 128) { break; }
+    }
+    return result;
+}
+
+std::uint32_t decodeIndex(Data &data, Data end, std::uint32_t last)
+{
+    const auto v(decodeVByte(data, end));
+    const std::uint32_t d((v >> 1) ^ (0 - (v & 1)));
+    return last + d;
+}
+
+void writeIndex(char *out, std::size_t i, std::size_t size
+                , std::uint32_t index)
+{
+    if (size == 2) {
+        const std::uint16_t v(index);
+        std::memcpy(out + i * 2, &v, 2);
+    } else {
+        std::memcpy(out + i * 4, &index, 4);
+    }
+}
+
+/** Triangle index buffer: edge and vertex FIFOs.
+ */
+class TriangleDecoder {
+public:
+    TriangleDecoder(char *out, std::size_t indexSize)
+        : out_(out), indexSize_(indexSize), edgeOffset_(), vertexOffset_()
+    {
+        std::memset(edges_, 0xff, sizeof(edges_));
+        std::memset(vertices_, 0xff, sizeof(vertices_));
+    }
+
+    void decode(Data data, Data end, std::size_t count);
+
+private:
+    void triangle(std::size_t i, std::uint32_t a, std::uint32_t b
+                  , std::uint32_t c)
+    {
+        writeIndex(out_, i, indexSize_, a);
+        writeIndex(out_, i + 1, indexSize_, b);
+        writeIndex(out_, i + 2, indexSize_, c);
+    }
+
+    void pushEdge(std::uint32_t a, std::uint32_t b) {
+        edges_[edgeOffset_][0] = a;
+        edges_[edgeOffset_][1] = b;
+        edgeOffset_ = (edgeOffset_ + 1) & 15;
+    }
+
+    void pushVertex(std::uint32_t v, bool cond = true) {
+        vertices_[vertexOffset_] = v;
+        vertexOffset_ = (vertexOffset_ + cond) & 15;
+    }
+
+    std::uint32_t vertex(std::size_t back) const {
+        return vertices_[(vertexOffset_ - back) & 15];
+    }
+
+    char *out_;
+    const std::size_t indexSize_;
+    std::uint32_t edges_[16][2];
+    std::uint32_t vertices_[16];
+    std::size_t edgeOffset_;
+    std::size_t vertexOffset_;
+};
+
+void TriangleDecoder::decode(Data buffer, Data end, std::size_t count)
+{
+    if (std::size_t(end - buffer) < 1 + count / 3 + 16) { truncated(); }
+    if ((buffer[0] & 0xf0) != IndexHeader) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid meshopt index buffer header.";
+    }
+    const int version(buffer[0] & 0x0f);
+    if (version > 1) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported meshopt index codec version " << version << ".";
+    }
+
+    const int fecmax(version >= 1 ? 13 : 15);
+
+    // codes, then data, then 16-byte auxiliary code table
+    Data code(buffer + 1);
+    Data data(code + count / 3);
+    const Data safeEnd(end - 16);
+    const Data aux(safeEnd);
+
+    std::uint32_t next(0), last(0);
+
+    for (std::size_t i(0); i < count; i += 3) {
+        if (data > safeEnd) { truncated(); }
+
+        const auto codetri(*code++);
+        if (codetri < 0xf0) {
+            // edge from FIFO
+            const auto &edge(edges_[(edgeOffset_ - 1 - (codetri >> 4)) & 15]);
+            const auto a(edge[0]), b(edge[1]);
+            const int fec(codetri & 15);
+
+            if (fec < fecmax) {
+                const bool fresh(fec == 0);
+                const auto c(fresh ? next : vertex(1 + fec));
+                next += fresh;
+                triangle(i, a, b, c);
+                pushVertex(c, fresh);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            } else {
+                const auto c(last = ((fec != 15)
+                                     ? last + (fec - (fec ^ 3))
+                                     : decodeIndex(data, safeEnd, last)));
+                triangle(i, a, b, c);
+                pushVertex(c);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            }
+        } else if (codetri < 0xfe) {
+            // auxiliary code from table
+            const auto codeaux(aux[codetri & 15]);
+            const int feb(codeaux >> 4), fec(codeaux & 15);
+
+            const auto a(next++);
+            const auto b((feb == 0) ? next : vertex(feb));
+            next += (feb == 0);
+            const auto c((fec == 0) ? next : vertex(fec));
+            next += (fec == 0);
+
+            triangle(i, a, b, c);
+            pushVertex(a);
+            pushVertex(b, feb == 0);
+            pushVertex(c, fec == 0);
+            pushEdge(b, a);
+            pushEdge(c, b);
+            pushEdge(a, c);
+        } else {
+            // explicit auxiliary code
+            if (data >= safeEnd) { truncated(); }
+            const auto codeaux(*data++);
+            const int fea(codetri == 0xfe ? 0 : 15);
+            const int feb(codeaux >> 4), fec(codeaux & 15);
+
+            if (!codeaux) { next = 0; }
+
+            std::uint32_t a((fea == 0) ? next++ : 0);
+            std::uint32_t b((feb == 0) ? next++ : vertex(feb));
+            std::uint32_t c((fec == 0) ? next++ : vertex(fec));
+
+            if (fea == 15) { last = a = decodeIndex(data, safeEnd, last); }
+            if (feb == 15) { last = b = decodeIndex(data, safeEnd, last); }
+            if (fec == 15) { last = c = decodeIndex(data, safeEnd, last); }
+
+            triangle(i, a, b, c);
+            pushVertex(a);
+            pushVertex(b, (feb == 0) || (feb == 15));
+            pushVertex(c, (fec == 0) || (fec == 15));
+            pushEdge(b, a);
+            pushEdge(c, b);
+            pushEdge(a, c);
+        }
+    }
+
+    if (data != safeEnd) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Malformed meshopt index buffer.";
+    }
+}
+
+void decodeSequence(Data buffer, Data end, char *out, std::size_t count
+                    , std::size_t indexSize)
+{
+    if (std::size_t(end - buffer) < 1 + count + 4) { truncated(); }
+    if ((buffer[0] & 0xf0) != SequenceHeader) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid meshopt index sequence header.";
+    }
+    if ((buffer[0] & 0x0f) > 1) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported meshopt index sequence version.";
+    }
+
+    Data data(buffer + 1);
+    const Data safeEnd(end - 4);
+    std::uint32_t last[2] = { 0, 0 };
+
+    for (std::size_t i(0); i < count; ++i) {
+        auto v(decodeVByte(data, safeEnd));
+
+        // baseline selector, then zigzag delta
+        const auto current(v & 1);
+        v >>= 1;
+        const std::uint32_t d((v >> 1) ^ (0 - (v & 1)));
+        last[current] += d;
+        writeIndex(out, i, indexSize, last[current]);
+    }
+
+    if (data != safeEnd) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Malformed meshopt index sequence.";
+    }
+}
+
+// ------------------------------------------------------------------------
+// filters
+
+void exponentialFilter(char *data, std::size_t size)
+{
+    for (std::size_t i(0); i + 4 <= size; i += 4) {
+        std::uint32_t v;
+        std::memcpy(&v, data + i, 4);
+        // 24-bit signed mantissa, 8-bit signed exponent
+        const std::int32_t m(std::int32_t(v << 8) >> 8);
+        const std::int32_t e(std::int32_t(v) >> 24);
+        const float f(std::ldexp(float(m), e));
+        std::memcpy(data + i, &f, 4);
+    }
+}
+
+} // namespace
+
+MeshoptMode meshoptMode(const std::string &name)
+{
+    if (name == "ATTRIBUTES") { return MeshoptMode::attributes; }
+    if (name == "TRIANGLES") { return MeshoptMode::triangles; }
+    if (name == "INDICES") { return MeshoptMode::indices; }
+    LOGTHROW(err2, std::runtime_error)
+        << "Unknown meshopt mode <" << name << ">.";
+    return MeshoptMode::attributes;
+}
+
+MeshoptFilter meshoptFilter(const std::string &name)
+{
+    if (name.empty() || (name == "NONE")) { return MeshoptFilter::none; }
+    if (name == "OCTAHEDRAL") { return MeshoptFilter::octahedral; }
+    if (name == "QUATERNION") { return MeshoptFilter::quaternion; }
+    if (name == "EXPONENTIAL") { return MeshoptFilter::exponential; }
+    LOGTHROW(err2, std::runtime_error)
+        << "Unknown meshopt filter <" << name << ">.";
+    return MeshoptFilter::none;
+}
+
+std::vector<char> decodeMeshopt(const char *data, std::size_t size
+                                , std::size_t count, std::size_t stride
+                                , MeshoptMode mode, MeshoptFilter filter)
+{
+    std::vector<char> out(count * stride);
+
+    const auto begin(reinterpret_cast<Data>(data));
+    const auto end(begin + size);
+
+    switch (mode) {
+    case MeshoptMode::attributes:
+        decodeVertices(begin, end, out.data(), count, stride);
+        break;
+
+    case MeshoptMode::triangles:
+        if ((count % 3) || ((stride != 2) && (stride != 4))) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid meshopt triangle buffer layout.";
+        }
+        TriangleDecoder(out.data(), stride).decode(begin, end, count);
+        break;
+
+    case MeshoptMode::indices:
+        if ((stride != 2) && (stride != 4)) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid meshopt index sequence stride.";
+        }
+        decodeSequence(begin, end, out.data(), count, stride);
+        break;
+    }
+
+    switch (filter) {
+    case MeshoptFilter::none: break;
+    case MeshoptFilter::exponential:
+        exponentialFilter(out.data(), out.size());
+        break;
+    default:
+        LOGTHROW(err2, std::runtime_error)
+            << "Unsupported meshopt filter.";
+    }
+
+    return out;
+}
+
+} // namespace vtstools
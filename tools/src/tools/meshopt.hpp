@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef vts_tools_meshopt_hpp_included_
+#define vts_tools_meshopt_hpp_included_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/** meshoptimizer buffer decompression (glTF EXT_meshopt_compression).
+ */
+namespace vtstools {
+
+enum class MeshoptMode { attributes, triangles, indices };
+
+enum class MeshoptFilter { none, octahedral, quaternion, exponential };
+
+/** Parses mode name (ATTRIBUTES, TRIANGLES, INDICES).
+ */
+MeshoptMode meshoptMode(const std::string &name);
+
+/** Parses filter name (NONE, OCTAHEDRAL, QUATERNION, EXPONENTIAL).
+ */
+MeshoptFilter meshoptFilter(const std::string &name);
+
+/** Decodes compressed buffer view into count elements of stride bytes.
+ *
+ *  Only version 0 vertex codec and exponential filter are supported (normals
+ *  and rotations filters are never needed by the converters). Throws on
+ *  malformed or unsupported data.
+ */
+std::vector<char> decodeMeshopt(const char *data, std::size_t size
+                                , std::size_t count, std::size_t stride
+                                , MeshoptMode mode
+                                , MeshoptFilter filter = MeshoptFilter::none);
+
+} // namespace vtstools
+
+#endif // vts_tools_meshopt_hpp_included_
@@ -0,0 +1,315 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <time.h>
+#include <sys/resource.h>
+
+#include <fstream>
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "metrics.hpp"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+namespace vtstools {
+
+namespace detail { Metrics *metrics(nullptr); }
+
+namespace {
+
+/** Path given by --metrics.
+ */
+boost::optional<fs::path> metricsPath;
+
+std::uint64_t threadCpuNs()
+{
+    ::timespec ts;
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) { return 0; }
+    return std::uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/** Bytes read by calling thread so far (all read syscalls, i.e. including
+ *  page cache hits). Linux only, 0 elsewhere.
+ */
+std::uint64_t threadBytesRead()
+{
+    std::ifstream f("/proc/thread-self/io");
+    std::string key;
+    std::uint64_t value;
+    while (f >> key >> value) {
+        if (key == "rchar:") { return value; }
+    }
+    return 0;
+}
+
+/** Peak RSS of this process in bytes.
+ */
+long peakRss()
+{
+    ::rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage)) { return 0; }
+    return usage.ru_maxrss * 1024L;
+}
+
+/** Phases where bytes read are measured. Measuring costs a few syscalls
+ *  therefore it is not done in fine-grained compute phases.
+ */
+bool ioPhase(Phase phase)
+{
+    switch (phase) {
+    case Phase::parse: case Phase::analyze: case Phase::generate:
+        return true;
+    default: break;
+    }
+    return false;
+}
+
+double seconds(std::uint64_t ns) { return ns / 1e9; }
+
+} // namespace
+
+const char* phaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::parse: return "parse";
+    case Phase::analyze: return "analyze";
+    case Phase::project: return "project";
+    case Phase::clip: return "clip";
+    case Phase::split: return "split";
+    case Phase::store: return "store";
+    case Phase::generate: return "generate";
+    }
+    return "unknown";
+}
+
+const char* counterName(Counter counter)
+{
+    switch (counter) {
+    case Counter::meshesDecoded: return "meshesDecoded";
+    case Counter::texturesDecoded: return "texturesDecoded";
+    case Counter::facesProjected: return "facesProjected";
+    case Counter::facesSplit: return "facesSplit";
+    case Counter::tilesWritten: return "tilesWritten";
+    }
+    return "unknown";
+}
+
+Metrics::PhaseStats::PhaseStats()
+    : calls(), wallNs(), cpuNs(), bytesRead(), counters(), peakRss()
+{}
+
+Metrics::Metrics()
+    : start_(Clock::now())
+{}
+
+Metrics::ThreadStats& Metrics::thread()
+{
+    struct Cache {
+        Metrics *owner;
+        ThreadStats *stats;
+    };
+    thread_local Cache cache{ nullptr, nullptr };
+
+    if (cache.owner != this) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_.emplace_back(threads_.size());
+        cache.owner = this;
+        cache.stats = &threads_.back();
+    }
+    return *cache.stats;
+}
+
+void Metrics::count(Counter counter, std::uint64_t value)
+{
+    auto &t(thread());
+    if (!t.current) { return; }
+    t.phases[static_cast<std::size_t>(*t.current)]
+        .counters[static_cast<std::size_t>(counter)] += value;
+}
+
+Json::Value Metrics::json() const
+{
+    const auto now(Clock::now());
+
+    Json::Value value(Json::objectValue);
+    value["wallTime"] = std::chrono::duration<double>(now - start_).count();
+    value["peakRss"] = Json::Int64(peakRss());
+
+    auto &phases(value["phases"] = Json::Value(Json::objectValue));
+
+    for (std::size_t p(0); p < PhaseCount; ++p) {
+        const auto phase(static_cast<Phase>(p));
+
+        Metrics::PhaseStats total;
+        boost::optional<Clock::time_point> first, last;
+        Json::Value threads(Json::arrayValue);
+
+        const auto fill([](Json::Value &out, const PhaseStats &ps)
+        {
+            out["calls"] = Json::UInt64(ps.calls);
+            out["wall"] = seconds(ps.wallNs);
+            out["cpu"] = seconds(ps.cpuNs);
+            out["bytesRead"] = Json::UInt64(ps.bytesRead);
+            for (std::size_t c(0); c < CounterCount; ++c) {
+                out[counterName(static_cast<Counter>(c))]
+                    = Json::UInt64(ps.counters[c]);
+            }
+            out["peakRss"] = Json::Int64(ps.peakRss);
+        });
+
+        for (const auto &thread : threads_) {
+            const auto &ps(thread.phases[p]);
+            if (!ps.calls) { continue; }
+
+            total.calls += ps.calls;
+            total.wallNs += ps.wallNs;
+            total.cpuNs += ps.cpuNs;
+            total.bytesRead += ps.bytesRead;
+            for (std::size_t c(0); c < CounterCount; ++c) {
+                total.counters[c] += ps.counters[c];
+            }
+            total.peakRss = std::max(total.peakRss, ps.peakRss);
+            first = first ? std::min(*first, ps.first) : ps.first;
+            last = last ? std::max(*last, ps.last) : ps.last;
+        }
+
+        if (!total.calls) { continue; }
+
+        // real time between phase's first start and last end
+        const auto elapsed(std::chrono::duration<double>(*last - *first)
+                           .count());
+
+        // pool threads without any call in this phase were idle all the time
+        double idle(0.0);
+        for (const auto &thread : threads_) {
+            const auto &ps(thread.phases[p]);
+            if (!ps.calls && !thread.pool) { continue; }
+
+            auto &t(threads.append(Json::Value(Json::objectValue)));
+            t["thread"] = Json::UInt64(thread.index);
+            fill(t, ps);
+
+            if (thread.pool) {
+                idle += std::max(0.0, elapsed - seconds(ps.wallNs));
+            }
+        }
+
+        auto &out(phases[phaseName(phase)]);
+        fill(out, total);
+        out["elapsed"] = elapsed;
+        out["idle"] = idle;
+        out["threadCount"] = Json::UInt64(threads.size());
+        out["threads"] = threads;
+    }
+
+    return value;
+}
+
+void enableMetrics()
+{
+    if (!detail::metrics) { detail::metrics = new Metrics(); }
+}
+
+ScopedPhase::ScopedPhase(Phase phase)
+    : thread_(), phase_(phase), cpuStart_(), readStart_()
+{
+    auto *m(metrics());
+    if (!m) { return; }
+
+    thread_ = &m->thread();
+    previous_ = thread_->current;
+    thread_->current = phase_;
+
+    if (ioPhase(phase_)) { readStart_ = threadBytesRead(); }
+    cpuStart_ = threadCpuNs();
+    start_ = Metrics::Clock::now();
+}
+
+void ScopedPhase::stop()
+{
+    if (!thread_) { return; }
+
+    const auto end(Metrics::Clock::now());
+    const auto cpu(threadCpuNs());
+
+    auto &ps(thread_->phases[static_cast<std::size_t>(phase_)]);
+    if (!ps.calls) { ps.first = start_; }
+    ps.last = end;
+    ++ps.calls;
+    ps.wallNs += std::chrono::duration_cast<std::chrono::nanoseconds>
+        (end - start_).count();
+    ps.cpuNs += cpu - cpuStart_;
+    if (ioPhase(phase_)) { ps.bytesRead += threadBytesRead() - readStart_; }
+    ps.peakRss = std::max(ps.peakRss, peakRss());
+
+    thread_->current = previous_;
+    thread_ = nullptr;
+}
+
+void metricsConfiguration(po::options_description &config)
+{
+    config.add_options()
+        ("metrics", po::value<fs::path>()
+         , "Collect performance metrics (time, I/O, counters and peak RSS "
+         "per phase and thread) and write them as JSON into given file "
+         "when the run finishes.")
+        ;
+}
+
+void configureMetrics(const po::variables_map &vars)
+{
+    if (!vars.count("metrics")) { return; }
+    metricsPath = vars["metrics"].as<fs::path>();
+    enableMetrics();
+}
+
+void writeMetrics(const boost::optional<unsigned int> &worker)
+{
+    if (!metricsPath || !metrics()) { return; }
+
+    auto path(*metricsPath);
+    if (worker) {
+        path += ".shard" + boost::lexical_cast<std::string>(*worker);
+    }
+
+    std::ofstream f(path.string());
+    Json::StyledStreamWriter().write(f, metrics()->json());
+    f.close();
+
+    if (!f) {
+        LOG(err2) << "Unable to write metrics into " << path << ".";
+        return;
+    }
+    LOG(info3) << "Metrics written into " << path << ".";
+}
+
+} // namespace vtstools
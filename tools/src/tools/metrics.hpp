@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_metrics_hpp_included_
+#define vts_tools_metrics_hpp_included_
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/program_options.hpp>
+
+#include "jsoncpp/json.hpp"
+
+/** Processing metrics shared by all converters.
+ *
+ *  Metrics are collected per phase and per thread into process-wide
+ *  collector. Collection is disabled by default; all probes are then reduced
+ *  to a single pointer test.
+ */
+namespace vtstools {
+
+/** Processing phases.
+ */
+enum class Phase {
+    parse, analyze, project, clip, split, store, generate
+};
+
+constexpr std::size_t PhaseCount(7);
+
+const char* phaseName(Phase phase);
+
+/** Counted quantities. Projected faces are input faces projected into RF
+ *  node SRS, split faces are faces of generated tiles.
+ */
+enum class Counter {
+    meshesDecoded, texturesDecoded, facesProjected, facesSplit
+    , tilesWritten
+};
+
+constexpr std::size_t CounterCount(5);
+
+const char* counterName(Counter counter);
+
+/** Metrics collector.
+ */
+class Metrics {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    Metrics();
+
+    /** Statistics of one phase in one thread.
+     */
+    struct PhaseStats {
+        std::uint64_t calls;
+        std::uint64_t wallNs;
+        std::uint64_t cpuNs;
+        std::uint64_t bytesRead;
+        std::array<std::uint64_t, CounterCount> counters;
+        Clock::time_point first;
+        Clock::time_point last;
+        long peakRss;
+
+        PhaseStats();
+    };
+
+    /** Statistics of one thread. Accessed only by owning thread while
+     *  running.
+     */
+    struct ThreadStats {
+        std::size_t index;
+        std::array<PhaseStats, PhaseCount> phases;
+        boost::optional<Phase> current;
+
+        /** Thread pool worker. Reported in every phase, even when it did no
+         *  work in it.
+         */
+        bool pool;
+
+        ThreadStats(std::size_t index) : index(index), pool(false) {}
+    };
+
+    /** Returns statistics of calling thread.
+     */
+    ThreadStats& thread();
+
+    /** Adds value to given counter in current phase of calling thread. Values
+     *  counted outside of any phase are ignored.
+     */
+    void count(Counter counter, std::uint64_t value);
+
+    Json::Value json() const;
+
+private:
+    Clock::time_point start_;
+    std::mutex mutex_;
+    std::deque<ThreadStats> threads_;
+};
+
+namespace detail { extern Metrics *metrics; }
+
+/** Global collector, null when metrics are disabled.
+ */
+inline Metrics* metrics() { return detail::metrics; }
+
+/** Enables global metrics collection.
+ */
+void enableMetrics();
+
+/** Counts value in the global collector (if enabled).
+ */
+inline void count(Counter counter, std::uint64_t value = 1)
+{
+    if (auto *m = metrics()) { m->count(counter, value); }
+}
+
+/** Measures scope as given phase in calling thread: wall and CPU time, bytes
+ *  read (I/O phases only) and peak RSS.
+ */
+class ScopedPhase {
+public:
+    ScopedPhase(Phase phase);
+
+    ~ScopedPhase() { stop(); }
+
+    /** Stops measurement before the end of the scope.
+     */
+    void stop();
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    Metrics::ThreadStats *thread_;
+    Phase phase_;
+    boost::optional<Phase> previous_;
+    Metrics::Clock::time_point start_;
+    std::uint64_t cpuStart_;
+    std::uint64_t readStart_;
+};
+
+/** Registers --metrics option.
+ */
+void metricsConfiguration(boost::program_options::options_description
+                          &config);
+
+/** Enables metrics collection if --metrics option is set.
+ */
+void configureMetrics(const boost::program_options::variables_map &vars);
+
+/** Writes collected metrics into file given by --metrics option (if any).
+ *  Shard workers write into <path>.shard<worker>.
+ */
+void writeMetrics(const boost::optional<unsigned int> &worker
+                  = boost::none);
+
+} // namespace vtstools
+
+#endif // vts_tools_metrics_hpp_included_
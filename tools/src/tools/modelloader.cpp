@@ -0,0 +1,684 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/replace.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "modelloader.hpp"
+
+namespace fs = boost::filesystem;
+namespace ba = boost::algorithm;
+
+namespace vtstools {
+
+namespace {
+
+/** Model file content terminated by NUL, parsed in place.
+ */
+typedef std::vector<char> Buffer;
+
+Buffer read(const roarchive::RoArchive &archive, const fs::path &path)
+{
+    Buffer data(archive.istream(path)->read());
+    data.push_back('\0');
+    return data;
+}
+
+/** Faces of one submesh. Indices point to model-wide vertex and texture
+ *  coordinate arrays, three per face.
+ */
+struct Group {
+    std::vector<int> faces;
+    std::vector<int> facesTc;
+    fs::path texture;
+
+    /** Adds polygon as a triangle fan.
+     */
+    void add(const std::vector<int> &polygon
+             , const std::vector<int> &polygonTc)
+    {
+        for (std::size_t i(2), e(polygon.size()); i < e; ++i) {
+            for (auto j : { std::size_t(0), i - 1, i }) {
+                faces.push_back(polygon[j]);
+                facesTc.push_back(polygonTc[j]);
+            }
+        }
+    }
+
+    typedef std::vector<Group> list;
+};
+
+/** Builds model from model-wide arrays: every group becomes a submesh
+ *  holding only vertices and texture coordinates its faces use.
+ */
+NativeModel build(const math::Points3d &vertices, const math::Points2d &tc
+                  , const Group::list &groups, const math::Point3 &origin
+                  , const roarchive::RoArchive &archive
+                  , const fs::path &path)
+{
+    // model-wide index -> submesh index, reset after each group
+    std::vector<int> vmap(vertices.size(), -1);
+    std::vector<int> tmap(tc.size(), -1);
+
+    const auto local([&](std::vector<int> &map, int index) -> int&
+    {
+        if ((index < 0) || (std::size_t(index) >= map.size())) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Face index out of range in model " << path << ".";
+        }
+        return map[index];
+    });
+
+    NativeModel model;
+    for (const auto &group : groups) {
+        if (group.faces.empty()) { continue; }
+
+        model.mesh.submeshes.emplace_back();
+        auto &sm(model.mesh.submeshes.back());
+
+        for (std::size_t i(0), e(group.faces.size()); i < e; i += 3) {
+            unsigned int face[3], faceTc[3];
+            for (int j(0); j < 3; ++j) {
+                const auto vi(group.faces[i + j]);
+                auto &v(local(vmap, vi));
+                if (v < 0) {
+                    v = sm.vertices.size();
+                    sm.vertices.push_back(vertices[vi] + origin);
+                }
+                face[j] = v;
+
+                const auto ti(group.facesTc[i + j]);
+                auto &t(local(tmap, ti));
+                if (t < 0) {
+                    t = sm.tc.size();
+                    sm.tc.push_back(tc[ti]);
+                }
+                faceTc[j] = t;
+            }
+            sm.faces.emplace_back(face[0], face[1], face[2]);
+            sm.facesTc.emplace_back(faceTc[0], faceTc[1], faceTc[2]);
+        }
+
+        for (auto index : group.faces) { vmap[index] = -1; }
+        for (auto index : group.facesTc) { tmap[index] = -1; }
+
+        model.textures.push_back(archive.istream(group.texture));
+    }
+
+    if (model.mesh.submeshes.empty()) {
+        throw ModelUnsupported("model without faces");
+    }
+
+    return model;
+}
+
+// text parsing helpers
+
+inline bool eol(char c) { return !c || (c == '\n') || (c == '\r'); }
+
+inline const char* skipSpace(const char *p)
+{
+    while ((*p == ' ') || (*p == '\t')) { ++p; }
+    return p;
+}
+
+inline const char* nextLine(const char *p)
+{
+    while (*p && (*p != '\n')) { ++p; }
+    return *p ? p + 1 : p;
+}
+
+/** Consumes keyword followed by white space.
+ */
+inline bool keyword(const char *&p, const char *kw, std::size_t size)
+{
+    if (std::strncmp(p, kw, size)
+        || ((p[size] != ' ') && (p[size] != '\t')))
+    {
+        return false;
+    }
+    p += size;
+    return true;
+}
+
+#define KEYWORD(p, kw) keyword(p, kw, sizeof(kw) - 1)
+
+double number(const char *&p, const fs::path &path)
+{
+    p = skipSpace(p);
+    char *end;
+    const double value(eol(*p) ? 0.0 : std::strtod(p, &end));
+    if (eol(*p) || (end == p)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid number in model " << path << ".";
+    }
+    p = end;
+    return value;
+}
+
+/** Rest of the line without surrounding white space.
+ */
+std::string rest(const char *p)
+{
+    p = skipSpace(p);
+    const char *end(p);
+    while (!eol(*end)) { ++end; }
+    while ((end > p) && ((end[-1] == ' ') || (end[-1] == '\t'))) { --end; }
+    return std::string(p, end);
+}
+
+/** Path in model file, possibly written on Windows.
+ */
+fs::path modelPath(std::string path)
+{
+    ba::replace_all(path, "\\", "/");
+    return path;
+}
+
+// OBJ
+
+/** OBJ index: 1-based or negative (relative to the current end).
+ */
+int objIndex(const char *&p, std::size_t count, const fs::path &path)
+{
+    char *end;
+    const long value(std::strtol(p, &end, 10));
+    if ((end == p) || !value) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid face index in model " << path << ".";
+    }
+    p = end;
+    return (value < 0) ? int(count + value) : int(value - 1);
+}
+
+/** Reads textures (map_Kd) of materials from MTL file.
+ */
+void loadMtl(const roarchive::RoArchive &archive, const fs::path &path
+             , std::map<std::string, fs::path> &textures)
+{
+    const auto data(read(archive, path));
+    const auto dir(path.parent_path());
+
+    std::string material;
+    for (const char *p(data.data()); *p; p = nextLine(p)) {
+        p = skipSpace(p);
+        if (KEYWORD(p, "newmtl")) {
+            material = rest(p);
+        } else if (KEYWORD(p, "map_Kd")) {
+            // file name is the last token, preceded by options
+            auto file(rest(p));
+            const auto space(file.find_last_of(" \t"));
+            if (space != std::string::npos) { file.erase(0, space + 1); }
+            textures[material] = dir / modelPath(file);
+        }
+    }
+}
+
+NativeModel loadObj(const roarchive::RoArchive &archive
+                    , const fs::path &path, const math::Point3 &origin)
+{
+    const auto data(read(archive, path));
+    const auto dir(path.parent_path());
+
+    math::Points3d vertices;
+    math::Points2d tc;
+    Group::list groups;
+    std::vector<std::string> materials;
+    std::map<std::string, std::size_t> byMaterial;
+    std::vector<fs::path> mtllibs;
+
+    // faces before first usemtl use default material
+    std::size_t current(0);
+    bool hasCurrent(false);
+    const auto useMaterial([&](const std::string &name)
+    {
+        const auto res(byMaterial.insert({ name, groups.size() }));
+        if (res.second) {
+            groups.emplace_back();
+            materials.push_back(name);
+        }
+        current = res.first->second;
+        hasCurrent = true;
+    });
+
+    std::vector<int> polygon;
+    std::vector<int> polygonTc;
+
+    for (const char *p(data.data()); *p; p = nextLine(p)) {
+        p = skipSpace(p);
+        if (KEYWORD(p, "v")) {
+            const auto x(number(p, path));
+            const auto y(number(p, path));
+            const auto z(number(p, path));
+            vertices.emplace_back(x, y, z);
+        } else if (KEYWORD(p, "vt")) {
+            // v is optional (defaults to 0)
+            const auto u(number(p, path));
+            const auto v(eol(*skipSpace(p)) ? 0.0 : number(p, path));
+            tc.emplace_back(u, v);
+        } else if (KEYWORD(p, "f")) {
+            polygon.clear();
+            polygonTc.clear();
+            while (!eol(*(p = skipSpace(p)))) {
+                polygon.push_back(objIndex(p, vertices.size(), path));
+                if ((p[0] != '/') || (p[1] == '/')) {
+                    throw ModelUnsupported("face without texture "
+                                           "coordinates");
+                }
+                ++p;
+                polygonTc.push_back(objIndex(p, tc.size(), path));
+                if (*p == '/') {
+                    // normal index, not used
+                    ++p;
+                    objIndex(p, 0, path);
+                }
+            }
+            if (polygon.size() < 3) {
+                LOGTHROW(err2, std::runtime_error)
+                    << "Degenerate face in model " << path << ".";
+            }
+            if (!hasCurrent) { useMaterial(std::string()); }
+            groups[current].add(polygon, polygonTc);
+        } else if (KEYWORD(p, "usemtl")) {
+            useMaterial(rest(p));
+        } else if (KEYWORD(p, "mtllib")) {
+            mtllibs.push_back(dir / modelPath(rest(p)));
+        }
+        // anything else (normals, groups, smoothing, comments) is ignored
+    }
+
+    std::map<std::string, fs::path> textures;
+    for (const auto &mtllib : mtllibs) { loadMtl(archive, mtllib, textures); }
+
+    for (std::size_t i(0), e(groups.size()); i != e; ++i) {
+        const auto ftextures(textures.find(materials[i]));
+        if (ftextures == textures.end()) {
+            throw ModelUnsupported("material <" + materials[i]
+                                   + "> without texture");
+        }
+        groups[i].texture = ftextures->second;
+    }
+
+    return build(vertices, tc, groups, origin, archive, path);
+}
+
+// PLY
+
+enum class PlyType { int8, uint8, int16, uint16, int32, uint32
+                     , float32, float64 };
+
+PlyType plyType(const std::string &name, const fs::path &path)
+{
+    static const std::map<std::string, PlyType> types{
+        { "char", PlyType::int8 }, { "int8", PlyType::int8 }
+        , { "uchar", PlyType::uint8 }, { "uint8", PlyType::uint8 }
+        , { "short", PlyType::int16 }, { "int16", PlyType::int16 }
+        , { "ushort", PlyType::uint16 }, { "uint16", PlyType::uint16 }
+        , { "int", PlyType::int32 }, { "int32", PlyType::int32 }
+        , { "uint", PlyType::uint32 }, { "uint32", PlyType::uint32 }
+        , { "float", PlyType::float32 }, { "float32", PlyType::float32 }
+        , { "double", PlyType::float64 }, { "float64", PlyType::float64 }
+    };
+
+    const auto ftypes(types.find(name));
+    if (ftypes == types.end()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unknown property type <" << name << "> in model " << path
+            << ".";
+    }
+    return ftypes->second;
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type;
+    bool list;
+    PlyType countType;
+};
+
+struct PlyElement {
+    std::string name;
+    std::size_t count;
+    std::vector<PlyProperty> properties;
+};
+
+/** PLY body reader, ASCII or little endian binary.
+ */
+class PlyReader {
+public:
+    PlyReader(const char *p, const char *end, bool ascii
+              , const fs::path &path)
+        : p_(p), end_(end), ascii_(ascii), path_(path)
+    {}
+
+    double value(PlyType type) {
+        if (ascii_) {
+            char *end;
+            const double value(std::strtod(p_, &end));
+            if (end == p_) { truncated(); }
+            p_ = end;
+            return value;
+        }
+
+        switch (type) {
+        case PlyType::int8: return binary<std::int8_t>();
+        case PlyType::uint8: return binary<std::uint8_t>();
+        case PlyType::int16: return binary<std::int16_t>();
+        case PlyType::uint16: return binary<std::uint16_t>();
+        case PlyType::int32: return binary<std::int32_t>();
+        case PlyType::uint32: return binary<std::uint32_t>();
+        case PlyType::float32: return binary<float>();
+        case PlyType::float64: return binary<double>();
+        }
+        return 0.0;
+    }
+
+    /** Reads non-negative integer value (list count, index).
+     */
+    std::size_t count(PlyType type) {
+        const auto v(value(type));
+        if (!(v >= 0.0) || (v != std::floor(v))
+            || (v > double(std::numeric_limits<std::uint32_t>::max())))
+        {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid count or index " << v << " in model " << path_
+                << ".";
+        }
+        return std::size_t(v);
+    }
+
+    /** Reads and discards property value(s).
+     */
+    void skip(const PlyProperty &property) {
+        if (!property.list) {
+            value(property.type);
+            return;
+        }
+        for (auto n(count(property.countType)); n; --n) {
+            value(property.type);
+        }
+    }
+
+private:
+    template <typename T> double binary() {
+        if (std::size_t(end_ - p_) < sizeof(T)) { truncated(); }
+        T value;
+        std::memcpy(&value, p_, sizeof(T));
+        p_ += sizeof(T);
+        return value;
+    }
+
+    void truncated() {
+        LOGTHROW(err2, std::runtime_error)
+            << "Truncated or malformed model " << path_ << ".";
+    }
+
+    const char *p_;
+    const char *end_;
+    const bool ascii_;
+    const fs::path &path_;
+};
+
+NativeModel loadPly(const roarchive::RoArchive &archive
+                    , const fs::path &path, const math::Point3 &origin)
+{
+    const auto data(read(archive, path));
+    const auto dir(path.parent_path());
+
+    // header
+    const char *p(data.data());
+    if (std::strncmp(p, "ply", 3)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Model " << path << " is not a PLY file.";
+    }
+
+    bool ascii(false);
+    std::vector<PlyElement> elements;
+    std::vector<fs::path> textureFiles;
+    for (p = nextLine(p); ; p = nextLine(p)) {
+        if (!*p) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Unterminated header of model " << path << ".";
+        }
+
+        const auto line(rest(p));
+        std::istringstream is(line);
+        std::string kw;
+        is >> kw;
+
+        if (kw == "end_header") {
+            p = nextLine(p);
+            break;
+        } else if (kw == "format") {
+            std::string format;
+            is >> format;
+            if (format == "ascii") {
+                ascii = true;
+            } else if (format != "binary_little_endian") {
+                throw ModelUnsupported("PLY format " + format);
+            }
+        } else if (kw == "comment") {
+            // texture reference written by MeshLab and others
+            std::string what;
+            is >> what;
+            if (what == "TextureFile") {
+                std::string file;
+                std::getline(is >> std::ws, file);
+                textureFiles.push_back(dir / modelPath(file));
+            }
+        } else if (kw == "element") {
+            elements.emplace_back();
+            is >> elements.back().name >> elements.back().count;
+        } else if (kw == "property") {
+            if (elements.empty()) {
+                LOGTHROW(err2, std::runtime_error)
+                    << "Property outside element in model " << path << ".";
+            }
+            PlyProperty property;
+            std::string type;
+            is >> type;
+            property.list = (type == "list");
+            if (property.list) {
+                is >> type;
+                property.countType = plyType(type, path);
+                is >> type;
+            }
+            property.type = plyType(type, path);
+            is >> property.name;
+            elements.back().properties.push_back(property);
+        }
+    }
+
+    if (textureFiles.empty()) {
+        throw ModelUnsupported("PLY without texture");
+    }
+
+    PlyReader reader(p, data.data() + data.size() - 1, ascii, path);
+
+    math::Points3d vertices;
+    math::Points2d tc;
+    bool vertexTc(false);
+    Group::list groups(textureFiles.size());
+    for (std::size_t i(0), e(groups.size()); i != e; ++i) {
+        groups[i].texture = textureFiles[i];
+    }
+
+    std::vector<int> polygon;
+    std::vector<int> polygonTc;
+    std::vector<double> corners;
+
+    for (const auto &element : elements) {
+        const auto &properties(element.properties);
+
+        if (element.name == "vertex") {
+            const auto find([&](std::initializer_list<const char*> names)
+                            -> int
+            {
+                for (std::size_t i(0), e(properties.size()); i != e; ++i) {
+                    for (const auto *name : names) {
+                        if (properties[i].name == name) { return i; }
+                    }
+                }
+                return -1;
+            });
+            const int x(find({ "x" })), y(find({ "y" })), z(find({ "z" }));
+            const int u(find({ "s", "u", "texture_u", "texture_s" }));
+            const int v(find({ "t", "v", "texture_v", "texture_t" }));
+            if ((x < 0) || (y < 0) || (z < 0)) {
+                LOGTHROW(err2, std::runtime_error)
+                    << "Missing vertex coordinates in model " << path
+                    << ".";
+            }
+            vertexTc = (u >= 0) && (v >= 0);
+
+            vertices.resize(element.count);
+            if (vertexTc) { tc.resize(element.count); }
+            for (std::size_t i(0); i != element.count; ++i) {
+                auto &vertex(vertices[i]);
+                for (int j(0), je(properties.size()); j != je; ++j) {
+                    const auto &property(properties[j]);
+                    if (property.list) {
+                        reader.skip(property);
+                        continue;
+                    }
+                    const auto value(reader.value(property.type));
+                    if (j == x) { vertex(0) = value; }
+                    else if (j == y) { vertex(1) = value; }
+                    else if (j == z) { vertex(2) = value; }
+                    else if (j == u) { tc[i](0) = value; }
+                    else if (j == v) { tc[i](1) = value; }
+                }
+            }
+        } else if (element.name == "face") {
+            for (std::size_t i(0); i != element.count; ++i) {
+                polygon.clear();
+                polygonTc.clear();
+                corners.clear();
+                std::size_t texture(0);
+
+                for (const auto &property : properties) {
+                    if (property.list && ((property.name == "vertex_indices")
+                                          || (property.name
+                                              == "vertex_index")))
+                    {
+                        for (auto n(reader.count(property.countType))
+                                 ; n; --n)
+                        {
+                            polygon.push_back
+                                (int(reader.count(property.type)));
+                        }
+                    } else if (property.list
+                               && (property.name == "texcoord"))
+                    {
+                        for (auto n(reader.count(property.countType))
+                                 ; n; --n)
+                        {
+                            corners.push_back(reader.value(property.type));
+                        }
+                    } else if (!property.list
+                               && (property.name == "texnumber"))
+                    {
+                        texture = reader.count(property.type);
+                    } else {
+                        reader.skip(property);
+                    }
+                }
+
+                if (polygon.size() < 3) {
+                    LOGTHROW(err2, std::runtime_error)
+                        << "Degenerate face in model " << path << ".";
+                }
+
+                if (corners.size() == 2 * polygon.size()) {
+                    // per-corner texture coordinates
+                    for (std::size_t c(0); c < corners.size(); c += 2) {
+                        polygonTc.push_back(tc.size());
+                        tc.emplace_back(corners[c], corners[c + 1]);
+                    }
+                } else if (vertexTc) {
+                    polygonTc = polygon;
+                } else {
+                    throw ModelUnsupported("face without texture "
+                                           "coordinates");
+                }
+
+                if (texture >= groups.size()) {
+                    LOGTHROW(err2, std::runtime_error)
+                        << "Invalid texture number in model " << path
+                        << ".";
+                }
+                groups[texture].add(polygon, polygonTc);
+            }
+        } else {
+            for (std::size_t i(0); i != element.count; ++i) {
+                for (const auto &property : properties) {
+                    reader.skip(property);
+                }
+            }
+        }
+    }
+
+    return build(vertices, tc, groups, origin, archive, path);
+}
+
+std::string extension(const fs::path &path)
+{
+    return ba::to_lower_copy(path.extension().string());
+}
+
+} // namespace
+
+bool nativeModelFormat(const fs::path &path)
+{
+    const auto ext(extension(path));
+    return (ext == ".obj") || (ext == ".ply");
+}
+
+NativeModel loadNativeModel(const roarchive::RoArchive &archive
+                            , const fs::path &path
+                            , const math::Point3 &origin)
+{
+    const auto ext(extension(path));
+    if (ext == ".obj") { return loadObj(archive, path, origin); }
+    if (ext == ".ply") { return loadPly(archive, path, origin); }
+    throw ModelUnsupported("model format " + ext);
+}
+
+} // namespace vtstools
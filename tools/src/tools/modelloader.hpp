@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_modelloader_hpp_included_
+#define vts_tools_modelloader_hpp_included_
+
+#include <vector>
+#include <stdexcept>
+
+#include <boost/filesystem/path.hpp>
+
+#include "math/geometry_core.hpp"
+
+#include "roarchive/roarchive.hpp"
+
+#include "vts-libs/vts/mesh.hpp"
+
+/** Native loaders of simple textured model formats (Wavefront OBJ with MTL
+ *  materials, PLY).
+ *
+ *  Model file is read once and parsed in place, without any generic scene
+ *  representation and post-processing. Meant to replace Assimp for plain
+ *  textured meshes exported by photogrammetry software.
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+
+/** Thrown on valid model content this loader does not support (e.g.
+ *  untextured faces). Caller should fall back to a generic loader.
+ */
+struct ModelUnsupported : std::runtime_error {
+    ModelUnsupported(const std::string &msg) : std::runtime_error(msg) {}
+};
+
+typedef std::vector<roarchive::IStream::pointer> TextureStreams;
+
+/** Loaded model: one submesh per texture and streams of the textures in
+ *  submesh order.
+ */
+struct NativeModel {
+    vts::Mesh mesh;
+    TextureStreams textures;
+};
+
+/** Returns true if model format (determined by file extension) is supported
+ *  by loadNativeModel.
+ */
+bool nativeModelFormat(const boost::filesystem::path &path);
+
+/** Loads model from archive. Texture paths are relative to model's
+ *  directory. Vertices are shifted by origin.
+ */
+NativeModel loadNativeModel(const roarchive::RoArchive &archive
+                            , const boost::filesystem::path &path
+                            , const math::Point3 &origin);
+
+} // namespace vtstools
+
+#endif // vts_tools_modelloader_hpp_included_
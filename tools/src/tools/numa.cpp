@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <thread>
+#include <fstream>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "numa.hpp"
+
+namespace fs = boost::filesystem;
+namespace ba = boost::algorithm;
+
+namespace vtstools {
+
+std::vector<int> parseCpuList(const std::string &list)
+{
+    std::vector<int> cpus;
+
+    std::vector<std::string> parts;
+    ba::split(parts, list, ba::is_any_of(","), ba::token_compress_on);
+
+    for (auto part : parts) {
+        ba::trim(part);
+        if (part.empty()) { continue; }
+
+        const auto dash(part.find('-'));
+        if (dash == std::string::npos) {
+            cpus.push_back(boost::lexical_cast<int>(part));
+            continue;
+        }
+
+        const auto from(boost::lexical_cast<int>(part.substr(0, dash)));
+        const auto to(boost::lexical_cast<int>(part.substr(dash + 1)));
+        for (int cpu(from); cpu <= to; ++cpu) { cpus.push_back(cpu); }
+    }
+
+    return cpus;
+}
+
+NumaNode::list numaTopology()
+{
+    NumaNode::list nodes;
+
+    const fs::path root("/sys/devices/system/node");
+    try {
+        if (fs::is_directory(root)) {
+            for (fs::directory_iterator idir(root), edir;
+                 idir != edir; ++idir)
+            {
+                const auto name(idir->path().filename().string());
+                if ((name.size() <= 4) || (name.compare(0, 4, "node"))) {
+                    continue;
+                }
+
+                int id;
+                try {
+                    id = boost::lexical_cast<int>(name.substr(4));
+                } catch (const boost::bad_lexical_cast&) {
+                    continue;
+                }
+
+                std::ifstream f((idir->path() / "cpulist").string());
+                std::string list;
+                if (!std::getline(f, list)) { continue; }
+
+                NumaNode node(id);
+                node.cpus = parseCpuList(list);
+                if (!node.cpus.empty()) { nodes.push_back(node); }
+            }
+        }
+    } catch (const std::exception &e) {
+        LOG(warn2) << "Unable to read NUMA topology: " << e.what() << ".";
+        nodes.clear();
+    }
+
+    if (nodes.empty()) {
+        // no topology, single node with all CPUs
+        NumaNode node;
+        const int count(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu(0); cpu < count; ++cpu) { node.cpus.push_back(cpu); }
+        nodes.push_back(node);
+    }
+
+    std::sort(nodes.begin(), nodes.end()
+              , [](const NumaNode &l, const NumaNode &r)
+              {
+                  return l.id < r.id;
+              });
+
+    return nodes;
+}
+
+} // namespace vtstools
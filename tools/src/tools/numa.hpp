@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_numa_hpp_included_
+#define vts_tools_numa_hpp_included_
+
+#include <vector>
+#include <string>
+
+namespace vtstools {
+
+/** NUMA node as seen by the kernel.
+ */
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+
+    NumaNode(int id = 0) : id(id) {}
+
+    typedef std::vector<NumaNode> list;
+};
+
+/** Returns NUMA nodes of this machine (from /sys/devices/system/node). When
+ *  topology is not available, one node with all online CPUs is returned.
+ */
+NumaNode::list numaTopology();
+
+/** Parses kernel CPU list (e.g. "0-7,16-23").
+ */
+std::vector<int> parseCpuList(const std::string &list);
+
+} // namespace vtstools
+
+#endif // vts_tools_numa_hpp_included_
@@ -0,0 +1,608 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <unistd.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <system_error>
+#include <algorithm>
+#include <limits>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "shard.hpp"
+#include "numa.hpp"
+#include "threadpool.hpp"
+#include "tmptsmerge.hpp"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+extern char **environ;
+
+namespace vtstools {
+
+namespace {
+
+/** Command line saved by saveCommandLine().
+ */
+std::vector<std::string> commandLine;
+
+/** Temporary tileset inside output tileset (as used by TmpTsEncoder).
+ */
+fs::path tmpsetPath(const fs::path &output)
+{
+    return output / "tmp";
+}
+
+/** Default whole extents: everything in the reference frame.
+ */
+vts::LodTileRange wholeExtents(const boost::optional<vts::LodTileRange>
+                               &tileExtents)
+{
+    if (tileExtents) { return *tileExtents; }
+    return vts::LodTileRange(0, vts::TileRange(0, 0, 0, 0));
+}
+
+/** Null-terminated array of C strings for exec.
+ */
+class CStrings {
+public:
+    CStrings(const std::vector<std::string> &strings)
+        : strings_(strings)
+    {
+        for (auto &s : strings_) { ptrs_.push_back(&s[0]); }
+        ptrs_.push_back(nullptr);
+    }
+
+    char* const* get() const { return ptrs_.data(); }
+
+private:
+    std::vector<std::string> strings_;
+    std::vector<char*> ptrs_;
+};
+
+struct Worker {
+    unsigned int index;
+    ::pid_t pid;
+    std::vector<std::string> args;
+    std::vector<std::string> env;
+    boost::optional< ::cpu_set_t> affinity;
+    std::string where;
+
+    Worker(unsigned int index) : index(index), pid(-1) {}
+};
+
+} // namespace
+
+bool Shard::owns(const vts::TileId &tileId) const
+{
+    const auto lod(extents_.lod);
+
+    vts::TileRange::value_type x, y;
+    if (tileId.lod >= lod) {
+        // parent at shard LOD
+        const auto diff(tileId.lod - lod);
+        x = tileId.x >> diff;
+        y = tileId.y >> diff;
+    } else {
+        // lowest child at shard LOD, clamped to whole extents
+        const auto diff(lod - tileId.lod);
+        x = std::min(std::max(tileId.x << diff, whole_.range.ll(0))
+                     , whole_.range.ur(0));
+        y = std::min(std::max(tileId.y << diff, whole_.range.ll(1))
+                     , whole_.range.ur(1));
+    }
+
+    const auto &r(extents_.range);
+    return ((x >= r.ll(0)) && (x <= r.ur(0))
+            && (y >= r.ll(1)) && (y <= r.ur(1)));
+}
+
+bool Shard::overlaps(vts::Lod lod, const vts::TileRange &range) const
+{
+    return vts::tileRangesOverlap(range, vts::shiftRange(extents_, lod));
+}
+
+Shard::list splitExtents(const vts::LodTileRange &extents, unsigned int count)
+{
+    auto lod(extents.lod);
+    auto range(extents.range);
+
+    typedef vts::TileRange::value_type Index;
+    const auto width([&]() -> Index {
+            return range.ur(0) - range.ll(0) + 1;
+        });
+    const auto height([&]() -> Index {
+            return range.ur(1) - range.ll(1) + 1;
+        });
+
+    // refine until there is enough tiles along the longer side; limited to
+    // sane depth
+    while ((std::max(width(), height()) < count) && (lod < extents.lod + 8)) {
+        ++lod;
+        range = vts::TileRange(range.ll(0) << 1, range.ll(1) << 1
+                               , (range.ur(0) << 1) + 1
+                               , (range.ur(1) << 1) + 1);
+    }
+
+    const vts::LodTileRange whole(lod, range);
+
+    // split into stripes along the longer side
+    const int axis((width() >= height()) ? 0 : 1);
+    const Index length(axis ? height() : width());
+    const Index stripes(std::min<Index>(std::max(count, 1u), length));
+
+    Shard::list shards;
+    for (Index i(0); i < stripes; ++i) {
+        auto r(range);
+        r.ll(axis) = range.ll(axis) + (i * length) / stripes;
+        r.ur(axis) = range.ll(axis) + ((i + 1) * length) / stripes - 1;
+        shards.emplace_back(vts::LodTileRange(lod, r), whole);
+    }
+
+    return shards;
+}
+
+void ShardConfig::configuration(po::options_description &config)
+{
+    config.add_options()
+        ("shard.count", po::value(&count)->default_value(count)
+         , "Split output into given number of disjoint shards and cut them "
+         "in the same number of local worker processes. Resulting temporary "
+         "tilesets are merged before tileset generation. "
+         "0 or 1 means no sharding.")
+        ("shard.numa", po::value(&numa)
+         ->default_value(numa)->implicit_value(true)
+         , "Bind worker processes to NUMA nodes (round-robin).")
+        ("shard.worker", po::value<unsigned int>()
+         , "Internal: index of worker process. Do not use.")
+        ("shard.analysis", po::value<fs::path>()
+         , "Internal: analysis result stored by coordinator. Do not use.")
+        ;
+}
+
+void ShardConfig::configure(const po::variables_map &vars)
+{
+    if (vars.count("shard.analysis")) {
+        analysis = vars["shard.analysis"].as<fs::path>();
+    }
+
+    if (vars.count("shard.worker")) {
+        worker = vars["shard.worker"].as<unsigned int>();
+        if (*worker >= count) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Invalid shard worker index " << *worker
+                << " (shard count: " << count << ").";
+        }
+    }
+}
+
+boost::optional<Shard>
+ShardConfig::shard(const boost::optional<vts::LodTileRange> &tileExtents)
+    const
+{
+    if (!worker) { return boost::none; }
+
+    const auto shards(splitExtents(wholeExtents(tileExtents), count));
+    if (*worker >= shards.size()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "No shard for worker " << *worker << ".";
+    }
+
+    const auto &shard(shards[*worker]);
+    LOG(info3) << "Worker " << *worker << " cuts shard "
+               << shard.extents() << ".";
+    return shard;
+}
+
+void saveCommandLine(int argc, char *argv[])
+{
+    commandLine.assign(argv, argv + argc);
+}
+
+fs::path shardOutput(const fs::path &output, unsigned int worker)
+{
+    auto path(output);
+    path += ".shard" + boost::lexical_cast<std::string>(worker);
+    return path;
+}
+
+void finishShard(const fs::path &output, tools::TmpTileset &tmpset
+                 , const vts::NtGenerator &ntg)
+{
+    tmpset.flush();
+    tmpset.keep(true);
+    ntg.save(tmpsetPath(output) / "navtile.info");
+    LOG(info4) << "Shard cut into " << tmpsetPath(output) << ".";
+}
+
+fs::path shardAnalysis(const fs::path &output)
+{
+    auto path(output);
+    path += ".analysis";
+    return path;
+}
+
+void saveShardAnalysis(const fs::path &path, const Json::Value &analysis)
+{
+    std::ofstream f(path.string());
+    Json::FastWriter writer;
+    f << writer.write(analysis);
+    f.close();
+
+    if (!f) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to write analysis result into " << path << ".";
+    }
+    LOG(info3) << "Analysis result stored in " << path << ".";
+}
+
+Json::Value loadShardAnalysis(const fs::path &path)
+{
+    std::ifstream f(path.string());
+    Json::Value value;
+    Json::Reader reader;
+    if (!f || !reader.parse(f, value)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to load analysis result from " << path << ": "
+            << reader.getFormattedErrorMessages() << ".";
+    }
+    LOG(info3) << "Using analysis result from " << path << ".";
+    return value;
+}
+
+Json::Value asJson(const vts::TileId &tileId)
+{
+    Json::Value value(Json::arrayValue);
+    value.append(Json::UInt(tileId.lod));
+    value.append(Json::UInt(tileId.x));
+    value.append(Json::UInt(tileId.y));
+    return value;
+}
+
+Json::Value asJson(const math::Extents2 &extents)
+{
+    Json::Value value(Json::arrayValue);
+    value.append(extents.ll(0));
+    value.append(extents.ll(1));
+    value.append(extents.ur(0));
+    value.append(extents.ur(1));
+    return value;
+}
+
+Json::Value asJson(const vts::LodRange &lodRange)
+{
+    Json::Value value(Json::arrayValue);
+    value.append(Json::UInt(lodRange.min));
+    value.append(Json::UInt(lodRange.max));
+    return value;
+}
+
+vts::TileId parseTileId(const Json::Value &value)
+{
+    return vts::TileId(value[Json::ArrayIndex(0)].asUInt()
+                       , value[Json::ArrayIndex(1)].asUInt()
+                       , value[Json::ArrayIndex(2)].asUInt());
+}
+
+math::Extents2 parseExtents(const Json::Value &value)
+{
+    return math::Extents2(value[Json::ArrayIndex(0)].asDouble()
+                          , value[Json::ArrayIndex(1)].asDouble()
+                          , value[Json::ArrayIndex(2)].asDouble()
+                          , value[Json::ArrayIndex(3)].asDouble());
+}
+
+vts::LodRange parseLodRange(const Json::Value &value)
+{
+    return vts::LodRange(value[Json::ArrayIndex(0)].asUInt()
+                         , value[Json::ArrayIndex(1)].asUInt());
+}
+
+const vts::NodeInfo& findNode(const vts::NodeInfo::list &nodes
+                              , const vts::TileId &nodeId)
+{
+    for (const auto &node : nodes) {
+        if (node.nodeId() == nodeId) { return node; }
+    }
+    LOGTHROW(err2, std::runtime_error)
+        << "Analysis result refers to unknown RF node " << nodeId << ".";
+    throw;
+}
+
+TreeAnalysis::TreeAnalysis()
+    : topDepth(std::numeric_limits<int>::max())
+    , commonBottom(std::numeric_limits<int>::max())
+    , bottomDepth(-1)
+{}
+
+tools::LodInfo TreeAnalysis::lodInfo() const
+{
+    auto lodInfo(tools::LodInfo::invalid());
+    lodInfo.topDepth = topDepth;
+    lodInfo.commonBottom = commonBottom;
+    lodInfo.bottomDepth = bottomDepth;
+    for (const auto &item : subtrees) {
+        lodInfo.localLods[item.first]
+            = tools::LodParams(item.second.extents, item.second.lod);
+    }
+    return lodInfo;
+}
+
+Json::Value TreeAnalysis::json() const
+{
+    Json::Value value(Json::objectValue);
+    value["topDepth"] = topDepth;
+    value["commonBottom"] = commonBottom;
+    value["bottomDepth"] = bottomDepth;
+
+    auto &list(value["subtrees"] = Json::Value(Json::arrayValue));
+    for (const auto &item : subtrees) {
+        auto &subtree(list.append(Json::Value(Json::objectValue)));
+        subtree["node"] = asJson(item.first->nodeId());
+        subtree["extents"] = asJson(item.second.extents);
+        subtree["lod"] = Json::UInt(item.second.lod);
+    }
+    return value;
+}
+
+TreeAnalysis TreeAnalysis::parse(const Json::Value &value
+                                 , const vts::NodeInfo::list &nodes)
+{
+    TreeAnalysis analysis;
+    analysis.topDepth = value["topDepth"].asInt();
+    analysis.commonBottom = value["commonBottom"].asInt();
+    analysis.bottomDepth = value["bottomDepth"].asInt();
+
+    for (const auto &subtree : value["subtrees"]) {
+        analysis.assign(findNode(nodes, parseTileId(subtree["node"]))
+                        , parseExtents(subtree["extents"])
+                        , subtree["lod"].asUInt());
+    }
+    return analysis;
+}
+
+boost::optional<TreeAnalysis>
+shardedAnalysis(const ShardConfig &config, const vts::NodeInfo::list &nodes
+                , const std::function<TreeAnalysis()> &analyze)
+{
+    if (config.loadAnalysis()) {
+        return TreeAnalysis::parse(loadShardAnalysis(*config.analysis)
+                                   , nodes);
+    }
+
+    auto analysis(analyze());
+    if (config.storeAnalysis()) {
+        saveShardAnalysis(*config.analysis, analysis.json());
+        return boost::none;
+    }
+    return analysis;
+}
+
+void ShardCoordinator::run() const
+{
+    if (commandLine.empty()) {
+        LOGTHROW(err2, std::logic_error)
+            << "Command line not saved, cannot launch workers.";
+    }
+
+    if (!config_.analysis) {
+        LOGTHROW(err2, std::logic_error)
+            << "Input not analyzed, cannot launch workers.";
+    }
+
+    const auto shards(splitExtents(wholeExtents(tileExtents_)
+                                   , config_.count));
+
+    // CPUs we may use (cpusets, affinity), split among workers
+    const auto cpus(availableCpus());
+
+    NumaNode::list nodes;
+    if (config_.numa) {
+        for (auto node : numaTopology()) {
+            auto &nc(node.cpus);
+            nc.erase(std::remove_if(nc.begin(), nc.end(), [&](int cpu) {
+                        return (std::find(cpus.begin(), cpus.end(), cpu)
+                                == cpus.end());
+                    }), nc.end());
+            if (!nc.empty()) { nodes.push_back(node); }
+        }
+    }
+
+    // threads per worker when not bound to a node
+    const auto workerThreads
+        (std::max<std::size_t>(1, cpus.size() / shards.size()));
+
+    // worker arguments: user's thread count (if any) replaced by worker's
+    // share of the CPUs
+    std::vector<std::string> args;
+    for (auto ia(commandLine.begin()), ea(commandLine.end()); ia != ea; ++ia)
+    {
+        if (*ia == "--threads") {
+            if (ia + 1 != ea) { ++ia; }
+            continue;
+        }
+        if (!ia->compare(0, 10, "--threads=")) { continue; }
+        args.push_back(*ia);
+    }
+
+    // environment, OpenMP thread count replaced by worker's share as well
+    std::vector<std::string> env;
+    for (char **e(environ); *e; ++e) {
+        if (!std::strncmp(*e, "OMP_NUM_THREADS=", 16)) { continue; }
+        env.emplace_back(*e);
+    }
+
+    std::vector<Worker> workers;
+    for (unsigned int i(0); i < shards.size(); ++i) {
+        workers.emplace_back(i);
+        auto &worker(workers.back());
+        std::size_t threads(workerThreads);
+
+        if (!nodes.empty()) {
+            const auto &node(nodes[i % nodes.size()]);
+            ::cpu_set_t set;
+            CPU_ZERO(&set);
+            for (auto cpu : node.cpus) { CPU_SET(cpu, &set); }
+            worker.affinity = set;
+            // workers sharing a node share its CPUs
+            const auto sharing((shards.size() + nodes.size() - 1
+                                - (i % nodes.size())) / nodes.size());
+            threads = std::max<std::size_t>(1, node.cpus.size() / sharing);
+            worker.where = " on NUMA node "
+                + boost::lexical_cast<std::string>(node.id);
+        }
+
+        const auto threadsStr(boost::lexical_cast<std::string>(threads));
+
+        worker.args = args;
+        worker.args.push_back("--shard.worker");
+        worker.args.push_back(boost::lexical_cast<std::string>(i));
+        worker.args.push_back("--shard.analysis");
+        worker.args.push_back(config_.analysis->string());
+        worker.args.push_back("--threads");
+        worker.args.push_back(threadsStr);
+
+        worker.env = env;
+        worker.env.push_back("OMP_NUM_THREADS=" + threadsStr);
+
+        // start with clean worker output
+        fs::remove_all(shardOutput(output_, i));
+    }
+
+    // launch
+    for (auto &worker : workers) {
+        const CStrings args(worker.args);
+        const CStrings env(worker.env);
+
+        const auto pid(::fork());
+        if (pid < 0) {
+            std::system_error e(errno, std::system_category());
+            LOGTHROW(err2, std::runtime_error)
+                << "Cannot launch worker: <" << e.code()
+                << ", " << e.what() << ">.";
+        }
+
+        if (!pid) {
+            // child
+            if (worker.affinity) {
+                ::sched_setaffinity(0, sizeof(*worker.affinity)
+                                    , &*worker.affinity);
+            }
+            ::execve("/proc/self/exe", args.get(), env.get());
+            ::_exit(127);
+        }
+
+        worker.pid = pid;
+        LOG(info4) << "Launched worker " << worker.index << " (pid "
+                   << pid << ") for shard " << shards[worker.index].extents()
+                   << worker.where << ".";
+    }
+
+    // wait for all workers
+    bool failed(false);
+    for (std::size_t running(workers.size()); running; ) {
+        int status;
+        const auto pid(::waitpid(-1, &status, 0));
+        if (pid < 0) {
+            if (errno == EINTR) { continue; }
+            std::system_error e(errno, std::system_category());
+            LOGTHROW(err2, std::runtime_error)
+                << "Cannot wait for workers: <" << e.code()
+                << ", " << e.what() << ">.";
+        }
+
+        auto iworker(std::find_if(workers.begin(), workers.end()
+                                  , [&](const Worker &w) {
+                                      return w.pid == pid;
+                                  }));
+        if (iworker == workers.end()) { continue; }
+        --running;
+
+        if (WIFEXITED(status) && !WEXITSTATUS(status)) {
+            LOG(info4) << "Worker " << iworker->index << " finished.";
+            continue;
+        }
+
+        failed = true;
+        if (WIFSIGNALED(status)) {
+            LOG(err3) << "Worker " << iworker->index << " killed by signal "
+                      << WTERMSIG(status) << ".";
+        } else {
+            LOG(err3) << "Worker " << iworker->index
+                      << " failed with status " << WEXITSTATUS(status) << ".";
+        }
+    }
+
+    if (failed) {
+        LOGTHROW(err3, std::runtime_error)
+            << "Some workers failed; shard outputs kept for inspection.";
+    }
+
+    merge();
+
+    if (!keepShards_) {
+        for (const auto &worker : workers) {
+            fs::remove_all(shardOutput(output_, worker.index));
+        }
+        fs::remove(*config_.analysis);
+    }
+}
+
+void ShardCoordinator::merge() const
+{
+    const auto shards(splitExtents(wholeExtents(tileExtents_)
+                                   , config_.count).size());
+
+    LOG(info4) << "Merging " << shards << " shards into "
+               << tmpsetPath(output_) << ".";
+
+    std::vector<fs::path> sources;
+    for (unsigned int i(0); i < shards; ++i) {
+        sources.push_back(tmpsetPath(shardOutput(output_, i)));
+    }
+
+    // navtile info is the same in all shards (analysis is not sharded)
+    tools::TmpTileset dst(tmpsetPath(output_), true);
+    dst.keep(true);
+    const auto stats(mergeTmpTilesets(sources, tmpsetPath(output_), dst));
+    dst.flush();
+
+    LOG(info4) << "Merged " << stats.tiles << " tiles.";
+}
+
+} // namespace vtstools
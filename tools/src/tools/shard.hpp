@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_shard_hpp_included_
+#define vts_tools_shard_hpp_included_
+
+#include <map>
+#include <vector>
+#include <functional>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/program_options.hpp>
+
+#include "vts-libs/vts.hpp"
+#include "vts-libs/vts/ntgenerator.hpp"
+#include "vts-libs/tools-support/tmptileset.hpp"
+#include "vts-libs/tools-support/analyze.hpp"
+
+#include "jsoncpp/json.hpp"
+
+/** Multi-process conversion.
+ *
+ *  Coordinator splits output tile extents into disjoint shards and launches
+ *  one local worker process (the same binary with the same command line) per
+ *  shard. Every worker cuts only tiles owned by its shard into its own
+ *  temporary tileset. Coordinator then merges these temporary tilesets and
+ *  generates the output tileset as if resuming. Merge decodes and re-encodes
+ *  every tile (see mergeTmpTilesets()).
+ *
+ *  Input is analyzed only once, by the coordinator, before workers are
+ *  launched; workers load the stored analysis result and only cut.
+ *
+ *  Border conditions are still computed from the global tile extents, i.e.
+ *  borderClipMargin is applied only at the real output border and never at
+ *  the artificial borders between shards.
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+namespace tools = vtslibs::vts::tools;
+
+/** Disjoint part of output tile extents.
+ */
+class Shard {
+public:
+    /** Shard of whole output.
+     *
+     * \param extents shard extents
+     * \param whole whole output extents (same LOD as shard extents)
+     */
+    Shard(const vts::LodTileRange &extents, const vts::LodTileRange &whole)
+        : extents_(extents), whole_(whole)
+    {}
+
+    /** Is tile generated by this shard? Tiles above shard LOD are owned by the
+     *  shard that owns their lowest (clamped to whole extents) child.
+     */
+    bool owns(const vts::TileId &tileId) const;
+
+    /** Can any tile from given range at given LOD be owned by this shard?
+     */
+    bool overlaps(vts::Lod lod, const vts::TileRange &range) const;
+
+    const vts::LodTileRange& extents() const { return extents_; }
+
+    typedef std::vector<Shard> list;
+
+private:
+    vts::LodTileRange extents_;
+    vts::LodTileRange whole_;
+};
+
+/** Splits whole output extents into (at most) count disjoint shards of
+ *  (roughly) the same area. Extents are refined to finer LODs when there are
+ *  not enough tiles to split.
+ */
+Shard::list splitExtents(const vts::LodTileRange &extents, unsigned int count);
+
+/** Sharding configuration.
+ */
+struct ShardConfig {
+    /** Number of shards/worker processes, 0 or 1 means no sharding.
+     */
+    unsigned int count;
+
+    /** Index of this worker. Set only in worker processes.
+     */
+    boost::optional<unsigned int> worker;
+
+    /** Bind workers to NUMA nodes.
+     */
+    bool numa;
+
+    /** Analysis result file. Written by the coordinator, read by workers.
+     */
+    boost::optional<boost::filesystem::path> analysis;
+
+    ShardConfig() : count(0), numa(false) {}
+
+    void configuration(boost::program_options::options_description &config);
+    void configure(const boost::program_options::variables_map &vars);
+
+    /** Should this process launch workers?
+     */
+    bool coordinator() const { return (count > 1) && !worker; }
+
+    /** Shard processed by this worker (none for non-workers).
+     */
+    boost::optional<Shard>
+    shard(const boost::optional<vts::LodTileRange> &tileExtents) const;
+
+    /** Should this process only analyze input and store the result?
+     */
+    bool storeAnalysis() const { return coordinator() && analysis; }
+
+    /** Should this process load analysis stored by the coordinator?
+     */
+    bool loadAnalysis() const { return worker && analysis; }
+};
+
+/** Analysis result file of sharded conversion into given output.
+ */
+boost::filesystem::path shardAnalysis(const boost::filesystem::path &output);
+
+void saveShardAnalysis(const boost::filesystem::path &path
+                       , const Json::Value &analysis);
+
+Json::Value loadShardAnalysis(const boost::filesystem::path &path);
+
+/** Analysis result serialization helpers.
+ */
+Json::Value asJson(const vts::TileId &tileId);
+Json::Value asJson(const math::Extents2 &extents);
+Json::Value asJson(const vts::LodRange &lodRange);
+vts::TileId parseTileId(const Json::Value &value);
+math::Extents2 parseExtents(const Json::Value &value);
+vts::LodRange parseLodRange(const Json::Value &value);
+
+/** Finds RF node by ID in given list. Throws when not found.
+ */
+const vts::NodeInfo& findNode(const vts::NodeInfo::list &nodes
+                              , const vts::TileId &nodeId);
+
+/** Analysis result of tree-like input (SLPK, 3D Tiles, LODTree): tree depths
+ *  and local LOD assigned to every RF node subtree with data.
+ */
+struct TreeAnalysis {
+    int topDepth;
+    int commonBottom;
+    int bottomDepth;
+
+    struct Subtree {
+        /** Mesh extents in subtree SRS.
+         */
+        math::Extents2 extents;
+        vts::Lod lod;
+    };
+
+    std::map<const vts::NodeInfo*, Subtree> subtrees;
+
+    /** Invalid depths, no subtree.
+     */
+    TreeAnalysis();
+
+    /** Assigns local LOD to given subtree.
+     */
+    void assign(const vts::NodeInfo &node, const math::Extents2 &extents
+                , vts::Lod lod)
+    {
+        subtrees[&node] = Subtree{ extents, lod };
+    }
+
+    tools::LodInfo lodInfo() const;
+
+    Json::Value json() const;
+
+    /** Parses result stored by json(), nodes are taken from given list.
+     */
+    static TreeAnalysis parse(const Json::Value &value
+                              , const vts::NodeInfo::list &nodes);
+};
+
+/** Analyzes tree-like input unless analysis was done by the shard
+ *  coordinator. Coordinator stores the result and gets none (there is
+ *  nothing to cut in the coordinator), workers load stored result.
+ */
+boost::optional<TreeAnalysis>
+shardedAnalysis(const ShardConfig &config, const vts::NodeInfo::list &nodes
+                , const std::function<TreeAnalysis()> &analyze);
+
+/** Remembers process command line. Must be called from main() by every tool
+ *  supporting sharding.
+ */
+void saveCommandLine(int argc, char *argv[]);
+
+/** Output tileset of given worker.
+ */
+boost::filesystem::path shardOutput(const boost::filesystem::path &output
+                                    , unsigned int worker);
+
+/** Worker's epilogue: keeps temporary tileset (including navtile info) for
+ *  the coordinator instead of generating the output tileset.
+ */
+void finishShard(const boost::filesystem::path &output
+                 , tools::TmpTileset &tmpset
+                 , const vts::NtGenerator &ntg);
+
+/** Coordinator. Launches workers, waits for them and merges their temporary
+ *  tilesets into output's temporary tileset. Output is then generated by the
+ *  caller in resume mode.
+ *
+ *  Input must be already analyzed into config.analysis; workers load it.
+ *
+ *  CPUs available to the coordinator are split evenly among workers: any
+ *  --threads and OMP_NUM_THREADS given by the user are replaced by the
+ *  worker's share.
+ */
+class ShardCoordinator {
+public:
+    ShardCoordinator(const boost::filesystem::path &output
+                     , const boost::optional<vts::LodTileRange> &tileExtents
+                     , const ShardConfig &config, bool keepShards = false)
+        : output_(output), tileExtents_(tileExtents)
+        , config_(config), keepShards_(keepShards)
+    {}
+
+    void run() const;
+
+private:
+    void merge() const;
+
+    const boost::filesystem::path output_;
+    const boost::optional<vts::LodTileRange> tileExtents_;
+    const ShardConfig config_;
+    const bool keepShards_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_shard_hpp_included_
@@ -24,6 +24,10 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <map>
+#include <mutex>
+#include <sstream>
+
 #include <boost/utility/in_place_factory.hpp>
 
 #include <opencv2/highgui/highgui.hpp>
@@ -32,7 +36,7 @@
 #include "utility/gccversion.hpp"
 #include "utility/limits.hpp"
 #include "utility/path.hpp"
-#include "utility/openmp.hpp"
+#include "utility/binaryio.hpp"
 
 #include "service/cmdline.hpp"
 
@@ -57,6 +61,18 @@
 #include "vts-libs/tools-support/repackatlas.hpp"
 #include "vts-libs/tools-support/analyze.hpp"
 
+#include "cutengine.hpp"
+#include "shard.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "threadpool.hpp"
+#include "geometrycache.hpp"
+#include "slpktextures.hpp"
+#include "compressedtexture.hpp"
+#include "slpktree.hpp"
+#include "slpknodepages.hpp"
+#include "draco.hpp"
+
 namespace po = boost::program_options;
 namespace bio = boost::iostreams;
 namespace fs = boost::filesystem;
@@ -66,26 +82,29 @@ namespace vr = vtslibs::registry;
 namespace vts = vtslibs::vts;
 namespace vt = vtslibs::tools;
 namespace tools = vtslibs::vts::tools;
+namespace bin = utility::binaryio;
 
 namespace {
 
-struct Config : tools::TmpTsEncoder::Config {
+struct Config : tools::TmpTsEncoder::Config, vtstools::CutConfig {
     std::string tilesetId;
     std::string referenceFrame;
     math::Size2 optimalTextureSize;
     double ntLodPixelSize;
 
-    boost::optional<vts::LodTileRange> tileExtents;
-    double clipMargin;
-    double borderClipMargin;
-    double zShift;
+    /** Geometry cache memory and spill file limits in MB.
+     */
+    std::size_t geometryCache;
+    std::size_t geometryCacheSpill;
+    fs::path geometryCacheSpillDir;
+
+    vtstools::ShardConfig sharding;
 
     Config()
         : optimalTextureSize(256, 256)
         , ntLodPixelSize(1.0)
-        , clipMargin(1.0 / 128.)
-        , borderClipMargin(clipMargin)
-        , zShift(0.0)
+        , geometryCache(1024)
+        , geometryCacheSpill(0)
     {}
 
     void configuration(po::options_description &config) {
@@ -129,7 +148,27 @@ struct Config : tools::TmpTsEncoder::Config {
              ->default_value(zShift)->required()
              , "Manual height adjustment (value is "
              "added to z component of all vertices).")
+
+            ("geometryCache", po::value(&geometryCache)
+             ->default_value(geometryCache)->required()
+             , "Memory limit (in MB) of cache of node geometry decoded during "
+             "analysis and reused when cutting (each node once). When full, "
+             "least recently stored nodes are spilled to disk (see "
+             "geometryCache.spill) or dropped and decoded again. Zero "
+             "disables the cache.")
+            ("geometryCache.spill", po::value(&geometryCacheSpill)
+             ->default_value(geometryCacheSpill)->required()
+             , "Size limit (in MB) of geometry cache spill file. Zero "
+             "(default) disables spilling.")
+            ("geometryCache.spillDir", po::value(&geometryCacheSpillDir)
+             , "Directory of geometry cache spill file. Defaults to system "
+             "temporary directory.")
             ;
+
+        sharding.configuration(config);
+        vtstools::metricsConfiguration(config);
+        vtstools::traceConfiguration(config);
+        vtstools::threadPoolConfiguration(config);
     }
 
     void configure(const po::variables_map &vars) {
@@ -138,6 +177,12 @@ struct Config : tools::TmpTsEncoder::Config {
         if (vars.count("tileExtents")) {
             tileExtents = vars["tileExtents"].as<vts::LodTileRange>();
         }
+
+        sharding.configure(vars);
+        shard = sharding.shard(tileExtents);
+        vtstools::configureMetrics(vars);
+        vtstools::configureTrace(vars);
+        vtstools::configureThreadPool(vars);
     }
 };
 
@@ -204,6 +249,12 @@ void Slpk2Vts::configure(const po::variables_map &vars)
                    ? vts::CreateMode::overwrite
                    : vts::CreateMode::failIfExists);
 
+    if (config_.sharding.worker) {
+        // worker cuts into its own tileset
+        output_ = vtstools::shardOutput(output_, *config_.sharding.worker);
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     epConfig_ = vt::configureProgress(vars);
 }
 
@@ -238,12 +289,27 @@ public:
 
         regions_.emplace_back();
         currentRInfo_ = &regions_.back();
+        rawRegions_.emplace_back();
         return *this;
     }
 
     const vts::Mesh& mesh() const { return mesh_; }
     const RegionInfo::list& regions() const { return regions_; }
 
+    /** Serializes loaded geometry into compact binary form.
+     */
+    std::string save() const;
+
+    /** Loads geometry serialized by save().
+     */
+    void load(const std::string &blob);
+
+    /** Loads I3S Draco compressed geometry. Vertex positions are relative to
+     *  given center.
+     */
+    void loadDraco(const char *data, std::size_t size
+                   , const math::Point3 &center);
+
     virtual void addVertex(const math::Point3d &v) {
         current_->vertices.push_back(v);
     }
@@ -260,6 +326,7 @@ public:
 
     virtual void addTxRegion(const Region &region) {
         currentRInfo_->regions.emplace_back(region);
+        rawRegions_.back().push_back(region);
     }
 
 private:
@@ -269,8 +336,213 @@ private:
     vts::SubMesh *current_;
     RegionInfo::list regions_;
     RegionInfo *currentRInfo_;
+
+    /** Regions as received from the archive, kept for serialization.
+     */
+    std::vector<std::vector<Region>> rawRegions_;
+};
+
+std::string VtsMeshLoader::save() const
+{
+    std::ostringstream os;
+    os.exceptions(std::ios::badbit | std::ios::failbit);
+
+    const auto size([&](std::size_t value) {
+        bin::write(os, std::uint32_t(value));
+    });
+
+    size(mesh_.submeshes.size());
+    for (std::size_t i(0), e(mesh_.submeshes.size()); i != e; ++i) {
+        const auto &sm(mesh_.submeshes[i]);
+        const auto &ri(regions_[i]);
+
+        size(sm.vertices.size());
+        for (const auto &v : sm.vertices) {
+            bin::write(os, v(0)); bin::write(os, v(1)); bin::write(os, v(2));
+        }
+
+        size(sm.tc.size());
+        for (const auto &t : sm.tc) {
+            bin::write(os, t(0)); bin::write(os, t(1));
+        }
+
+        // faces, texture faces and face regions are parallel arrays
+        size(sm.faces.size());
+        for (std::size_t f(0), fe(sm.faces.size()); f != fe; ++f) {
+            const auto &face(sm.faces[f]);
+            const auto &faceTc(sm.facesTc[f]);
+            for (int j : { 0, 1, 2 }) {
+                bin::write(os, std::uint32_t(face(j)));
+            }
+            for (int j : { 0, 1, 2 }) {
+                bin::write(os, std::uint32_t(faceTc(j)));
+            }
+            bin::write(os, std::int32_t(ri.faces[f]));
+        }
+
+        size(rawRegions_[i].size());
+        for (const auto &region : rawRegions_[i]) {
+            bin::write(os, region.ll(0)); bin::write(os, region.ll(1));
+            bin::write(os, region.ur(0)); bin::write(os, region.ur(1));
+        }
+    }
+
+    return os.str();
+}
+
+void VtsMeshLoader::load(const std::string &blob)
+{
+    std::istringstream is(blob);
+    is.exceptions(std::ios::badbit | std::ios::failbit);
+
+    const auto size([&]() -> std::size_t {
+        std::uint32_t value;
+        bin::read(is, value);
+        return value;
+    });
+
+    const auto point([&](math::Point2d &p) {
+        bin::read(is, p(0)); bin::read(is, p(1));
+    });
+
+    for (auto count(size()); count; --count) {
+        next();
+        auto &sm(*current_);
+        auto &ri(*currentRInfo_);
+
+        sm.vertices.resize(size());
+        for (auto &v : sm.vertices) {
+            bin::read(is, v(0)); bin::read(is, v(1)); bin::read(is, v(2));
+        }
+
+        sm.tc.resize(size());
+        for (auto &t : sm.tc) { point(t); }
+
+        const auto faces(size());
+        sm.faces.resize(faces);
+        sm.facesTc.resize(faces);
+        ri.faces.resize(faces);
+        for (std::size_t f(0); f != faces; ++f) {
+            std::uint32_t index;
+            for (int j : { 0, 1, 2 }) {
+                bin::read(is, index);
+                sm.faces[f](j) = index;
+            }
+            for (int j : { 0, 1, 2 }) {
+                bin::read(is, index);
+                sm.facesTc[f](j) = index;
+            }
+            std::int32_t region;
+            bin::read(is, region);
+            ri.faces[f] = region;
+        }
+
+        for (auto regions(size()); regions; --regions) {
+            Region region;
+            point(region.ll);
+            point(region.ur);
+            addTxRegion(region);
+        }
+    }
+}
+
+void VtsMeshLoader::loadDraco(const char *data, std::size_t size
+                              , const math::Point3 &center)
+{
+    next();
+    auto &sm(*current_);
+
+    std::vector<vtstools::DracoUvRegion> uvRegions;
+    vtstools::decodeDraco(data, size, sm, vtstools::DracoAttributes()
+                          , &uvRegions);
+
+    for (auto &v : sm.vertices) { v += center; }
+
+    // I3S texture origin is at the top-left corner
+    for (auto &t : sm.tc) { t(1) = 1.0 - t(1); }
+
+    if (sm.tc.empty()) { return; }
+
+    // per-vertex regions to per-face region indices
+    currentRInfo_->faces.resize(sm.faces.size(), 0);
+    if (uvRegions.empty()) { return; }
+
+    std::map<vtstools::DracoUvRegion, int> regions;
+    for (std::size_t f(0), e(sm.faces.size()); f != e; ++f) {
+        const auto &uvr(uvRegions[sm.faces[f](0)]);
+        auto fregions(regions.find(uvr));
+        if (fregions == regions.end()) {
+            const auto n(65535.0);
+            fregions = regions.insert(std::make_pair
+                                      (uvr, int(regions.size()))).first;
+            addTxRegion(Region(math::Point2(uvr[0] / n, 1.0 - uvr[3] / n)
+                               , math::Point2(uvr[2] / n
+                                              , 1.0 - uvr[1] / n)));
+        }
+        currentRInfo_->faces[f] = fregions->second;
+    }
+}
+
+/** Node geometry source. Draco compressed geometry described by node pages
+ *  is decoded from mapped package, everything else is loaded through the
+ *  archive.
+ *
+ *  NB: legacy (non-Draco) geometry is decoded by the slpk library, which only
+ *  reads through slpk::Archive streams; concurrent loads of such geometry
+ *  serialize on the archive. This is the remaining I/O bottleneck of cutting
+ *  legacy packages: only common bottom nodes held by the geometry cache avoid
+ *  it, every other node is read through the archive (traced as
+ *  "loadArchiveGeometry").
+ */
+class GeometrySource {
+public:
+    GeometrySource(const slpk::Archive &archive
+                   , const vtstools::MappedZip *zip
+                   , const vtstools::SlpkNodePages *pages)
+        : archive_(archive), zip_(zip), pages_(pages)
+    {}
+
+    void load(VtsMeshLoader &loader, const slpk::TreeNode &treeNode) const;
+
+    /** Processing cost of node: size of node's resources (geometry,
+     *  textures) in the mapped package, 1 if not mapped. Does no I/O.
+     */
+    double cost(const slpk::Node &node) const;
+
+private:
+    const slpk::Archive &archive_;
+    const vtstools::MappedZip *zip_;
+    const vtstools::SlpkNodePages *pages_;
 };
 
+void GeometrySource::load(VtsMeshLoader &loader
+                          , const slpk::TreeNode &treeNode) const
+{
+    const auto &node(treeNode.node);
+    if (zip_ && pages_) {
+        if (const auto *pageNode = pages_->find(node.id)) {
+            const auto data(pages_->dracoGeometry(*zip_, *pageNode));
+            if (data.data) {
+                loader.loadDraco(data.data, data.size, pageNode->center);
+                return;
+            }
+        }
+    }
+
+    vtstools::TraceSpan span("loadArchiveGeometry", node.id);
+    archive_.loadGeometry(loader, node, treeNode.sharedResource);
+}
+
+double GeometrySource::cost(const slpk::Node &node) const
+{
+    double cost(1.0);
+    if (!zip_) { return cost; }
+    for (const auto *entry : zip_->list("nodes/" + node.id + "/")) {
+        cost += entry->size;
+    }
+    return cost;
+}
+
 // ------------------------------------------------------------------------
 
 void remapTcToRegion(vts::SubMesh &sm, const vts::FaceOriginList &faceOrigin
@@ -307,68 +579,37 @@ void remapTcToRegion(vts::SubMesh &sm, const vts::FaceOriginList &faceOrigin
     }
 }
 
-tools::LodInfo analyze(vt::ExternalProgress &progress
-                       , const Config &config
-                       , const vts::NodeInfo::list &nodes
-                       , const slpk::Tree &tree
-                       , const slpk::Archive &archive)
+/** Measures nodes at common bottom depth.
+ */
+void measure(const vts::NodeInfo::list &nodes
+             , const std::vector<const slpk::TreeNode*> &treeNodes
+             , const slpk::Archive &archive
+             , const GeometrySource &geometry
+             , vtstools::GeometryCache &cache
+             , tools::MeshInfo::map &mim)
 {
-    LOG(info3) << "Analyzing input dataset (" << tree.nodes.size()
-               << " I3S nodes).";
-    progress.expect(tree.nodes.size());
-
     const geo::SrsDefinition inputSrs(archive.srs());
+    std::mutex mimMutex;
 
-    // find limits for data nodes: top/bottom and bottom common to all subtrees
-    tools::LodInfo lodInfo;
-    lodInfo.topDepth = std::numeric_limits<int>::max();
-    lodInfo.commonBottom = std::numeric_limits<int>::max();
-    lodInfo.bottomDepth = -1;
-
-    {
-        for (const auto item : tree.nodes) {
-            const auto &node(item.second.node);
-            if (!node.hasGeometry()) { continue; }
-            if (node.children.empty()) {
-                // leaf
-                lodInfo.commonBottom
-                    = std::min(lodInfo.commonBottom, node.level);
-                lodInfo.bottomDepth
-                    = std::max(lodInfo.bottomDepth, node.level);
-            }
-
-            // update top
-            lodInfo.topDepth = std::min(lodInfo.topDepth, node.level);
-        }
-
-        LOG(info2) << "Found top/common-bottom/bottom: "
-                   << lodInfo.topDepth << "/" << lodInfo.commonBottom
-                   << "/" << lodInfo.bottomDepth << ".";
+    // most expensive nodes first
+    std::vector<double> costs;
+    for (const auto *treeNode : treeNodes) {
+        costs.push_back(geometry.cost(treeNode->node));
     }
+    const auto order(vtstools::costOrder(costs));
 
-    tools::MeshInfo::map mim;
-
-    // accumulate mesh area (both 3D and 2D) in all nodes at common bottom depth
-
-    // collect nodes for OpenMP
-    std::vector<const slpk::TreeNode*> treeNodes;
-    for (const auto &item : tree.nodes) {
-        const auto &node(item.second.node);
-        if ((node.level == lodInfo.commonBottom) && (node.hasGeometry())) {
-            treeNodes.push_back(&item.second);
-        }
-    }
-
-    auto *pmim(&mim);
-
-    UTILITY_OMP(parallel for shared(pmim, treeNodes) schedule(dynamic))
-    for (std::size_t i = 0; i < treeNodes.size(); ++i) {
-        const auto &treeNode(treeNodes[i]);
+    vtstools::parallelFor(order.size(), [&](std::size_t o)
+    {
+        const auto &treeNode(treeNodes[order[o]]);
         const auto &node(treeNode->node);
+        vtstools::ScopedPhase phase(vtstools::Phase::analyze);
 
         // load geometry
         VtsMeshLoader loader;
-        archive.loadGeometry(loader, node, treeNode->sharedResource);
+        geometry.load(loader, *treeNode);
+        vtstools::count(vtstools::Counter::meshesDecoded
+                        , loader.mesh().submeshes.size());
+        if (cache.enabled()) { cache.put(node.id, loader.save()); }
 
         // measure textures
         std::vector<math::Size2> sizes;
@@ -384,360 +625,292 @@ tools::LodInfo analyze(vt::ExternalProgress &progress
             const auto mi(tools::measureMesh(rfNode, conv, loader.mesh()
                                              , loader.regions(), sizes));
             if (mi) {
-                UTILITY_OMP(critical(slpk2vts_meshInfo_1))
-                    (*pmim)[&rfNode] += mi;
+                std::lock_guard<std::mutex> lock(mimMutex);
+                mim[&rfNode] += mi;
+            }
+        }
+    });
+}
+
+/** Analyzes input tree while it is being streamed.
+ *
+ *  Tree is streamed top-down, therefore first level containing any leaf is
+ *  the common bottom level; its nodes are measured right away while deeper
+ *  levels are still being indexed.
+ */
+vtstools::TreeAnalysis
+analyze(const Config &config
+        , const vts::NodeInfo::list &nodes
+        , vtstools::SlpkTreeStream &stream
+        , const slpk::Archive &archive
+        , const GeometrySource &geometry
+        , vtstools::GeometryCache &cache)
+{
+    LOG(info3) << "Analyzing input dataset.";
+
+    // find limits for data nodes: top/bottom and bottom common to all subtrees
+    vtstools::TreeAnalysis analysis;
+
+    tools::MeshInfo::map mim;
+
+    // accumulate mesh area (both 3D and 2D) in all nodes at common bottom depth
+    bool measured(false);
+    std::size_t count(0);
+    while (const auto *level = stream.next()) {
+        count += level->size();
+        for (const auto &treeNode : *level) {
+            const auto &node(treeNode.node);
+            if (!node.hasGeometry()) { continue; }
+            if (node.children.empty()) {
+                // leaf
+                analysis.commonBottom
+                    = std::min(analysis.commonBottom, node.level);
+                analysis.bottomDepth
+                    = std::max(analysis.bottomDepth, node.level);
+            }
+
+            // update top
+            analysis.topDepth = std::min(analysis.topDepth, node.level);
+        }
+
+        if (measured || (analysis.bottomDepth < 0)) { continue; }
+
+        // first level with leaves: common bottom
+        std::vector<const slpk::TreeNode*> treeNodes;
+        for (const auto &treeNode : *level) {
+            const auto &node(treeNode.node);
+            if ((node.level == analysis.commonBottom) && (node.hasGeometry()))
+            {
+                treeNodes.push_back(&treeNode);
             }
         }
+
+        LOG(info2) << "Measuring " << treeNodes.size()
+                   << " nodes at common bottom depth "
+                   << analysis.commonBottom << ".";
+        measure(nodes, treeNodes, archive, geometry, cache, mim);
+        measured = true;
     }
 
+    LOG(info2) << "Found top/common-bottom/bottom: "
+               << analysis.topDepth << "/" << analysis.commonBottom
+               << "/" << analysis.bottomDepth << " in " << count
+               << " I3S nodes.";
+
     // shift between common depth and bottom depth
-    const auto lodShift(lodInfo.bottomDepth - lodInfo.commonBottom);
+    const auto lodShift(analysis.bottomDepth - analysis.commonBottom);
 
     for (const auto &item : mim) {
         const auto bl
             (lodShift + tools::bestLod(*item.first, item.second.area
                                        , config.optimalTextureSize));
-        const auto &lod(lodInfo.localLods[item.first]
-                        = tools::LodParams(item.second.extents
-                                           , std::round(bl)));
+        const vts::Lod lod(std::round(bl));
+        analysis.assign(*item.first, item.second.extents, lod);
         LOG(info3)
             << "Assigned LOD " << (item.first->nodeId().lod + lod)
             << " (local LOD " << lod
-            << ") for bottom depth (" << lodInfo.bottomDepth
+            << ") for bottom depth (" << analysis.bottomDepth
             << ") in subtree " << item.first->srs() << ".";
     }
 
-    return lodInfo;
+    return analysis;
 }
 
 // ------------------------------------------------------------------------
 
-class Cutter {
+/** Provides I3S nodes to the cutting engine.
+ */
+class NodeReader : public vtstools::SourceReader {
 public:
-    Cutter(const Config &config, const vr::ReferenceFrame &rf
-           , tools::TmpTileset &tmpset, vts::NtGenerator &ntg
-           , const slpk::Archive &archive)
-        : config_(config), rf_(rf), tmpset_(tmpset), ntg_(ntg)
-        , archive_(archive), nodes_(vts::NodeInfo::leaves(rf_))
-        , inputSrs_(archive_.srs())
+    NodeReader(const slpk::Archive &archive
+               , const GeometrySource &geometry
+               , const std::vector<const slpk::TreeNode*> &nodes
+               , const tools::LodInfo &lodInfo
+               , vtstools::GeometryCache &cache
+               , const vtstools::SlpkTextures &textures)
+        : archive_(archive), geometry_(geometry), nodes_(nodes)
+        , lodInfo_(lodInfo)
+        , cache_(cache), textures_(textures), inputSrs_(archive_.srs())
     {}
 
-    void run(vt::ExternalProgress &progress);
-
-private:
-    void cutNode(const slpk::TreeNode &node, const tools::LodInfo &lodInfo);
+    virtual std::size_t size() const { return nodes_.size(); }
 
-    void splitToTiles(const slpk::Node &slpkNode
-                      , const vts::NodeInfo &root
-                      , vts::Lod lod, const vts::TileRange &tr
-                      , const vts::Mesh &mesh
-                      , const RegionInfo::list &textureRegions
-                      , const vts::opencv::Atlas &atlas
-                      , vts::TileIndex::Flag::value_type tileFlags);
-
-    void cutTile(const slpk::Node &slpkNode, const vts::NodeInfo &node
-                 , const vts::Mesh &mesh
-                 , const RegionInfo::list &textureRegions
-                 , const vts::opencv::Atlas &atlas
-                 , vts::TileIndex::Flag::value_type tileFlags);
-
-    cv::Mat loadTexture(const slpk::Node &node, int index) const;
-
-    const Config &config_;
-    const vr::ReferenceFrame &rf_;
-    tools::TmpTileset &tmpset_;
-    vts::NtGenerator &ntg_;
-    const slpk::Archive &archive_;
+    virtual std::string name(std::size_t index) const {
+        return "SLPK node <" + nodes_[index]->node.id + ">";
+    }
 
-    const vts::NodeInfo::list nodes_;
-    const geo::SrsDefinition inputSrs_;
-};
+    virtual const char* traceName() const { return "cutNode"; }
 
-void Cutter::run(vt::ExternalProgress &progress)
-{
-    // load all available nodes
-    const auto tree(archive_.loadTree());
+    virtual const geo::SrsDefinition& srs(std::size_t) const {
+        return inputSrs_;
+    }
 
-    // analyze first
-    const auto lodInfo(analyze(progress, config_, nodes_, tree, archive_));
+    virtual vtstools::CutTarget::list targets(std::size_t index) const {
+        const auto &node(nodes_[index]->node);
+        if (!node.hasGeometry()) { return {}; }
+        return vtstools::lodInfoTargets(lodInfo_, node.level);
+    }
 
-    // compute navtile information (adds accumulators)
-    for (const auto &item : lodInfo.localLods) {
-        tools::computeNavtileInfo(*item.first, item.second, lodInfo, ntg_
-                                  , config_.tileExtents
-                                  , config_.ntLodPixelSize);
+    virtual double cost(std::size_t index) const {
+        return geometry_.cost(nodes_[index]->node);
     }
 
-    // update progress
-    progress.expect(tree.nodes.size());
+    virtual void load(std::size_t index, vtstools::SourceMesh &source) const;
 
-    // convert node map to node (pointer) list (needed by OpenMP to iterate over
-    // nodes)
-    auto nl([&]() -> std::vector<const slpk::TreeNode*>
-    {
-        std::vector<const slpk::TreeNode*> nl;
-        nl.reserve(tree.nodes.size());
-        for (const auto &item : tree.nodes) {
-            nl.push_back(&item.second);
-        }
-        return nl;
-    }());
+private:
+    /** Loads texture. If footprint is given, GPU compressed texture is
+     *  decoded only where the footprint maps.
+     */
+    cv::Mat loadTexture(const slpk::Node &node, int index
+                        , const vts::SubMesh *footprint) const;
 
-    const std::size_t nlSize(nl.size());
-    UTILITY_OMP(parallel for schedule(dynamic))
-    for (std::size_t i = 0; i < nlSize; ++i) {
-        const auto &treeNode(*nl[i]);
-        cutNode(treeNode, lodInfo);
-        ++progress;
-    }
-}
+    const slpk::Archive &archive_;
+    const GeometrySource &geometry_;
+    const std::vector<const slpk::TreeNode*> &nodes_;
+    const tools::LodInfo &lodInfo_;
+    vtstools::GeometryCache &cache_;
+    const vtstools::SlpkTextures &textures_;
+    const geo::SrsDefinition inputSrs_;
+};
 
-cv::Mat Cutter::loadTexture(const slpk::Node &node, int index) const
+cv::Mat NodeReader::loadTexture(const slpk::Node &node, int index
+                                , const vts::SubMesh *footprint) const
 {
-    const auto is(archive_.texture(node, index));
-    LOG(info1) << "Loading texture from " << is->path() << ".";
-    auto tex(cv::imdecode(is->read(), cv::IMREAD_COLOR));
+    vtstools::TraceSpan span("loadTexture", node.id);
+    LOG(info1) << "Loading texture " << index << " of node <"
+               << node.id << ">.";
+    const auto data(textures_.texture(node, index));
+
+    cv::Mat tex;
+    if (data.encoding != vtstools::TextureEncoding::image) {
+        tex = vtstools::decodeCompressedTexture(data.data, data.size
+                                                , footprint);
+    } else {
+        tex = cv::imdecode(cv::Mat(1, data.size, CV_8U
+                                   , const_cast<char*>(data.data))
+                           , cv::IMREAD_COLOR);
+    }
 
     if (!tex.data) {
         LOGTHROW(err2, std::runtime_error)
-            << "Unable to load texture from " << is->path() << ".";
+            << "Unable to load texture " << index << " of node <"
+            << node.id << ">.";
     }
 
     return tex;
 }
 
-void Cutter::cutNode(const slpk::TreeNode &treeNode
-                     , const tools::LodInfo &lodInfo)
+void NodeReader::load(std::size_t index, vtstools::SourceMesh &source) const
 {
+    const auto &treeNode(*nodes_[index]);
     const auto &node(treeNode.node);
 
     VtsMeshLoader loader;
-    archive_.loadGeometry(loader, node, treeNode.sharedResource);
-
-    vts::opencv::Atlas inAtlas;
-    for (std::size_t i(0), e(loader.mesh().size()); i != e; ++i) {
-        inAtlas.add(loadTexture(node, i));
+    std::string blob;
+    if (cache_.take(node.id, blob)) {
+        // decoded during analysis
+        vtstools::TraceSpan span("loadCachedGeometry", node.id);
+        loader.load(blob);
+    } else {
+        vtstools::TraceSpan span("loadGeometry", node.id);
+        geometry_.load(loader, treeNode);
     }
 
-    // for each valid rfnode
-    for (const auto &item : lodInfo.localLods) {
-        const auto rfNode(*item.first);
-        const auto bottomLod(item.second);
-        const vts::CsConvertor conv(inputSrs_, rfNode.srs());
-
-        // compute local lod + sanity check
-        const auto fromBottom(lodInfo.bottomDepth - node.level);
-        if (fromBottom > bottomLod) {
-            // out of reference frame -> skip
-            continue;
-        }
-
-        const vts::Lod localLod(bottomLod - fromBottom);
-        const auto lod(localLod + rfNode.nodeId().lod);
-
-        /** (extra) Tile flags to be stored along generate tiles from this node
-         */
-        vts::TileIndex::Flag::value_type tileFlags(0);
-        if (node.level <= lodInfo.commonBottom) {
-            // mark all tiles not below common bottom level as watertight
-            tileFlags |= vts::TileIndex::Flag::watertight;
-
-            if (node.level == lodInfo.commonBottom) {
-                // mark all tiles at commom bottom level as alien
-                tileFlags |= vts::TileIndex::Flag::alien;
-            }
-        }
-
-        // projected mesh/atlas
-        vts::Mesh mesh;
-        RegionInfo::list textureRegions;
-        vts::opencv::Atlas atlas;
-
-        // and for each submesh
-        std::size_t meshIndex(0);
-        auto iregions(loader.regions().begin());
-        for (auto &sm : loader.mesh()) {
-            const auto &texture(inAtlas.get(meshIndex++));
-            const auto &srcRi(*iregions++);
-
-            // make all faces valid by default
-            vts::VertexMask valid(sm.vertices.size(), true);
-            math::Points3 projected;
-            projected.reserve(sm.vertices.size());
-
-            auto ivalid(valid.begin());
-            for (const auto &v : sm.vertices) {
-                try {
-                    projected.push_back(conv(v));
-                    // apply zShift
-                    if (config_.zShift) {
-                        projected.back()(2) += config_.zShift;
-                    }
-                    ++ivalid;
-                } catch (const std::exception&) {
-                    // failed to convert vertex, mask it and skip
-                    projected.emplace_back();
-                    *ivalid++ = false;
-                }
-            }
-
-            // clip mesh to node's extents
-            // FIXME: implement actual mask application in clipping!
-            vts::FaceOriginList faceOrigin;
-            auto osm(vts::clip(sm, projected, rfNode.extents(), valid
-                               , &faceOrigin));
-            if (osm.faces.empty()) { continue; }
-
-            // at least one face survived, remember
-
-            // get texturing info
-            textureRegions.emplace_back(srcRi.regions);
-            auto &tr(textureRegions.back());
-            // remap face regions (if any)
-            if (!srcRi.regions.empty()) {
-                for (const auto fo : faceOrigin) {
-                    tr.faces.push_back(srcRi.faces[fo]);
-                }
-            }
-
-            mesh.submeshes.push_back(std::move(osm));
-            atlas.add(texture);
-        }
-
-        // anything there?
-        if (mesh.empty()) { continue; }
-
-        // compute local tile range
-        auto tr(tools::computeTileRange(rfNode.extents(), localLod
-                                        , tools::computeExtents(mesh)));
-
-        // convert local tilerange to global tilerange
-        {
-            const auto origin
-                (vts::lowestChild(vts::point(rfNode.nodeId()), localLod));
-            tr.ll += origin;
-            tr.ur += origin;
-        }
-
-        // split to tiles
-        LOG(info3) << "Splitting I3S node <" << node.id << "> to tiles in "
-                   << lod << "/" << tr << ".";
-        splitToTiles(node, rfNode, lod, tr, mesh, textureRegions, atlas
-                     , tileFlags);
+    const auto &mesh(loader.mesh());
+    const auto &regions(loader.regions());
+    for (std::size_t i(0), e(mesh.size()); i != e; ++i) {
+        // texture regions wrap texture coordinates, decode whole texture
+        const bool plain((i >= regions.size()) || regions[i].regions.empty());
+        source.atlas.add(loadTexture(node, i, plain ? &mesh[i] : nullptr));
     }
-}
 
-void Cutter::splitToTiles(const slpk::Node &slpkNode
-                          , const vts::NodeInfo &root
-                          , vts::Lod lod, const vts::TileRange &tr
-                          , const vts::Mesh &mesh
-                          , const RegionInfo::list &textureRegions
-                          , const vts::opencv::Atlas &atlas
-                          , vts::TileIndex::Flag::value_type tileFlags)
-{
-    if (config_.tileExtents) {
-        // check for range validity
-        const auto &rootId(root.nodeId());
-        if (lod < config_.tileExtents->lod) {
-            LOG(info2)
-                << "Nothing to cut from SLPK node <" << slpkNode.id << ">.";
-        }
+    source.mesh = loader.mesh();
+    source.regions = loader.regions();
+}
 
-        const auto gtr(vts::global(rootId, lod, tr));
-        const auto extents(vts::shiftRange(*config_.tileExtents, lod));
+class Cutter {
+public:
+    Cutter(const Config &config, const vr::ReferenceFrame &rf
+           , tools::TmpTileset &tmpset, vts::NtGenerator &ntg
+           , const slpk::Archive &archive, const fs::path &archivePath)
+        : config_(config), rf_(rf), tmpset_(tmpset), ntg_(ntg)
+        , archive_(archive), textures_(archive, archivePath)
+        , nodes_(vts::NodeInfo::leaves(rf_))
+    {}
 
-        if (!vts::tileRangesOverlap(gtr, extents)) {
-            LOG(info2)
-                << "Nothing to cut from SLPK node <" << slpkNode.id << ">"
-                << ", gtr: " << gtr << ", extents: " << extents << ".";
-            return;
-        }
-    }
+    void run(vt::ExternalProgress &progress);
 
-    typedef vts::TileRange::value_type Index;
-    Index je(tr.ur(1));
-    Index ie(tr.ur(0));
+private:
+    const Config &config_;
+    const vr::ReferenceFrame &rf_;
+    tools::TmpTileset &tmpset_;
+    vts::NtGenerator &ntg_;
+    const slpk::Archive &archive_;
+    vtstools::SlpkTextures textures_;
 
-    for (Index j = tr.ll(1); j <= je; ++j) {
-        for (Index i = tr.ll(0); i <= ie; ++i) {
-            vts::TileId tileId(lod, i, j);
-            const auto node(root.child(tileId));
-            cutTile(slpkNode, node, mesh, textureRegions, atlas, tileFlags);
-        }
-    }
-}
+    const vts::NodeInfo::list nodes_;
+};
 
-void Cutter::cutTile(const slpk::Node &slpkNode, const vts::NodeInfo &node
-                     , const vts::Mesh &mesh
-                     , const RegionInfo::list &textureRegions
-                     , const vts::opencv::Atlas &atlas
-                     , vts::TileIndex::Flag::value_type tileFlags)
+void Cutter::run(vt::ExternalProgress &progress)
 {
-
-    // compute border condition (defaults to all available)
-    vts::BorderCondition borderCondition;
-    if (config_.tileExtents) {
-        borderCondition = vts::inside(*config_.tileExtents, node.nodeId());
-        if (!borderCondition) {
-            LOG(info1)
-                << node.nodeId() << ": Nothing to cut from SLPK node <"
-                << slpkNode.id << ">.";
-            return;
-        }
+    // tree structure from node pages if available
+    boost::optional<vtstools::SlpkNodePages> pages;
+    if (const auto *zip = textures_.zip()) {
+        pages = vtstools::SlpkNodePages::load(*zip);
     }
+    textures_.nodePages(pages.get_ptr());
+
+    // index tree in background
+    vtstools::SlpkTreeStream stream(archive_, pages.get_ptr());
+
+    // geometry decoded by analysis, reused by cutting; not used when the
+    // analysis is only stored for shard workers
+    vtstools::GeometryCache::Config cacheConfig
+        (config_.geometryCache << 20, config_.geometryCacheSpill << 20);
+    cacheConfig.spillDir = config_.geometryCacheSpillDir;
+    if (config_.sharding.storeAnalysis()) { cacheConfig.memory = 0; }
+    vtstools::GeometryCache cache(cacheConfig);
+
+    // node geometry loader
+    const GeometrySource geometry(archive_, textures_.zip()
+                                  , pages.get_ptr());
+
+    // analyze first (consumes whole stream); sharded conversion analyzes
+    // only in the coordinator
+    const auto analysis(vtstools::shardedAnalysis
+                        (config_.sharding, nodes_, [&]()
+                         {
+                             return analyze(config_, nodes_, stream, archive_
+                                            , geometry, cache);
+                         }));
+    if (!analysis) { return; }
+    const auto lodInfo(analysis->lodInfo());
+
+    // whole tree is needed for cutting even when analysis was loaded
+    while (stream.next()) {}
 
-    // compute clip extents
-    const auto extents(vts::inflateTileExtents
-                       (node.extents(), config_.clipMargin
-                        , borderCondition, config_.borderClipMargin));
-
-    vts::Mesh clipped;
-    vts::opencv::Atlas clippedAtlas(0); // PNG!
-    RegionInfo::list clippedRegions;
-
-    std::size_t smIndex(0);
-    std::size_t faces(0);
-    for (const auto &sm : mesh) {
-        const auto &texture(atlas.get(smIndex));
-        const auto &ri(textureRegions[smIndex]);
-        ++smIndex;
-
-        vts::FaceOriginList faceOrigin;
+    // compute navtile information (adds accumulators)
+    for (const auto &item : lodInfo.localLods) {
+        tools::computeNavtileInfo(*item.first, item.second, lodInfo, ntg_
+                                  , config_.tileExtents
+                                  , config_.ntLodPixelSize);
+    }
 
-        auto m(vts::clip(sm, extents, vts::VertexMask(), &faceOrigin));
-        if (m.empty()) { continue; }
+    // all streamed nodes
+    const auto nl(stream.nodes());
 
-        clipped.submeshes.push_back(std::move(m));
-        clippedAtlas.add(texture);
-        faces += clipped.submeshes.back().faces.size();
+    const NodeReader reader(archive_, geometry, nl, lodInfo, cache
+                            , textures_);
 
-        // get texturing info
-        clippedRegions.emplace_back(ri.regions);
-        auto &tr(clippedRegions.back());
-        // remap face regions (if any)
-        if (!ri.regions.empty()) {
-            for (const auto fo : faceOrigin) {
-                tr.faces.push_back(ri.faces[fo]);
-            }
+    // drop cached geometry of measured nodes that are never cut
+    if (cache.enabled()) {
+        for (std::size_t i(0), e(nl.size()); i != e; ++i) {
+            if (nl[i]->node.level != analysis->commonBottom) { continue; }
+            if (reader.targets(i).empty()) { cache.drop(nl[i]->node.id); }
         }
     }
 
-    if (clipped.empty()) {
-        LOG(info1)
-            << node.nodeId() << ": Nothing cut from SLPK node <"
-            << slpkNode.id << ">.";
-        return;
-    }
-
-    LOG(info2)
-        << node.nodeId() << ": Cut " << faces
-        << " faces from SLPK node <" << slpkNode.id << ">.";
-
-    // store in temporary storage
-    const auto tileId(node.nodeId());
-
-    tools::repack(tileId, clipped, clippedAtlas, clippedRegions);
-    tmpset_.store(tileId, clipped, clippedAtlas, tileFlags);
+    vtstools::CutEngine(config_, tmpset_).run(reader, progress);
 }
 
 // ------------------------------------------------------------------------
@@ -752,7 +925,8 @@ public:
             , vts::CreateMode mode
             , const ::Config &config
             , vt::ExternalProgress::Config &&epConfig
-            , const boost::optional<slpk::Archive> &input)
+            , const boost::optional<slpk::Archive> &input
+            , const fs::path &inputPath)
         : tools::TmpTsEncoder(path, properties, mode
                               , config, std::move(epConfig)
                               , (config.resume ? weightsResume : weightsFull))
@@ -764,10 +938,16 @@ public:
                 << "No archive passed while not resuming.";
         }
 
-        Cutter(config_, referenceFrame(), tmpset(), ntg(), *input)
+        Cutter(config_, referenceFrame(), tmpset(), ntg(), *input, inputPath)
             .run(progress());
     }
 
+    /** Keeps cut tiles for the shard coordinator.
+     */
+    void finishShard(const boost::filesystem::path &path) {
+        vtstools::finishShard(path, tmpset(), ntg());
+    }
+
 private:
     const ::Config config_;
 };
@@ -803,9 +983,35 @@ int Slpk2Vts::run()
         }
     }
 
+    if (config_.sharding.coordinator() && !config_.resume) {
+        // analyze input once (creates output), cut in worker processes, then
+        // generate from merged tiles
+        config_.sharding.analysis = vtstools::shardAnalysis(output_);
+        {
+            Encoder analyzer(output_, properties, createMode_, config_
+                             , vt::ExternalProgress::Config(epConfig_)
+                             , input, input_);
+        }
+        vtstools::ShardCoordinator(output_, config_.tileExtents
+                                   , config_.sharding, config_.keepTmpset)
+            .run();
+        config_.resume = true;
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     // run the encoder
-    Encoder(output_, properties, createMode_, config_
-            , std::move(epConfig_), input).run();
+    Encoder encoder(output_, properties, createMode_, config_
+                    , std::move(epConfig_), input, input_);
+
+    if (config_.sharding.worker) {
+        encoder.finishShard(output_);
+    } else {
+        vtstools::ScopedPhase phase(vtstools::Phase::generate);
+        encoder.run();
+    }
+
+    vtstools::writeMetrics(config_.sharding.worker);
+    vtstools::writeTrace(config_.sharding.worker);
 
     // all done
     LOG(info4) << "All done.";
@@ -817,5 +1023,6 @@ int Slpk2Vts::run()
 int main(int argc, char *argv[])
 {
     utility::unlimitedCoredump();
+    vtstools::saveCommandLine(argc, argv);
     return Slpk2Vts()(argc, argv);
 }
@@ -0,0 +1,312 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** Scaling benchmark of SLPK texture access.
+ *
+ *  Reads all node textures of given SLPK package from increasing number of
+ *  threads, once through slpk::Archive streams, once through memory mapped
+ *  package and once through memory mapped package preferring GPU compressed
+ *  encodings, and reports throughput of all as JSON. Meant to be run
+ *  on large (tens of GB) packages with cold and warm page cache.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "utility/buildsys.hpp"
+#include "utility/gccversion.hpp"
+#include "utility/limits.hpp"
+
+#include "service/cmdline.hpp"
+
+#include "jsoncpp/json.hpp"
+
+#include "slpk/reader.hpp"
+
+#include "slpktextures.hpp"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/** One texture to read.
+ */
+struct Item {
+    const slpk::Node *node;
+    int index;
+
+    Item(const slpk::Node *node, int index) : node(node), index(index) {}
+};
+
+/** Reads one item, adds number of bytes read to second argument.
+ */
+typedef std::function<void(const Item&, std::size_t&)> Reader;
+
+class SlpkBench : public service::Cmdline
+{
+public:
+    SlpkBench()
+        : service::Cmdline("vts-tools-slpkbench", BUILD_TARGET_VERSION)
+        , maxThreads_(std::thread::hardware_concurrency())
+        , decode_(false)
+    {}
+
+private:
+    virtual void configuration(po::options_description &cmdline
+                               , po::options_description &config
+                               , po::positional_options_description &pd)
+        UTILITY_OVERRIDE;
+
+    virtual void configure(const po::variables_map &vars)
+        UTILITY_OVERRIDE;
+
+    virtual bool help(std::ostream &out, const std::string &what) const
+        UTILITY_OVERRIDE;
+
+    virtual int run() UTILITY_OVERRIDE;
+
+    /** Reads all items from given number of threads. Returns bytes read.
+     */
+    std::size_t read(const std::vector<Item> &items, unsigned int threads
+                     , const Reader &reader) const;
+
+    fs::path input_;
+    fs::path output_;
+    unsigned int maxThreads_;
+    bool decode_;
+};
+
+void SlpkBench::configuration(po::options_description &cmdline
+                              , po::options_description &config
+                              , po::positional_options_description &pd)
+{
+    cmdline.add_options()
+        ("input", po::value(&input_)->required()
+         , "Path to input SLPK archive.")
+        ("output", po::value(&output_)
+         , "Path to JSON report. Written to stdout if not set.")
+        ("maxThreads", po::value(&maxThreads_)
+         ->default_value(maxThreads_)
+         , "Thread count is doubled from 1 up to this value.")
+        ("decode", po::value(&decode_)->default_value(false)
+         ->implicit_value(true)
+         , "Decode textures as well (measures reading including the work "
+         "done by converter threads).")
+        ;
+
+    pd.add("input", 1);
+
+    (void) config;
+}
+
+void SlpkBench::configure(const po::variables_map &vars)
+{
+    (void) vars;
+    if (!maxThreads_) { maxThreads_ = 1; }
+}
+
+bool SlpkBench::help(std::ostream &out, const std::string &what) const
+{
+    if (what.empty()) {
+        out << R"RAW(vts-tools-slpkbench
+usage
+    vts-tools-slpkbench INPUT [OPTIONS]
+
+Reads all node textures of SLPK package through slpk::Archive ("archive")
+through memory mapped package ("mapped") and through memory mapped package
+preferring GPU compressed encodings ("compressed") from 1, 2, 4, ... threads
+and reports elapsed time and throughput of each run. Drop page cache between
+runs (echo 3 > /proc/sys/vm/drop_caches) to measure cold reads.
+
+)RAW";
+    }
+    return false;
+}
+
+std::size_t SlpkBench::read(const std::vector<Item> &items
+                            , unsigned int threads
+                            , const Reader &reader) const
+{
+    std::atomic<std::size_t> next(0);
+    std::atomic<std::size_t> total(0);
+
+    const auto worker([&]()
+    {
+        std::size_t bytes(0);
+        for (;;) {
+            const auto i(next++);
+            if (i >= items.size()) { break; }
+            reader(items[i], bytes);
+        }
+        total += bytes;
+    });
+
+    std::vector<std::thread> pool;
+    for (unsigned int t(0); t != threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (auto &thread : pool) { thread.join(); }
+
+    return total;
+}
+
+int SlpkBench::run()
+{
+    slpk::Archive archive(input_);
+    const auto tree(archive.loadTree());
+    const vtstools::SlpkTextures textures(archive, input_);
+
+    if (!textures.mapped()) {
+        LOG(warn3) << "Input " << input_ << " cannot be mapped; "
+            "\"mapped\" runs fall back to archive.";
+    }
+
+    // mesh pyramid nodes carry single texture atlas
+    std::vector<Item> items;
+    for (const auto &item : tree.nodes) {
+        const auto &node(item.second.node);
+        if (node.hasGeometry()) { items.emplace_back(&node, 0); }
+    }
+
+    LOG(info3) << "Reading " << items.size() << " textures from "
+               << input_ << ".";
+
+    const auto decode([&](const char *data, std::size_t size
+                          , vtstools::TextureEncoding encoding
+                          = vtstools::TextureEncoding::image)
+    {
+        if (!decode_) { return; }
+        const auto tex((encoding == vtstools::TextureEncoding::image)
+                       ? cv::imdecode(cv::Mat(1, size, CV_8U
+                                              , const_cast<char*>(data))
+                                      , cv::IMREAD_COLOR)
+                       : vtstools::decodeCompressedTexture(data, size));
+        if (!tex.data) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Unable to decode texture.";
+        }
+    });
+
+    const Reader archiveReader([&](const Item &item, std::size_t &bytes)
+    {
+        const auto buffer(archive.texture(*item.node, item.index)->read());
+        decode(buffer.data(), buffer.size());
+        bytes += buffer.size();
+    });
+
+    const Reader mappedReader([&](const Item &item, std::size_t &bytes)
+    {
+        const auto data(textures.texture(*item.node, item.index, false));
+        decode(data.data, data.size);
+        bytes += data.size;
+    });
+
+    // cheapest encoding available in the package
+    const Reader compressedReader([&](const Item &item, std::size_t &bytes)
+    {
+        const auto data(textures.texture(*item.node, item.index));
+        decode(data.data, data.size, data.encoding);
+        bytes += data.size;
+    });
+
+    Json::Value report(Json::objectValue);
+    report["benchmark"] = "vts-tools-slpkbench";
+    report["version"] = BUILD_TARGET_VERSION;
+    report["input"] = input_.string();
+    report["inputSize"] = Json::UInt64(fs::file_size(input_));
+    report["textures"] = Json::UInt64(items.size());
+    report["decode"] = decode_;
+    auto &runs(report["runs"] = Json::arrayValue);
+
+    for (unsigned int threads(1); ; threads *= 2) {
+        threads = std::min(threads, maxThreads_);
+
+        for (const auto &reader
+                 : { std::make_pair("archive", archiveReader)
+                     , std::make_pair("mapped", mappedReader)
+                     , std::make_pair("compressed", compressedReader) })
+        {
+            const auto start(Clock::now());
+            const auto bytes(read(items, threads, reader.second));
+            const std::chrono::duration<double> elapsed
+                (Clock::now() - start);
+
+            auto &run(runs.append(Json::objectValue));
+            run["reader"] = reader.first;
+            run["threads"] = threads;
+            run["bytes"] = Json::UInt64(bytes);
+            run["elapsed"] = elapsed.count();
+            run["throughput"] = (elapsed.count() > 0)
+                ? (bytes / elapsed.count() / (1 << 20)) : 0.0;
+
+            LOG(info3) << reader.first << " x" << threads << ": "
+                       << run["throughput"].asDouble() << " MB/s.";
+        }
+
+        if (threads == maxThreads_) { break; }
+    }
+
+    if (output_.empty()) {
+        Json::StyledStreamWriter().write(std::cout, report);
+    } else {
+        std::ofstream f(output_.string());
+        Json::StyledStreamWriter().write(f, report);
+        f.close();
+        if (!f) {
+            LOG(fatal) << "Unable to write report to " << output_ << ".";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    utility::unlimitedCoredump();
+    return SlpkBench()(argc, argv);
+}
@@ -0,0 +1,333 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string>
+#include <sstream>
+#include <iterator>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "jsoncpp/json.hpp"
+
+#include "slpknodepages.hpp"
+#include "threadpool.hpp"
+
+namespace bio = boost::iostreams;
+
+namespace vtstools {
+
+namespace {
+
+/** Finds JSON document in package, plain or gzipped.
+ */
+const MappedZip::Entry* findJson(const MappedZip &zip
+                                 , const std::string &name)
+{
+    if (const auto *entry = zip.find(name + ".json.gz")) { return entry; }
+    return zip.find(name + ".json");
+}
+
+Json::Value loadJson(const MappedZip &zip, const MappedZip::Entry &entry)
+{
+    const auto data(zip.data(entry));
+
+    bio::filtering_istream is;
+    if (entry.name.size() > 3
+        && !entry.name.compare(entry.name.size() - 3, 3, ".gz"))
+    {
+        is.push(bio::gzip_decompressor());
+    }
+    is.push(bio::array_source(data.data, data.size));
+
+    Json::Value value;
+    Json::Reader reader;
+    if (!reader.parse(is, value)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to parse <" << entry.name << "> from "
+            << zip.path() << ": " << reader.getFormattedErrorMessages()
+            << ".";
+    }
+    return value;
+}
+
+} // namespace
+
+boost::optional<SlpkNodePages> SlpkNodePages::load(const MappedZip &zip)
+{
+    const auto *layerEntry(findJson(zip, "3dSceneLayer"));
+    if (!layerEntry) { return boost::none; }
+
+    const auto layer(loadJson(zip, *layerEntry));
+    const auto &np(layer["nodePages"]);
+    if (!np.isObject()) { return boost::none; }
+
+    const auto perPage(np.get("nodesPerPage", 64).asInt());
+    const auto rootIndex(np.get("rootIndex", 0).asInt());
+    if (perPage <= 0) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid nodesPerPage in " << zip.path() << ".";
+    }
+
+    // collect all pages (nodepages/0, nodepages/1, ...)
+    std::vector<const MappedZip::Entry*> pages;
+    for (;;) {
+        const auto *entry
+            (findJson(zip, "nodepages/"
+                      + boost::lexical_cast<std::string>(pages.size())));
+        if (!entry) { break; }
+        pages.push_back(entry);
+    }
+
+    if (pages.empty()) { return boost::none; }
+
+    SlpkNodePages nodePages;
+    nodePages.root_ = rootIndex;
+
+    // geometry buffers compressed by Draco
+    for (const auto &definition : layer["geometryDefinitions"]) {
+        int draco(-1);
+        const auto &buffers(definition["geometryBuffers"]);
+        for (int b(0), e(buffers.size()); b < e; ++b) {
+            const auto &ca(buffers[b]["compressedAttributes"]);
+            if (ca.isObject() && (ca["encoding"].asString() == "draco")) {
+                draco = b;
+                break;
+            }
+        }
+        nodePages.dracoBuffers_.push_back(draco);
+    }
+
+    // base color texture of each material and encodings of each texture set
+    for (const auto &definition : layer["materialDefinitions"]) {
+        nodePages.materialTextureSets_.push_back
+            (definition["pbrMetallicRoughness"]["baseColorTexture"]
+             .get("textureSetDefinitionId", -1).asInt());
+    }
+    for (const auto &definition : layer["textureSetDefinitions"]) {
+        nodePages.textureSets_.emplace_back();
+        for (const auto &format : definition["formats"]) {
+            nodePages.textureSets_.back().push_back
+                (format["name"].asString());
+        }
+    }
+
+    auto &nodes(nodePages.nodes_);
+    nodes.resize(pages.size() * perPage);
+
+    parallelFor(pages.size(), [&](std::size_t p)
+    {
+        const auto page(loadJson(zip, *pages[p]));
+        const auto &pageNodes(page["nodes"]);
+        for (const auto &value : pageNodes) {
+            const auto index(value["index"].asInt());
+            if ((index < int(p * perPage))
+                || (index >= int((p + 1) * perPage)))
+            {
+                LOGTHROW(err2, std::runtime_error)
+                    << "Node " << index << " out of its page <"
+                    << pages[p]->name << "> in " << zip.path() << ".";
+            }
+
+            auto &node(nodes[index]);
+            node.index = index;
+            node.parent = value.get("parentIndex", -1).asInt();
+            for (const auto &child : value["children"]) {
+                node.children.push_back(child.asInt());
+            }
+
+            const auto &mesh(value["mesh"]);
+            node.mesh = mesh.isObject() && mesh["geometry"].isObject();
+            if (node.mesh) {
+                node.id = boost::lexical_cast<std::string>
+                    (mesh["geometry"].get("resource", index).asInt());
+                node.geometryDefinition
+                    = mesh["geometry"].get("definition", -1).asInt();
+
+                const auto &material(mesh["material"]);
+                if (material.isObject()) {
+                    node.materialDefinition
+                        = material.get("definition", -1).asInt();
+                    node.textureResource = boost::lexical_cast<std::string>
+                        (material.get("resource", index).asInt());
+                }
+            }
+
+            const auto &center(value["obb"]["center"]);
+            if (center.isArray() && (center.size() == 3)) {
+                node.center = math::Point3(center[0].asDouble()
+                                           , center[1].asDouble()
+                                           , center[2].asDouble());
+            }
+        }
+    });
+
+    if ((rootIndex < 0) || (std::size_t(rootIndex) >= nodes.size())
+        || (nodes[rootIndex].index != rootIndex))
+    {
+        LOGTHROW(err2, std::runtime_error)
+            << "Root node " << rootIndex << " not found in node pages of "
+            << zip.path() << ".";
+    }
+
+    // assign levels top-down
+    std::vector<int> level{rootIndex};
+    for (int depth(0); !level.empty(); ++depth) {
+        std::vector<int> next;
+        for (auto index : level) {
+            auto &node(nodes[index]);
+            node.level = depth;
+            for (auto child : node.children) {
+                if ((child < 0) || (std::size_t(child) >= nodes.size())
+                    || (nodes[child].index != child))
+                {
+                    LOGTHROW(err2, std::runtime_error)
+                        << "Child " << child << " of node " << index
+                        << " not found in node pages of " << zip.path()
+                        << ".";
+                }
+
+                // guard against cycles and shared children
+                if ((nodes[child].level >= 0) || (child == rootIndex)) {
+                    LOGTHROW(err2, std::runtime_error)
+                        << "Node " << child << " reached twice in node "
+                        "pages of " << zip.path() << ".";
+                }
+                nodes[child].level = depth + 1;
+                next.push_back(child);
+            }
+        }
+        level.swap(next);
+    }
+
+    for (const auto &node : nodes) {
+        if ((node.index >= 0) && node.mesh) {
+            nodePages.byId_[node.id] = node.index;
+        }
+    }
+
+    LOG(info2) << "Loaded " << pages.size() << " I3S node pages from "
+               << zip.path() << ".";
+
+    return nodePages;
+}
+
+std::vector<std::vector<int>> SlpkNodePages::levels() const
+{
+    std::vector<std::vector<int>> levels;
+    for (const auto &node : nodes_) {
+        if (node.level < 0) { continue; }
+        if (std::size_t(node.level) >= levels.size()) {
+            levels.resize(node.level + 1);
+        }
+        levels[node.level].push_back(node.index);
+    }
+    return levels;
+}
+
+const SlpkNodePages::Node* SlpkNodePages::find(const std::string &id) const
+{
+    const auto fbyId(byId_.find(id));
+    if (fbyId == byId_.end()) { return nullptr; }
+    return &nodes_[fbyId->second];
+}
+
+int SlpkNodePages::dracoBuffer(int geometryDefinition) const
+{
+    if ((geometryDefinition < 0)
+        || (std::size_t(geometryDefinition) >= dracoBuffers_.size()))
+    {
+        return -1;
+    }
+    return dracoBuffers_[geometryDefinition];
+}
+
+std::vector<std::string> SlpkNodePages::textureNames(const Node &node)
+    const
+{
+    const auto m(node.materialDefinition);
+    if ((m < 0) || (std::size_t(m) >= materialTextureSets_.size())) {
+        return {};
+    }
+
+    const auto t(materialTextureSets_[m]);
+    if ((t < 0) || (std::size_t(t) >= textureSets_.size())) { return {}; }
+
+    std::vector<std::string> names;
+    for (const auto &name : textureSets_[t]) {
+        names.push_back("nodes/" + node.textureResource + "/textures/"
+                        + name);
+    }
+    return names;
+}
+
+MappedZip::Data SlpkNodePages::dracoGeometry(const MappedZip &zip
+                                             , const Node &node) const
+{
+    const auto buffer(dracoBuffer(node.geometryDefinition));
+    if (buffer < 0) { return {}; }
+
+    const auto base("nodes/" + node.id + "/geometries/"
+                    + boost::lexical_cast<std::string>(buffer));
+
+    const MappedZip::Entry *entry(nullptr);
+    for (const auto *suffix : { ".bin.gz", ".bin", "" }) {
+        if ((entry = zip.find(base + suffix))) { break; }
+    }
+
+    if (!entry) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Draco geometry <" << base << "> not found in "
+            << zip.path() << ".";
+    }
+
+    auto data(zip.data(*entry));
+    if ((entry->name.size() < 3)
+        || entry->name.compare(entry->name.size() - 3, 3, ".gz"))
+    {
+        return data;
+    }
+
+    // gzipped buffer
+    bio::filtering_istream is;
+    is.push(bio::gzip_decompressor());
+    is.push(bio::array_source(data.data, data.size));
+
+    auto inflated(std::make_shared<std::vector<char>>
+                  (std::istreambuf_iterator<char>(is)
+                   , std::istreambuf_iterator<char>()));
+    data.data = inflated->data();
+    data.size = inflated->size();
+    data.buffer = inflated;
+    return data;
+}
+
+} // namespace vtstools
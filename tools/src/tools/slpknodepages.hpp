@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_slpknodepages_hpp_included_
+#define vts_tools_slpknodepages_hpp_included_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include "math/geometry_core.hpp"
+
+#include "mappedzip.hpp"
+
+namespace vtstools {
+
+/** I3S node pages (I3S 1.7+): compact hierarchy of the whole tree stored in
+ *  a few nodepages/N.json(.gz) documents instead of one document per node.
+ */
+class SlpkNodePages {
+public:
+    struct Node {
+        /** Index in node pages.
+         */
+        int index;
+
+        /** Parent index, -1 for root.
+         */
+        int parent;
+
+        std::vector<int> children;
+
+        /** Depth in tree, root is at 0.
+         */
+        int level;
+
+        /** Node carries mesh.
+         */
+        bool mesh;
+
+        /** Node resource ID (directory under nodes/), i.e. its geometry
+         *  resource. Empty for nodes without mesh.
+         */
+        std::string id;
+
+        /** Index of mesh geometry definition in layer, -1 if none.
+         */
+        int geometryDefinition;
+
+        /** Index of material definition in layer, -1 if none.
+         */
+        int materialDefinition;
+
+        /** Resource ID (directory under nodes/) of node's textures.
+         */
+        std::string textureResource;
+
+        /** Center of node's oriented bounding box; Draco compressed vertex
+         *  positions are relative to it.
+         */
+        math::Point3 center;
+
+        Node()
+            : index(-1), parent(-1), level(-1), mesh(false)
+            , geometryDefinition(-1), materialDefinition(-1)
+            , center(0, 0, 0)
+        {}
+
+        typedef std::vector<Node> list;
+    };
+
+    /** Loads node pages from package. Returns none if package's layer has no
+     *  node pages.
+     */
+    static boost::optional<SlpkNodePages> load(const MappedZip &zip);
+
+    const Node::list& nodes() const { return nodes_; }
+
+    /** Node indices grouped by tree level, top-down.
+     */
+    std::vector<std::vector<int>> levels() const;
+
+    /** Finds node with mesh by its resource ID. Returns nullptr if not
+     *  found.
+     */
+    const Node* find(const std::string &id) const;
+
+    /** Index of Draco compressed geometry buffer of given geometry
+     *  definition, -1 if there is none.
+     */
+    int dracoBuffer(int geometryDefinition) const;
+
+    /** Reads node's Draco compressed geometry buffer from package. Returns
+     *  empty data if node has no Draco geometry.
+     */
+    MappedZip::Data dracoGeometry(const MappedZip &zip, const Node &node)
+        const;
+
+    /** Entry names (without extension) of all encodings of node's texture
+     *  as given by its material's texture set definition. Empty if node has
+     *  no texture.
+     */
+    std::vector<std::string> textureNames(const Node &node) const;
+
+private:
+    Node::list nodes_;
+    int root_;
+
+    /** Draco buffer index per geometry definition.
+     */
+    std::vector<int> dracoBuffers_;
+
+    /** Texture set definition index per material definition.
+     */
+    std::vector<int> materialTextureSets_;
+
+    /** Encoding (format) names per texture set definition.
+     */
+    std::vector<std::vector<std::string>> textureSets_;
+
+    /** Resource ID -> index of nodes with mesh.
+     */
+    std::unordered_map<std::string, int> byId_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_slpknodepages_hpp_included_
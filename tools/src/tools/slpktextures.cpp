@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "slpktextures.hpp"
+
+namespace fs = boost::filesystem;
+namespace ba = boost::algorithm;
+
+namespace vtstools {
+
+SlpkTextures::SlpkTextures(const slpk::Archive &archive
+                           , const fs::path &path)
+    : archive_(archive), pages_()
+{
+    if (!fs::is_regular_file(path)) { return; }
+
+    try {
+        zip_.reset(new MappedZip(path));
+    } catch (const std::exception &e) {
+        LOG(warn2) << "Unable to map SLPK package " << path << " ("
+                   << e.what() << "); reading textures through archive.";
+    }
+}
+
+namespace {
+
+bool imageTexture(const std::string &name)
+{
+    return (ba::iends_with(name, ".jpg") || ba::iends_with(name, ".jpeg")
+            || ba::iends_with(name, ".png"));
+}
+
+/** Resolves texture href relative to node document directory.
+ */
+std::string resolveHref(const slpk::Node &node, std::string href)
+{
+    std::string dir("nodes/" + node.id);
+    while (!href.empty()) {
+        if (ba::starts_with(href, "./")) {
+            href.erase(0, 2);
+        } else if (ba::starts_with(href, "../")) {
+            href.erase(0, 3);
+            const auto slash(dir.rfind('/'));
+            dir = ((slash == std::string::npos)
+                   ? std::string() : dir.substr(0, slash));
+        } else {
+            break;
+        }
+    }
+    return dir.empty() ? href : (dir + "/" + href);
+}
+
+/** Adds all entries that are encodings of texture with given base name, i.e.
+ *  base.ext or base_suffix.ext.
+ */
+void addEncodings(const MappedZip &zip, const std::string &base
+                  , std::vector<const MappedZip::Entry*> &set)
+{
+    for (const auto *entry : zip.list(base)) {
+        const auto &name(entry->name);
+        if (name.size() <= base.size()) { continue; }
+        const auto c(name[base.size()]);
+        if ((c != '.') && (c != '_')) { continue; }
+        if (name.find('/', base.size()) != std::string::npos) { continue; }
+
+        if (!imageTexture(name)
+            && (textureEncoding(name) == TextureEncoding::image))
+        {
+            continue;
+        }
+        set.push_back(entry);
+    }
+}
+
+} // namespace
+
+const MappedZip::Entry* SlpkTextures::find(const slpk::Node &node
+                                           , int index, bool compressed)
+    const
+{
+    if (!zip_) { return nullptr; }
+
+    // collect encodings of index-th texture
+    std::vector<const MappedZip::Entry*> set;
+    const SlpkNodePages::Node *pageNode(nullptr);
+    if (pages_ && !index && (pageNode = pages_->find(node.id))) {
+        // 1.7+: node's material -> texture set definition -> formats
+        for (const auto &name : pages_->textureNames(*pageNode)) {
+            addEncodings(*zip_, name, set);
+        }
+    }
+
+    if (set.empty() && (index >= 0)
+        && (std::size_t(index) < node.textureData.size()))
+    {
+        // 1.6: node's own texture resource reference
+        addEncodings(*zip_, resolveHref(node, node.textureData[index].href)
+                     , set);
+    }
+
+    const MappedZip::Entry *best(nullptr);
+    auto bestEncoding(TextureEncoding::image);
+    for (const auto *entry : set) {
+        const auto encoding(textureEncoding(entry->name));
+        if (encoding == TextureEncoding::image) {
+            if (!best) { best = entry; }
+            continue;
+        }
+
+        if (!compressed || (best && (encoding >= bestEncoding))) { continue; }
+
+        // check payload support; only header is decompressed
+        const auto header(zip_->head(*entry, CompressedTextureHeaderSize));
+        if (!compressedTextureSupported(header.data, header.size
+                                        , entry->size))
+        {
+            continue;
+        }
+
+        best = entry;
+        bestEncoding = encoding;
+    }
+
+    return best;
+}
+
+SlpkTextures::Texture SlpkTextures::texture(const slpk::Node &node
+                                            , int index, bool compressed)
+    const
+{
+    Texture texture;
+    if (const auto *entry = find(node, index, compressed)) {
+        static_cast<MappedZip::Data&>(texture) = zip_->data(*entry);
+        texture.encoding = textureEncoding(entry->name);
+        return texture;
+    }
+
+    // fallback
+    const auto is(archive_.texture(node, index));
+    auto buffer(std::make_shared<std::vector<char>>(is->read()));
+    texture.data = buffer->data();
+    texture.size = buffer->size();
+    texture.buffer = buffer;
+    return texture;
+}
+
+} // namespace vtstools
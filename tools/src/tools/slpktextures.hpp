@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_slpktextures_hpp_included_
+#define vts_tools_slpktextures_hpp_included_
+
+#include <memory>
+
+#include <boost/filesystem/path.hpp>
+
+#include "slpk/reader.hpp"
+
+#include "mappedzip.hpp"
+#include "compressedtexture.hpp"
+#include "slpknodepages.hpp"
+
+namespace vtstools {
+
+/** Serves encoded node textures from memory mapped SLPK package.
+ *
+ *  Texture of node is resolved through node pages (material's texture set
+ *  definition lists names of all its encodings) when attached, otherwise
+ *  through node's textureData reference. Entries named <base>.<ext> or
+ *  <base>_<suffix>.<ext> are encodings of the same texture; the cheapest one
+ *  to decode is served. Anything not found there (or input that is not a ZIP
+ *  file, e.g. unpacked SLPK) is read through the archive.
+ */
+class SlpkTextures {
+public:
+    SlpkTextures(const slpk::Archive &archive
+                 , const boost::filesystem::path &path);
+
+    /** Encoded texture data.
+     */
+    struct Texture : MappedZip::Data {
+        TextureEncoding encoding;
+
+        Texture() : encoding(TextureEncoding::image) {}
+    };
+
+    /** Returns encoded texture data. Safe to call from multiple threads.
+     *
+     *  \param node texture owner
+     *  \param index texture index
+     *  \param compressed allow GPU compressed encodings
+     */
+    Texture texture(const slpk::Node &node, int index
+                    , bool compressed = true) const;
+
+    /** Attaches node pages used to resolve textures of 1.7+ packages.
+     */
+    void nodePages(const SlpkNodePages *pages) { pages_ = pages; }
+
+    bool mapped() const { return bool(zip_); }
+
+    /** Mapped package, nullptr if not mapped.
+     */
+    const MappedZip* zip() const { return zip_.get(); }
+
+private:
+    const MappedZip::Entry* find(const slpk::Node &node, int index
+                                 , bool compressed) const;
+
+    const slpk::Archive &archive_;
+    std::unique_ptr<MappedZip> zip_;
+    const SlpkNodePages *pages_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_slpktextures_hpp_included_
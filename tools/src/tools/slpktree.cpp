@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <set>
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "slpktree.hpp"
+#include "threadpool.hpp"
+#include "trace.hpp"
+
+namespace vtstools {
+
+namespace {
+
+slpk::TreeNode loadTreeNode(const slpk::Archive &archive
+                            , slpk::Node &&node)
+{
+    slpk::TreeNode treeNode;
+    treeNode.sharedResource = archive.loadSharedResource(node);
+    treeNode.node = std::move(node);
+    return treeNode;
+}
+
+/** Builds tree node from node page data only. Node references its
+ *  resources the same way an I3S 1.6 node index document would.
+ */
+slpk::TreeNode pageTreeNode(const SlpkNodePages &pages
+                            , const SlpkNodePages::Node &pageNode)
+{
+    const auto &nodes(pages.nodes());
+
+    slpk::TreeNode treeNode;
+    auto &node(treeNode.node);
+    node.id = pageNode.id;
+    node.level = pageNode.level;
+
+    for (auto index : pageNode.children) {
+        node.children.emplace_back();
+        auto &child(node.children.back());
+        child.id = nodes[index].mesh
+            ? nodes[index].id : boost::lexical_cast<std::string>(index);
+        child.href = "../" + child.id;
+    }
+
+    node.geometryData.emplace_back();
+    node.geometryData.back().href = "./geometries/0";
+
+    // "nodes/<resource>/textures/<name>" -> "../<resource>/textures/<name>"
+    const auto textures(pages.textureNames(pageNode));
+    if (!textures.empty()) {
+        node.textureData.emplace_back();
+        node.textureData.back().href = ".." + textures.front().substr(5);
+    }
+
+    return treeNode;
+}
+
+} // namespace
+
+SlpkTreeStream::SlpkTreeStream(const slpk::Archive &archive
+                               , const SlpkNodePages *pages)
+    : archive_(archive), pages_(pages), consumed_(), done_(false)
+    , stop_(false)
+{
+    indexer_ = std::thread(&SlpkTreeStream::index, this);
+}
+
+SlpkTreeStream::~SlpkTreeStream()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    indexer_.join();
+}
+
+void SlpkTreeStream::index()
+{
+    dbglog::thread_id("slpk-index");
+
+    try {
+        if (pages_) {
+            indexPages();
+        } else {
+            indexDocuments();
+        }
+    } catch (...) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_ = true;
+    cond_.notify_all();
+}
+
+bool SlpkTreeStream::publish(Level &&level)
+{
+    LOG(info2) << "Indexed I3S tree level with " << level.size()
+               << " nodes.";
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    levels_.push_back(std::move(level));
+    cond_.notify_all();
+    return !stop_;
+}
+
+void SlpkTreeStream::indexDocuments()
+{
+    Level level;
+    level.push_back(loadTreeNode(archive_, archive_.loadRootNodeIndex()));
+
+    // guard against cycles and shared children
+    std::set<std::string> visited{level.back().node.id};
+
+    while (!level.empty()) {
+        // collect children of this level
+        std::vector<std::string> children;
+        for (const auto &treeNode : level) {
+            for (const auto &child : treeNode.node.children) {
+                if (!visited.insert(child.id).second) {
+                    LOG(warn2) << "Node <" << child.id << "> reached twice "
+                               "in I3S tree; ignored.";
+                    continue;
+                }
+                children.push_back(child.href);
+            }
+        }
+
+        if (!publish(std::move(level))) { return; }
+
+        // load next level; shares pool with consumer's parallelFor calls
+        TraceSpan span("indexLevel");
+        level = Level(children.size());
+        parallelFor(children.size(), [&](std::size_t i)
+        {
+            TraceSpan span("loadNodeIndex", children[i]);
+            level[i] = loadTreeNode
+                (archive_, archive_.loadNodeIndex(children[i]));
+        });
+    }
+}
+
+void SlpkTreeStream::indexPages()
+{
+    const auto &nodes(pages_->nodes());
+    for (const auto &indices : pages_->levels()) {
+        // only nodes with mesh are of any interest
+        Level level;
+        for (auto index : indices) {
+            if (nodes[index].mesh) {
+                level.push_back(pageTreeNode(*pages_, nodes[index]));
+            }
+        }
+
+        if (!publish(std::move(level))) { return; }
+    }
+}
+
+const SlpkTreeStream::Level* SlpkTreeStream::next()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [&]() { return done_ || (consumed_ < levels_.size()); });
+
+    if (consumed_ < levels_.size()) {
+        return &levels_[consumed_++];
+    }
+
+    if (error_) { std::rethrow_exception(error_); }
+    return nullptr;
+}
+
+std::vector<const slpk::TreeNode*> SlpkTreeStream::nodes() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<const slpk::TreeNode*> nodes;
+    for (const auto &level : levels_) {
+        for (const auto &treeNode : level) {
+            nodes.push_back(&treeNode);
+        }
+    }
+    return nodes;
+}
+
+} // namespace vtstools
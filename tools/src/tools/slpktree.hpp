@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_slpktree_hpp_included_
+#define vts_tools_slpktree_hpp_included_
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <condition_variable>
+
+#include "slpk/reader.hpp"
+
+#include "slpknodepages.hpp"
+
+namespace vtstools {
+
+/** Streams I3S node tree level by level.
+ *
+ *  Node index documents (and nodes' shared resources) are loaded in
+ *  background, one tree level at a time; nodes of one level are loaded in
+ *  parallel (pool threads are shared with consumer's own parallelFor
+ *  calls). Consumer gets each level as soon as it is complete, i.e. it can
+ *  start processing upper levels while the rest of the tree is still being
+ *  indexed.
+ *
+ *  When node pages are available the tree is built from page data alone:
+ *  no node document is loaded and nodes without mesh are skipped.
+ */
+class SlpkTreeStream {
+public:
+    SlpkTreeStream(const slpk::Archive &archive
+                   , const SlpkNodePages *pages = nullptr);
+
+    /** Stops indexing (at the end of current level) and waits for it.
+     */
+    ~SlpkTreeStream();
+
+    SlpkTreeStream(const SlpkTreeStream&) = delete;
+    SlpkTreeStream& operator=(const SlpkTreeStream&) = delete;
+
+    typedef std::vector<slpk::TreeNode> Level;
+
+    /** Waits for next level. Returns nullptr when the whole tree has been
+     *  streamed. Rethrows error encountered during indexing.
+     *
+     *  Returned level stays valid during stream's lifetime.
+     */
+    const Level* next();
+
+    /** All nodes streamed so far.
+     */
+    std::vector<const slpk::TreeNode*> nodes() const;
+
+private:
+    void index();
+
+    /** Discovers levels from node documents.
+     */
+    void indexDocuments();
+
+    /** Takes levels from node pages.
+     */
+    void indexPages();
+
+    /** Publishes loaded level. Returns false if stream should stop.
+     */
+    bool publish(Level &&level);
+
+    const slpk::Archive &archive_;
+    const SlpkNodePages *pages_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+
+    /** Indexed levels; deque keeps levels in place when growing.
+     */
+    std::deque<Level> levels_;
+
+    /** Number of levels returned by next().
+     */
+    std::size_t consumed_;
+
+    bool done_;
+    bool stop_;
+    std::exception_ptr error_;
+
+    std::thread indexer_;
+};
+
+} // namespace vtstools
+
+#endif // vts_tools_slpktree_hpp_included_
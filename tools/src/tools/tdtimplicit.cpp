@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <algorithm>
+
+#include "tdtimplicit.hpp"
+
+namespace vtstools {
+
+void tdtDemorton(std::uint64_t index, int dimensions
+                 , std::uint64_t coords[3])
+{
+    coords[0] = coords[1] = coords[2] = 0;
+    for (int bit(0); index; ++bit) {
+        for (int d(0); d < dimensions; ++d, index >>= 1) {
+            coords[d] |= (index & 1) << bit;
+        }
+    }
+}
+
+void expandTdtSubtree(const TdtImplicitTiling &tiling
+                      , const TdtSubtreeAvailability &availability
+                      , int level, const std::uint64_t coords[3]
+                      , TdtImplicitTile::list &tiles
+                      , TdtImplicitTile::list &subtrees)
+{
+    const auto n(tiling.children());
+    const auto dim(tiling.dimensions);
+    const auto levels(std::min(tiling.subtreeLevels
+                               , tiling.availableLevels - level));
+    const bool childSubtrees((levels == tiling.subtreeLevels)
+                             && (level + tiling.subtreeLevels
+                                 < tiling.availableLevels));
+
+    const auto global([&](int l, std::uint64_t m) -> TdtImplicitTile
+    {
+        TdtImplicitTile tile;
+        tile.level = level + l;
+        tile.leaf = true;
+        tdtDemorton(m, dim, tile.coords);
+        for (int d(0); d < dim; ++d) {
+            tile.coords[d] |= coords[d] << l;
+        }
+        return tile;
+    });
+
+    // available tiles (Morton indices) of current level; level l starts at
+    // offset in tile/content availability
+    std::vector<std::uint64_t> current;
+    if (availability.tile(0)) { current.push_back(0); }
+
+    std::uint64_t offset(0), size(1);
+    for (int l(0); !current.empty() && (l < levels); ++l) {
+        const bool last(l + 1 == levels);
+        std::vector<std::uint64_t> next;
+
+        for (const auto m : current) {
+            // available children: tiles of next level or child subtrees
+            bool leaf(true);
+            for (int c(0); c < n; ++c) {
+                const auto child(m * n + c);
+                if (!last) {
+                    if (!availability.tile(offset + size + child)) {
+                        continue;
+                    }
+                    next.push_back(child);
+                } else {
+                    if (!childSubtrees || !availability.child(child)) {
+                        continue;
+                    }
+                    subtrees.push_back(global(tiling.subtreeLevels, child));
+                }
+                leaf = false;
+            }
+
+            if (!availability.content(offset + m)) { continue; }
+
+            tiles.push_back(global(l, m));
+            tiles.back().leaf = leaf;
+        }
+
+        current.swap(next);
+        offset += size;
+        size *= n;
+    }
+}
+
+} // namespace vtstools
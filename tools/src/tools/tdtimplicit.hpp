@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef vts_tools_tdtimplicit_hpp_included_
+#define vts_tools_tdtimplicit_hpp_included_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/** 3D Tiles implicit tiling: expansion of one subtree from its availability
+ *  (independent of subtree file format).
+ */
+namespace vtstools {
+
+/** Availability bitstream or constant.
+ */
+struct TdtAvailability {
+    const std::uint8_t *bits;
+    std::size_t size;
+    bool constant;
+
+    TdtAvailability() : bits(), size(), constant(false) {}
+
+    bool operator()(std::uint64_t index) const {
+        if (!bits) { return constant; }
+        const auto byte(index >> 3);
+        return (byte < size) && ((bits[byte] >> (index & 7)) & 1);
+    }
+};
+
+/** Availability of one subtree: tiles and content are indexed by level
+ *  offset plus Morton index, child subtrees by Morton index at subtree's
+ *  bottom.
+ */
+struct TdtSubtreeAvailability {
+    TdtAvailability tile;
+    TdtAvailability content;
+    TdtAvailability child;
+};
+
+/** Tile of implicit tiling, global level and coordinates.
+ */
+struct TdtImplicitTile {
+    int level;
+    std::uint64_t coords[3];
+
+    /** There is no available tile or child subtree below this one.
+     */
+    bool leaf;
+
+    typedef std::vector<TdtImplicitTile> list;
+};
+
+/** Implicit tiling parameters.
+ */
+struct TdtImplicitTiling {
+    /** 2 for quadtree, 3 for octree.
+     */
+    int dimensions;
+    int subtreeLevels;
+    int availableLevels;
+
+    int children() const { return 1 << dimensions; }
+};
+
+/** Expands subtree rooted at given global level and coordinates.
+ *
+ *  Subtree is descended from its root through available tiles only, i.e.
+ *  work is proportional to the number of available tiles (and their
+ *  children), not to the size of the full quadtree/octree. Child subtrees
+ *  are looked up only below available tiles of subtree's last level.
+ *
+ *  Tiles with available content go to tiles, roots of available child
+ *  subtrees go to subtrees.
+ */
+void expandTdtSubtree(const TdtImplicitTiling &tiling
+                      , const TdtSubtreeAvailability &availability
+                      , int level, const std::uint64_t coords[3]
+                      , TdtImplicitTile::list &tiles
+                      , TdtImplicitTile::list &subtrees);
+
+/** Morton index to per-axis coordinates.
+ */
+void tdtDemorton(std::uint64_t index, int dimensions
+                 , std::uint64_t coords[3]);
+
+} // namespace vtstools
+
+#endif // vts_tools_tdtimplicit_hpp_included_
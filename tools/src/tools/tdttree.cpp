@@ -0,0 +1,576 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "jsoncpp/json.hpp"
+
+#include "tdttree.hpp"
+#include "tdtimplicit.hpp"
+#include "threadpool.hpp"
+
+namespace ba = boost::algorithm;
+namespace ublas = boost::numeric::ublas;
+
+namespace vtstools {
+
+namespace {
+
+/** Name of root tileset inside the archive.
+ */
+const char *RootTileset("tileset.json");
+
+const char *ImplicitExtension("3DTILES_implicit_tiling");
+
+bool externalTileset(const std::string &uri)
+{
+    return ba::iends_with(uri, ".json");
+}
+
+bool templated(const std::string &uri)
+{
+    return uri.find("{level}") != std::string::npos;
+}
+
+/** Resolves URI relative to file it is referenced from.
+ */
+std::string resolve(const std::string &base, const std::string &uri)
+{
+    if ((uri.find("://") != std::string::npos)
+        || (!uri.empty() && (uri[0] == '/')))
+    {
+        return uri;
+    }
+
+    const auto slash(base.rfind('/'));
+    if (slash == std::string::npos) { return uri; }
+    return base.substr(0, slash + 1) + uri;
+}
+
+Json::Value parseJson(const char *data, std::size_t size
+                      , const std::string &uri)
+{
+    Json::Value value;
+    Json::Reader reader;
+    if (!reader.parse(data, data + size, value)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unable to parse <" << uri << ">: "
+            << reader.getFormattedErrorMessages() << ".";
+    }
+    return value;
+}
+
+Json::Value loadJson(const tdt::Archive &archive, const std::string &uri)
+{
+    const auto data(archive.istream(uri)->read());
+    return parseJson(data.data(), data.size(), uri);
+}
+
+/** Implicit tiling of one tile (3D Tiles 1.1 or 3DTILES_implicit_tiling).
+ */
+struct Implicit {
+    /** Content and subtree URI templates, resolved.
+     */
+    std::string content;
+    std::string subtrees;
+
+    TdtImplicitTiling tiling;
+
+    math::Matrix4 transform;
+    tdt::Refinement refine;
+
+    /** Depth and path of implicit root tile.
+     */
+    int depth;
+    std::string path;
+
+    typedef std::shared_ptr<const Implicit> pointer;
+};
+
+/** Work item: external tileset or implicit tiling subtree.
+ */
+struct Item {
+    std::string uri;
+
+    // external tileset
+    math::Matrix4 transform;
+    tdt::Refinement refine;
+    int depth;
+    std::string path;
+
+    // implicit subtree
+    Implicit::pointer implicit;
+    int level;
+    std::uint64_t coords[3];
+
+    typedef std::vector<Item> list;
+};
+
+/** Output of one work item.
+ */
+struct Output {
+    TdtTile::list tiles;
+    Item::list items;
+};
+
+std::string expand(const std::string &pattern, int dimensions, int level
+                   , const std::uint64_t coords[3])
+{
+    auto out(pattern);
+    ba::replace_all(out, "{level}", std::to_string(level));
+    ba::replace_all(out, "{x}", std::to_string(coords[0]));
+    ba::replace_all(out, "{y}", std::to_string(coords[1]));
+    if (dimensions > 2) {
+        ba::replace_all(out, "{z}", std::to_string(coords[2]));
+    }
+    return out;
+}
+
+Implicit::pointer implicitTiling(const Json::Value &tile
+                                 , const std::string &base
+                                 , const math::Matrix4 &transform
+                                 , tdt::Refinement refine, int depth
+                                 , const std::string &path)
+{
+    const auto *it(&tile["implicitTiling"]);
+    bool extension(false);
+    if (!it->isObject()) {
+        it = &tile["extensions"][ImplicitExtension];
+        extension = true;
+    }
+    if (!it->isObject()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Templated content URI in tile <" << path
+            << "> without implicit tiling.";
+    }
+
+    auto implicit(std::make_shared<Implicit>());
+    auto &tiling(implicit->tiling);
+    const auto scheme((*it)["subdivisionScheme"].asString());
+    if (scheme == "QUADTREE") {
+        tiling.dimensions = 2;
+    } else if (scheme == "OCTREE") {
+        tiling.dimensions = 3;
+    } else {
+        LOGTHROW(err2, std::runtime_error)
+            << "Unknown implicit subdivision scheme <" << scheme
+            << "> in tile <" << path << ">.";
+    }
+
+    tiling.subtreeLevels = (*it)["subtreeLevels"].asInt();
+    tiling.availableLevels = extension
+        ? ((*it)["maximumLevel"].asInt() + 1)
+        : (*it)["availableLevels"].asInt();
+    if ((tiling.subtreeLevels <= 0) || (tiling.availableLevels <= 0)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid implicit tiling levels in tile <" << path << ">.";
+    }
+
+    const auto &content(tile["content"]);
+    implicit->content = resolve(base, content.isMember("uri")
+                                ? content["uri"].asString()
+                                : content["url"].asString());
+    implicit->subtrees = resolve(base, (*it)["subtrees"]["uri"].asString());
+    implicit->transform = transform;
+    implicit->refine = refine;
+    implicit->depth = depth;
+    implicit->path = path;
+
+    return implicit;
+}
+
+Item subtreeItem(const Implicit::pointer &implicit, int level
+                 , const std::uint64_t coords[3])
+{
+    Item item;
+    item.uri = expand(implicit->subtrees, implicit->tiling.dimensions, level
+                      , coords);
+    item.implicit = implicit;
+    item.level = level;
+    std::copy(coords, coords + 3, item.coords);
+    return item;
+}
+
+/** Parsed subtree file (binary .subtree or JSON).
+ */
+class Subtree : public TdtSubtreeAvailability {
+public:
+    Subtree(const tdt::Archive &archive, const std::string &uri);
+
+private:
+    TdtAvailability availability(const Json::Value &value) const;
+
+    Json::Value json_;
+    std::vector<std::shared_ptr<std::vector<char>>> buffers_;
+    const std::string uri_;
+};
+
+Subtree::Subtree(const tdt::Archive &archive, const std::string &uri)
+    : uri_(uri)
+{
+    auto data(std::make_shared<std::vector<char>>
+              (archive.istream(uri)->read()));
+
+    // internal binary buffer
+    std::shared_ptr<std::vector<char>> bin;
+
+    if ((data->size() >= 24) && !std::memcmp(data->data(), "subt", 4)) {
+        std::uint64_t jsonLength, binLength;
+        std::memcpy(&jsonLength, data->data() + 8, 8);
+        std::memcpy(&binLength, data->data() + 16, 8);
+        if ((jsonLength > data->size() - 24)
+            || (binLength > data->size() - 24 - jsonLength))
+        {
+            LOGTHROW(err2, std::runtime_error)
+                << "Truncated subtree <" << uri << ">.";
+        }
+
+        json_ = parseJson(data->data() + 24, jsonLength, uri);
+        bin = std::make_shared<std::vector<char>>
+            (data->begin() + 24 + jsonLength
+             , data->begin() + 24 + jsonLength + binLength);
+    } else {
+        json_ = parseJson(data->data(), data->size(), uri);
+    }
+
+    for (const auto &buffer : json_["buffers"]) {
+        if (buffer.isMember("uri")) {
+            buffers_.push_back
+                (std::make_shared<std::vector<char>>
+                 (archive.istream(resolve(uri, buffer["uri"].asString()))
+                  ->read()));
+        } else {
+            buffers_.push_back(bin);
+        }
+    }
+
+    tile = availability(json_["tileAvailability"]);
+    const auto &content(json_["contentAvailability"]);
+    if (content.isArray()) {
+        if (content.size()) { this->content = availability(content[0u]); }
+    } else if (content.isObject()) {
+        this->content = availability(content);
+    }
+    child = availability(json_["childSubtreeAvailability"]);
+}
+
+TdtAvailability Subtree::availability(const Json::Value &value) const
+{
+    TdtAvailability a;
+    if (!value.isObject()) { return a; }
+
+    if (value.isMember("constant")) {
+        a.constant = value["constant"].asInt();
+        return a;
+    }
+
+    const auto &index(value.isMember("bitstream") ? value["bitstream"]
+                      : value["bufferView"]);
+    const auto &view(json_["bufferViews"][index.asUInt()]);
+    const auto bufferIndex(view.get("buffer", 0).asUInt());
+    if (!view.isObject() || (bufferIndex >= buffers_.size())
+        || !buffers_[bufferIndex])
+    {
+        LOGTHROW(err2, std::runtime_error)
+            << "Invalid availability buffer view in subtree <"
+            << uri_ << ">.";
+    }
+
+    const auto &buffer(*buffers_[bufferIndex]);
+    const std::size_t offset(view.get("byteOffset", 0).asUInt64());
+    const std::size_t length(view["byteLength"].asUInt64());
+    if ((offset > buffer.size()) || (length > buffer.size() - offset)) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Availability buffer view out of bounds in subtree <"
+            << uri_ << ">.";
+    }
+
+    a.bits = reinterpret_cast<const std::uint8_t*>(buffer.data() + offset);
+    a.size = length;
+    return a;
+}
+
+/** Generates content tiles of one subtree, queues available child subtrees
+ *  (see expandTdtSubtree).
+ */
+void expandSubtree(const tdt::Archive &archive, const Item &item
+                   , Output &out)
+{
+    const auto &implicit(*item.implicit);
+    const auto dim(implicit.tiling.dimensions);
+
+    TdtImplicitTile::list tiles, subtrees;
+    expandTdtSubtree(implicit.tiling, Subtree(archive, item.uri), item.level
+                     , item.coords, tiles, subtrees);
+
+    for (const auto &t : tiles) {
+        TdtTile tile;
+        tile.uri = expand(implicit.content, dim, t.level, t.coords);
+        tile.transform = implicit.transform;
+        tile.depth = implicit.depth + t.level;
+        tile.leaf = t.leaf;
+        tile.path = implicit.path + "/" + expand
+            (dim > 2 ? "{level}-{x}-{y}-{z}" : "{level}-{x}-{y}"
+             , dim, t.level, t.coords);
+        out.tiles.push_back(std::move(tile));
+    }
+
+    for (const auto &t : subtrees) {
+        out.items.push_back(subtreeItem(item.implicit, t.level, t.coords));
+    }
+}
+
+/** Starts implicit tiling at given tile.
+ */
+void startImplicit(const Json::Value &tile, const std::string &base
+                   , const math::Matrix4 &transform
+                   , tdt::Refinement refine, int depth
+                   , const std::string &path, Output &out)
+{
+    const auto implicit(implicitTiling(tile, base, transform, refine
+                                       , depth, path));
+    const std::uint64_t root[3] = { 0, 0, 0 };
+    out.items.push_back(subtreeItem(implicit, 0, root));
+}
+
+void checkRefinement(tdt::Refinement refine)
+{
+    if (refine != tdt::Refinement::replace) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Only <" << tdt::Refinement::replace
+            << "> refinement is supported.";
+    }
+}
+
+/** Flattens tileset tree loaded by the archive. Its transformations and
+ *  refinement are resolved already.
+ */
+class TreeFlattener {
+public:
+    TreeFlattener(const tdt::Archive &archive, Output &out)
+        : archive_(archive), out_(out)
+    {}
+
+    void operator()(const tdt::Tile &tile, int depth
+                    , const std::string &path);
+
+private:
+    /** Raw JSON of tile at given path (loaded on demand).
+     */
+    const Json::Value& raw(const std::string &path);
+
+    const tdt::Archive &archive_;
+    Output &out_;
+    Json::Value root_;
+};
+
+void TreeFlattener::operator()(const tdt::Tile &tile, int depth
+                               , const std::string &path)
+{
+    checkRefinement(*tile.refine);
+
+    if (tile.content) {
+        const auto &uri(tile.content->uri);
+        if (templated(uri)) {
+            // implicit tiling; not exposed by tdt::Tile
+            startImplicit(raw(path), RootTileset, *tile.transform
+                          , *tile.refine, depth, path, out_);
+            return;
+        } else if (externalTileset(uri)) {
+            // root of external tileset becomes next child
+            Item item;
+            item.uri = uri;
+            item.transform = *tile.transform;
+            item.refine = *tile.refine;
+            item.depth = depth + 1;
+            item.path = path + "/" + std::to_string(tile.children.size());
+            out_.items.push_back(std::move(item));
+        } else {
+            out_.tiles.push_back({ uri, *tile.transform, depth
+                                   , tile.children.empty(), path });
+        }
+    }
+
+    int index(0);
+    for (const auto &child : tile.children) {
+        (*this)(*child, depth + 1, path + "/" + std::to_string(index++));
+    }
+}
+
+const Json::Value& TreeFlattener::raw(const std::string &path)
+{
+    if (root_.isNull()) { root_ = loadJson(archive_, RootTileset); }
+
+    // path is "0/i/j/..."
+    const Json::Value *tile(&root_["root"]);
+    std::size_t start(path.find('/'));
+    while (start != std::string::npos) {
+        const auto end(path.find('/', start + 1));
+        const auto index(std::stoul(path.substr(start + 1, end - start - 1)));
+        tile = &(*tile)["children"][Json::ArrayIndex(index)];
+        start = end;
+    }
+
+    if (!tile->isObject()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Tile <" << path << "> not found in <" << RootTileset
+            << ">.";
+    }
+    return *tile;
+}
+
+tdt::Refinement refinement(const Json::Value &tile, tdt::Refinement parent)
+{
+    if (!tile.isMember("refine")) { return parent; }
+    return ba::iequals(tile["refine"].asString(), "REPLACE")
+        ? tdt::Refinement::replace : tdt::Refinement::add;
+}
+
+math::Matrix4 transformation(const Json::Value &tile
+                             , const math::Matrix4 &parent)
+{
+    const auto &t(tile["transform"]);
+    if (!t.isArray() || (t.size() != 16)) { return parent; }
+
+    // column major
+    math::Matrix4 local(4, 4);
+    for (Json::ArrayIndex i(0); i < 16; ++i) {
+        local(i % 4, i / 4) = t[i].asDouble();
+    }
+    return ublas::prod(parent, local);
+}
+
+/** Flattens tile of externally loaded tileset (raw JSON).
+ */
+void flattenJson(const Json::Value &tile, const std::string &base
+                 , const math::Matrix4 &parent
+                 , tdt::Refinement parentRefine, int depth
+                 , const std::string &path, Output &out)
+{
+    const auto transform(transformation(tile, parent));
+    const auto refine(refinement(tile, parentRefine));
+    checkRefinement(refine);
+
+    const auto &children(tile["children"]);
+
+    const auto &content(tile["content"]);
+    if (content.isObject()) {
+        const auto uri(resolve(base, content.isMember("uri")
+                               ? content["uri"].asString()
+                               : content["url"].asString()));
+        if (templated(uri)) {
+            startImplicit(tile, base, transform, refine, depth, path, out);
+            return;
+        } else if (externalTileset(uri)) {
+            Item item;
+            item.uri = uri;
+            item.transform = transform;
+            item.refine = refine;
+            item.depth = depth + 1;
+            item.path = path + "/" + std::to_string(children.size());
+            out.items.push_back(std::move(item));
+        } else {
+            out.tiles.push_back({ uri, transform, depth, !children.size()
+                                  , path });
+        }
+    }
+
+    for (Json::ArrayIndex i(0); i < children.size(); ++i) {
+        flattenJson(children[i], base, transform, refine, depth + 1
+                    , path + "/" + std::to_string(i), out);
+    }
+}
+
+void process(const tdt::Archive &archive, const Item &item, Output &out)
+{
+    if (item.implicit) {
+        expandSubtree(archive, item, out);
+        return;
+    }
+
+    const auto tileset(loadJson(archive, item.uri));
+    const auto &root(tileset["root"]);
+    if (!root.isObject()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "External tileset <" << item.uri << "> has no root tile.";
+    }
+
+    flattenJson(root, item.uri, item.transform, item.refine, item.depth
+                , item.path, out);
+}
+
+} // namespace
+
+TdtTile::list collectTiles(const tdt::Archive &archive)
+{
+    Output out;
+    TreeFlattener(archive, out)(*archive.tileset().root, 0, "0");
+
+    TdtTile::list tiles(std::move(out.tiles));
+    auto items(std::move(out.items));
+
+    std::size_t processed(0);
+    while (!items.empty()) {
+        LOG(info2) << "Loading " << items.size()
+                   << " external tilesets/subtrees.";
+
+        std::vector<Output> outputs(items.size());
+        parallelFor(items.size(), [&](std::size_t i)
+        {
+            process(archive, items[i], outputs[i]);
+        });
+
+        processed += items.size();
+        items.clear();
+        for (auto &output : outputs) {
+            std::move(output.tiles.begin(), output.tiles.end()
+                      , std::back_inserter(tiles));
+            std::move(output.items.begin(), output.items.end()
+                      , std::back_inserter(items));
+        }
+    }
+
+    LOG(info3) << "Collected " << tiles.size() << " content tiles ("
+               << processed << " external tilesets/subtrees loaded).";
+
+    return tiles;
+}
+
+} // namespace vtstools
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef vts_tools_tdttree_hpp_included_
+#define vts_tools_tdttree_hpp_included_
+
+#include <string>
+#include <vector>
+
+#include "math/geometry_core.hpp"
+
+#include "3dtiles/3dtiles.hpp"
+#include "3dtiles/reader.hpp"
+
+namespace vtstools {
+
+namespace tdt = threedtiles;
+
+/** Content tile detached from the tileset tree.
+ */
+struct TdtTile {
+    /** Content URI (relative to archive root).
+     */
+    std::string uri;
+
+    /** Absolute tile transformation.
+     */
+    math::Matrix4 transform;
+
+    /** Depth in the tree; root of external tileset is a child of the
+     *  referencing tile.
+     */
+    int depth;
+
+    /** There is no tile below this one.
+     */
+    bool leaf;
+
+    /** Child indices from the root, for logging.
+     */
+    std::string path;
+
+    typedef std::vector<TdtTile> list;
+};
+
+/** Collects all content tiles of archive's tileset.
+ *
+ *  Archive has to be opened without external tilesets. External tilesets are
+ *  loaded as traversal reaches them: all tilesets referenced from one level
+ *  of tilesets are fetched and parsed in parallel, flattened and released
+ *  right away, i.e. no more than one parsed tileset per worker thread is
+ *  held in memory.
+ *
+ *  Implicit tiling (3D Tiles 1.1 or 3DTILES_implicit_tiling, quadtree and
+ *  octree) is expanded straight from subtree availability bitstreams;
+ *  subtrees are processed the same way as external tilesets. Implicit tiles
+ *  share transformation of the implicit root tile.
+ *
+ *  Throws on refinement other than replace.
+ */
+TdtTile::list collectTiles(const tdt::Archive &archive);
+
+} // namespace vtstools
+
+#endif // vts_tools_tdttree_hpp_included_
@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE compressedtexture
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../compressedtexture.hpp"
+
+namespace {
+
+typedef std::vector<std::uint8_t> Bytes;
+
+void put32(std::string &data, std::size_t offset, std::uint32_t value)
+{
+    std::memcpy(&data[offset], &value, sizeof(value));
+}
+
+void put64(std::string &data, std::size_t offset, std::uint64_t value)
+{
+    std::memcpy(&data[offset], &value, sizeof(value));
+}
+
+std::string bytes(const Bytes &blocks)
+{
+    return std::string(blocks.begin(), blocks.end());
+}
+
+/** DDS with legacy FourCC (DXT1/3/5) or DX10 header.
+ */
+std::string dds(int width, int height, const std::string &fourCC
+                , const Bytes &blocks, std::uint32_t dxgiFormat = 0)
+{
+    std::string data(dxgiFormat ? 148 : 128, '\0');
+    std::memcpy(&data[0], "DDS ", 4);
+    put32(data, 4, 124);
+    put32(data, 12, height);
+    put32(data, 16, width);
+    put32(data, 76, 32);
+    put32(data, 80, 4);
+    std::memcpy(&data[84], fourCC.data(), 4);
+    if (dxgiFormat) {
+        put32(data, 128, dxgiFormat);
+        put32(data, 132, 3);
+        put32(data, 140, 1);
+    }
+    return data + bytes(blocks);
+}
+
+/** KTX 1 with given OpenGL internal format and some key/value data.
+ */
+std::string ktx(int width, int height, std::uint32_t glFormat
+                , const Bytes &blocks)
+{
+    const std::string kv(16, 'k');
+    std::string data(64, '\0');
+    std::memcpy(&data[0], "\xabKTX 11\xbb\r\n\x1a\n", 12);
+    put32(data, 12, 0x04030201);
+    put32(data, 28, glFormat);
+    put32(data, 36, width);
+    put32(data, 40, height);
+    put32(data, 56, 1);
+    put32(data, 60, kv.size());
+    data += kv;
+    data += std::string(4, '\0');
+    put32(data, data.size() - 4, blocks.size());
+    return data + bytes(blocks);
+}
+
+/** KTX 2 with given Vulkan format, payload right after header.
+ */
+std::string ktx2(int width, int height, std::uint32_t vkFormat
+                 , const Bytes &blocks, std::uint32_t supercompression = 0)
+{
+    std::string data(104, '\0');
+    std::memcpy(&data[0], "\xabKTX 20\xbb\r\n\x1a\n", 12);
+    put32(data, 12, vkFormat);
+    put32(data, 20, width);
+    put32(data, 24, height);
+    put32(data, 40, 1);
+    put32(data, 44, supercompression);
+    put64(data, 80, data.size());
+    put64(data, 88, blocks.size());
+    put64(data, 96, blocks.size());
+    return data + bytes(blocks);
+}
+
+cv::Mat decode(const std::string &data
+               , const vtstools::vts::SubMesh *footprint = nullptr)
+{
+    return vtstools::decodeCompressedTexture(data.data(), data.size()
+                                             , footprint);
+}
+
+/** Checks BGR pixel against RGB value.
+ */
+void checkPixel(const cv::Mat &image, int x, int y, int r, int g, int b)
+{
+    const auto &p(image.at<cv::Vec3b>(y, x));
+    BOOST_CHECK_EQUAL(int(p[2]), r);
+    BOOST_CHECK_EQUAL(int(p[1]), g);
+    BOOST_CHECK_EQUAL(int(p[0]), b);
+}
+
+/** BC1 block: red and blue endpoints, 4-color mode, pixel i uses palette
+ *  entry i % 4.
+ */
+const Bytes bc1RedBlue{ 0x00, 0xf8, 0x1f, 0x00, 0xe4, 0xe4, 0xe4, 0xe4 };
+
+/** BC1 block: blue and red endpoints (c0 <= c1), 3-color mode.
+ */
+const Bytes bc1BlueRed{ 0x1f, 0x00, 0x00, 0xf8, 0xe4, 0xe4, 0xe4, 0xe4 };
+
+/** ETC1 individual block: left half base (136, 68, 34) with table 0, right
+ *  half same base with table 7; pixel (1, 1) has index 2, (2, 1) index 1,
+ *  (3, 3) index 3, the rest index 0.
+ */
+const Bytes etc1Individual{ 0x88, 0x44, 0x22, 0x1c, 0x80, 0x20, 0x82, 0x00 };
+
+/** ETC1 differential block, flipped: top half base 5-bit (16, 8, 4), bottom
+ *  half base + (1, -1, 0), both with table 1; all pixels index 0.
+ */
+const Bytes etc1Differential{ 0x81, 0x47, 0x20, 0x27, 0, 0, 0, 0 };
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(encodingByName)
+{
+    using vtstools::TextureEncoding;
+    BOOST_CHECK(vtstools::textureEncoding("0.dds") == TextureEncoding::dds);
+    BOOST_CHECK(vtstools::textureEncoding("0.KTX") == TextureEncoding::ktx);
+    BOOST_CHECK(vtstools::textureEncoding("0.ktx2")
+                == TextureEncoding::ktx2);
+    BOOST_CHECK(vtstools::textureEncoding("0.jpg")
+                == TextureEncoding::image);
+    BOOST_CHECK(vtstools::textureEncoding("0") == TextureEncoding::image);
+}
+
+BOOST_AUTO_TEST_CASE(bc1)
+{
+    Bytes blocks(bc1RedBlue);
+    blocks.insert(blocks.end(), bc1BlueRed.begin(), bc1BlueRed.end());
+    const auto data(dds(8, 4, "DXT1", blocks));
+
+    BOOST_CHECK(vtstools::compressedTextureSupported(data.data()
+                                                     , data.size()));
+    const auto size(vtstools::compressedTextureSize(data.data()
+                                                    , data.size()));
+    BOOST_CHECK_EQUAL(size.width, 8);
+    BOOST_CHECK_EQUAL(size.height, 4);
+
+    const auto image(decode(data));
+    BOOST_REQUIRE_EQUAL(image.cols, 8);
+    BOOST_REQUIRE_EQUAL(image.rows, 4);
+
+    // 4-color mode: endpoints and 2/3 + 1/3 blends
+    checkPixel(image, 0, 0, 255, 0, 0);
+    checkPixel(image, 1, 0, 0, 0, 255);
+    checkPixel(image, 2, 0, 170, 0, 85);
+    checkPixel(image, 3, 3, 85, 0, 170);
+
+    // 3-color mode: endpoints, average and black
+    checkPixel(image, 4, 0, 0, 0, 255);
+    checkPixel(image, 5, 1, 255, 0, 0);
+    checkPixel(image, 6, 2, 127, 0, 127);
+    checkPixel(image, 7, 3, 0, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(bc3Dx10)
+{
+    // alpha block is skipped, color block always uses 4-color mode
+    Bytes block(8, 0xff);
+    block.insert(block.end(), bc1BlueRed.begin(), bc1BlueRed.end());
+    const auto data(dds(4, 4, "DX10", block, 77));
+
+    const auto image(decode(data));
+    checkPixel(image, 0, 0, 0, 0, 255);
+    checkPixel(image, 1, 0, 255, 0, 0);
+    checkPixel(image, 2, 0, 85, 0, 170);
+    checkPixel(image, 3, 0, 170, 0, 85);
+}
+
+BOOST_AUTO_TEST_CASE(etc1)
+{
+    // 3x3 image: one block clipped at image edges
+    const auto data(ktx(3, 3, 0x8d64, etc1Individual));
+
+    const auto image(decode(data));
+    BOOST_REQUIRE_EQUAL(image.cols, 3);
+    BOOST_REQUIRE_EQUAL(image.rows, 3);
+    checkPixel(image, 0, 0, 138, 70, 36);
+    checkPixel(image, 1, 1, 134, 66, 32);
+    checkPixel(image, 1, 2, 138, 70, 36);
+    checkPixel(image, 2, 0, 183, 115, 81);
+    checkPixel(image, 2, 1, 255, 251, 217);
+}
+
+BOOST_AUTO_TEST_CASE(etc2Differential)
+{
+    // ETC2 decodes ETC1 compatible blocks the same way
+    const auto data(ktx2(4, 4, 147, etc1Differential));
+
+    BOOST_CHECK(vtstools::compressedTextureSupported(data.data()
+                                                     , data.size()));
+    const auto image(decode(data));
+
+    // top: (132, 66, 33) + 5, bottom: (140, 57, 33) + 5
+    checkPixel(image, 0, 0, 137, 71, 38);
+    checkPixel(image, 3, 1, 137, 71, 38);
+    checkPixel(image, 0, 2, 145, 62, 38);
+    checkPixel(image, 3, 3, 145, 62, 38);
+}
+
+BOOST_AUTO_TEST_CASE(headerOnly)
+{
+    const auto data(dds(4, 4, "DX10", bc1RedBlue, 71));
+    const auto headerSize(vtstools::CompressedTextureHeaderSize);
+    BOOST_REQUIRE_GE(data.size(), headerSize);
+
+    // payload size is checked against full size
+    BOOST_CHECK(vtstools::compressedTextureSupported
+                (data.data(), headerSize, data.size()));
+    BOOST_CHECK(!vtstools::compressedTextureSupported
+                (data.data(), headerSize, data.size() - 1));
+    BOOST_CHECK(!vtstools::compressedTextureSupported
+                (data.data(), data.size() - 1));
+}
+
+BOOST_AUTO_TEST_CASE(unsupported)
+{
+    // BC7, supercompressed KTX 2, big-endian KTX and plain image
+    const Bytes block(16, 0);
+    const auto bc7(dds(4, 4, "DX10", block, 98));
+    const auto zstd(ktx2(4, 4, 147, etc1Differential, 2));
+    auto bigEndian(ktx(4, 4, 0x8d64, etc1Individual));
+    put32(bigEndian, 12, 0x01020304);
+    const std::string jpeg("\xff\xd8\xff\xe0" + std::string(200, '\0'));
+
+    for (const auto &data : { bc7, zstd, bigEndian, jpeg }) {
+        BOOST_CHECK(!vtstools::compressedTextureSupported(data.data()
+                                                          , data.size()));
+        BOOST_CHECK_THROW(decode(data), std::runtime_error);
+    }
+
+    // truncated payload
+    const auto truncated(dds(8, 4, "DXT1", bc1RedBlue));
+    BOOST_CHECK_THROW(decode(truncated), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(footprint)
+{
+    // 8x8 image of red blocks
+    Bytes blocks;
+    const Bytes red{ 0x00, 0xf8, 0x1f, 0x00, 0, 0, 0, 0 };
+    for (int i(0); i < 4; ++i) {
+        blocks.insert(blocks.end(), red.begin(), red.end());
+    }
+    const auto data(dds(8, 8, "DXT1", blocks));
+
+    // small face at the bottom-left corner (texture origin)
+    vtstools::vts::SubMesh sm;
+    sm.tc.emplace_back(0.0, 0.0);
+    sm.tc.emplace_back(0.1, 0.0);
+    sm.tc.emplace_back(0.0, 0.1);
+    sm.facesTc.emplace_back(0, 1, 2);
+
+    const auto image(decode(data, &sm));
+    checkPixel(image, 0, 7, 255, 0, 0);
+    checkPixel(image, 3, 4, 255, 0, 0);
+    checkPixel(image, 0, 0, 0, 0, 0);
+    checkPixel(image, 7, 0, 0, 0, 0);
+    checkPixel(image, 7, 7, 0, 0, 0);
+
+    // wrapped texture coordinates need whole image
+    sm.tc[1] = math::Point2d(1.5, 0.0);
+    checkPixel(decode(data, &sm), 7, 0, 255, 0, 0);
+}
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE geometrycache
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../geometrycache.hpp"
+
+namespace fs = boost::filesystem;
+
+typedef vtstools::GeometryCache::Config Config;
+
+namespace {
+
+std::string blob(char c, std::size_t size = 100)
+{
+    return std::string(size, c);
+}
+
+bool has(vtstools::GeometryCache &cache, const std::string &key
+         , const std::string &expected)
+{
+    std::string value;
+    return cache.take(key, value) && (value == expected);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+    vtstools::GeometryCache cache(Config(0));
+    BOOST_CHECK(!cache.enabled());
+    cache.put("a", blob('a'));
+
+    std::string value;
+    BOOST_CHECK(!cache.take("a", value));
+    BOOST_CHECK_EQUAL(cache.stats().stored, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(takeOnce)
+{
+    vtstools::GeometryCache cache(Config(1000));
+    cache.put("a", blob('a'));
+    cache.put("b", blob('b'));
+
+    BOOST_CHECK(has(cache, "b", blob('b')));
+    BOOST_CHECK(has(cache, "a", blob('a')));
+
+    std::string value;
+    BOOST_CHECK(!cache.take("a", value));
+
+    const auto stats(cache.stats());
+    BOOST_CHECK_EQUAL(stats.stored, 2u);
+    BOOST_CHECK_EQUAL(stats.hits, 2u);
+    BOOST_CHECK_EQUAL(stats.misses, 1u);
+    BOOST_CHECK_EQUAL(stats.peakSize, 200u);
+}
+
+BOOST_AUTO_TEST_CASE(evictLeastRecent)
+{
+    // room for 3 blobs, no spilling
+    vtstools::GeometryCache cache(Config(300));
+    for (char c : { 'a', 'b', 'c', 'd', 'e' }) {
+        cache.put(std::string(1, c), blob(c));
+    }
+
+    std::string value;
+    BOOST_CHECK(!cache.take("a", value));
+    BOOST_CHECK(!cache.take("b", value));
+    BOOST_CHECK(has(cache, "c", blob('c')));
+    BOOST_CHECK(has(cache, "e", blob('e')));
+
+    // freed space is reused
+    cache.put("f", blob('f'));
+    cache.put("g", blob('g'));
+    BOOST_CHECK(has(cache, "d", blob('d')));
+
+    const auto stats(cache.stats());
+    BOOST_CHECK_EQUAL(stats.evicted, 2u);
+    BOOST_CHECK_EQUAL(stats.spilled, 0u);
+    BOOST_CHECK_EQUAL(stats.peakSize, 300u);
+}
+
+BOOST_AUTO_TEST_CASE(spill)
+{
+    // room for 2 blobs in memory and 2 in spill file
+    Config config(200, 200);
+    config.spillDir = fs::temp_directory_path();
+    vtstools::GeometryCache cache(config);
+
+    for (char c : { 'a', 'b', 'c', 'd', 'e' }) {
+        cache.put(std::string(1, c), blob(c));
+    }
+
+    // a and b spilled, c dropped (spill file full)
+    std::string value;
+    BOOST_CHECK(has(cache, "b", blob('b')));
+    BOOST_CHECK(has(cache, "a", blob('a')));
+    BOOST_CHECK(!cache.take("c", value));
+    BOOST_CHECK(has(cache, "d", blob('d')));
+    BOOST_CHECK(has(cache, "e", blob('e')));
+
+    const auto stats(cache.stats());
+    BOOST_CHECK_EQUAL(stats.spilled, 2u);
+    BOOST_CHECK_EQUAL(stats.spillHits, 2u);
+    BOOST_CHECK_EQUAL(stats.evicted, 1u);
+    BOOST_CHECK_EQUAL(stats.spillSize, 200u);
+}
+
+BOOST_AUTO_TEST_CASE(drop)
+{
+    vtstools::GeometryCache cache(Config(100, 1000));
+    cache.put("a", blob('a'));
+    cache.put("b", blob('b'));
+    cache.put("c", blob('c'));
+
+    // a and b spilled, c in memory
+    cache.drop("a");
+    cache.drop("c");
+    cache.drop("x");
+
+    std::string value;
+    BOOST_CHECK(!cache.take("a", value));
+    BOOST_CHECK(has(cache, "b", blob('b')));
+    BOOST_CHECK(!cache.take("c", value));
+
+    // dropped memory is free again: d and e fit without spilling
+    cache.put("d", blob('d', 50));
+    cache.put("e", blob('e', 50));
+
+    const auto stats(cache.stats());
+    BOOST_CHECK_EQUAL(stats.dropped, 2u);
+    BOOST_CHECK_EQUAL(stats.spilled, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(replace)
+{
+    vtstools::GeometryCache cache(Config(150));
+    cache.put("a", blob('a'));
+    cache.put("a", blob('A', 50));
+    cache.put("b", blob('b', 100));
+
+    BOOST_CHECK(has(cache, "a", blob('A', 50)));
+    BOOST_CHECK(has(cache, "b", blob('b', 100)));
+    BOOST_CHECK_EQUAL(cache.stats().evicted, 0u);
+}
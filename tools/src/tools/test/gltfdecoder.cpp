@@ -0,0 +1,501 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE gltfdecoder
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#ifdef VTS_TOOLS_HAS_DRACO
+#  include <draco/compression/encode.h>
+#  include <draco/mesh/triangle_soup_mesh_builder.h>
+#endif
+
+#include "../gltfdecoder.hpp"
+#include "../draco.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+namespace {
+
+/** Appends little-endian values to binary buffer.
+ */
+template <typename T>
+void append(std::string &bin, std::initializer_list<T> values)
+{
+    for (const auto value : values) {
+        bin.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+void pad(std::string &data, std::size_t alignment, char c)
+{
+    while (data.size() % alignment) { data.push_back(c); }
+}
+
+/** Builds GLB from JSON and binary chunk.
+ */
+std::string glb(std::string json, std::string bin = std::string())
+{
+    pad(json, 4, ' ');
+    pad(bin, 4, '\0');
+
+    std::string out("glTF");
+    const std::uint32_t length(12 + 8 + json.size()
+                               + (bin.empty() ? 0 : 8 + bin.size()));
+    append<std::uint32_t>(out, { 2, length });
+    append<std::uint32_t>(out, { std::uint32_t(json.size()), 0x4e4f534a });
+    out += json;
+    if (!bin.empty()) {
+        append<std::uint32_t>(out, { std::uint32_t(bin.size()), 0x004e4942 });
+        out += bin;
+    }
+    return out;
+}
+
+/** Wraps GLB into b3dm with given feature table JSON.
+ */
+std::string b3dm(const std::string &glb, std::string featureTable)
+{
+    pad(featureTable, 8, ' ');
+
+    std::string out("b3dm");
+    append<std::uint32_t>
+        (out, { 1, std::uint32_t(28 + featureTable.size() + glb.size())
+                , std::uint32_t(featureTable.size()), 0, 0, 0 });
+    return out + featureTable + glb;
+}
+
+math::Matrix4 identity()
+{
+    return ublas::identity_matrix<double>(4);
+}
+
+vtstools::GltfContent decode(const std::string &data, bool flipTc = false)
+{
+    vtstools::GltfContent content;
+    vtstools::decodeGltf(data.data(), data.size(), identity(), flipTc
+                         , content);
+    return content;
+}
+
+/** Unit quad in glTF XY plane (4 float positions, 4 float texture
+ *  coordinates, 6 uint16 indices) followed by 4 image bytes.
+ */
+std::string quadBin()
+{
+    std::string bin;
+    append<float>(bin, { 0, 0, 0,  1, 0, 0,  0, 1, 0,  1, 1, 0 });
+    append<float>(bin, { 0, 0,  1, 0,  0, 1,  1, 1 });
+    append<std::uint16_t>(bin, { 0, 1, 2,  2, 1, 3 });
+    bin += "IMG!";
+    return bin;
+}
+
+/** Buffer views and accessors of quadBin().
+ */
+const char *quadViews(R"RAW(
+    "buffers": [{ "byteLength": 92 }],
+    "bufferViews": [
+        { "buffer": 0, "byteOffset": 0, "byteLength": 48 },
+        { "buffer": 0, "byteOffset": 48, "byteLength": 32 },
+        { "buffer": 0, "byteOffset": 80, "byteLength": 12 },
+        { "buffer": 0, "byteOffset": 92, "byteLength": 4 }
+    ],
+    "accessors": [
+        { "bufferView": 0, "componentType": 5126, "count": 4
+          , "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0] },
+        { "bufferView": 1, "componentType": 5126, "count": 4
+          , "type": "VEC2", "min": [0, 0], "max": [1, 1] },
+        { "bufferView": 2, "componentType": 5123, "count": 6
+          , "type": "SCALAR" }
+    ],
+    "images": [{ "bufferView": 3, "mimeType": "image/jpeg" }],
+    "textures": [{ "source": 0 }],
+    "materials": [
+        { "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 } } }
+    ]
+)RAW");
+
+std::string quadGltf(const std::string &meshes
+                     , const std::string &extra = std::string())
+{
+    return glb("{ \"asset\": { \"version\": \"2.0\" }, " + extra
+               + quadViews + ", \"meshes\": " + meshes + " }"
+               , quadBin());
+}
+
+const char *texturedQuad(R"RAW([{ "primitives": [
+    { "attributes": { "POSITION": 0, "TEXCOORD_0": 1 }, "indices": 2
+      , "material": 0 }
+]}])RAW");
+
+void checkPoint(const math::Point3d &p, double x, double y, double z)
+{
+    BOOST_CHECK_SMALL(p(0) - x, 1e-9);
+    BOOST_CHECK_SMALL(p(1) - y, 1e-9);
+    BOOST_CHECK_SMALL(p(2) - z, 1e-9);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(texturedPrimitive)
+{
+    // node translated by (10, 20, 30) in glTF (Y-up) space
+    const auto content
+        (decode(quadGltf(texturedQuad, R"RAW(
+            "scenes": [{ "nodes": [0] }],
+            "nodes": [{ "mesh": 0, "translation": [10, 20, 30] }],
+        )RAW"), true));
+
+    BOOST_REQUIRE_EQUAL(content.mesh.submeshes.size(), 1u);
+    const auto &sm(content.mesh.submeshes[0]);
+
+    // Y-up -> Z-up: (x, y, z) -> (x, -z, y)
+    BOOST_REQUIRE_EQUAL(sm.vertices.size(), 4u);
+    checkPoint(sm.vertices[0], 10, -30, 20);
+    checkPoint(sm.vertices[3], 11, -30, 21);
+
+    // flipped texture coordinates, shared faces
+    BOOST_REQUIRE_EQUAL(sm.tc.size(), 4u);
+    BOOST_CHECK_EQUAL(sm.tc[0](1), 1.0);
+    BOOST_CHECK_EQUAL(sm.tc[3](1), 0.0);
+    BOOST_REQUIRE_EQUAL(sm.faces.size(), 2u);
+    BOOST_CHECK_EQUAL(sm.faces[1](0), 2u);
+    BOOST_CHECK_EQUAL(sm.faces[1](2), 3u);
+    BOOST_CHECK_EQUAL(sm.facesTc.size(), 2u);
+
+    // image points into content
+    BOOST_REQUIRE_EQUAL(content.images.size(), 1u);
+    BOOST_CHECK_EQUAL(std::string(content.images[0].data
+                                  , content.images[0].size), "IMG!");
+}
+
+BOOST_AUTO_TEST_CASE(rtcCenter)
+{
+    const auto content
+        (decode(b3dm(quadGltf(texturedQuad)
+                     , R"RAW({ "BATCH_LENGTH": 0
+                             , "RTC_CENTER": [100, 200, 300] })RAW")));
+
+    BOOST_REQUIRE_EQUAL(content.mesh.submeshes.size(), 1u);
+    checkPoint(content.mesh.submeshes[0].vertices[3], 101, 200, 301);
+}
+
+BOOST_AUTO_TEST_CASE(sharedTextureMerged)
+{
+    // two primitives textured by the same image, one untextured
+    const auto content(decode(quadGltf(R"RAW([{ "primitives": [
+        { "attributes": { "POSITION": 0, "TEXCOORD_0": 1 }, "indices": 2
+          , "material": 0 },
+        { "attributes": { "POSITION": 0, "TEXCOORD_0": 1 }, "indices": 2
+          , "material": 0 },
+        { "attributes": { "POSITION": 0 }, "indices": 2 }
+    ]}])RAW")));
+
+    BOOST_REQUIRE_EQUAL(content.mesh.submeshes.size(), 2u);
+    BOOST_CHECK_EQUAL(content.images.size(), 1u);
+
+    const auto &merged(content.mesh.submeshes[0]);
+    BOOST_CHECK_EQUAL(merged.vertices.size(), 8u);
+    BOOST_CHECK_EQUAL(merged.tc.size(), 8u);
+    BOOST_REQUIRE_EQUAL(merged.faces.size(), 4u);
+    BOOST_REQUIRE_EQUAL(merged.facesTc.size(), 4u);
+
+    // second primitive's faces are shifted past the first one's vertices
+    BOOST_CHECK_EQUAL(merged.faces[2](0), 4u);
+    BOOST_CHECK_EQUAL(merged.faces[3](2), 7u);
+    BOOST_CHECK_EQUAL(merged.facesTc[3](2), 7u);
+
+    const auto &plain(content.mesh.submeshes[1]);
+    BOOST_CHECK_EQUAL(plain.vertices.size(), 4u);
+    BOOST_CHECK(plain.tc.empty());
+    BOOST_CHECK(plain.facesTc.empty());
+}
+
+BOOST_AUTO_TEST_CASE(invalidContent)
+{
+    // triangle, positions accessor of given vertex count, index 3
+    const auto triangle([](int count) -> std::string
+    {
+        std::string bin;
+        append<float>(bin, { 0, 0, 0,  1, 0, 0,  0, 1, 0 });
+        append<std::uint16_t>(bin, { 0, 1, 3,  0 });
+        return glb(R"RAW({
+            "asset": { "version": "2.0" },
+            "buffers": [{ "byteLength": 44 }],
+            "bufferViews": [
+                { "buffer": 0, "byteOffset": 0, "byteLength": 36 },
+                { "buffer": 0, "byteOffset": 36, "byteLength": 6 }
+            ],
+            "accessors": [
+                { "bufferView": 0, "componentType": 5126, "count": )RAW"
+                   + std::to_string(count) + R"RAW(, "type": "VEC3" },
+                { "bufferView": 1, "componentType": 5123, "count": 3
+                  , "type": "SCALAR" }
+            ],
+            "meshes": [{ "primitives": [
+                { "attributes": { "POSITION": 0 }, "indices": 1 }
+            ]}]
+        })RAW", bin);
+    });
+
+    // index past vertex count
+    BOOST_CHECK_THROW(decode(triangle(3)), std::runtime_error);
+
+    // accessor reaching past its buffer view
+    BOOST_CHECK_THROW(decode(triangle(4)), std::runtime_error);
+
+    // neither GLB nor b3dm
+    const std::string garbage(64, 'x');
+    BOOST_CHECK_THROW(decode(garbage), vtstools::GltfUnsupported);
+
+    // unknown required extension
+    BOOST_CHECK_THROW(decode(quadGltf(texturedQuad, R"RAW(
+        "extensionsRequired": ["EXT_unknown"],
+    )RAW")), vtstools::GltfUnsupported);
+}
+
+BOOST_AUTO_TEST_CASE(headerSize)
+{
+    const auto data(quadGltf(texturedQuad));
+    const auto *d(data.data());
+
+    // GLB header, JSON chunk and binary chunk header
+    std::uint32_t json;
+    std::memcpy(&json, d + 12, 4);
+    const std::size_t glbHeader(12 + 8 + json + 8);
+    BOOST_CHECK_EQUAL(vtstools::gltfHeaderSize(d, 10), 28u);
+    BOOST_CHECK_EQUAL(vtstools::gltfHeaderSize(d, 28), glbHeader);
+    BOOST_CHECK_EQUAL(vtstools::gltfHeaderSize(d, data.size()), glbHeader);
+
+    // b3dm: known only once b3dm header is available
+    const auto tile(b3dm(data, R"RAW({ "BATCH_LENGTH": 0 })RAW"));
+    const std::size_t offset(tile.size() - data.size());
+    BOOST_CHECK_EQUAL(vtstools::gltfHeaderSize(tile.data(), 27), 28u);
+    BOOST_CHECK_EQUAL(vtstools::gltfHeaderSize(tile.data(), 28)
+                      , offset + 20);
+    BOOST_CHECK_EQUAL(vtstools::gltfHeaderSize(tile.data(), offset + 20)
+                      , offset + glbHeader);
+}
+
+BOOST_AUTO_TEST_CASE(estimateFromHeader)
+{
+    const auto data(b3dm(quadGltf(texturedQuad)
+                         , R"RAW({ "BATCH_LENGTH": 0
+                                 , "RTC_CENTER": [100, 200, 300] })RAW"));
+
+    // grow prefix until header is complete
+    std::size_t size(0);
+    for (std::size_t needed(0);
+         (needed = vtstools::gltfHeaderSize(data.data(), size)) > size; )
+    {
+        size = needed;
+    }
+    BOOST_REQUIRE_LT(size, data.size());
+
+    // header only: binary chunk is never touched
+    const std::string header(data, 0, size);
+    BOOST_CHECK(!vtstools::gltfNeedsNativeDecoder(header.data()
+                                                  , header.size()));
+
+    vtstools::GltfContent content;
+    vtstools::estimateGltf(header.data(), header.size(), identity(), true
+                           , content);
+
+    // quad spanning POSITION bounds, perpendicular to the flat axis
+    BOOST_REQUIRE_EQUAL(content.mesh.submeshes.size(), 1u);
+    const auto &sm(content.mesh.submeshes[0]);
+    BOOST_REQUIRE_EQUAL(sm.vertices.size(), 4u);
+    BOOST_CHECK_EQUAL(sm.faces.size(), 2u);
+    checkPoint(sm.vertices[0], 100, 200, 300);
+    checkPoint(sm.vertices[3], 101, 200, 301);
+    BOOST_REQUIRE_EQUAL(sm.tc.size(), 4u);
+    BOOST_CHECK_EQUAL(sm.tc[0](1), 1.0);
+    BOOST_CHECK_EQUAL(sm.tc[3](1), 0.0);
+
+    // image is only located in content
+    BOOST_REQUIRE_EQUAL(content.images.size(), 1u);
+    const auto &image(content.images[0]);
+    BOOST_CHECK(!image.data);
+    BOOST_CHECK_EQUAL(data.substr(image.offset, image.size), "IMG!");
+}
+
+BOOST_AUTO_TEST_CASE(imagesLocated)
+{
+    const auto data(b3dm(quadGltf(texturedQuad)
+                         , R"RAW({ "BATCH_LENGTH": 0 })RAW"));
+
+    // image points into content, offset is relative to content start
+    const auto images(vtstools::gltfImages(data.data(), data.size()));
+    BOOST_REQUIRE_EQUAL(images.size(), 1u);
+    BOOST_CHECK_EQUAL(images[0].data, data.data() + images[0].offset);
+    BOOST_CHECK_EQUAL(std::string(images[0].data, images[0].size), "IMG!");
+
+    // not glTF at all
+    BOOST_CHECK(vtstools::gltfImages("garbage", 7).empty());
+}
+
+BOOST_AUTO_TEST_CASE(estimateUnsupported)
+{
+    // accessor without bounds
+    const auto data(glb(R"RAW({
+        "asset": { "version": "2.0" },
+        "extensionsUsed": ["KHR_mesh_quantization"],
+        "buffers": [{ "byteLength": 36 }],
+        "bufferViews": [{ "buffer": 0, "byteLength": 36 }],
+        "accessors": [
+            { "bufferView": 0, "componentType": 5126, "count": 3
+              , "type": "VEC3" }
+        ],
+        "meshes": [{ "primitives": [{ "attributes": { "POSITION": 0 } }]}]
+    })RAW", std::string(36, '\0')));
+
+    const auto size(vtstools::gltfHeaderSize(data.data(), data.size()));
+    BOOST_CHECK(vtstools::gltfNeedsNativeDecoder(data.data(), size));
+
+    vtstools::GltfContent content;
+    BOOST_CHECK_THROW(vtstools::estimateGltf(data.data(), size, identity()
+                                             , false, content)
+                      , vtstools::GltfUnsupported);
+}
+
+#ifdef VTS_TOOLS_HAS_DRACO
+
+BOOST_AUTO_TEST_CASE(dracoPrimitive)
+{
+    BOOST_CHECK(vtstools::dracoSupported());
+
+    // textured quad encoded by Draco
+    const float positions[4][3]
+        = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 } };
+    const float tcs[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    const int faces[2][3] = { { 0, 1, 2 }, { 2, 1, 3 } };
+
+    draco::TriangleSoupMeshBuilder builder;
+    builder.Start(2);
+    const auto pa(builder.AddAttribute(draco::GeometryAttribute::POSITION
+                                       , 3, draco::DT_FLOAT32));
+    const auto ta(builder.AddAttribute(draco::GeometryAttribute::TEX_COORD
+                                       , 2, draco::DT_FLOAT32));
+    for (int f(0); f < 2; ++f) {
+        const auto *face(faces[f]);
+        builder.SetAttributeValuesForFace
+            (pa, draco::FaceIndex(f), positions[face[0]]
+             , positions[face[1]], positions[face[2]]);
+        builder.SetAttributeValuesForFace
+            (ta, draco::FaceIndex(f), tcs[face[0]], tcs[face[1]]
+             , tcs[face[2]]);
+    }
+    const auto mesh(builder.Finalize());
+    BOOST_REQUIRE(mesh);
+
+    draco::Encoder encoder;
+    encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, 16);
+    encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD
+                                     , 16);
+    draco::EncoderBuffer buffer;
+    BOOST_REQUIRE(encoder.EncodeMeshToBuffer(*mesh, &buffer).ok());
+
+    std::string bin(buffer.data(), buffer.size());
+    const auto compressedSize(bin.size());
+    pad(bin, 4, '\0');
+    bin += "IMG!";
+
+    const auto size(std::to_string(compressedSize));
+    const auto data(glb(R"RAW({
+        "asset": { "version": "2.0" },
+        "extensionsUsed": ["KHR_draco_mesh_compression"],
+        "extensionsRequired": ["KHR_draco_mesh_compression"],
+        "buffers": [{ "byteLength": )RAW" + std::to_string(bin.size())
+                        + R"RAW( }],
+        "bufferViews": [
+            { "buffer": 0, "byteOffset": 0, "byteLength": )RAW" + size
+                        + R"RAW( },
+            { "buffer": 0, "byteOffset": )RAW"
+                        + std::to_string(bin.size() - 4)
+                        + R"RAW(, "byteLength": 4 }
+        ],
+        "accessors": [
+            { "componentType": 5126, "count": 4, "type": "VEC3" },
+            { "componentType": 5126, "count": 4, "type": "VEC2" }
+        ],
+        "images": [{ "bufferView": 1, "mimeType": "image/jpeg" }],
+        "textures": [{ "source": 0 }],
+        "materials": [
+            { "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 } } }
+        ],
+        "meshes": [{ "primitives": [
+            { "attributes": { "POSITION": 0, "TEXCOORD_0": 1 }
+              , "material": 0
+              , "extensions": { "KHR_draco_mesh_compression": {
+                  "bufferView": 0
+                  , "attributes": { "POSITION": 0, "TEXCOORD_0": 1 } } } }
+        ]}]
+    })RAW", bin));
+
+    BOOST_CHECK(vtstools::gltfNeedsNativeDecoder(data.data(), data.size()));
+
+    const auto content(decode(data));
+    BOOST_REQUIRE_EQUAL(content.mesh.submeshes.size(), 1u);
+    BOOST_CHECK_EQUAL(content.images.size(), 1u);
+
+    // Draco may reorder points and faces: check every corner's position
+    // against its texture coordinates (u = x, v = y on this quad)
+    const auto &sm(content.mesh.submeshes[0]);
+    BOOST_REQUIRE_EQUAL(sm.faces.size(), 2u);
+    BOOST_REQUIRE_EQUAL(sm.facesTc.size(), 2u);
+    for (std::size_t f(0); f < 2; ++f) {
+        for (int c(0); c < 3; ++c) {
+            const auto &v(sm.vertices[sm.faces[f](c)]);
+            const auto &t(sm.tc[sm.facesTc[f](c)]);
+            BOOST_CHECK_SMALL(v(0) - t(0), 1e-3);
+            BOOST_CHECK_SMALL(v(2) - t(1), 1e-3);
+            BOOST_CHECK_SMALL(v(1), 1e-3);
+        }
+    }
+}
+
+#else // VTS_TOOLS_HAS_DRACO
+
+BOOST_AUTO_TEST_CASE(dracoUnavailable)
+{
+    BOOST_CHECK(!vtstools::dracoSupported());
+
+    const std::string data(16, '\0');
+    vtstools::vts::SubMesh sm;
+    BOOST_CHECK_THROW(vtstools::decodeDraco(data.data(), data.size(), sm)
+                      , std::runtime_error);
+}
+
+#endif // VTS_TOOLS_HAS_DRACO
@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE mappedzip
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/crc.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#include "../mappedzip.hpp"
+
+namespace fs = boost::filesystem;
+namespace bio = boost::iostreams;
+
+namespace {
+
+/** Minimal ZIP writer: stored and deflated entries, no ZIP64.
+ */
+class ZipWriter {
+public:
+    struct Options {
+        bool deflate;
+
+        /** Overrides size in central directory when set.
+         */
+        long size;
+
+        Options() : deflate(false), size(-1) {}
+    };
+
+    void add(const std::string &name, const std::string &content
+             , const Options &options = Options())
+    {
+        boost::crc_32_type crc;
+        crc.process_bytes(content.data(), content.size());
+
+        std::string data(content);
+        if (options.deflate) {
+            data.clear();
+            bio::zlib_params params;
+            params.noheader = true;
+            bio::filtering_ostream os;
+            os.push(bio::zlib_compressor(params));
+            os.push(bio::back_inserter(data));
+            os.write(content.data(), content.size());
+            os.reset();
+        }
+
+        Entry entry;
+        entry.name = name;
+        entry.method = options.deflate ? 8 : 0;
+        entry.crc = crc.checksum();
+        entry.compressedSize = data.size();
+        entry.size = (options.size >= 0) ? options.size : content.size();
+        entry.offset = out_.size();
+
+        value<std::uint32_t>(0x04034b50);
+        value<std::uint16_t>(20);
+        value<std::uint16_t>(0);
+        value<std::uint16_t>(entry.method);
+        value<std::uint32_t>(0);
+        value<std::uint32_t>(entry.crc);
+        value<std::uint32_t>(entry.compressedSize);
+        value<std::uint32_t>(entry.size);
+        value<std::uint16_t>(name.size());
+        value<std::uint16_t>(0);
+        out_ += name;
+        out_ += data;
+
+        entries_.push_back(entry);
+    }
+
+    /** Writes archive to given file, optionally truncated by given number of
+     *  bytes taken from the end of the last entry's data.
+     */
+    void write(const fs::path &path, std::size_t cut = 0)
+    {
+        auto out(out_);
+        const auto cdOffset(out_.size());
+        for (const auto &entry : entries_) {
+            value<std::uint32_t>(0x02014b50);
+            value<std::uint16_t>(20);
+            value<std::uint16_t>(20);
+            value<std::uint16_t>(0);
+            value<std::uint16_t>(entry.method);
+            value<std::uint32_t>(0);
+            value<std::uint32_t>(entry.crc);
+            value<std::uint32_t>(entry.compressedSize);
+            value<std::uint32_t>(entry.size);
+            value<std::uint16_t>(entry.name.size());
+            value<std::uint16_t>(0);
+            value<std::uint16_t>(0);
+            value<std::uint16_t>(0);
+            value<std::uint16_t>(0);
+            value<std::uint32_t>(0);
+            value<std::uint32_t>(entry.offset);
+            out_ += entry.name;
+        }
+        const auto cdSize(out_.size() - cdOffset);
+
+        value<std::uint32_t>(0x06054b50);
+        value<std::uint16_t>(0);
+        value<std::uint16_t>(0);
+        value<std::uint16_t>(entries_.size());
+        value<std::uint16_t>(entries_.size());
+        value<std::uint32_t>(cdSize);
+        value<std::uint32_t>(cdOffset);
+        value<std::uint16_t>(0);
+
+        // cut data out of last entry, keep central directory reachable
+        std::string data(out_);
+        out_.swap(out);
+        if (cut) {
+            data.erase(cdOffset - cut, cut);
+            auto *end(&data[data.size() - 22]);
+            const auto offset(std::uint32_t(cdOffset - cut));
+            for (int i(0); i < 4; ++i) {
+                end[16 + i] = char(offset >> (8 * i));
+            }
+        }
+
+        std::ofstream f(path.string(), std::ios::binary | std::ios::trunc);
+        f.write(data.data(), data.size());
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::uint16_t method;
+        std::uint32_t crc;
+        std::uint32_t compressedSize;
+        std::uint32_t size;
+        std::uint32_t offset;
+    };
+
+    template <typename T> void value(T value) {
+        for (std::size_t i(0); i < sizeof(T); ++i) {
+            out_.push_back(char(value >> (8 * i)));
+        }
+    }
+
+    std::string out_;
+    std::vector<Entry> entries_;
+};
+
+/** Temporary file removed at scope exit.
+ */
+struct TmpFile {
+    fs::path path;
+
+    TmpFile() : path(fs::temp_directory_path()
+                     / fs::unique_path("mappedzip-%%%%-%%%%.zip"))
+    {}
+
+    ~TmpFile() {
+        boost::system::error_code ec;
+        fs::remove(path, ec);
+    }
+};
+
+std::string str(const vtstools::MappedZip::Data &data)
+{
+    return std::string(data.data, data.size);
+}
+
+/** Compressible content of given size.
+ */
+std::string content(std::size_t size)
+{
+    std::string out;
+    for (std::size_t i(0); out.size() < size; ++i) {
+        out += "line " + std::to_string(i) + "\n";
+    }
+    out.resize(size);
+    return out;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(storedAndDeflated)
+{
+    const auto big(content(100000));
+
+    ZipWriter zw;
+    ZipWriter::Options deflate;
+    deflate.deflate = true;
+    zw.add("nodes/0/3dNodeIndexDocument.json", "{\"id\": \"0\"}");
+    zw.add("nodes/0/geometries/0.bin", big, deflate);
+    zw.add("nodes/1/3dNodeIndexDocument.json", "{\"id\": \"1\"}", deflate);
+    zw.add("metadata.json", "{}");
+
+    TmpFile tmp;
+    zw.write(tmp.path);
+
+    const vtstools::MappedZip zip(tmp.path);
+    BOOST_REQUIRE_EQUAL(zip.entries().size(), 4u);
+    BOOST_CHECK(!zip.find("nodes/2/3dNodeIndexDocument.json"));
+    BOOST_CHECK(!zip.find("nodes/0"));
+
+    // stored: served from mapping
+    const auto *doc(zip.find("nodes/0/3dNodeIndexDocument.json"));
+    BOOST_REQUIRE(doc);
+    const auto stored(zip.data(*doc));
+    BOOST_CHECK(!stored.buffer);
+    BOOST_CHECK_EQUAL(str(stored), "{\"id\": \"0\"}");
+    BOOST_CHECK_EQUAL(str(zip.head(*doc, 4)), "{\"id");
+
+    // deflated: inflated into buffer
+    const auto *geometry(zip.find("nodes/0/geometries/0.bin"));
+    BOOST_REQUIRE(geometry);
+    BOOST_CHECK_EQUAL(geometry->size, big.size());
+    BOOST_CHECK_LT(geometry->compressedSize, geometry->size);
+    const auto inflated(zip.data(*geometry));
+    BOOST_CHECK(inflated.buffer);
+    BOOST_CHECK(str(inflated) == big);
+
+    // head inflates only requested prefix, clamped to entry size
+    const auto head(zip.head(*geometry, 1000));
+    BOOST_CHECK_EQUAL(head.size, 1000u);
+    BOOST_CHECK(str(head) == big.substr(0, 1000));
+    BOOST_CHECK_EQUAL(zip.head(*geometry, 1 << 30).size, big.size());
+
+    // listing is ordered by name
+    const auto nodes(zip.list("nodes/"));
+    BOOST_REQUIRE_EQUAL(nodes.size(), 3u);
+    BOOST_CHECK_EQUAL(nodes[0]->name, "nodes/0/3dNodeIndexDocument.json");
+    BOOST_CHECK_EQUAL(nodes[1]->name, "nodes/0/geometries/0.bin");
+    BOOST_CHECK_EQUAL(nodes[2]->name, "nodes/1/3dNodeIndexDocument.json");
+    BOOST_CHECK_EQUAL(str(zip.data(*nodes[2])), "{\"id\": \"1\"}");
+    BOOST_CHECK(zip.list("nodes/2").empty());
+}
+
+BOOST_AUTO_TEST_CASE(storedSizeMismatch)
+{
+    // stored entry claiming more data than it holds
+    ZipWriter zw;
+    ZipWriter::Options options;
+    options.size = 1000;
+    zw.add("a.bin", "abc", options);
+
+    TmpFile tmp;
+    zw.write(tmp.path);
+
+    const vtstools::MappedZip zip(tmp.path);
+    const auto *entry(zip.find("a.bin"));
+    BOOST_REQUIRE(entry);
+    BOOST_CHECK_THROW(zip.data(*entry), std::runtime_error);
+    BOOST_CHECK_THROW(zip.head(*entry, 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(truncatedData)
+{
+    // last entry's data cut short: directory points past the end
+    ZipWriter zw;
+    zw.add("a.bin", content(10));
+    zw.add("b.bin", content(1000));
+
+    TmpFile tmp;
+    zw.write(tmp.path, 500);
+
+    const vtstools::MappedZip zip(tmp.path);
+    BOOST_CHECK_EQUAL(str(zip.data(*zip.find("a.bin"))), content(10));
+    BOOST_CHECK_THROW(zip.data(*zip.find("b.bin")), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(truncatedDeflate)
+{
+    // deflated entry whose declared size exceeds its inflated data
+    ZipWriter zw;
+    ZipWriter::Options options;
+    options.deflate = true;
+    options.size = 2000;
+    zw.add("a.bin", content(1000), options);
+
+    TmpFile tmp;
+    zw.write(tmp.path);
+
+    const vtstools::MappedZip zip(tmp.path);
+    const auto *entry(zip.find("a.bin"));
+    BOOST_REQUIRE(entry);
+    BOOST_CHECK_EQUAL(str(zip.head(*entry, 1000)), content(1000));
+    BOOST_CHECK_THROW(zip.data(*entry), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(notZip)
+{
+    TmpFile tmp;
+    {
+        std::ofstream f(tmp.path.string());
+        f << content(1000);
+    }
+    BOOST_CHECK_THROW(vtstools::MappedZip zip(tmp.path), std::runtime_error);
+    BOOST_CHECK_THROW(vtstools::MappedZip zip(tmp.path.string() + ".missing")
+                      , std::runtime_error);
+}
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE meshopt
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../meshopt.hpp"
+
+namespace {
+
+typedef std::vector<std::uint8_t> Bytes;
+
+std::vector<char> decode(const Bytes &data, std::size_t count
+                         , std::size_t stride, vtstools::MeshoptMode mode
+                         , vtstools::MeshoptFilter filter
+                         = vtstools::MeshoptFilter::none)
+{
+    return vtstools::decodeMeshopt
+        (reinterpret_cast<const char*>(data.data()), data.size(), count
+         , stride, mode, filter);
+}
+
+template <typename T>
+T read(const std::vector<char> &data, std::size_t index)
+{
+    T value;
+    std::memcpy(&value, data.data() + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+/** Reference index buffer from meshoptimizer's test suite: triangles
+ *  0 1 2, 2 1 3, 4 6 5, 7 8 9.
+ */
+const Bytes triangles = {
+    0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00
+    , 0x76, 0x87, 0x56, 0x67, 0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01
+    , 0x69, 0x00, 0x00
+};
+
+const std::uint32_t trianglesIndices[] = {
+    0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9
+};
+
+/** Reference vertex buffer from meshoptimizer's test suite: 4 vertices of
+ *  stride 8, uint16 positions (0, 0, 0), (300, 0, 0), (0, 300, 0),
+ *  (300, 300, 0) followed by zeros.
+ */
+Bytes vertices()
+{
+    Bytes data = {
+        0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26
+        , 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08
+        , 0x00, 0x00, 0x00
+    };
+    data.resize(data.size() + 36);
+    return data;
+}
+
+/** Single 4-byte vertex with all deltas zero: the value lives in the tail.
+ */
+Bytes constantVertex(std::uint32_t value)
+{
+    Bytes data = { 0xa0, 0x00, 0x00, 0x00, 0x00 };
+    data.resize(data.size() + 32);
+    std::memcpy(&data[data.size() - 4], &value, 4);
+    return data;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(names)
+{
+    using vtstools::MeshoptMode;
+    using vtstools::MeshoptFilter;
+
+    BOOST_CHECK(vtstools::meshoptMode("ATTRIBUTES")
+                == MeshoptMode::attributes);
+    BOOST_CHECK(vtstools::meshoptMode("TRIANGLES") == MeshoptMode::triangles);
+    BOOST_CHECK(vtstools::meshoptMode("INDICES") == MeshoptMode::indices);
+    BOOST_CHECK_THROW(vtstools::meshoptMode("attributes")
+                      , std::runtime_error);
+
+    BOOST_CHECK(vtstools::meshoptFilter("") == MeshoptFilter::none);
+    BOOST_CHECK(vtstools::meshoptFilter("NONE") == MeshoptFilter::none);
+    BOOST_CHECK(vtstools::meshoptFilter("EXPONENTIAL")
+                == MeshoptFilter::exponential);
+    BOOST_CHECK_THROW(vtstools::meshoptFilter("COLOR"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(triangleIndices)
+{
+    const auto out32(decode(triangles, 12, 4
+                            , vtstools::MeshoptMode::triangles));
+    BOOST_REQUIRE_EQUAL(out32.size(), 12u * 4);
+    for (std::size_t i(0); i < 12; ++i) {
+        BOOST_CHECK_EQUAL(read<std::uint32_t>(out32, i), trianglesIndices[i]);
+    }
+
+    const auto out16(decode(triangles, 12, 2
+                            , vtstools::MeshoptMode::triangles));
+    BOOST_REQUIRE_EQUAL(out16.size(), 12u * 2);
+    for (std::size_t i(0); i < 12; ++i) {
+        BOOST_CHECK_EQUAL(read<std::uint16_t>(out16, i), trianglesIndices[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(indexSequence)
+{
+    // deltas 0 1 1 0 -1 2 against baseline 0
+    const Bytes data = {
+        0xd1, 0x00, 0x04, 0x04, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00
+    };
+    const std::uint32_t expected[] = { 0, 1, 2, 2, 1, 3 };
+
+    const auto out(decode(data, 6, 4, vtstools::MeshoptMode::indices));
+    for (std::size_t i(0); i < 6; ++i) {
+        BOOST_CHECK_EQUAL(read<std::uint32_t>(out, i), expected[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(attributes)
+{
+    const auto out(decode(vertices(), 4, 8
+                          , vtstools::MeshoptMode::attributes));
+    BOOST_REQUIRE_EQUAL(out.size(), 4u * 8);
+
+    const std::uint16_t expected[4][3] = {
+        { 0, 0, 0 }, { 300, 0, 0 }, { 0, 300, 0 }, { 300, 300, 0 }
+    };
+    for (std::size_t v(0); v < 4; ++v) {
+        for (std::size_t c(0); c < 3; ++c) {
+            BOOST_CHECK_EQUAL(read<std::uint16_t>(out, v * 4 + c)
+                              , expected[v][c]);
+        }
+        BOOST_CHECK_EQUAL(read<std::uint16_t>(out, v * 4 + 3), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(exponentialFilter)
+{
+    // mantissa 3, exponent -1
+    const auto out(decode(constantVertex((0xffu << 24) | 3), 1, 4
+                          , vtstools::MeshoptMode::attributes
+                          , vtstools::MeshoptFilter::exponential));
+    BOOST_CHECK_EQUAL(read<float>(out, 0), 1.5f);
+
+    BOOST_CHECK_THROW(decode(constantVertex(0), 1, 4
+                             , vtstools::MeshoptMode::attributes
+                             , vtstools::MeshoptFilter::octahedral)
+                      , std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(malformed)
+{
+    using vtstools::MeshoptMode;
+
+    // bad headers and unsupported versions
+    auto badHeader(vertices());
+    badHeader[0] = 0xb0;
+    BOOST_CHECK_THROW(decode(badHeader, 4, 8, MeshoptMode::attributes)
+                      , std::runtime_error);
+    auto badVersion(vertices());
+    badVersion[0] = 0xa1;
+    BOOST_CHECK_THROW(decode(badVersion, 4, 8, MeshoptMode::attributes)
+                      , std::runtime_error);
+    auto badIndexVersion(triangles);
+    badIndexVersion[0] = 0xe2;
+    BOOST_CHECK_THROW(decode(badIndexVersion, 12, 4, MeshoptMode::triangles)
+                      , std::runtime_error);
+    BOOST_CHECK_THROW(decode(triangles, 12, 4, MeshoptMode::indices)
+                      , std::runtime_error);
+
+    // truncated and oversized data
+    for (std::size_t cut : { 1, 10, 30 }) {
+        auto data(vertices());
+        data.resize(data.size() - cut);
+        BOOST_CHECK_THROW(decode(data, 4, 8, MeshoptMode::attributes)
+                          , std::runtime_error);
+    }
+    auto longer(vertices());
+    longer.push_back(0);
+    BOOST_CHECK_THROW(decode(longer, 4, 8, MeshoptMode::attributes)
+                      , std::runtime_error);
+    for (std::size_t cut : { 1, 5, 20 }) {
+        Bytes data(triangles.begin(), triangles.end() - cut);
+        BOOST_CHECK_THROW(decode(data, 12, 4, MeshoptMode::triangles)
+                          , std::runtime_error);
+    }
+
+    // invalid layouts
+    BOOST_CHECK_THROW(decode(vertices(), 4, 6, MeshoptMode::attributes)
+                      , std::runtime_error);
+    BOOST_CHECK_THROW(decode(triangles, 12, 1, MeshoptMode::triangles)
+                      , std::runtime_error);
+    BOOST_CHECK_THROW(decode(triangles, 11, 4, MeshoptMode::triangles)
+                      , std::runtime_error);
+}
@@ -0,0 +1,413 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE modelloader
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../modelloader.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/** Temporary directory serving as model archive.
+ */
+struct TmpDir {
+    fs::path path;
+
+    TmpDir() : path(fs::temp_directory_path()
+                     / fs::unique_path("modelloader-%%%%-%%%%"))
+    {
+        fs::create_directories(path);
+    }
+
+    ~TmpDir() {
+        boost::system::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    void write(const fs::path &file, const std::string &content) const {
+        const auto full(path / file);
+        fs::create_directories(full.parent_path());
+        std::ofstream f(full.string(), std::ios::binary);
+        f.write(content.data(), content.size());
+    }
+};
+
+vtstools::NativeModel load(const TmpDir &dir, const fs::path &path
+                           , const math::Point3 &origin
+                           = math::Point3(0, 0, 0))
+{
+    return vtstools::loadNativeModel(roarchive::RoArchive(dir.path), path
+                                     , origin);
+}
+
+enum class Result { ok, unsupported, malformed };
+
+/** Loads model, telling unsupported (fallback) from malformed content.
+ */
+Result tryLoad(const TmpDir &dir, const fs::path &path)
+{
+    try {
+        load(dir, path);
+    } catch (const vtstools::ModelUnsupported&) {
+        return Result::unsupported;
+    } catch (const std::runtime_error&) {
+        return Result::malformed;
+    }
+    return Result::ok;
+}
+
+void checkPoint(const math::Point3 &p, double x, double y, double z)
+{
+    BOOST_CHECK_SMALL(p(0) - x, 1e-9);
+    BOOST_CHECK_SMALL(p(1) - y, 1e-9);
+    BOOST_CHECK_SMALL(p(2) - z, 1e-9);
+}
+
+void checkTc(const math::Point2 &p, double u, double v)
+{
+    BOOST_CHECK_SMALL(p(0) - u, 1e-9);
+    BOOST_CHECK_SMALL(p(1) - v, 1e-9);
+}
+
+void checkFace(const vtstools::vts::Face &face, unsigned int a, unsigned int b
+               , unsigned int c)
+{
+    BOOST_CHECK_EQUAL(face(0), a);
+    BOOST_CHECK_EQUAL(face(1), b);
+    BOOST_CHECK_EQUAL(face(2), c);
+}
+
+/** OBJ with textured materials a and b, with given faces.
+ */
+void obj(const TmpDir &dir, const std::string &faces)
+{
+    dir.write("tile/model.mtl",
+              "newmtl a\n"
+              "map_Kd textures\\a.jpg\n"
+              "newmtl b\n"
+              "map_Kd -s 1 1 1 b.jpg\n"
+              "newmtl c\n"
+              "Kd 1 0 0\n");
+    dir.write("tile/textures/a.jpg", "a");
+    dir.write("tile/b.jpg", "b");
+    dir.write("tile/model.obj",
+              "# test model\n"
+              "mtllib model.mtl\n"
+              "v 0 0 0\n"
+              "v 1 0 0\n"
+              "v 1 1 0\n"
+              "v 0 1 0\n"
+              "v 5 5 5\n"
+              "vt 0 0\n"
+              "vt 1 0\n"
+              "vt 1 1\n"
+              "vt 0.5\n"
+              "vn 0 0 1\n"
+              + faces);
+}
+
+/** ASCII PLY with textures a and b, two faces with per-corner texture
+ *  coordinates, with given face lines.
+ */
+void asciiPly(const TmpDir &dir, const std::string &faces
+              , const std::string &header = std::string())
+{
+    dir.write("a.png", "a");
+    dir.write("b.png", "b");
+    dir.write("model.ply",
+              "ply\n"
+              "format ascii 1.0\n"
+              "comment TextureFile a.png\n"
+              "comment TextureFile b.png\n"
+              + header +
+              "element vertex 4\n"
+              "property float x\n"
+              "property float y\n"
+              "property float z\n"
+              "property uchar red\n"
+              "element face 2\n"
+              "property list uchar int vertex_indices\n"
+              "property list uchar float texcoord\n"
+              "property int texnumber\n"
+              "end_header\n"
+              "0 0 0 1\n"
+              "1 0 0 1\n"
+              "1 1 0 1\n"
+              "0 1 0 1\n"
+              + faces);
+}
+
+template <typename T>
+void append(std::string &data, T value)
+{
+    char raw[sizeof(T)];
+    std::memcpy(raw, &value, sizeof(T));
+    data.append(raw, sizeof(T));
+}
+
+/** Binary PLY, single triangle with per-vertex texture coordinates.
+ */
+std::string binaryPly()
+{
+    std::string data("ply\n"
+                     "format binary_little_endian 1.0\n"
+                     "comment TextureFile texture.jpg\n"
+                     "element vertex 3\n"
+                     "property double x\n"
+                     "property double y\n"
+                     "property double z\n"
+                     "property float s\n"
+                     "property float t\n"
+                     "element face 1\n"
+                     "property list uchar uint vertex_indices\n"
+                     "end_header\n");
+
+    const float vertices[3][5] = {
+        { 0, 0, 0, 0.0f, 0.0f }, { 2, 0, 0, 1.0f, 0.0f }
+        , { 0, 2, 0, 0.0f, 1.0f }
+    };
+    for (const auto &v : vertices) {
+        for (int i(0); i < 3; ++i) { append<double>(data, v[i]); }
+        append<float>(data, v[3]);
+        append<float>(data, v[4]);
+    }
+
+    append<std::uint8_t>(data, 3);
+    for (std::uint32_t i(0); i < 3; ++i) { append(data, i); }
+    return data;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(formats)
+{
+    BOOST_CHECK(vtstools::nativeModelFormat("a/b.obj"));
+    BOOST_CHECK(vtstools::nativeModelFormat("a/b.PLY"));
+    BOOST_CHECK(!vtstools::nativeModelFormat("a/b.fbx"));
+    BOOST_CHECK(!vtstools::nativeModelFormat("obj"));
+
+    TmpDir dir;
+    dir.write("model.fbx", "");
+    BOOST_CHECK(tryLoad(dir, "model.fbx") == Result::unsupported);
+}
+
+BOOST_AUTO_TEST_CASE(objMaterials)
+{
+    TmpDir dir;
+    obj(dir, "usemtl a\n"
+        "f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+        "usemtl b\n"
+        "f -1/-1 -4/-3 -3/-2\n");
+
+    const auto model(load(dir, "tile/model.obj", math::Point3(10, 20, 30)));
+    BOOST_REQUIRE_EQUAL(model.mesh.submeshes.size(), 2u);
+    BOOST_REQUIRE_EQUAL(model.textures.size(), 2u);
+    BOOST_CHECK_EQUAL(model.textures[0]->path().filename(), "a.jpg");
+    BOOST_CHECK_EQUAL(model.textures[0]->path().parent_path().filename()
+                      , "textures");
+    BOOST_CHECK_EQUAL(model.textures[1]->path().filename(), "b.jpg");
+
+    // quad as triangle fan, shifted by origin
+    const auto &a(model.mesh.submeshes[0]);
+    BOOST_REQUIRE_EQUAL(a.vertices.size(), 4u);
+    BOOST_REQUIRE_EQUAL(a.tc.size(), 4u);
+    BOOST_REQUIRE_EQUAL(a.faces.size(), 2u);
+    BOOST_REQUIRE_EQUAL(a.facesTc.size(), 2u);
+    checkPoint(a.vertices[1], 11, 20, 30);
+    checkPoint(a.vertices[3], 10, 21, 30);
+    checkTc(a.tc[2], 1, 1);
+    checkFace(a.faces[0], 0, 1, 2);
+    checkFace(a.faces[1], 0, 2, 3);
+    checkFace(a.facesTc[1], 0, 2, 3);
+
+    // relative indices, only used vertices, single-component vt
+    const auto &b(model.mesh.submeshes[1]);
+    BOOST_REQUIRE_EQUAL(b.vertices.size(), 3u);
+    BOOST_REQUIRE_EQUAL(b.tc.size(), 3u);
+    BOOST_REQUIRE_EQUAL(b.faces.size(), 1u);
+    checkPoint(b.vertices[0], 15, 25, 35);
+    checkPoint(b.vertices[1], 11, 20, 30);
+    checkTc(b.tc[0], 0.5, 0);
+    checkTc(b.tc[1], 1, 0);
+    checkFace(b.faces[0], 0, 1, 2);
+    checkFace(b.facesTc[0], 0, 1, 2);
+}
+
+BOOST_AUTO_TEST_CASE(objUnsupported)
+{
+    TmpDir dir;
+
+    obj(dir, "usemtl a\nf 1//1 2//1 3//1\n");
+    BOOST_CHECK(tryLoad(dir, "tile/model.obj") == Result::unsupported);
+
+    obj(dir, "usemtl c\nf 1/1 2/2 3/3\n");
+    BOOST_CHECK(tryLoad(dir, "tile/model.obj") == Result::unsupported);
+
+    obj(dir, "f 1/1 2/2 3/3\n");
+    BOOST_CHECK(tryLoad(dir, "tile/model.obj") == Result::unsupported);
+
+    obj(dir, "usemtl a\n");
+    BOOST_CHECK(tryLoad(dir, "tile/model.obj") == Result::unsupported);
+}
+
+BOOST_AUTO_TEST_CASE(objMalformed)
+{
+    TmpDir dir;
+
+    for (const auto *faces : {
+            "usemtl a\nf 1/1 2/2 9/3\n"
+            , "usemtl a\nf 1/1 2/2 3/9\n"
+            , "usemtl a\nf 0/1 2/2 3/3\n"
+            , "usemtl a\nf 1/1 2/2 -9/3\n"
+            , "usemtl a\nf 1/1 2/2\n"
+            , "usemtl a\nf 1/x 2/2 3/3\n"
+            , "v 1 x 2\n"
+            , "v 1 2\n"
+            , "vt \n" })
+    {
+        obj(dir, faces);
+        BOOST_CHECK_MESSAGE(tryLoad(dir, "tile/model.obj")
+                            == Result::malformed, faces);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(plyAscii)
+{
+    TmpDir dir;
+    asciiPly(dir, "3 0 1 2 6 0 0 1 0 1 1 0\n"
+             "4 0 1 2 3 8 0 0 1 0 1 1 0 1 1\n");
+
+    const auto model(load(dir, "model.ply"));
+    BOOST_REQUIRE_EQUAL(model.mesh.submeshes.size(), 2u);
+    BOOST_REQUIRE_EQUAL(model.textures.size(), 2u);
+    BOOST_CHECK_EQUAL(model.textures[0]->path().filename(), "a.png");
+    BOOST_CHECK_EQUAL(model.textures[1]->path().filename(), "b.png");
+
+    const auto &a(model.mesh.submeshes[0]);
+    BOOST_REQUIRE_EQUAL(a.vertices.size(), 3u);
+    BOOST_REQUIRE_EQUAL(a.tc.size(), 3u);
+    BOOST_REQUIRE_EQUAL(a.faces.size(), 1u);
+    checkPoint(a.vertices[2], 1, 1, 0);
+    checkTc(a.tc[1], 1, 0);
+
+    const auto &b(model.mesh.submeshes[1]);
+    BOOST_REQUIRE_EQUAL(b.vertices.size(), 4u);
+    BOOST_REQUIRE_EQUAL(b.tc.size(), 4u);
+    BOOST_REQUIRE_EQUAL(b.faces.size(), 2u);
+    checkFace(b.faces[1], 0, 2, 3);
+    checkFace(b.facesTc[1], 0, 2, 3);
+    checkTc(b.tc[3], 0, 1);
+}
+
+BOOST_AUTO_TEST_CASE(plyBinary)
+{
+    TmpDir dir;
+    dir.write("texture.jpg", "t");
+    dir.write("model.ply", binaryPly());
+
+    const auto model(load(dir, "model.ply", math::Point3(1, 1, 1)));
+    BOOST_REQUIRE_EQUAL(model.mesh.submeshes.size(), 1u);
+    BOOST_REQUIRE_EQUAL(model.textures.size(), 1u);
+
+    const auto &sm(model.mesh.submeshes[0]);
+    BOOST_REQUIRE_EQUAL(sm.vertices.size(), 3u);
+    BOOST_REQUIRE_EQUAL(sm.tc.size(), 3u);
+    BOOST_REQUIRE_EQUAL(sm.faces.size(), 1u);
+    checkPoint(sm.vertices[1], 3, 1, 1);
+    checkTc(sm.tc[2], 0, 1);
+    checkFace(sm.faces[0], 0, 1, 2);
+    checkFace(sm.facesTc[0], 0, 1, 2);
+
+    // truncated body
+    auto data(binaryPly());
+    data.resize(data.size() - 2);
+    dir.write("model.ply", data);
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::malformed);
+}
+
+BOOST_AUTO_TEST_CASE(plyUnsupported)
+{
+    TmpDir dir;
+
+    auto data(binaryPly());
+    data.replace(data.find("little"), 6, "big");
+    dir.write("model.ply", data);
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::unsupported);
+
+    data = binaryPly();
+    data.replace(data.find("comment TextureFile"), 7, "comment");
+    data.replace(data.find("TextureFile"), 11, "Texture");
+    dir.write("model.ply", data);
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::unsupported);
+
+    // neither per-corner nor per-vertex texture coordinates
+    asciiPly(dir, "3 0 1 2 0 0\n"
+             "3 0 2 3 0 1\n");
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::unsupported);
+}
+
+BOOST_AUTO_TEST_CASE(plyMalformed)
+{
+    TmpDir dir;
+
+    // invalid counts and indices
+    for (const auto *faces : {
+            "-1 0 1 2 6 0 0 1 0 1 1 0\n"
+            , "3 0 1.5 2 6 0 0 1 0 1 1 0\n"
+            , "3 0 1 9 6 0 0 1 0 1 1 0\n"
+            , "3 0 1 2 6 0 0 1 0 1 1 2\n"
+            , "2 0 1 4 0 0 1 0 0\n"
+            , "3 0 1 2 6 0 0 1 0 1 1 0\n" })
+    {
+        asciiPly(dir, faces);
+        BOOST_CHECK_MESSAGE(tryLoad(dir, "model.ply") == Result::malformed
+                            , faces);
+    }
+
+    asciiPly(dir, "", "property float orphan\n");
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::malformed);
+
+    asciiPly(dir, "", "element extra 1\nproperty half value\n");
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::malformed);
+
+    dir.write("model.ply", "ply\nformat ascii 1.0\n");
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::malformed);
+
+    dir.write("model.ply", "solid model\n");
+    BOOST_CHECK(tryLoad(dir, "model.ply") == Result::malformed);
+}
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE tdtimplicit
+
+#include <vector>
+#include <cstdint>
+
+#include <boost/test/unit_test.hpp>
+
+#include "../tdtimplicit.hpp"
+
+namespace {
+
+typedef std::vector<std::uint8_t> Bits;
+
+/** Bitstream with given bits set.
+ */
+Bits bitstream(std::initializer_list<int> set)
+{
+    Bits bits;
+    for (const auto bit : set) {
+        if (std::size_t(bit / 8) >= bits.size()) { bits.resize(bit / 8 + 1); }
+        bits[bit / 8] |= 1 << (bit % 8);
+    }
+    return bits;
+}
+
+vtstools::TdtAvailability available(const Bits &bits)
+{
+    vtstools::TdtAvailability a;
+    a.bits = bits.data();
+    a.size = bits.size();
+    return a;
+}
+
+vtstools::TdtAvailability constant(bool value)
+{
+    vtstools::TdtAvailability a;
+    a.constant = value;
+    return a;
+}
+
+vtstools::TdtImplicitTiling quadtree(int subtreeLevels, int availableLevels)
+{
+    return { 2, subtreeLevels, availableLevels };
+}
+
+struct Expanded {
+    vtstools::TdtImplicitTile::list tiles;
+    vtstools::TdtImplicitTile::list subtrees;
+};
+
+Expanded expand(const vtstools::TdtImplicitTiling &tiling
+                , const vtstools::TdtSubtreeAvailability &availability
+                , int level = 0, std::uint64_t x = 0, std::uint64_t y = 0)
+{
+    const std::uint64_t coords[3] = { x, y, 0 };
+    Expanded e;
+    vtstools::expandTdtSubtree(tiling, availability, level, coords, e.tiles
+                               , e.subtrees);
+    return e;
+}
+
+void checkTile(const vtstools::TdtImplicitTile &tile, int level
+               , std::uint64_t x, std::uint64_t y, bool leaf)
+{
+    BOOST_CHECK_EQUAL(tile.level, level);
+    BOOST_CHECK_EQUAL(tile.coords[0], x);
+    BOOST_CHECK_EQUAL(tile.coords[1], y);
+    BOOST_CHECK_EQUAL(tile.leaf, leaf);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(demorton)
+{
+    std::uint64_t c[3];
+    vtstools::tdtDemorton(5, 2, c);
+    BOOST_CHECK_EQUAL(c[0], 3u);
+    BOOST_CHECK_EQUAL(c[1], 0u);
+
+    vtstools::tdtDemorton(7, 3, c);
+    BOOST_CHECK_EQUAL(c[0], 1u);
+    BOOST_CHECK_EQUAL(c[1], 1u);
+    BOOST_CHECK_EQUAL(c[2], 1u);
+
+    vtstools::tdtDemorton(8, 3, c);
+    BOOST_CHECK_EQUAL(c[0], 2u);
+    BOOST_CHECK_EQUAL(c[1], 0u);
+    BOOST_CHECK_EQUAL(c[2], 0u);
+}
+
+BOOST_AUTO_TEST_CASE(fullSubtree)
+{
+    // everything available, subtree covers all levels
+    vtstools::TdtSubtreeAvailability a;
+    a.tile = a.content = a.child = constant(true);
+
+    const auto e(expand(quadtree(2, 2), a));
+    BOOST_REQUIRE_EQUAL(e.tiles.size(), 5u);
+    BOOST_CHECK(e.subtrees.empty());
+
+    checkTile(e.tiles[0], 0, 0, 0, false);
+    checkTile(e.tiles[1], 1, 0, 0, true);
+    checkTile(e.tiles[2], 1, 1, 0, true);
+    checkTile(e.tiles[3], 1, 0, 1, true);
+    checkTile(e.tiles[4], 1, 1, 1, true);
+}
+
+BOOST_AUTO_TEST_CASE(sparseSubtree)
+{
+    // 3-level subtree of 6 available levels: root -> (1, 0) -> (3, 0) ->
+    // child subtree (7, 0); content at root and (3, 0) only
+    const auto tiles(bitstream({ 0, 1 + 1, 5 + 5 }));
+    const auto content(bitstream({ 0, 5 + 5 }));
+    const auto children(bitstream({ 21 }));
+
+    vtstools::TdtSubtreeAvailability a;
+    a.tile = available(tiles);
+    a.content = available(content);
+    a.child = available(children);
+
+    const auto e(expand(quadtree(3, 6), a));
+    BOOST_REQUIRE_EQUAL(e.tiles.size(), 2u);
+    checkTile(e.tiles[0], 0, 0, 0, false);
+    checkTile(e.tiles[1], 2, 3, 0, false);
+
+    BOOST_REQUIRE_EQUAL(e.subtrees.size(), 1u);
+    BOOST_CHECK_EQUAL(e.subtrees[0].level, 3);
+    BOOST_CHECK_EQUAL(e.subtrees[0].coords[0], 7u);
+    BOOST_CHECK_EQUAL(e.subtrees[0].coords[1], 0u);
+
+    // the same availability in that child subtree: global coordinates, no
+    // subtrees past available levels
+    const auto child(expand(quadtree(3, 6), a, 3, 7, 0));
+    BOOST_REQUIRE_EQUAL(child.tiles.size(), 2u);
+    checkTile(child.tiles[0], 3, 7, 0, false);
+    checkTile(child.tiles[1], 5, 31, 0, true);
+    BOOST_CHECK(child.subtrees.empty());
+}
+
+BOOST_AUTO_TEST_CASE(truncatedLevels)
+{
+    // subtree reaching past available levels is cut, no child subtrees
+    vtstools::TdtSubtreeAvailability a;
+    a.tile = a.content = a.child = constant(true);
+
+    const auto e(expand(quadtree(3, 4), a, 3, 1, 1));
+    BOOST_REQUIRE_EQUAL(e.tiles.size(), 1u);
+    checkTile(e.tiles[0], 3, 1, 1, true);
+    BOOST_CHECK(e.subtrees.empty());
+}
+
+BOOST_AUTO_TEST_CASE(unavailable)
+{
+    // nothing below unavailable tiles is visited: deep octree subtree with
+    // only its root available is expanded immediately
+    const auto root(bitstream({ 0 }));
+
+    vtstools::TdtSubtreeAvailability a;
+    a.tile = available(root);
+    a.content = constant(true);
+    a.child = constant(true);
+
+    const auto e(expand({ 3, 20, 40 }, a));
+    BOOST_REQUIRE_EQUAL(e.tiles.size(), 1u);
+    BOOST_CHECK(e.tiles[0].leaf);
+    BOOST_CHECK(e.subtrees.empty());
+
+    // unavailable root
+    a.tile = constant(false);
+    const auto none(expand(quadtree(2, 2), a));
+    BOOST_CHECK(none.tiles.empty());
+    BOOST_CHECK(none.subtrees.empty());
+}
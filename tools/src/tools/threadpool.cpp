@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <exception>
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "threadpool.hpp"
+#include "numa.hpp"
+#include "metrics.hpp"
+
+namespace po = boost::program_options;
+
+namespace vtstools {
+
+namespace {
+
+ThreadPoolConfig poolConfig;
+
+/** NUMA nodes restricted to CPUs available to this process.
+ */
+NumaNode::list availableNodes()
+{
+    const auto cpus(availableCpus());
+
+    NumaNode::list nodes;
+    for (auto node : numaTopology()) {
+        auto &nc(node.cpus);
+        nc.erase(std::remove_if(nc.begin(), nc.end(), [&](int cpu) {
+                    return !std::binary_search(cpus.begin(), cpus.end()
+                                               , cpu);
+                }), nc.end());
+        if (!nc.empty()) { nodes.push_back(node); }
+    }
+    return nodes;
+}
+
+/** Prefer allocation of memory on given node for calling thread. Falls back
+ *  to other nodes when the node is full.
+ */
+void preferNode(int node)
+{
+    const int MpolPreferred(1); // MPOL_PREFERRED from linux/mempolicy.h
+    const std::size_t bits(8 * sizeof(unsigned long));
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] |= 1ul << (node % bits);
+
+    if (::syscall(SYS_set_mempolicy, MpolPreferred, mask.data()
+                  , mask.size() * bits + 1))
+    {
+        LOG(warn1) << "Unable to bind memory to NUMA node " << node << ".";
+    }
+}
+
+/** Node memory allocation statistics (/sys/.../numastat). These are
+ *  system-wide counters, not counters of this process.
+ */
+typedef std::map<std::string, long long> NumaStat;
+
+NumaStat numaStat(int node)
+{
+    NumaStat stat;
+    std::ifstream f("/sys/devices/system/node/node"
+                    + boost::lexical_cast<std::string>(node)
+                    + "/numastat");
+    std::string key;
+    long long value;
+    while (f >> key >> value) { stat[key] = value; }
+    return stat;
+}
+
+/** Work submitted to the pool by one parallelFor call.
+ */
+class Task {
+public:
+    virtual ~Task() {}
+
+    /** Processes one work item in given pool thread. Returns false when
+     *  there is no item left, i.e. nothing has been processed. Must not
+     *  throw.
+     */
+    virtual bool step(std::size_t thread) = 0;
+};
+
+/** Persistent worker threads, created on first use. In NUMA mode each
+ *  thread is pinned to its home node (threads are assigned to nodes
+ *  round-robin).
+ *
+ *  Several tasks (from different submitting threads) run at once: idle
+ *  threads take items from active tasks round-robin, one item at a time,
+ *  therefore concurrent tasks share the pool. Submitting thread waits for
+ *  its task's completion.
+ */
+class Pool {
+public:
+    Pool();
+
+    /** Processes all items of given task and waits until they are done.
+     */
+    void run(Task &task);
+
+    std::size_t size() const { return threads_.size(); }
+
+    const NumaNode::list& nodes() const { return nodes_; }
+
+    bool numa() const { return numa_; }
+
+    /** True in pool threads.
+     */
+    static bool inPool() { return inPool_; }
+
+    /** Pool instance; never destroyed (threads are left to the process
+     *  exit).
+     */
+    static Pool& instance();
+
+private:
+    struct Active {
+        Task *task;
+
+        /** Number of threads processing task's item right now.
+         */
+        std::size_t running;
+
+        /** No item left, no other thread starts processing.
+         */
+        bool exhausted;
+
+        Active(Task *task) : task(task), running(), exhausted(false) {}
+    };
+
+    void worker(std::size_t index);
+
+    /** Picks next task with items left; called under lock.
+     */
+    Active* pick();
+
+    NumaNode::list nodes_;
+    bool numa_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    std::vector<Active*> active_;
+    std::size_t next_;
+
+    static thread_local bool inPool_;
+};
+
+thread_local bool Pool::inPool_(false);
+
+Pool::Pool()
+    : numa_(false), next_()
+{
+    if (poolConfig.numa) { nodes_ = availableNodes(); }
+    numa_ = (nodes_.size() > 1);
+    if (!numa_) { nodes_.assign(1, NumaNode()); }
+
+    const auto count(threadCount());
+    threads_.reserve(count);
+    for (std::size_t t(0); t < count; ++t) {
+        threads_.emplace_back(&Pool::worker, this, t);
+    }
+}
+
+Pool& Pool::instance()
+{
+    static Pool *pool(new Pool());
+    return *pool;
+}
+
+Pool::Active* Pool::pick()
+{
+    for (std::size_t i(0), e(active_.size()); i != e; ++i) {
+        auto *active(active_[next_++ % e]);
+        if (!active->exhausted) { return active; }
+    }
+    return nullptr;
+}
+
+void Pool::worker(std::size_t index)
+{
+    inPool_ = true;
+
+    // reported in metrics even when it gets no work
+    if (auto *m = metrics()) { m->thread().pool = true; }
+
+    if (numa_) {
+        const auto &node(nodes_[index % nodes_.size()]);
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto cpu : node.cpus) { CPU_SET(cpu, &set); }
+        ::sched_setaffinity(0, sizeof(set), &set);
+        preferNode(node.id);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Active *active(nullptr);
+        start_.wait(lock, [&]() { return (active = pick()); });
+
+        ++active->running;
+        lock.unlock();
+        const bool processed(active->task->step(index));
+        lock.lock();
+        --active->running;
+
+        if (!processed) { active->exhausted = true; }
+        if (active->exhausted && !active->running) { done_.notify_all(); }
+    }
+}
+
+void Pool::run(Task &task)
+{
+    Active active(&task);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    active_.push_back(&active);
+    start_.notify_all();
+
+    done_.wait(lock, [&]() { return active.exhausted && !active.running; });
+    active_.erase(std::find(active_.begin(), active_.end(), &active));
+}
+
+/** Work queue of one node.
+ */
+struct Queue {
+    std::vector<std::size_t> items;
+    std::atomic<std::size_t> next;
+    std::atomic<std::size_t> processed;
+    std::atomic<std::size_t> stolen;
+
+    Queue() : next(0), processed(0), stolen(0) {}
+};
+
+/** parallelFor task: hands out items from node queues, home node of
+ *  calling thread first. First exception stops processing.
+ */
+class ForTask : public Task {
+public:
+    ForTask(std::vector<Queue> &queues
+            , const std::function<void(std::size_t)> &fn)
+        : queues_(queues), fn_(fn), failed_(false)
+    {}
+
+    virtual bool step(std::size_t thread) {
+        const auto home(thread % queues_.size());
+        for (std::size_t offset(0); offset < queues_.size(); ++offset) {
+            auto &queue(queues_[(home + offset) % queues_.size()]);
+            if (failed_) { return false; }
+
+            const auto i(queue.next++);
+            if (i >= queue.items.size()) { continue; }
+
+            try {
+                fn_(queue.items[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_) { error_ = std::current_exception(); }
+                failed_ = true;
+            }
+            ++queue.processed;
+            if (offset) { ++queue.stolen; }
+            return true;
+        }
+        return false;
+    }
+
+    std::exception_ptr error() const { return error_; }
+
+private:
+    std::vector<Queue> &queues_;
+    const std::function<void(std::size_t)> &fn_;
+    std::atomic<bool> failed_;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+} // namespace
+
+std::vector<std::size_t> costOrder(const std::vector<double> &costs)
+{
+    // cost class, i.e. binary order of magnitude
+    std::vector<int> classes;
+    classes.reserve(costs.size());
+    for (const auto cost : costs) {
+        classes.push_back((cost > 0.0) ? std::ilogb(cost)
+                          : std::numeric_limits<int>::min());
+    }
+
+    std::vector<std::size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(order.begin(), order.end()
+                     , [&](std::size_t l, std::size_t r)
+                     {
+                         return classes[l] > classes[r];
+                     });
+    return order;
+}
+
+std::vector<int> availableCpus()
+{
+    std::vector<int> cpus;
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    if (!::sched_getaffinity(0, sizeof(set), &set)) {
+        for (int cpu(0); cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) { cpus.push_back(cpu); }
+        }
+    }
+
+    if (cpus.empty()) {
+        const int count(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu(0); cpu < count; ++cpu) { cpus.push_back(cpu); }
+    }
+    return cpus;
+}
+
+unsigned int threadCount()
+{
+    if (poolConfig.threads) { return poolConfig.threads; }
+
+    if (const char *omp = std::getenv("OMP_NUM_THREADS")) {
+        try {
+            const auto threads(boost::lexical_cast<unsigned int>(omp));
+            if (threads) { return threads; }
+        } catch (const boost::bad_lexical_cast&) {}
+    }
+
+    return availableCpus().size();
+}
+
+void parallelFor(std::size_t count
+                 , const std::function<void(std::size_t)> &fn)
+{
+    if (!count) { return; }
+
+    // nested call: already running in a pool thread
+    if (Pool::inPool()) {
+        for (std::size_t i(0); i < count; ++i) { fn(i); }
+        return;
+    }
+
+    auto &pool(Pool::instance());
+    const auto &nodes(pool.nodes());
+    const bool numa(pool.numa());
+
+    // distribute items to node queues (round-robin keeps the order)
+    std::vector<Queue> queues(nodes.size());
+    for (std::size_t i(0); i < count; ++i) {
+        queues[i % queues.size()].items.push_back(i);
+    }
+
+    std::vector<NumaStat> before;
+    if (numa) {
+        for (const auto &node : nodes) { before.push_back(numaStat(node.id)); }
+    }
+
+    ForTask task(queues, fn);
+    pool.run(task);
+
+    const auto error(task.error());
+    if (error) { std::rethrow_exception(error); }
+
+    if (!numa) { return; }
+
+    // report work and memory allocation distribution
+    for (std::size_t n(0); n < nodes.size(); ++n) {
+        const auto after(numaStat(nodes[n].id));
+        const auto delta([&](const std::string &key) -> long long {
+                auto fa(after.find(key));
+                auto fb(before[n].find(key));
+                if ((fa == after.end()) || (fb == before[n].end())) {
+                    return 0;
+                }
+                return fa->second - fb->second;
+            });
+
+        LOG(info3)
+            << "NUMA node " << nodes[n].id << ": "
+            << queues[n].items.size() << " items queued, "
+            << queues[n].stolen << " of them processed by other nodes; "
+            << "system-wide numastat during this run (all processes): "
+            << "local_node " << delta("local_node")
+            << ", other_node " << delta("other_node")
+            << ", numa_miss " << delta("numa_miss") << ".";
+    }
+}
+
+void threadPoolConfiguration(po::options_description &config)
+{
+    config.add_options()
+        ("threads", po::value(&poolConfig.threads)
+         ->default_value(poolConfig.threads)
+         , "Number of processing threads. 0 means OMP_NUM_THREADS if set "
+         "or number of available CPUs.")
+        ("numa", po::value(&poolConfig.numa)
+         ->default_value(poolConfig.numa)->implicit_value(true)
+         , "Pin processing threads to NUMA nodes and allocate their memory "
+         "locally. Reports per-node work distribution and system-wide "
+         "(i.e. all processes) node allocation counters.")
+        ;
+}
+
+void configureThreadPool(const po::variables_map &vars)
+{
+    (void) vars;
+    LOG(info2) << "Using " << threadCount() << " processing thread(s)"
+               << (poolConfig.numa ? " pinned to NUMA nodes" : "") << ".";
+}
+
+} // namespace vtstools
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_threadpool_hpp_included_
+#define vts_tools_threadpool_hpp_included_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+/** Converter thread pool.
+ *
+ *  Independent of OpenMP (i.e. threaded in all build types). Pool threads
+ *  are created on first use and live until the process exits. In NUMA mode
+ *  worker threads are pinned to NUMA nodes and their memory allocation is
+ *  bound to the local node so data decoded by a thread are processed by the
+ *  same node. Work items are distributed to per-node queues; idle nodes steal
+ *  from others.
+ */
+namespace vtstools {
+
+struct ThreadPoolConfig {
+    /** Number of threads; 0 means OMP_NUM_THREADS if set or number of CPUs
+     *  available to this process.
+     */
+    unsigned int threads;
+
+    /** Pin threads to NUMA nodes.
+     */
+    bool numa;
+
+    ThreadPoolConfig() : threads(), numa(false) {}
+};
+
+/** Calls fn(index) for all index in [0, count) from pool threads. Items are
+ *  handed out in order, i.e. put most expensive items first. First exception
+ *  thrown by fn stops processing and is rethrown.
+ *
+ *  Calls from different threads run concurrently and share pool threads
+ *  item by item; nested calls (from fn) run serially in the calling pool
+ *  thread.
+ */
+void parallelFor(std::size_t count
+                 , const std::function<void(std::size_t)> &fn);
+
+/** Order in which parallelFor should process items of given estimated costs:
+ *  most expensive first to avoid a long single-thread tail. Costs within a
+ *  factor of two are considered equal and such items keep their input order;
+ *  inputs are traversed in spatial order, therefore neighbouring items (i.e.
+ *  sharing output tiles and archive pages) are processed at the same time.
+ */
+std::vector<std::size_t> costOrder(const std::vector<double> &costs);
+
+/** Number of threads parallelFor uses.
+ */
+unsigned int threadCount();
+
+/** CPUs this process is allowed to run on (affinity mask, i.e. honours
+ *  cpusets and taskset).
+ */
+std::vector<int> availableCpus();
+
+/** Registers --threads and --numa options.
+ */
+void threadPoolConfiguration(boost::program_options::options_description
+                             &config);
+
+void configureThreadPool(const boost::program_options::variables_map &vars);
+
+} // namespace vtstools
+
+#endif // vts_tools_threadpool_hpp_included_
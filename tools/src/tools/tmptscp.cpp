@@ -78,6 +78,8 @@
 #include "vts-libs/tools-support/tmptileset.hpp"
 #include "vts-libs/tools-support/repackatlas.hpp"
 
+#include "tmptsmerge.hpp"
+#include "threadpool.hpp"
 
 namespace po = boost::program_options;
 namespace bio = boost::iostreams;
@@ -96,6 +98,7 @@ class TmpTsCherryPick : public service::Cmdline
 public:
     TmpTsCherryPick()
         : service::Cmdline("tmptscp", BUILD_TARGET_VERSION)
+        , append_(false)
     {
     }
 
@@ -113,9 +116,10 @@ private:
 
     virtual int run() UTILITY_OVERRIDE;
 
-    fs::path input_;
+    std::vector<fs::path> input_;
     fs::path output_;
-    std::vector<vts::TileId> tileIds_;
+    bool append_;
+    vtstools::TileSelection selection_;
 };
 
 void TmpTsCherryPick::configuration(po::options_description &cmdline
@@ -126,13 +130,27 @@ void TmpTsCherryPick::configuration(po::options_description &cmdline
 
     cmdline.add_options()
         ("input", po::value(&input_)->required()
-         , "Path to input tmp tileset.")
+         , "Path to input tmp tileset. Can be used multiple times to merge "
+         "several tmp tilesets into one.")
         ("output", po::value(&output_)->required()
          , "Path to output tmp tileset.")
-        ("tileId", po::value(&tileIds_)->required()
-         , "One (or more) tiles to cherry pick from input tmp tileset.")
+        ("tileId", po::value(&selection_.tileIds)
+         , "One (or more) tiles to cherry pick from input tmp tileset(s).")
+        ("tileRange", po::value(&selection_.ranges)
+         , "One (or more) tile ranges in form lod/llx,lly:urx,ury to cherry "
+         "pick from input tmp tileset(s); tiles in range and below are "
+         "copied.")
+        ("tileIndex", po::value<fs::path>()
+         , "Path to tile index; tiles present in this index are copied from "
+         "input tmp tileset(s).")
+        ("append", po::value(&append_)
+         ->default_value(false)->implicit_value(true)
+         , "Add tiles to existing output tmp tileset instead of "
+         "creating new one.")
         ;
 
+    vtstools::threadPoolConfiguration(cmdline);
+
     pd
         .add("input", 1)
         .add("output", 1);
@@ -142,7 +160,16 @@ void TmpTsCherryPick::configuration(po::options_description &cmdline
 
 void TmpTsCherryPick::configure(const po::variables_map &vars)
 {
-    (void) vars;
+    vtstools::configureThreadPool(vars);
+
+    if (vars.count("tileIndex")) {
+        selection_.index = boost::in_place();
+        selection_.index->load(vars["tileIndex"].as<fs::path>());
+    }
+
+    if (selection_.empty()) {
+        LOG(info3) << "No selection given, copying all tiles.";
+    }
 }
 
 bool TmpTsCherryPick::help(std::ostream &out, const std::string &what) const
@@ -150,7 +177,11 @@ bool TmpTsCherryPick::help(std::ostream &out, const std::string &what) const
     if (what.empty()) {
         out << R"RAW(tmptscp
 usage
-    tmptscp INPUT OUTPUT
+    tmptscp INPUT OUTPUT [--input INPUT]* [OPTIONS]
+
+Copies (selected) tiles from one or more temporary tilesets into one. Tiles
+are copied in parallel but not raw: every tile's mesh and atlas is decoded
+and encoded again.
 
 )RAW";
     }
@@ -159,22 +190,18 @@ usage
 
 int TmpTsCherryPick::run()
 {
-    // open source and destination, keep them both
-    tools::TmpTileset src(input_, false);
-    src.keep(true);
-    tools::TmpTileset dst(output_);
+    // open destination, keep it
+    tools::TmpTileset dst(output_, !append_);
     dst.keep(true);
 
-    utility::copy_file(input_ / "navtile.info"
-                       , output_ / "navtile.info", true);
-
-    for (const auto &tileId : tileIds_) {
-        const auto tile(src.load(tileId, 0));
-        dst.store(tileId, *std::get<0>(tile), *std::get<1>(tile));
-    }
+    const auto stats(vtstools::mergeTmpTilesets
+                     (input_, output_, dst, selection_));
 
     dst.flush();
 
+    LOG(info3) << "Copied " << stats.tiles << " tiles from "
+               << stats.sources << " tmp tileset(s).";
+
     // all done
     LOG(info4) << "All done.";
     return EXIT_SUCCESS;
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <memory>
+#include <atomic>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "utility/filesystem.hpp"
+
+#include "tmptsmerge.hpp"
+#include "threadpool.hpp"
+
+namespace fs = boost::filesystem;
+
+namespace vtstools {
+
+namespace {
+
+bool inRange(const vts::LodTileRange &range, const vts::TileId &tileId)
+{
+    if (tileId.lod < range.lod) { return false; }
+
+    const auto diff(tileId.lod - range.lod);
+    const auto x(tileId.x >> diff);
+    const auto y(tileId.y >> diff);
+
+    const auto &r(range.range);
+    return ((x >= r.ll(0)) && (x <= r.ur(0))
+            && (y >= r.ll(1)) && (y <= r.ur(1)));
+}
+
+typedef vts::TileIndex::Flag TiFlag;
+
+/** Single tile copy job.
+ */
+struct Job {
+    std::size_t source;
+    vts::TileId tileId;
+    TiFlag::value_type flags;
+
+    Job(std::size_t source, const vts::TileId &tileId
+        , TiFlag::value_type flags)
+        : source(source), tileId(tileId), flags(flags)
+    {}
+};
+
+} // namespace
+
+bool TileSelection::operator()(const vts::TileId &tileId) const
+{
+    if (empty()) { return true; }
+
+    if (std::find(tileIds.begin(), tileIds.end(), tileId) != tileIds.end()) {
+        return true;
+    }
+
+    for (const auto &range : ranges) {
+        if (inRange(range, tileId)) { return true; }
+    }
+
+    return (index && index->get(tileId));
+}
+
+MergeStats mergeTmpTilesets(const std::vector<fs::path> &sources
+                            , const fs::path &dstPath
+                            , tools::TmpTileset &dst
+                            , const TileSelection &selection)
+{
+    MergeStats stats;
+
+    // open all sources, keep them
+    std::vector<std::unique_ptr<tools::TmpTileset>> srcs;
+    for (const auto &path : sources) {
+        srcs.emplace_back(new tools::TmpTileset(path, false));
+        srcs.back()->keep(true);
+    }
+    stats.sources = srcs.size();
+
+    // collect selected tiles from all sources
+    std::vector<Job> jobs;
+    for (std::size_t i(0), e(srcs.size()); i != e; ++i) {
+        srcs[i]->tileIndex().forEach([&](const vts::TileId &tileId
+                                         , TiFlag::value_type flags)
+        {
+            if (!(flags & TiFlag::mesh) || !selection(tileId)) { return; }
+            jobs.emplace_back(i, tileId, flags);
+        });
+    }
+
+    LOG(info3) << "Copying " << jobs.size() << " tiles from "
+               << srcs.size() << " temporary tileset(s).";
+
+    std::atomic<std::size_t> done(0);
+
+    parallelFor(jobs.size(), [&](std::size_t i)
+    {
+        const auto &job(jobs[i]);
+
+        const auto tile(srcs[job.source]->load(job.tileId, 0));
+        dst.store(job.tileId, *std::get<0>(tile), *std::get<1>(tile)
+                  , job.flags & (TiFlag::watertight | TiFlag::alien));
+
+        const auto d(++done);
+        if (!(d % 1000)) {
+            LOG(info3) << "Copied " << d << "/" << jobs.size() << " tiles.";
+        }
+    });
+    stats.tiles = jobs.size();
+
+    // navtile info from first source that has one
+    for (const auto &path : sources) {
+        const auto ntInfo(path / "navtile.info");
+        if (fs::exists(ntInfo)) {
+            utility::copy_file(ntInfo, dstPath / "navtile.info", true);
+            break;
+        }
+    }
+
+    return stats;
+}
+
+} // namespace vtstools
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_tmptsmerge_hpp_included_
+#define vts_tools_tmptsmerge_hpp_included_
+
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "vts-libs/vts.hpp"
+#include "vts-libs/tools-support/tmptileset.hpp"
+
+/** Temporary tileset merging: copies (selected) tiles from several temporary
+ *  tilesets into one. Used by tmptscp and by the shard coordinator.
+ *
+ *  This is not a raw copy: TmpTileset has no fragment level access, so every
+ *  tile is loaded (mesh and atlas decoded) and stored (re-encoded) again.
+ *  Merge cost is therefore comparable to a (parallel) pass over the tileset
+ *  that touches every tile.
+ */
+namespace vtstools {
+
+namespace vts = vtslibs::vts;
+namespace tools = vtslibs::vts::tools;
+
+/** Tile selection. Empty selection selects all tiles.
+ */
+struct TileSelection {
+    /** Explicit list of tiles.
+     */
+    std::vector<vts::TileId> tileIds;
+
+    /** Tile ranges; tiles in range and below are selected.
+     */
+    std::vector<vts::LodTileRange> ranges;
+
+    /** Tile index; tiles present in index are selected.
+     */
+    boost::optional<vts::TileIndex> index;
+
+    bool empty() const {
+        return tileIds.empty() && ranges.empty() && !index;
+    }
+
+    bool operator()(const vts::TileId &tileId) const;
+};
+
+/** Merge statistics.
+ */
+struct MergeStats {
+    std::size_t tiles;
+    std::size_t sources;
+
+    MergeStats() : tiles(), sources() {}
+};
+
+/** Copies selected tiles from all sources to destination. Tiles present in
+ *  multiple sources end up as multiple fragments of the same tile (the same
+ *  way as when cut by one process). Navtile info is copied from the first
+ *  source that has one.
+ *
+ *  Tiles are decoded and re-encoded, in parallel.
+ */
+MergeStats mergeTmpTilesets(const std::vector<boost::filesystem::path> &sources
+                            , const boost::filesystem::path &dstPath
+                            , tools::TmpTileset &dst
+                            , const TileSelection &selection = TileSelection());
+
+} // namespace vtstools
+
+#endif // vts_tools_tmptsmerge_hpp_included_
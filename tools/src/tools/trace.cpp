@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <unistd.h>
+
+#include <fstream>
+#include <algorithm>
+#include <ostream>
+
+#include <boost/lexical_cast.hpp>
+
+#include "dbglog/dbglog.hpp"
+
+#include "trace.hpp"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+namespace vtstools {
+
+namespace detail { Tracer *tracer(nullptr); }
+
+namespace {
+
+/** Path given by --trace.
+ */
+boost::optional<fs::path> tracePath;
+
+/** Writes JSON string literal.
+ */
+void writeString(std::ostream &os, const char *s)
+{
+    os << '"';
+    for (; *s; ++s) {
+        const unsigned char c(*s);
+        switch (c) {
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        default:
+            if (c < 0x20) {
+                const char *hex("0123456789abcdef");
+                os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+} // namespace
+
+void Tracer::Buffer::push(const char *name, const std::string &detail
+                          , std::int64_t start, std::int64_t duration)
+{
+    if (events.size() < capacity) {
+        if (events.size() == events.capacity()) {
+            events.reserve(std::min(capacity, std::max<std::size_t>
+                                    (1024, 2 * events.size())));
+        }
+        events.emplace_back();
+    }
+
+    auto &event(events[next % events.size()]);
+    if (next >= events.size()) { ++dropped; }
+    ++next;
+
+    event.name = name;
+    event.detail = detail;
+    event.start = start;
+    event.duration = duration;
+}
+
+Tracer::Tracer(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1)), start_(Clock::now())
+{}
+
+Tracer::Buffer& Tracer::buffer()
+{
+    // hands the buffer back when the thread finishes
+    struct Cache {
+        Tracer *owner;
+        Buffer *buffer;
+
+        ~Cache() { if (owner) { owner->release(buffer); } }
+    };
+    thread_local Cache cache{ nullptr, nullptr };
+
+    if (cache.owner != this) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            buffers_.emplace_back(buffers_.size(), capacity_);
+            cache.buffer = &buffers_.back();
+        } else {
+            cache.buffer = free_.back();
+            free_.pop_back();
+        }
+        cache.owner = this;
+    }
+    return *cache.buffer;
+}
+
+void Tracer::release(Buffer *buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(buffer);
+}
+
+void Tracer::write(std::ostream &os) const
+{
+    const auto pid(::getpid());
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first(true);
+    const auto separator([&]() {
+            if (!first) { os << ",\n"; }
+            first = false;
+        });
+
+    std::size_t dropped(0);
+    for (const auto &buffer : buffers_) {
+        // thread name
+        separator();
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << buffer.index
+           << ",\"args\":{\"name\":\"thread " << buffer.index << "\"}}";
+
+        const auto size(std::min(buffer.next, buffer.events.size()));
+        const auto begin(buffer.next - size);
+        for (auto i(begin); i < buffer.next; ++i) {
+            const auto &event(buffer.events[i % buffer.events.size()]);
+            separator();
+            os << "{\"name\":";
+            writeString(os, event.name);
+            os << ",\"ph\":\"X\",\"pid\":" << pid
+               << ",\"tid\":" << buffer.index
+               << ",\"ts\":" << (event.start / 1000.0)
+               << ",\"dur\":" << (event.duration / 1000.0);
+            if (!event.detail.empty()) {
+                os << ",\"args\":{\"detail\":";
+                writeString(os, event.detail.c_str());
+                os << '}';
+            }
+            os << '}';
+        }
+        dropped += buffer.dropped;
+    }
+
+    os << "\n]}\n";
+
+    if (dropped) {
+        LOG(warn2) << "Trace buffers overflowed, " << dropped
+                   << " oldest spans dropped.";
+    }
+}
+
+void TraceSpan::begin(Tracer &tracer, const char *name
+                      , const std::string *detail)
+{
+    buffer_ = &tracer.buffer();
+    name_ = name;
+    if (detail) { detail_ = *detail; }
+    start_ = tracer.now();
+}
+
+void TraceSpan::end()
+{
+    // tracer cannot change while spans are open
+    const auto end(tracer()->now());
+    buffer_->push(name_, detail_, start_, end - start_);
+    buffer_ = nullptr;
+}
+
+void traceConfiguration(po::options_description &config)
+{
+    config.add_options()
+        ("trace", po::value<fs::path>()
+         , "Record spans of hot functions and write them as Chrome "
+         "trace-event JSON (chrome://tracing, Perfetto UI) into given file "
+         "when the run finishes.")
+        ("trace.bufferSize", po::value<std::size_t>()
+         ->default_value(1 << 18)
+         , "Maximum number of spans kept per thread; buffers grow on "
+         "demand, oldest spans are dropped when the limit is reached.")
+        ;
+}
+
+void configureTrace(const po::variables_map &vars)
+{
+    if (!vars.count("trace")) { return; }
+    tracePath = vars["trace"].as<fs::path>();
+    if (!detail::tracer) {
+        detail::tracer = new Tracer
+            (vars["trace.bufferSize"].as<std::size_t>());
+    }
+}
+
+void writeTrace(const boost::optional<unsigned int> &worker)
+{
+    if (!tracePath || !tracer()) { return; }
+
+    auto path(*tracePath);
+    if (worker) {
+        path += ".shard" + boost::lexical_cast<std::string>(*worker);
+    }
+
+    std::ofstream f(path.string());
+    tracer()->write(f);
+    f.close();
+
+    if (!f) {
+        LOG(err2) << "Unable to write trace into " << path << ".";
+        return;
+    }
+    LOG(info3) << "Trace written into " << path << ".";
+}
+
+} // namespace vtstools
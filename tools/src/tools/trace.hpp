@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2026 Melown Technologies SE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * *  Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef vts_tools_trace_hpp_included_
+#define vts_tools_trace_hpp_included_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/program_options.hpp>
+
+/** Span tracer producing Chrome trace-event JSON (loadable by
+ *  chrome://tracing and Perfetto UI).
+ *
+ *  Spans are recorded into per-thread ring buffers (oldest spans are
+ *  overwritten when full). Buffers grow on demand up to the configured
+ *  capacity and buffers of finished threads are reused by new ones. When
+ *  tracing is disabled every span costs a single pointer test.
+ */
+namespace vtstools {
+
+class Tracer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Event {
+        const char *name;
+        std::string detail;
+        std::int64_t start;
+        std::int64_t duration;
+    };
+
+    /** Per-thread ring buffer. Written only by owning thread. Storage is
+     *  doubled when full until capacity is reached, then the ring wraps.
+     */
+    struct Buffer {
+        std::size_t index;
+        std::size_t capacity;
+        std::vector<Event> events;
+        std::size_t next;
+        std::size_t dropped;
+
+        Buffer(std::size_t index, std::size_t capacity)
+            : index(index), capacity(capacity), next(), dropped()
+        {}
+
+        void push(const char *name, const std::string &detail
+                  , std::int64_t start, std::int64_t duration);
+    };
+
+    Tracer(std::size_t capacity);
+
+    /** Returns buffer of calling thread.
+     */
+    Buffer& buffer();
+
+    /** Returns buffer of finished thread for reuse.
+     */
+    void release(Buffer *buffer);
+
+    /** Nanoseconds since tracer start.
+     */
+    std::int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>
+            (Clock::now() - start_).count();
+    }
+
+    /** Writes all recorded spans as Chrome trace JSON.
+     */
+    void write(std::ostream &os) const;
+
+private:
+    const std::size_t capacity_;
+    const Clock::time_point start_;
+    std::mutex mutex_;
+    std::deque<Buffer> buffers_;
+    std::vector<Buffer*> free_;
+};
+
+namespace detail { extern Tracer *tracer; }
+
+/** Global tracer, null when tracing is disabled.
+ */
+inline Tracer* tracer() { return detail::tracer; }
+
+/** Records one span: from construction to destruction.
+ */
+class TraceSpan {
+public:
+    /** Span with static name (must outlive the tracer).
+     */
+    TraceSpan(const char *name) : buffer_() {
+        if (auto *t = tracer()) { begin(*t, name, nullptr); }
+    }
+
+    /** Span with static name and detail (e.g. window path, node ID).
+     */
+    TraceSpan(const char *name, const std::string &detail) : buffer_() {
+        if (auto *t = tracer()) { begin(*t, name, &detail); }
+    }
+
+    ~TraceSpan() { if (buffer_) { end(); } }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    void begin(Tracer &tracer, const char *name, const std::string *detail);
+    void end();
+
+    Tracer::Buffer *buffer_;
+    const char *name_;
+    std::string detail_;
+    std::int64_t start_;
+};
+
+/** Registers --trace options.
+ */
+void traceConfiguration(boost::program_options::options_description
+                        &config);
+
+/** Enables tracing if --trace option is set.
+ */
+void configureTrace(const boost::program_options::variables_map &vars);
+
+/** Writes recorded spans into file given by --trace option (if any). Shard
+ *  workers write into <path>.shard<worker>.
+ */
+void writeTrace(const boost::optional<unsigned int> &worker = boost::none);
+
+} // namespace vtstools
+
+#endif // vts_tools_trace_hpp_included_
@@ -29,6 +29,7 @@
 #include <iostream>
 #include <algorithm>
 #include <iterator>
+#include <mutex>
 
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
@@ -43,7 +44,6 @@
 #include "utility/gccversion.hpp"
 #include "utility/progress.hpp"
 #include "utility/streams.hpp"
-#include "utility/openmp.hpp"
 #include "utility/limits.hpp"
 #include "utility/binaryio.hpp"
 
@@ -81,6 +81,12 @@
 #include "vts-libs/tools-support/tmptsencoder.hpp"
 #include "vts-libs/tools-support/repackatlas.hpp"
 
+#include "cutengine.hpp"
+#include "shard.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "threadpool.hpp"
+
 
 namespace po = boost::program_options;
 namespace bio = boost::iostreams;
@@ -94,7 +100,7 @@ namespace tools = vtslibs::vts::tools;
 
 namespace {
 
-struct Config : tools::TmpTsEncoder::Config {
+struct Config : tools::TmpTsEncoder::Config, vtstools::CutConfig {
     std::string tilesetId;
     std::string referenceFrame;
     math::Size2 optimalTextureSize;
@@ -102,30 +108,27 @@ struct Config : tools::TmpTsEncoder::Config {
     int fixedBestLod;
     bool isLoadMeshJson;
 
-    boost::optional<vts::LodTileRange> tileExtents;
     int lodDepth = 0;
-    double clipMargin;
-    double borderClipMargin;
     double sigmaEditCoef;
     boost::optional<double> nominalResolution;
 
-    double zShift;
-
     unsigned int revision = 0;
 
     bool debug_nothreads;
 
+    vtstools::ShardConfig sharding;
+
     Config()
         : optimalTextureSize(256, 256)
         , ntLodPixelSize(1.0)
         , fixedBestLod(0)
         , isLoadMeshJson(false)
-        , clipMargin(1.0 / 128.)
-        , borderClipMargin(clipMargin)
         , sigmaEditCoef(1.5)
-        , zShift(0.0)
         , debug_nothreads(false)
-    {}
+    {
+        // tiles are stored with original window textures
+        repack = false;
+    }
 
     void configuration(po::options_description &config) {
         tools::TmpTsEncoder::Config::configuration(config);
@@ -201,6 +204,11 @@ struct Config : tools::TmpTsEncoder::Config {
              , "Disable threading for debugging purposes. Applies only to "
              "tileset encoding so far.")
             ;
+
+        sharding.configuration(config);
+        vtstools::metricsConfiguration(config);
+        vtstools::traceConfiguration(config);
+        vtstools::threadPoolConfiguration(config);
     }
 
     void configure(const po::variables_map &vars) {
@@ -224,6 +232,11 @@ struct Config : tools::TmpTsEncoder::Config {
             LOG(info3) << "Limiting output to last "
                        << -lodDepth << " LODs.";
         }
+        sharding.configure(vars);
+        shard = sharding.shard(tileExtents);
+        vtstools::configureMetrics(vars);
+        vtstools::configureTrace(vars);
+        vtstools::configureThreadPool(vars);
     }
 };
 
@@ -289,6 +302,12 @@ void Vef2Vts::configure(const po::variables_map &vars)
                    ? vts::CreateMode::overwrite
                    : vts::CreateMode::failIfExists);
 
+    if (config_.sharding.worker) {
+        // worker cuts into its own tileset
+        output_ = vtstools::shardOutput(output_, *config_.sharding.worker);
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     epConfig_ = vt::configureProgress(vars);
 }
 
@@ -450,6 +469,8 @@ void loadJson(ObjLoader &loader, const roarchive::RoArchive &archive
 bool loadObj(ObjLoader &loader, const roarchive::RoArchive &archive
              , const vef::Window &window)
 {
+    vtstools::TraceSpan span("loadObj", window.mesh.path.string());
+
     switch (window.mesh.format) {
     case vef::Mesh::Format::obj:
         return loader.parse(*archive.istream(window.mesh.path));
@@ -504,6 +525,16 @@ struct Assignment {
         , meshExtents(meshExtents), lodRange(vts::LodRange::emptyRange())
     {}
 
+    /** Computes output LOD for window LOD lodDiff levels above the most
+     *  detailed one.
+     *
+     *  Returns false if such window LOD produces nothing in this node or, when
+     *  tileExtents are set, if mesh extents (computed during analysis) miss
+     *  them. No I/O is performed.
+     */
+    bool outputLod(vts::Lod lodDiff, const Config &config
+                   , vts::Lod &lod) const;
+
     void setLod(vts::Lod localLod) {
         const auto& nodeId(node.nodeId());
         auto tileRange(computeTileRange(node.node(), localLod, meshExtents));
@@ -543,6 +574,80 @@ struct Assignment {
     typedef std::vector<map> maplist;
 };
 
+bool Assignment::outputLod(vts::Lod lodDiff, const Config &config
+                           , vts::Lod &lod) const
+{
+    if (lodRange.empty()) { return false; }
+    // check for absolute underflow
+    if (lodDiff > lodRange.max) { return false; }
+    lod = lodRange.max - lodDiff;
+    // check for underflow in given assignment
+    if (lod < lodRange.min) { return false; }
+
+    const auto &nodeId(node.nodeId());
+    // out of this node
+    if (lod < nodeId.lod) { return false; }
+
+    if (!config.tileExtents && !config.shard) { return true; }
+
+    // only tiles at and below tile extents' LOD are generated
+    if (config.tileExtents && (lod < config.tileExtents->lod)) {
+        return false;
+    }
+
+    const vts::Lod localLod(lod - nodeId.lod);
+    auto tr(computeTileRange(node.node(), localLod, meshExtents));
+
+    // extents were measured at the most detailed window LOD; coarser LODs
+    // can overshoot a bit -> grow range by one tile
+    for (int i(0); i < 2; ++i) {
+        if (tr.ll(i) > 0) { --tr.ll(i); }
+        ++tr.ur(i);
+    }
+
+    // convert local tilerange to global tilerange
+    {
+        const auto origin(vts::lowestChild(vts::point(nodeId), localLod));
+        tr.ll += origin;
+        tr.ur += origin;
+    }
+
+    if (config.tileExtents
+        && !vts::tileRangesOverlap
+        (tr, vts::shiftRange(*config.tileExtents, lod)))
+    {
+        return false;
+    }
+
+    // nothing for this worker's shard
+    return !config.shard || config.shard->overlaps(lod, tr);
+}
+
+/** Returns range [begin, end) of window LODs to process after applying
+ *  lodDepth.
+ */
+std::pair<std::size_t, std::size_t> windowLods(const Config &config
+                                               , std::size_t lodCount)
+{
+    // start/end lods, defaults to whole dataset
+    std::size_t bLod(0);
+    std::size_t eLod(lodCount);
+
+    // apply lod depth
+    if (config.lodDepth > 0) {
+        // >0 -> only first lodDepth lods
+        eLod = std::min(std::size_t(config.lodDepth), eLod);
+    } else if (config.lodDepth < 0) {
+        // <0 -> only last lodDepth lods
+        const std::size_t lodDepth(-config.lodDepth);
+        if (lodDepth < eLod) {
+            bLod = eLod - lodDepth;
+        }
+    }
+
+    return { bLod, eLod };
+}
+
 struct NavtileInfo {
     vts::LodRange lodRange;
     double pixelSize;
@@ -720,12 +825,13 @@ NavtileInfo computeNavtileInfo(const vts::NodeInfo &node
 
 class Analyzer {
 public:
+    /** Analyzes whole input.
+     */
     Analyzer(const std::vector<vef::Archive> &input
              , const vr::ReferenceFrame &rf
              , const Config &config
-             , vts::NtGenerator &ntg
              , vt::ExternalProgress &progress)
-        : rf_(rf), config_(config), progress_(progress)
+        : rf_(rf), config_(config), progress_(&progress)
         , nodes_(vts::NodeInfo::nodes(rf_))
     {
         // calculate number of reported events
@@ -748,18 +854,20 @@ public:
             auto assignmentsStart(assignments.size());
             assignments.resize(assignmentsStart + manifestWindowsSize);
 
-            UTILITY_OMP(parallel for)
-                for (std::size_t i = 0; i < manifestWindowsSize; ++i) {
-                    // calculate assignment
-                    const auto &loddedWindow(manifest.windows[i]);
-                    const auto assignment
-                        (assign(*manifest.srs, archive
-                                , loddedWindow.lods.front()
-                                , loddedWindow.lods.size() - 1
-                                , vef::windowMatrix(manifest, loddedWindow)));
-                    // store
-                    assignments[assignmentsStart + i] = assignment;
-                }
+            vtstools::parallelFor(manifestWindowsSize, [&](std::size_t i)
+            {
+                vtstools::ScopedPhase phase(vtstools::Phase::analyze);
+
+                // calculate assignment
+                const auto &loddedWindow(manifest.windows[i]);
+                const auto assignment
+                    (assign(*manifest.srs, archive
+                            , loddedWindow.lods.front()
+                            , loddedWindow.lods.size() - 1
+                            , vef::windowMatrix(manifest, loddedWindow)));
+                // store
+                assignments[assignmentsStart + i] = assignment;
+            });
         }
 
         analyze(assignments);
@@ -771,9 +879,20 @@ public:
             assignments_.emplace_back(iassignments, iassignments + size);
             iassignments += size;
         }
+    }
+
+    /** Loads analysis result stored by shard coordinator (see json()).
+     */
+    Analyzer(const std::vector<vef::Archive> &input
+             , const vr::ReferenceFrame &rf
+             , const Config &config
+             , const Json::Value &analysis);
 
-        for (const auto &item : ntMap_) {
-            ntg.addAccumulator(item.first->srs, item.second.lodRange
+    /** Adds navtile accumulators of all analyzed subtrees.
+     */
+    void addAccumulators(vts::NtGenerator &ntg) const {
+        for (const auto &item : navtiles_) {
+            ntg.addAccumulator(item.first, item.second.lodRange
                                , item.second.pixelSize);
         }
     }
@@ -782,24 +901,118 @@ public:
         return assignments_;
     }
 
+    /** Analysis result, passed from shard coordinator to workers.
+     */
+    Json::Value json() const;
+
 private:
     void analyze(Assignment::maplist &assignments);
     Assignment::map assign(const geo::SrsDefinition &inputSrs
                            , const vef::Archive &archive
                            , const vef::Window &window, std::size_t lodCount
-                           , const vef::OptionalMatrix trafo);
+                           , const vef::OptionalMatrix trafo) const;
 
     const vr::ReferenceFrame &rf_;
     const Config &config_;
-    vt::ExternalProgress &progress_;
+    vt::ExternalProgress *progress_;
 
     const vts::NodeInfo::list nodes_;
-    NavtileInfo::map ntMap_;
+
+    /** Navtile info of every analyzed subtree, by subtree SRS.
+     */
+    std::vector<std::pair<std::string, NavtileInfo>> navtiles_;
     std::vector<Assignment::maplist> assignments_;
 };
 
+Analyzer::Analyzer(const std::vector<vef::Archive> &input
+                   , const vr::ReferenceFrame &rf
+                   , const Config &config
+                   , const Json::Value &analysis)
+    : rf_(rf), config_(config), progress_()
+    , nodes_(vts::NodeInfo::nodes(rf_))
+{
+    const auto &archives(analysis["assignments"]);
+    if (archives.size() != input.size()) {
+        LOGTHROW(err2, std::runtime_error)
+            << "Analysis result does not match input (" << archives.size()
+            << " archives analyzed, " << input.size() << " given).";
+    }
+
+    for (Json::ArrayIndex a(0); a < archives.size(); ++a) {
+        const auto &windows(archives[a]);
+        if (windows.size() != input[a].manifest().windows.size()) {
+            LOGTHROW(err2, std::runtime_error)
+                << "Analysis result does not match window count of input "
+                "archive #" << a << ".";
+        }
+
+        assignments_.emplace_back();
+        auto &maplist(assignments_.back());
+        for (const auto &window : windows) {
+            maplist.emplace_back();
+            auto &map(maplist.back());
+            for (const auto &item : window) {
+                const auto &node(vtstools::findNode
+                                 (nodes_, vtstools::parseTileId
+                                  (item["node"])));
+                Assignment assignment
+                    (node, item["bestLod"].asDouble()
+                     , item["lodCount"].asUInt()
+                     , vtstools::parseExtents(item["extents"]));
+                assignment.lodRange
+                    = vtstools::parseLodRange(item["lodRange"]);
+                map.insert(Assignment::map::value_type
+                           (node.nodeId(), assignment));
+            }
+        }
+    }
+
+    for (const auto &item : analysis["navtiles"]) {
+        navtiles_.emplace_back
+            (item["srs"].asString()
+             , NavtileInfo(vtstools::parseLodRange(item["lodRange"])
+                           , item["pixelSize"].asDouble()));
+    }
+}
+
+Json::Value Analyzer::json() const
+{
+    Json::Value value(Json::objectValue);
+
+    auto &archives(value["assignments"] = Json::Value(Json::arrayValue));
+    for (const auto &maplist : assignments_) {
+        auto &windows(archives.append(Json::Value(Json::arrayValue)));
+        for (const auto &map : maplist) {
+            auto &window(windows.append(Json::Value(Json::arrayValue)));
+            for (const auto &item : map) {
+                const auto &assignment(item.second);
+                // assignments without LOD range produce nothing
+                if (assignment.lodRange.empty()) { continue; }
+
+                auto &a(window.append(Json::Value(Json::objectValue)));
+                a["node"] = vtstools::asJson(assignment.node.nodeId());
+                a["bestLod"] = assignment.bestLod;
+                a["lodCount"] = Json::UInt(assignment.lodCount);
+                a["extents"] = vtstools::asJson(assignment.meshExtents);
+                a["lodRange"] = vtstools::asJson(assignment.lodRange);
+            }
+        }
+    }
+
+    auto &navtiles(value["navtiles"] = Json::Value(Json::arrayValue));
+    for (const auto &item : navtiles_) {
+        auto &nt(navtiles.append(Json::Value(Json::objectValue)));
+        nt["srs"] = item.first;
+        nt["lodRange"] = vtstools::asJson(item.second.lodRange);
+        nt["pixelSize"] = item.second.pixelSize;
+    }
+
+    return value;
+}
+
 void Analyzer::analyze(Assignment::maplist &assignments)
 {
+    NavtileInfo::map ntMap;
     for (const auto &node : nodes_) {
         Assignment::plist nodeAssignments;
         for (auto &assignment : assignments) {
@@ -816,17 +1029,21 @@ void Analyzer::analyze(Assignment::maplist &assignments)
 
         // create navtile info mapping for this node
         if (const auto ni = computeNavtileInfo(node, analyzed, config_)) {
-            ntMap_.insert(NavtileInfo::map::value_type
-                          (&node.subtree().root(), ni));
+            ntMap.insert(NavtileInfo::map::value_type
+                         (&node.subtree().root(), ni));
         }
     }
+
+    for (const auto &item : ntMap) {
+        navtiles_.emplace_back(item.first->srs, item.second);
+    }
 }
 
 Assignment::map Analyzer::assign(const geo::SrsDefinition &inputSrs
                                  , const vef::Archive &archive
                                  , const vef::Window &window
                                  , std::size_t lodCount
-                                 , const vef::OptionalMatrix trafo)
+                                 , const vef::OptionalMatrix trafo) const
 {
     // load mesh
     ObjLoader loader(trafo);
@@ -838,7 +1055,9 @@ Assignment::map Analyzer::assign(const geo::SrsDefinition &inputSrs
     }
 
     // mesh loaded
-    ++progress_;
+    ++*progress_;
+    vtstools::count(vtstools::Counter::meshesDecoded
+                    , loader.mesh().submeshes.size());
 
     if (loader.mesh().submeshes.size() != window.atlas.size()) {
         LOGTHROW(err2, std::runtime_error)
@@ -850,9 +1069,10 @@ Assignment::map Analyzer::assign(const geo::SrsDefinition &inputSrs
 
     // process all real RF nodes
     Assignment::map assignment;
-    std::size_t nodeCount(nodes_.size());
-    UTILITY_OMP(parallel for)
-    for (std::size_t i = 0; i < nodeCount; ++i) {
+    std::mutex assignmentMutex;
+    // nested in window loop, i.e. runs serially inside pool thread
+    vtstools::parallelFor(nodes_.size(), [&](std::size_t i)
+    {
         const auto &node(nodes_[i]);
 
         // try to convert mesh into node's SRS
@@ -893,7 +1113,7 @@ Assignment::map Analyzer::assign(const geo::SrsDefinition &inputSrs
 
         if (mesh.empty()) {
             // nothing left in the mesh, skip this node
-            continue;
+            return;
         }
 
         // calculate optimal tile area
@@ -957,7 +1177,7 @@ Assignment::map Analyzer::assign(const geo::SrsDefinition &inputSrs
             optimalTileArea = area(config_.optimalTextureSize) * texelArea;
         }
 
-        if (optimalTileArea <= 0.0) { continue; }
+        if (optimalTileArea <= 0.0) { return; }
 
         const auto optimalTileCount(node.extents().area()
                                     / optimalTileArea);
@@ -965,68 +1185,129 @@ Assignment::map Analyzer::assign(const geo::SrsDefinition &inputSrs
         if (config_.fixedBestLod > 0) {
             bestLod = config_.fixedBestLod;
         }
-        if (bestLod < 0) { continue; }
+        if (bestLod < 0) { return; }
 
         // we have best lod for this window in this SDS node, store info
-        UTILITY_OMP(critical)
-            assignment.insert
+        std::lock_guard<std::mutex> lock(assignmentMutex);
+        assignment.insert
             (Assignment::map::value_type
              (node.nodeId()
               , Assignment(node, bestLod, lodCount, computeExtents(mesh))));
-    }
+    });
 
     // mesh analyzed
-    ++progress_;
+    ++*progress_;
 
     // done
     return assignment;
 }
 
-class Cutter {
+/** Provides VEF windows to the cutting engine.
+ *
+ *  Work unit is one LOD of one window of one input archive. All units from
+ *  all archives form one work list, therefore there is no barrier between
+ *  archives.
+ */
+class WindowReader : public vtstools::SourceReader {
 public:
-    Cutter(tools::TmpTileset &tmpset, const vef::Archive &archive
-           , const vr::ReferenceFrame &rf, const Config &config
-           , vt::ExternalProgress &progress
-           , const Assignment::maplist &assignments)
-        : tmpset_(tmpset), archive_(archive)
-        , manifest_(archive_.manifest()), rf_(rf)
-        , inputSrs_(*manifest_.srs), config_(config), progress_(progress)
-        , nodes_(vts::NodeInfo::nodes(rf_))
+    WindowReader(const std::vector<vef::Archive> &input
+                 , const std::vector<Assignment::maplist> &assignments
+                 , const Config &config)
+        : input_(input), assignments_(assignments), config_(config)
     {
-        cut(assignments);
+        for (std::size_t a(0), ae(input_.size()); a != ae; ++a) {
+            const auto &windows(input_[a].manifest().windows);
+            for (std::size_t w(0), we(windows.size()); w != we; ++w) {
+                const auto lods(windowLods(config_, windows[w].lods.size()));
+                for (std::size_t l(lods.first); l < lods.second; ++l) {
+                    units_.emplace_back(a, w, l);
+                }
+            }
+        }
     }
 
-private:
-    void cut(const Assignment::maplist &assignments);
+    virtual std::size_t size() const { return units_.size(); }
 
-    void windowCut(const vef::Window &window, vts::Lod lodDiff
-                   , const Assignment::map &assignemnts
-                   , const vef::OptionalMatrix trafo);
+    virtual std::string name(std::size_t index) const {
+        return "window " + window(units_[index]).path.string();
+    }
 
-    void splitToTiles(const vts::NodeInfo &root
-                      , vts::Lod lod, const vts::TileRange &tr
-                      , const vts::Mesh &mesh
-                      , const vts::opencv::Atlas &atlas);
-    void cutTile(const vts::NodeInfo &node, const vts::Mesh &mesh
-                 , const vts::opencv::Atlas &atlas);
+    virtual const char* traceName() const { return "windowCut"; }
 
-    cv::Mat loadTexture(const fs::path &path) const;
+    virtual const geo::SrsDefinition& srs(std::size_t index) const {
+        return *input_[units_[index].archive].manifest().srs;
+    }
 
-    tools::TmpTileset &tmpset_;
-    const vef::Archive &archive_;
-    const vef::Manifest &manifest_;
-    const vr::ReferenceFrame &rf_;
-    const geo::SrsDefinition &inputSrs_;
-    const Config &config_;
-    vt::ExternalProgress &progress_;
-    const vts::NodeInfo::list nodes_;
+    virtual vtstools::CutTarget::list targets(std::size_t index) const;
+
+    virtual void load(std::size_t index, vtstools::SourceMesh &source) const;
 
-    NavtileInfo::map ntMap_;
+    virtual double cost(std::size_t index) const;
+
+private:
+    struct Unit {
+        std::size_t archive;
+        std::size_t window;
+        std::size_t lod;
+
+        Unit(std::size_t archive, std::size_t window, std::size_t lod)
+            : archive(archive), window(window), lod(lod)
+        {}
+    };
+
+    const auto& loddedWindow(const Unit &unit) const {
+        return input_[unit.archive].manifest().windows[unit.window];
+    }
+
+    const vef::Window& window(const Unit &unit) const {
+        return loddedWindow(unit).lods[unit.lod];
+    }
+
+    cv::Mat loadTexture(const roarchive::RoArchive &archive
+                        , const fs::path &path) const;
+
+    const std::vector<vef::Archive> &input_;
+    const std::vector<Assignment::maplist> &assignments_;
+    const Config &config_;
+    std::vector<Unit> units_;
 };
 
-cv::Mat Cutter::loadTexture(const fs::path &path) const
+vtstools::CutTarget::list WindowReader::targets(std::size_t index) const
 {
-    const auto &archive(archive_.archive());
+    const auto &unit(units_[index]);
+
+    vtstools::CutTarget::list targets;
+    for (const auto &item : assignments_[unit.archive][unit.window]) {
+        const auto &assignment(item.second);
+        vts::Lod lod;
+        if (assignment.outputLod(unit.lod, config_, lod)) {
+            targets.emplace_back(assignment.node, lod);
+        }
+    }
+
+    if (targets.empty()) {
+        LOG(info1) << "Window " << window(unit).path
+                   << " produces no output, skipped.";
+    }
+
+    return targets;
+}
+
+double WindowReader::cost(std::size_t index) const
+{
+    // texture data to load and process
+    double cost(1.0);
+    for (const auto &texture : window(units_[index]).atlas) {
+        cost += math::area(texture.size);
+    }
+    return cost;
+}
+
+cv::Mat WindowReader::loadTexture(const roarchive::RoArchive &archive
+                                  , const fs::path &path) const
+{
+    vtstools::TraceSpan span("loadTexture", path.string());
+
     if (archive.directio()) {
         // optimized access
         auto tex(cv::imread(archive.path(path).string()));
@@ -1047,247 +1328,72 @@ cv::Mat Cutter::loadTexture(const fs::path &path) const
     return tex;
 }
 
-void Cutter::cut(const Assignment::maplist &assignments)
+void WindowReader::load(std::size_t index, vtstools::SourceMesh &source)
+    const
 {
-    std::size_t manifestWindowsSize(manifest_.windows.size());
-    UTILITY_OMP(parallel for)
-        for (std::size_t i = 0; i < manifestWindowsSize; ++i) {
-            const auto &loddedWindow(manifest_.windows[i]);
-            auto &assignment(assignments[i]);
-
-            dbglog::thread_id(loddedWindow.path.filename().string());
-
-            LOG(info3) << "Processing window LODs from: " << loddedWindow.path
-                       << " (" << loddedWindow.lods.size() << " LODs).";
-
-            // start/end lods, defaults to whole datase
-            std::size_t bLod(0);
-            std::size_t eLod(loddedWindow.lods.size());
-
-            // apply lod depth
-            if (config_.lodDepth > 0) {
-                // >0 -> only first lodDepth lods
-                eLod = std::min(std::size_t(config_.lodDepth), eLod);
-            } else if (config_.lodDepth < 0) {
-                // <0 -> only last lodDepth lods
-                const std::size_t lodDepth(-config_.lodDepth);
-                if (lodDepth < eLod) {
-                    bLod = eLod - lodDepth;
-                }
-            }
-
-            for (std::size_t ii = bLod; ii < eLod; ++ii) {
-                windowCut( loddedWindow.lods[ii], ii, assignment
-                         , vef::windowMatrix(manifest_, loddedWindow));
-                ++progress_;
-            }
-        }
-}
+    const auto &unit(units_[index]);
+    const auto &manifest(input_[unit.archive].manifest());
+    const auto &archive(input_[unit.archive].archive());
+    const auto &lw(loddedWindow(unit));
+    const auto &window(lw.lods[unit.lod]);
 
+    dbglog::thread_id(lw.path.filename().string());
 
-void Cutter::windowCut(const vef::Window &window, vts::Lod lodDiff
-                       , const Assignment::map &assignemnts
-                       , const vef::OptionalMatrix trafo)
-{
     // load mesh
-    ObjLoader loader(trafo);
+    ObjLoader loader(vef::windowMatrix(manifest, lw));
     LOG(info3) << "Loading window mesh from: " << window.mesh.path;
-    if (!loadObj(loader, archive_.archive(), window)) {
+    if (!loadObj(loader, archive, window)) {
         LOGTHROW(err2, std::runtime_error)
             << "Unable to load mesh from " << window.mesh.path << ".";
     }
 
     if (config_.isLoadMeshJson) {
         LOG(info3) << "loading submesh json from: " << window.path;
-        loadJson(loader, archive_.archive(), window);
+        loadJson(loader, archive, window);
     }
 
-    if (loader.mesh().submeshes.size() != window.atlas.size()) {
+    if (loader.mesh_.submeshes.size() != window.atlas.size()) {
         LOGTHROW(err2, std::runtime_error)
             << "Texture/submesh count mismatch in window "
             << window.path << ".";
     }
 
-    vts::opencv::Atlas inAtlas;
     for (const auto &texture : window.atlas) {
         LOG(info3) << "Loading window texture from: " << texture.path;
-        inAtlas.add(loadTexture(texture.path));
-    }
-
-    // get input mesh
-    const auto &inMesh(loader.mesh());
-
-    for (const auto &item : assignemnts) {
-        const auto &assignment(item.second);
-
-        // compute current lod
-        if (assignment.lodRange.empty()) { continue; }
-        // grab lod
-        auto lod(assignment.lodRange.max);
-        // check for absolute underflow
-        if (lodDiff > lod) { continue; }
-        // fix lod
-        lod -= lodDiff;
-        // check for underflow in given assignment
-        if (lod < assignment.lodRange.min) { continue; }
-
-        const auto &node(assignment.node);
-        const auto &nodeId(node.nodeId());
-
-        // out of this node, abandon
-        if (lod < nodeId.lod) { continue; }
-
-        // try to convert mesh into node's SRS
-        const vts::CsConvertor conv(inputSrs_, node.srs());
-
-        // local mesh and textures
-        vts::Mesh mesh;
-        vts::opencv::Atlas atlas;
-        mesh.submeshes.reserve(inMesh.submeshes.size());
-
-        std::size_t smIndex(0);
-        for (const auto &sm : inMesh) {
-            const auto &texture(inAtlas.get(smIndex++));
-            // project mesh to srs and create mask (full by default)
-
-            // make all faces valid by default
-            vts::VertexMask valid(sm.vertices.size(), true);
-            math::Points3 projected;
-            projected.reserve(sm.vertices.size());
-
-            auto ivalid(valid.begin());
-            for (const auto &v : sm.vertices) {
-                try {
-                    projected.push_back(conv(v));
-                    // apply zShift
-                    if (config_.zShift) {
-                        projected.back()(2) += config_.zShift;
-                    }
-                    ++ivalid;
-                } catch (const std::exception&) {
-                    // failed to convert vertex, mask it and skip
-                    projected.emplace_back();
-                    *ivalid++ = false;
-                }
-            }
-
-            // clip mesh to node's extents
-            // FIXME: implement mask application in clipping!
-            auto osm(vts::clip(sm, projected, node.extents(), valid));
-            if (osm.faces.empty()) { continue; }
-            osm.jsonStr = sm.jsonStr;
-            // at least one face survived, remember
-            mesh.submeshes.push_back(std::move(osm));
-            atlas.add(texture);
-        }
-
-        if (mesh.empty()) {
-            // nothing left in the mesh, skip this node
-            continue;
-        }
-
-        const vts::Lod localLod(lod - nodeId.lod);
-
-        // compute local tile range
-        auto tr(computeTileRange(node.node(), localLod, computeExtents(mesh)));
-
-        // convert local tilerange to global tilerange
-        {
-            const auto origin(vts::lowestChild(vts::point(nodeId), localLod));
-            tr.ll += origin;
-            tr.ur += origin;
-        }
-
-        splitToTiles(node, lod, tr, mesh, atlas);
+        source.atlas.add(loadTexture(archive, texture.path));
     }
-}
 
-void Cutter::splitToTiles(const vts::NodeInfo &root
-                          , vts::Lod lod, const vts::TileRange &tr
-                          , const vts::Mesh &mesh
-                          , const vts::opencv::Atlas &atlas)
-{
-    LOG(info3) << "Splitting to tiles in " << lod << "/" << tr << ".";
-    typedef vts::TileRange::value_type Index;
-    Index je(tr.ur(1));
-    Index ie(tr.ur(0));
-
-    for (Index j = tr.ll(1); j <= je; ++j) {
-        for (Index i = tr.ll(0); i <= ie; ++i) {
-            vts::TileId tileId(lod, i, j);
-            const auto node(root.child(tileId));
-            cutTile(node, mesh, atlas);
-        }
-    }
-}
-
-void Cutter::cutTile(const vts::NodeInfo &node, const vts::Mesh &mesh
-                     , const vts::opencv::Atlas &atlas)
-{
-    // compute border condition (defaults to all available)
-    vts::BorderCondition borderCondition;
-    if (config_.tileExtents) {
-        borderCondition = vts::inside(*config_.tileExtents, node.nodeId());
-        if (!borderCondition) { return; }
-    }
-
-    // compute clip extents
-    const auto extents(vts::inflateTileExtents
-                       (node.extents(), config_.clipMargin
-                        , borderCondition, config_.borderClipMargin));
-
-    vts::Mesh clipped;
-    vts::opencv::Atlas clippedAtlas(0); // PNG!
-
-    std::size_t smIndex(0);
-    for (const auto &sm : mesh) {
-        const auto &texture(atlas.get(smIndex++));
-
-        auto m(vts::clip(sm, extents));
-        if (m.empty()) { continue; }
-        m.jsonStr = sm.jsonStr;
-        clipped.submeshes.push_back(std::move(m));
-        clippedAtlas.add(texture);
-    }
-
-    if (clipped.empty()) { return; }
-
-    // store in temporary storage
-    const auto tileId(node.nodeId());
-    //
-//    tools::repack(tileId, clipped, clippedAtlas);
-    tmpset_.store(tileId, clipped, clippedAtlas);
+    source.mesh = std::move(loader.mesh_);
 }
 
 void cutTiles(const std::vector<vef::Archive> &input
               , tools::TmpTileset &tmpset
               , const vr::ReferenceFrame &rf
-              , const Config config
+              , const Config &config
               , vts::NtGenerator &ntg
               , vt::ExternalProgress &progress)
 {
-    // analyze whole input
-    Analyzer analyzer(input, rf, config, ntg, progress);
-    const auto &assignments(analyzer.assignments());
-
-    // cut phase
-    progress.expect([&]() -> std::size_t
-    {
-        std::size_t events(0);
-        for (const auto &archive : input) {
-            for (const auto &window : archive.manifest().windows) {
-                events += window.lods.size();
-            }
+    // analyze whole input; sharded conversion analyzes only in the
+    // coordinator
+    boost::optional<Analyzer> analyzer;
+    if (config.sharding.loadAnalysis()) {
+        analyzer = boost::in_place
+            (input, rf, config
+             , vtstools::loadShardAnalysis(*config.sharding.analysis));
+    } else {
+        analyzer = boost::in_place(input, rf, config, progress);
+        if (config.sharding.storeAnalysis()) {
+            vtstools::saveShardAnalysis(*config.sharding.analysis
+                                        , analyzer->json());
+            return;
         }
-        return events;
-    }());
-
-    // cut per archive
-    auto iassignments(assignments.begin());
-    for (const auto &archive : input) {
-        Cutter(tmpset, archive, rf, config, progress
-               , *iassignments++);
     }
+    analyzer->addAccumulators(ntg);
+
+    // cut all windows from all archives
+    vtstools::CutEngine(config, tmpset)
+        .run(WindowReader(input, analyzer->assignments(), config)
+             , progress);
 }
 
 /**
@@ -1329,6 +1435,12 @@ public:
                  , progress());
     }
 
+    /** Keeps cut tiles for the shard coordinator.
+     */
+    void finishShard(const boost::filesystem::path &path) {
+        vtstools::finishShard(path, tmpset(), ntg());
+    }
+
 private:
     const ::Config config_;
 };
@@ -1354,9 +1466,35 @@ int Vef2Vts::run()
         }
     }
 
+    if (config_.sharding.coordinator() && !config_.resume) {
+        // analyze input once (creates output), cut in worker processes, then
+        // generate from merged tiles
+        config_.sharding.analysis = vtstools::shardAnalysis(output_);
+        {
+            Encoder analyzer(output_, properties, createMode_, input
+                             , config_
+                             , vt::ExternalProgress::Config(epConfig_));
+        }
+        vtstools::ShardCoordinator(output_, config_.tileExtents
+                                   , config_.sharding, config_.keepTmpset)
+            .run();
+        config_.resume = true;
+        createMode_ = vts::CreateMode::overwrite;
+    }
+
     // run the encoder
-    Encoder(output_, properties, createMode_, input, config_
-            , std::move(epConfig_)).run(!config_.debug_nothreads);
+    Encoder encoder(output_, properties, createMode_, input, config_
+                    , std::move(epConfig_));
+
+    if (config_.sharding.worker) {
+        encoder.finishShard(output_);
+    } else {
+        vtstools::ScopedPhase phase(vtstools::Phase::generate);
+        encoder.run(!config_.debug_nothreads);
+    }
+
+    vtstools::writeMetrics(config_.sharding.worker);
+    vtstools::writeTrace(config_.sharding.worker);
 
     // all done
     LOG(info4) << "All done.";
@@ -1368,5 +1506,6 @@ int Vef2Vts::run()
 int main(int argc, char *argv[])
 {
     utility::unlimitedCoredump();
+    vtstools::saveCommandLine(argc, argv);
     return Vef2Vts()(argc, argv);
 }